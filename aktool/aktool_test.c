@@ -825,6 +825,67 @@
  return EXIT_SUCCESS;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* количество операций выработки (проверки) подписи в секунду */
+ static double aktool_test_sign_verify_speed( ak_signkey ctx, ak_verifykey pctx,
+                                          ak_uint64 *k, ak_uint64 *e, ak_uint8 *sign, size_t cnt )
+{
+  size_t i = cnt;
+  clock_t timea = clock();
+  ak_uint8 out[128];
+
+  if( pctx == NULL ) while( i-- ) ak_signkey_sign_const_values( ctx, k, e, out );
+   else while( i-- )
+     if( !ak_verifykey_verify_hash( pctx, e, sizeof( ak_uint64 )*pctx->wc->size, sign )) return 0;
+  timea = clock() - timea;
+  if( timea == 0 ) timea = 1;
+ return ( cnt *(double) CLOCKS_PER_SEC )/(double) timea;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сравнение скорости выработки и проверки подписи при использовании реализаций арифметики
+   Монтгомери для модулей произвольного размера (before) и специализированных реализаций (after) */
+ static int aktool_test_montgomery_for_one_curve( ak_signkey ctx, ak_oid curve )
+{
+  int idx = 0;
+  struct verifykey pctx;
+  struct random generator;
+  double sgn[2], vrf[2];
+  ak_uint8 sign[128];
+  ak_uint64 e[8], k[8];
+  ak_int64 fixed = ak_libakrypt_get_option_by_name( "use_fixed_size_montgomery" ),
+           level = ak_libakrypt_get_option_by_name( "cpu_dispatch_level" );
+
+  if( ak_random_create_lcg( &generator ) != ak_error_ok ) return EXIT_FAILURE;
+  if( ak_verifykey_create_from_signkey( &pctx, ctx ) != ak_error_ok ) {
+    ak_random_destroy( &generator );
+    return EXIT_FAILURE;
+  }
+  ak_random_ptr( &generator, e, 64 );
+  ak_random_ptr( &generator, k, 64 );
+  ak_signkey_sign_hash( ctx, &generator, e, sizeof( ak_uint64 )*pctx.wc->size, sign, sizeof( sign ));
+
+  for( idx = 0; idx < 2; idx++ ) {
+     ak_libakrypt_set_option( "use_fixed_size_montgomery", idx );
+     ak_libakrypt_set_cpu_level(( cpu_level_t ) level );
+     sgn[idx] = aktool_test_sign_verify_speed( ctx, NULL, k, e, sign, 500 );
+     vrf[idx] = aktool_test_sign_verify_speed( ctx, &pctx, k, e, sign, 250 );
+  }
+  ak_libakrypt_set_option( "use_fixed_size_montgomery", fixed );
+  ak_libakrypt_set_cpu_level(( cpu_level_t ) level );
+  ak_verifykey_destroy( &pctx );
+  ak_random_destroy( &generator );
+
+  if(( vrf[0] == 0 ) || ( vrf[1] == 0 )) {
+    aktool_error(_("incorrect verification of digital signature"));
+    return EXIT_FAILURE;
+  }
+  printf(_("curve: %s sign: %10f -> %10f sgn/sec. (x%.2f), "
+                                                   "verify: %10f -> %10f vrf/sec. (x%.2f)\n"),
+          curve->name[0], sgn[0], sgn[1], sgn[1]/sgn[0], vrf[0], vrf[1], vrf[1]/vrf[0] );
+ return EXIT_SUCCESS;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_test_speed_sign_function( int index, ak_oid oid )
 {
@@ -859,6 +920,20 @@
     curve = ak_oid_findnext_by_mode( curve, wcurve_params );
   }
 
+ /* второй тест - сравнение реализаций арифметики Монтгомери */
+  printf(_("montgomery arithmetic: generic loops -> fixed size implementation\n"));
+  curve = ak_oid_find_by_mode( wcurve_params );
+  while( curve != NULL ) {
+    ak_wcurve wc = ( ak_wcurve )curve->data;
+    if(( ctx->ctx.data.sctx.hsize >> 3 ) == wc->size ) {
+      ak_signkey_set_curve( ctx, wc );
+      ak_signkey_set_key_random( ctx, &generator );
+      if(( exit_status =
+               aktool_test_montgomery_for_one_curve( ctx, curve )) == EXIT_FAILURE ) goto labex;
+    }
+    curve = ak_oid_findnext_by_mode( curve, wcurve_params );
+  }
+
   labex:
     ak_random_destroy( &generator );
     ak_oid_delete_object( oid, ctx );
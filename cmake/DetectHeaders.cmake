@@ -234,6 +234,15 @@ check_c_source_compiles("
      return 0;
   }" AK_HAVE_BYTESWAP_H )
 
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <cpuid.h>
+  int main( void ) {
+     unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+     __get_cpuid( 1, &eax, &ebx, &ecx, &edx );
+     return 0;
+  }" AK_HAVE_CPUID_H )
+
 # -------------------------------------------------------------------------------------------------- #
 if( LIBAKRYPT_PTHREAD )
   check_c_source_compiles("
@@ -17,6 +17,23 @@ check_c_source_compiles("
 
 if( AK_HAVE_BUILTIN_MULQ_GCC )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MULQ_GCC" )
+# -------------------------------------------------------------------------------------------------- #
+# команды mulx (bmi2), adcx и adox (adx) используются в ассемблерных вставках, поэтому
+# проверяется только поддержка ассемблером; наличие команд у процессора определяется cpuid
+# -------------------------------------------------------------------------------------------------- #
+  check_c_source_compiles("
+    #include <sys/types.h>
+    int main( void ) {
+      u_int64_t w1, w0, u = 1, v = 2;
+      __asm__ volatile ( \"mulxq %2, %0, %1\" : \"=r\" (w0), \"=r\" (w1) : \"r\" (v), \"d\" (u) );
+      __asm__ volatile ( \"adcxq %1, %0\" : \"+r\" (w0) : \"r\" (w1) : \"cc\" );
+      __asm__ volatile ( \"adoxq %1, %0\" : \"+r\" (w1) : \"r\" (w0) : \"cc\" );
+      return ( int )( w0 + w1 );
+    }" AK_HAVE_BUILTIN_MULX_ADX )
+
+  if( AK_HAVE_BUILTIN_MULX_ADX )
+      set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MULX_ADX" )
+  endif()
 endif()
 
 # -------------------------------------------------------------------------------------------------- #
@@ -33,6 +50,29 @@ check_c_source_compiles("
 
 if( AK_HAVE_BUILTIN_CLMULEPI64 )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_CLMULEPI64" )
+else()
+# -------------------------------------------------------------------------------------------------- #
+# если инструкция pclmulqdq не разрешена флагами компилятора, проверяем возможность сборки
+# отдельных функций с атрибутом target; выбор реализации выполняется во время работы библиотеки
+# -------------------------------------------------------------------------------------------------- #
+  check_c_source_compiles("
+    #include <cpuid.h>
+    #include <wmmintrin.h>
+    __attribute__((target(\"pclmul,sse2\")))
+     static void mul( __m128i *c, __m128i *a, __m128i *b ) {
+       *c = _mm_clmulepi64_si128( *a, *b, 0x00 );
+    }
+    int main( void ) {
+     unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+     __m128i a, b, c;
+     __get_cpuid( 1, &eax, &ebx, &ecx, &edx );
+     if( ecx&bit_PCLMUL ) mul( &c, &a, &b );
+    return 0;
+   }" AK_HAVE_TARGET_CLMULEPI64 )
+
+  if( AK_HAVE_TARGET_CLMULEPI64 )
+      set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_CLMULEPI64 -DAK_HAVE_TARGET_CLMULEPI64" )
+  endif()
 endif()
 
 # -------------------------------------------------------------------------------------------------- #
@@ -53,3 +93,37 @@ check_c_source_compiles("
 if( AK_HAVE_BUILTIN_MM256_SLL )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MM256_SLL" )
 endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <emmintrin.h>
+  int main( void ) {
+
+   __m128i a = _mm_set1_epi16( 1 ), b = _mm_set1_epi16( 2 );
+   a = _mm_xor_si128( _mm_mulhi_epu16( a, b ), _mm_slli_si128( b, 2 ));
+
+  return _mm_cvtsi128_si32( a );
+ }" AK_HAVE_BUILTIN_XOR_SI128 )
+
+if( AK_HAVE_BUILTIN_XOR_SI128 )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_XOR_SI128" )
+else()
+ # флаги компилятора не разрешают sse2 (например, 32-х битная сборка),
+ # однако функции могут быть собраны с атрибутом target и вызваны после проверки cpuid
+  check_c_source_compiles("
+    #include <emmintrin.h>
+    __attribute__((target(\"sse2\")))
+     static int sum( void ) {
+       __m128i a = _mm_set1_epi16( 1 ), b = _mm_set1_epi16( 2 );
+       a = _mm_xor_si128( _mm_mulhi_epu16( a, b ), _mm_slli_si128( b, 2 ));
+      return _mm_cvtsi128_si32( a );
+    }
+    int main( void ) {
+    return sum();
+   }" AK_HAVE_TARGET_XOR_SI128 )
+
+  if( AK_HAVE_TARGET_XOR_SI128 )
+      set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_XOR_SI128 -DAK_HAVE_TARGET_XOR_SI128" )
+  endif()
+endif()
@@ -33,6 +33,20 @@ if( AK_TESTS_GMP )
   endif()
 endif()
 
+# -------------------------------------------------------------------------------------------------- #
+# поиск liburing (асинхронное чтение файлов в Linux)
+if( AK_LIBURING )
+  find_library( LIBAKRYPT_URING uring )
+  find_file( LIBAKRYPT_URING_H liburing.h )
+  if( LIBAKRYPT_URING AND LIBAKRYPT_URING_H )
+    message( STATUS "Searching liburing - done ")
+    set( LIBAKRYPT_LIBS ${LIBAKRYPT_LIBS} uring )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_LIBURING_H" )
+  else()
+    message( WARNING "liburing or liburing.h not found")
+  endif()
+endif()
+
 # -------------------------------------------------------------------------------------------------- #
 # ищем реализацию сокетов для Windows
 if( WIN32 )
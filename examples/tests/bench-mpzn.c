@@ -0,0 +1,315 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  измерение скорости арифметических операций с вычетами и операций с точками эллиптических       */
+/*  кривых, а также выработки ключей, выработки и проверки электронной подписи                     */
+/*                                                                                                 */
+/*  для каждой операции выводится среднее время (в наносекундах) и среднее количество тактов       */
+/*  процессора (только для x86); при сборке с опцией AK_TESTS_GMP функции ak_mpzn_xxx()            */
+/*  сравниваются с аналогичными функциями библиотеки libgmp                                        */
+/*                                                                                                 */
+/*  результат выводится в формате csv в стандартный поток вывода или в файл,                       */
+/*  имя которого передается первым аргументом командной строки                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+ #if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ))
+  #include <x86intrin.h>
+  #define AK_BENCH_HAVE_RDTSC
+ #endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/* количество повторов для быстрых операций, возведения в степень и операций с ключами */
+ #define fast_count  (200000)
+ #define pow_count     (1000)
+ #define sign_count     (200)
+
+/* ----------------------------------------------------------------------------------------------- */
+/* счетчик времени и тактов процессора */
+ typedef struct bench_timer {
+  double ns;
+  ak_uint64 cycles;
+ } *ak_bench_timer;
+
+ static FILE *out = NULL;
+
+/* ----------------------------------------------------------------------------------------------- */
+ static double bench_now( void )
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if( clock_gettime( CLOCK_MONOTONIC, &ts ) == 0 ) return 1.0e9*(double)ts.tv_sec + (double)ts.tv_nsec;
+#endif
+ return 1.0e9*(double)clock()/(double)CLOCKS_PER_SEC;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 bench_cycles( void )
+{
+#ifdef AK_BENCH_HAVE_RDTSC
+ return ( ak_uint64 ) __rdtsc();
+#else
+ return 0;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void bench_start( ak_bench_timer tm )
+{
+  tm->cycles = bench_cycles();
+  tm->ns = bench_now();
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* завершение измерения и вывод строки с результатами */
+ static void bench_stop( ak_bench_timer tm, const char *group, const char *operation,
+                         const char *backend, const char *curve, size_t size, size_t count )
+{
+  double ns = bench_now() - tm->ns;
+  ak_uint64 cycles = bench_cycles() - tm->cycles;
+
+  fprintf( out, "%s,%s,%s,%s,%u,%u,%.1f,%.1f\n", group, operation, backend, curve,
+                       (unsigned int)( 64*size ), (unsigned int) count, ns/(double) count,
+                                                              (double) cycles/(double) count );
+  fflush( out );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                 арифметика вычетов ak_mpzn_xxx()                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void mpzn_bench( ak_wcurve wc, ak_random generator )
+{
+  size_t i = 0, size = wc->size;
+  struct bench_timer tm;
+  ak_mpznmax x, y, z, k;
+  ak_uint64 w[2*ak_mpzn512_size];
+  const char *name = ak_oid_find_by_data( wc )->name[0];
+
+  ak_mpzn_set_random_modulo( x, wc->p, size, generator );
+  ak_mpzn_set_random_modulo( y, wc->p, size, generator );
+  ak_mpzn_set_random_modulo( k, wc->q, size, generator );
+
+  bench_start( &tm );
+  for( i = 0; i < fast_count; i++ ) ak_mpzn_add( z, x, y, size );
+  bench_stop( &tm, "mpzn", "add", "mpzn", name, size, fast_count );
+
+  bench_start( &tm );
+  for( i = 0; i < fast_count; i++ ) ak_mpzn_sub( z, x, y, size );
+  bench_stop( &tm, "mpzn", "sub", "mpzn", name, size, fast_count );
+
+  bench_start( &tm );
+  for( i = 0; i < fast_count; i++ ) ak_mpzn_mul( w, x, y, size );
+  bench_stop( &tm, "mpzn", "mul", "mpzn", name, size, fast_count );
+
+  bench_start( &tm );
+  for( i = 0; i < fast_count; i++ ) ak_mpzn_rem( z, x, wc->p, size );
+  bench_stop( &tm, "mpzn", "rem", "mpzn", name, size, fast_count );
+
+  bench_start( &tm );
+  for( i = 0; i < fast_count; i++ ) ak_mpzn_mul_montgomery( z, x, y, wc->p, wc->n, size );
+  bench_stop( &tm, "mpzn", "modmul", "mpzn", name, size, fast_count );
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count; i++ ) ak_mpzn_modpow_montgomery( z, x, k, wc->p, wc->n, size );
+  bench_stop( &tm, "mpzn", "modpow", "mpzn", name, size, pow_count );
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count; i++ ) ak_mpzn_inverse_montgomery( z, x, wc->p, wc->n, wc->r2, size );
+  bench_stop( &tm, "mpzn", "inverse", "mpzn", name, size, pow_count );
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count; i++ )
+     ak_mpzn_inverse_montgomery_vartime( z, x, wc->p, wc->n, wc->r2, size );
+  bench_stop( &tm, "mpzn", "inverse_vartime", "mpzn", name, size, pow_count );
+
+#ifdef AK_HAVE_GMP_H
+ /* аналогичные операции библиотеки libgmp: сложение, умножение и деление выполняются
+    функциями mpn_xxx(), возведение в степень и обращение функциями mpz_xxx() */
+ {
+  mpz_t xm, ym, zm, km, pm;
+  mpz_init( xm ); mpz_init( ym ); mpz_init( zm ); mpz_init( km ); mpz_init( pm );
+  ak_mpzn_to_mpz( x, size, xm );
+  ak_mpzn_to_mpz( y, size, ym );
+  ak_mpzn_to_mpz( k, size, km );
+  ak_mpzn_to_mpz( wc->p, size, pm );
+
+ #if GMP_LIMB_BITS == 64
+  {
+   mp_limb_t *xl = ( mp_limb_t *) x, *yl = ( mp_limb_t *) y, *zl = ( mp_limb_t *) z,
+             *pl = ( mp_limb_t *) wc->p, *wl = ( mp_limb_t *) w, q[ak_mpzn512_size+1];
+
+   bench_start( &tm );
+   for( i = 0; i < fast_count; i++ ) mpn_add_n( zl, xl, yl, ( mp_size_t ) size );
+   bench_stop( &tm, "mpzn", "add", "gmp", name, size, fast_count );
+
+   bench_start( &tm );
+   for( i = 0; i < fast_count; i++ ) mpn_sub_n( zl, xl, yl, ( mp_size_t ) size );
+   bench_stop( &tm, "mpzn", "sub", "gmp", name, size, fast_count );
+
+   bench_start( &tm );
+   for( i = 0; i < fast_count; i++ ) mpn_mul_n( wl, xl, yl, ( mp_size_t ) size );
+   bench_stop( &tm, "mpzn", "mul", "gmp", name, size, fast_count );
+
+   bench_start( &tm );
+   for( i = 0; i < fast_count; i++ )
+      mpn_tdiv_qr( q, zl, 0, xl, ( mp_size_t ) size, pl, ( mp_size_t ) size );
+   bench_stop( &tm, "mpzn", "rem", "gmp", name, size, fast_count );
+
+  /* модульное умножение: произведение с последующим делением с остатком */
+   bench_start( &tm );
+   for( i = 0; i < fast_count; i++ ) {
+      mpn_mul_n( wl, xl, yl, ( mp_size_t ) size );
+      mpn_tdiv_qr( q, zl, 0, wl, 2*( mp_size_t ) size, pl, ( mp_size_t ) size );
+   }
+   bench_stop( &tm, "mpzn", "modmul", "gmp", name, size, fast_count );
+  }
+ #endif
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count; i++ ) mpz_powm( zm, xm, km, pm );
+  bench_stop( &tm, "mpzn", "modpow", "gmp", name, size, pow_count );
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count; i++ ) mpz_invert( zm, xm, pm );
+  bench_stop( &tm, "mpzn", "inverse_vartime", "gmp", name, size, pow_count );
+
+  mpz_clear( xm ); mpz_clear( ym ); mpz_clear( zm ); mpz_clear( km ); mpz_clear( pm );
+ }
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                 операции с точками кривой                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void wpoint_bench( ak_wcurve wc, const char *backend, ak_random generator )
+{
+  size_t i = 0, size = wc->size;
+  struct bench_timer tm;
+  struct wpoint p, q, r;
+  ak_mpznmax k, l;
+  const char *name = ak_oid_find_by_data( wc )->name[0];
+
+  ak_mpzn_set_random_modulo( k, wc->q, size, generator );
+  ak_mpzn_set_random_modulo( l, wc->q, size, generator );
+  ak_wpoint_pow_base( &q, l, size, wc );
+  ak_wpoint_reduce( &q, wc );
+
+  if( strcmp( backend, "weierstrass" ) == 0 ) {
+    ak_wpoint_set( &p, wc );
+    bench_start( &tm );
+    for( i = 0; i < fast_count/10; i++ ) ak_wpoint_double( &p, wc );
+    bench_stop( &tm, "curve", "double", backend, name, size, fast_count/10 );
+
+    bench_start( &tm );
+    for( i = 0; i < fast_count/10; i++ ) ak_wpoint_add( &p, &q, wc );
+    bench_stop( &tm, "curve", "add", backend, name, size, fast_count/10 );
+  } else {
+     struct epoint ep, eq;
+     ak_ecurve ed = ak_wcurve_get_ecurve( wc );
+
+     ak_epoint_set_wpoint( &ep, &wc->point, ed );
+     ak_epoint_set_wpoint( &eq, &q, ed );
+     bench_start( &tm );
+     for( i = 0; i < fast_count/10; i++ ) ak_epoint_double( &ep, ed );
+     bench_stop( &tm, "curve", "double", backend, name, size, fast_count/10 );
+
+     bench_start( &tm );
+     for( i = 0; i < fast_count/10; i++ ) ak_epoint_add( &ep, &eq, ed );
+     bench_stop( &tm, "curve", "add", backend, name, size, fast_count/10 );
+    }
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count/10; i++ ) ak_wpoint_pow( &r, &q, k, size, wc );
+  bench_stop( &tm, "curve", "pow", backend, name, size, pow_count/10 );
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count/10; i++ ) ak_wpoint_pow_base( &r, k, size, wc );
+  bench_stop( &tm, "curve", "pow_base", backend, name, size, pow_count/10 );
+
+  bench_start( &tm );
+  for( i = 0; i < pow_count/10; i++ ) ak_wpoint_pow2( &r, &wc->point, k, &q, l, size, wc );
+  bench_stop( &tm, "curve", "pow2", backend, name, size, pow_count/10 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                        выработка ключей, выработка и проверка подписи                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void sign_bench( ak_wcurve wc, const char *backend, ak_random generator )
+{
+  size_t i = 0, size = wc->size, hsize = 8*wc->size;
+  struct bench_timer tm;
+  struct signkey sk;
+  struct verifykey pk;
+  ak_uint8 hash[64], sign[128];
+  const char *name = ak_oid_find_by_data( wc )->name[0];
+
+  if( size == ak_mpzn256_size ) ak_signkey_create_streebog256( &sk );
+   else ak_signkey_create_streebog512( &sk );
+  ak_signkey_set_curve( &sk, wc );
+  ak_random_ptr( generator, hash, hsize );
+
+  bench_start( &tm );
+  for( i = 0; i < sign_count; i++ ) {
+     ak_signkey_set_key_random( &sk, generator );
+     ak_verifykey_create_from_signkey( &pk, &sk );
+     ak_verifykey_destroy( &pk );
+  }
+  bench_stop( &tm, "sign", "keygen", backend, name, size, sign_count );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+
+  bench_start( &tm );
+  for( i = 0; i < sign_count; i++ )
+     ak_signkey_sign_hash( &sk, generator, hash, hsize, sign, sizeof( sign ));
+  bench_stop( &tm, "sign", "sign", backend, name, size, sign_count );
+
+  bench_start( &tm );
+  for( i = 0; i < sign_count; i++ ) ak_verifykey_verify_hash( &pk, hash, hsize, sign );
+  bench_stop( &tm, "sign", "verify", backend, name, size, sign_count );
+
+  ak_verifykey_destroy( &pk );
+  ak_signkey_destroy( &sk );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( int argc, char *argv[] )
+{
+  ak_oid oid = NULL;
+  struct random generator;
+  ak_int64 edwards = 0;
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  if( argc > 1 ) {
+    if(( out = fopen( argv[1], "w" )) == NULL ) {
+      fprintf( stderr, "cannot open %s\n", argv[1] );
+      ak_libakrypt_destroy();
+      return EXIT_FAILURE;
+    }
+  } else out = stdout;
+  ak_random_create_lcg( &generator );
+  edwards = ak_libakrypt_get_option_by_name( "use_twisted_edwards" );
+
+  fprintf( out, "group,operation,backend,curve,bits,iterations,ns_per_op,cycles_per_op\n" );
+  mpzn_bench(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA, &generator );
+  mpzn_bench(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA, &generator );
+
+ /* для кривых, имеющих эквивалентную форму Эдвардса, измерения проводятся дважды */
+  oid = ak_oid_find_by_mode( wcurve_params );
+  do{
+     ak_libakrypt_set_option( "use_twisted_edwards", 0 );
+     wpoint_bench( oid->data, "weierstrass", &generator );
+     sign_bench( oid->data, "weierstrass", &generator );
+
+     ak_libakrypt_set_option( "use_twisted_edwards", 1 );
+     if( ak_wcurve_get_ecurve( oid->data ) != NULL ) {
+       wpoint_bench( oid->data, "edwards", &generator );
+       sign_bench( oid->data, "edwards", &generator );
+     }
+  } while(( oid = ak_oid_findnext_by_mode( oid, wcurve_params )) != NULL );
+  ak_libakrypt_set_option( "use_twisted_edwards", edwards );
+
+  ak_random_destroy( &generator );
+  if( out != stdout ) fclose( out );
+  ak_libakrypt_destroy();
+ return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест пакетной выработки ключей абонентов схемы Блома                                           */
+/*                                                                                                 */
+/*  ключи, выработанные функциями ak_blomkey_create_abonent_key() и                                */
+/*  ak_blomkey_create_abonent_keys(), сравниваются с результатом вычисления многочлена по схеме    */
+/*  Горнера; ключи, сохраненные функцией ak_blomkey_export_abonent_keys_to_files_with_password(),  */
+/*  импортируются и сравниваются с ключами, выработанными в памяти; ключи парной связи,            */
+/*  выработанные функцией ak_blomkey_create_pairwise_keys_as_ptr(), сравниваются с результатами    */
+/*  функции ak_blomkey_create_pairwise_key_as_ptr()                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* максимальная длина идентификатора и имени файла */
+ #define id_size    (32)
+ #define name_size (128)
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вычисление ключа абонента по схеме Горнера (так, как это определено в описании схемы) */
+ static void horner_abonent_key( ak_blomkey master, char *id, ak_uint8 *out )
+{
+  struct hash ctx;
+  ak_uint8 value[64];
+  ak_int32 column = 0;
+  ak_uint32 i = 0, row = 0;
+
+  ak_hash_create_oid( &ctx, master->ctx.oid );
+  ak_hash_ptr( &ctx, id, strlen( id ), value, master->count );
+  ak_hash_destroy( &ctx );
+
+  for( row = 0; row < master->size; row++ ) {
+     ak_uint8 *sum = out + row*master->count;
+     memset( sum, 0, master->count );
+     for( column = master->size - 1; column >= 0; column-- ) {
+        ak_uint8 *key = ak_blomkey_get_element_by_index( master, row, column );
+        if( master->count == ak_galois256_size ) ak_gf256_mul( sum, sum, value );
+         else ak_gf512_mul( sum, sum, value );
+        for( i = 0; i < master->count; i++ ) sum[i] ^= key[i];
+     }
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* выработка ключей парной связи абонента с номером 0 со всеми абонентами */
+ static int pairwise_test( ak_blomkey keys, ak_pointer *ids, size_t *idsizes, const size_t abonents )
+{
+  size_t i = 0, count = keys[0].count;
+  clock_t time_single, time_batch;
+  ak_uint8 *single = malloc( abonents*count ), *batch = malloc( abonents*count ), other[64];
+  int result = EXIT_FAILURE;
+
+  time_single = clock();
+  for( i = 0; i < abonents; i++ ) {
+     if( ak_blomkey_create_pairwise_key_as_ptr( keys, ids[i], idsizes[i],
+                                                   single +i*count, count ) != ak_error_ok ) {
+       printf("creation of pairwise key [Wrong]\n");
+       goto labex;
+     }
+  }
+  time_single = clock() - time_single;
+
+  time_batch = clock();
+  if( ak_blomkey_create_pairwise_keys_as_ptr( keys, ids, idsizes, abonents,
+                                                      batch, abonents*count ) != ak_error_ok ) {
+    printf("batch creation of pairwise keys [Wrong]\n");
+    goto labex;
+  }
+  time_batch = clock() - time_batch;
+
+  for( i = 0; i < abonents; i++ ) {
+     if( !ak_ptr_is_equal( single +i*count, batch +i*count, count )) {
+       printf("batch pairwise key %u differs from single one [Wrong]\n", (unsigned int) i );
+       goto labex;
+     }
+    /* ключ, выработанный вторым абонентом, должен совпадать */
+     ak_blomkey_create_pairwise_key_as_ptr( keys +i, ids[0], idsizes[0], other, sizeof( other ));
+     if( !ak_ptr_is_equal( other, batch +i*count, count )) {
+       printf("pairwise key %u is not symmetric [Wrong]\n", (unsigned int) i );
+       goto labex;
+     }
+  }
+
+ /* недостаточный размер памяти должен приводить к ошибке длины */
+  if( ak_blomkey_create_pairwise_keys_as_ptr( keys, ids, idsizes, abonents,
+                                         batch, abonents*count -1 ) != ak_error_wrong_length ) {
+    printf("batch creation of pairwise keys with short buffer [Wrong]\n");
+    goto labex;
+  }
+  printf("%u pairwise keys [Ok] (single: %f sec, batch: %f sec)\n", (unsigned int) abonents,
+                                            (double) time_single / (double) CLOCKS_PER_SEC,
+                                             (double) time_batch / (double) CLOCKS_PER_SEC );
+  result = EXIT_SUCCESS;
+
+  labex:
+   free( batch ); free( single );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int batch_test( const ak_uint32 size, const ak_uint32 count, const size_t abonents,
+                                                            const size_t exported, size_t threads )
+{
+  size_t i = 0;
+  struct blomkey master, imported;
+  struct random generator;
+  clock_t time_single, time_batch;
+  ak_blomkey keys = malloc( abonents*sizeof( struct blomkey ));
+  ak_pointer *ids = malloc( abonents*sizeof( ak_pointer ));
+  size_t *idsizes = malloc( abonents*sizeof( size_t ));
+  char *names = malloc( abonents*id_size ), *files = malloc( exported*name_size );
+  ak_uint8 *reference = malloc( size*count );
+  int result = EXIT_FAILURE;
+
+  ak_libakrypt_set_option( "threads_count", threads );
+  ak_random_create_lcg( &generator );
+  if( ak_blomkey_create_matrix( &master, size, count, &generator ) != ak_error_ok ) {
+    printf("creation of master key [Wrong]\n");
+    goto labex;
+  }
+  for( i = 0; i < abonents; i++ ) {
+     ids[i] = names +i*id_size;
+     snprintf( ids[i], id_size, "abonent-%u", (unsigned int) i );
+     idsizes[i] = strlen( ids[i] );
+  }
+
+ /* последовательная выработка ключей */
+  time_single = clock();
+  for( i = 0; i < abonents; i++ ) {
+     if( ak_blomkey_create_abonent_key( keys +i, &master, ids[i], idsizes[i] ) != ak_error_ok ) {
+       printf("creation of abonent key [Wrong]\n");
+       goto labex1;
+     }
+  }
+  time_single = clock() - time_single;
+  for( i = 0; i < abonents; i++ ) {
+     horner_abonent_key( &master, ids[i], reference );
+     if( !ak_ptr_is_equal( keys[i].data, reference, size*count )) {
+       printf("abonent key %u differs from horner scheme [Wrong]\n", (unsigned int) i );
+       for( ; i < abonents; i++ ) ak_blomkey_destroy( keys +i );
+       goto labex1;
+     }
+     ak_blomkey_destroy( keys +i );
+  }
+
+ /* пакетная выработка ключей */
+  time_batch = clock();
+  if( ak_blomkey_create_abonent_keys( keys, &master, ids, idsizes, abonents ) != ak_error_ok ) {
+    printf("batch creation of abonent keys [Wrong]\n");
+    goto labex1;
+  }
+  time_batch = clock() - time_batch;
+  for( i = 0; i < abonents; i++ ) {
+     horner_abonent_key( &master, ids[i], reference );
+     if( !ak_ptr_is_equal( keys[i].data, reference, size*count )) {
+       printf("batch abonent key %u differs from horner scheme [Wrong]\n", (unsigned int) i );
+       goto labex2;
+     }
+  }
+  printf("size: %u, field: GF(2^%u), threads: %u, %u keys [Ok] (single: %f sec, batch: %f sec)\n",
+               size, count << 3, (unsigned int) threads, (unsigned int) abonents,
+                                            (double) time_single / (double) CLOCKS_PER_SEC,
+                                             (double) time_batch / (double) CLOCKS_PER_SEC );
+  if( pairwise_test( keys, ids, idsizes, abonents ) != EXIT_SUCCESS ) goto labex2;
+
+ /* экспорт ключей в файлы и их последующий импорт */
+  if( ak_blomkey_export_abonent_keys_to_files_with_password( &master, ids, idsizes, exported,
+                                             "hello", 5, files, name_size ) != ak_error_ok ) {
+    printf("batch export of abonent keys [Wrong]\n");
+    goto labex2;
+  }
+  for( i = 0; i < exported; i++ ) {
+     char *filename = files +i*name_size;
+     if( ak_blomkey_import_from_file_with_password( &imported, "hello", 5,
+                                                                  filename ) != ak_error_ok ) {
+       printf("import of abonent key from %s [Wrong]\n", filename );
+       goto labex2;
+     }
+     if(( imported.type != blom_abonent_key ) ||
+        !ak_ptr_is_equal( imported.data, keys[i].data, size*count )) {
+       printf("imported key %u differs from generated one [Wrong]\n", (unsigned int) i );
+       ak_blomkey_destroy( &imported );
+       goto labex2;
+     }
+     ak_blomkey_destroy( &imported );
+     remove( filename );
+  }
+  printf("export of %u keys [Ok]\n", (unsigned int) exported );
+  result = EXIT_SUCCESS;
+
+  labex2:
+   for( i = 0; i < abonents; i++ ) ak_blomkey_destroy( keys +i );
+  labex1:
+   ak_blomkey_destroy( &master );
+  labex:
+   ak_random_destroy( &generator );
+   free( reference ); free( files ); free( names ); free( idsizes ); free( ids ); free( keys );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  int result = EXIT_SUCCESS;
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+  if( batch_test( 256, ak_galois256_size, 50, 5, 1 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( batch_test( 256, ak_galois256_size, 50, 20, 4 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( batch_test( 128, ak_galois512_size, 37, 5, 3 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( batch_test( 5, ak_galois256_size, 3, 3, 2 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+  ak_libakrypt_set_option( "threads_count", 0 );
+  ak_libakrypt_destroy();
+ return result;
+}
@@ -4,6 +4,34 @@
  #include <string.h>
  #include <libakrypt.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/* сравниваем ak_bckey_cmac_multi() с последовательным вызовом ak_bckey_cmac() */
+ bool_t multi_test( ak_bckey bkey, ak_uint8 *data, size_t data_size )
+{
+  size_t i, count = 37, size[37];
+  ak_pointer in[37];
+  ak_uint8 out[37*16], imito[16];
+
+  for( i = 0; i < count; i++ ) {
+     size[i] = ( i*i*41 + i*7 )%1501; /* длины от 0 до 1500 октетов, в том числе кратные длине блока */
+     if( i == 9 ) size[i] = 64;
+     in[i] = data + ( i*131 )%( data_size - 1500 );
+     if( i == 5 ) { size[i] = 0; in[i] = NULL; } /* пустое сообщение без данных */
+  }
+  memset( out, 0, sizeof( out ));
+  if( ak_bckey_cmac_multi( bkey, count, in, size, out, bkey->bsize ) != ak_error_ok ) return ak_false;
+  for( i = 0; i < count; i++ ) {
+     ak_bckey_cmac( bkey, in[i], size[i], imito, bkey->bsize );
+     if( ak_ptr_is_equal_with_log( imito, out + i*bkey->bsize, bkey->bsize ) != ak_true ) {
+       printf("message %u of length %u [Wrong]\n", (unsigned int) i, (unsigned int) size[i] );
+       return ak_false;
+     }
+  }
+  printf("imito for %u messages [Ok] (ak_bckey_cmac_multi, openssl_compability = %d)\n",
+           (unsigned int) count, (int) ak_libakrypt_get_option_by_name( "openssl_compability" ));
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
@@ -85,6 +113,20 @@
     ak_bckey_destroy( &bkey );
     goto ex;
   }
+
+ /* M6. вычисляем имитовставки для нескольких независимых сообщений */
+  if( multi_test( &bkey, data, sizeof( data )) != ak_true ) {
+    ak_bckey_destroy( &bkey );
+    goto ex;
+  }
+ /* M7. то же, с порядком октетов, принятым в openssl */
+  ak_libakrypt_set_option( "openssl_compability", 1 );
+  if( multi_test( &bkey, data, sizeof( data )) != ak_true ) {
+    ak_libakrypt_set_option( "openssl_compability", 0 );
+    ak_bckey_destroy( &bkey );
+    goto ex;
+  }
+  ak_libakrypt_set_option( "openssl_compability", 0 );
   ak_bckey_destroy( &bkey );
 
  /* K1. создаем ключ и вычисляем первое значение имитовставки */
@@ -141,6 +183,20 @@
     ak_bckey_destroy( &bkey );
     goto ex;
   }
+
+ /* K6. вычисляем имитовставки для нескольких независимых сообщений */
+  if( multi_test( &bkey, data, sizeof( data )) != ak_true ) {
+    ak_bckey_destroy( &bkey );
+    goto ex;
+  }
+ /* K7. то же, с порядком октетов, принятым в openssl */
+  ak_libakrypt_set_option( "openssl_compability", 1 );
+  if( multi_test( &bkey, data, sizeof( data )) != ak_true ) {
+    ak_libakrypt_set_option( "openssl_compability", 0 );
+    ak_bckey_destroy( &bkey );
+    goto ex;
+  }
+  ak_libakrypt_set_option( "openssl_compability", 0 );
   ak_bckey_destroy( &bkey );
 
  /* завершаем тестирование */
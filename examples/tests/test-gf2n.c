@@ -26,9 +26,7 @@
 
  static ak_uint8 gamma[64] = { 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL };
 
-#ifdef AK_HAVE_BUILTIN_CLMULEPI64
  static ak_uint8 delta[64] = { 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL, 0x0LL };
-#endif
 
 /* функция тестирования */
  void gftest( void (func)( ak_pointer , ak_pointer , ak_pointer ),
@@ -46,6 +44,38 @@
     printf(" (%s, %f sec)\n", str, (double)time / (double)CLOCKS_PER_SEC );
 }
 
+/* сравнение суммы попарных произведений с результатом последовательных умножений */
+ bool_t sumtest( void (func)( ak_pointer , ak_pointer , ak_pointer ),
+                 void (sumfunc)( ak_pointer , ak_pointer , ak_pointer , size_t ),
+                                                                char *str, size_t n, size_t count )
+{
+  time_t time;
+  size_t i = 0, j = 0, size = n/8;
+  ak_uint8 a[64*32], b[64*32], t[64], value[64], sum[64];
+
+  for( i = 0; i < count*size; i++ ) {
+     a[i] = alpha[i%64]^( ak_uint8 )( 13*i );
+     b[i] = beta[i%64]^( ak_uint8 )( 7*i+1 );
+  }
+  memset( value, 0, sizeof( value ));
+  for( i = 0; i < count; i++ ) {
+     func( t, a +i*size, b +i*size );
+     for( j = 0; j < size; j++ ) value[j] ^= t[j];
+  }
+
+  time = clock();
+  for( i = 0; i < iteration_count/count; i++ ) {
+     memset( sum, 0, sizeof( sum ));
+     sumfunc( sum, a, b, count );
+  }
+  time = clock() - time;
+  printf(" GF(2^%u): sum of %u products (%s, %f sec) is ", (unsigned int)n, (unsigned int)count,
+                                                   str, (double)time / (double)CLOCKS_PER_SEC );
+  if( ak_ptr_is_equal( sum, value, size )) { printf("Ok\n"); return ak_true; }
+  printf("Wrong\n");
+ return ak_false;
+}
+
  int main( void )
 {
    ak_uint8 t64[8] =
@@ -64,53 +94,75 @@
        0x19, 0x12, 0xf4, 0xc2, 0x4e, 0x1d, 0x64, 0xfe, 0x62, 0xec, 0x44, 0xad, 0x48, 0xd8, 0xa4, 0x6b,
        0x7a, 0x9e, 0xf8, 0xe4, 0xab, 0x7f, 0x7b, 0x3b, 0x47, 0x95, 0x18, 0x3d, 0xf6, 0x73, 0x1c, 0x1e };
 
+   if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+   printf(" cpu dispatch level: %d (features: %04x)\n\n",
+                      (int) ak_libakrypt_get_cpu_level(), (unsigned int) ak_libakrypt_get_cpu_features( ));
 
    gftest( ak_gf64_mul_uint64, "ak_gf64_mul_uint64", 64, gamma );
- #ifdef AK_HAVE_BUILTIN_CLMULEPI64
-   gftest( ak_gf64_mul_pcmulqdq, "ak_gf64_mul_pcmulqdq", 64, delta );
+  /* реализация, выбранная библиотекой во время работы */
+   gftest( ak_gf64_mul, "ak_gf64_mul", 64, delta );
    printf(" dual test is ");
    if( ak_ptr_is_equal( gamma, delta, 8 )) printf("Ok\n");
      else { printf("Wrong\n"); return EXIT_FAILURE; }
- #endif
    printf(" const value test is ");
    if( ak_ptr_is_equal( gamma, t64, sizeof( t64 ))) printf("Ok\n\n");
      else { printf("Wrong\n\n"); return EXIT_FAILURE; }
 
 
    gftest( ak_gf128_mul_uint64, "ak_gf128_mul_uint64", 128, gamma );
- #ifdef AK_HAVE_BUILTIN_CLMULEPI64
-   gftest( ak_gf128_mul_pcmulqdq, "ak_gf128_mul_pcmulqdq", 128, delta );
+  /* реализация, выбранная библиотекой во время работы */
+   gftest( ak_gf128_mul, "ak_gf128_mul", 128, delta );
    printf(" dual test is ");
    if( ak_ptr_is_equal( gamma, delta, 16 )) printf("Ok\n");
      else { printf("Wrong\n"); return EXIT_FAILURE; }
- #endif
    printf(" const value test is ");
    if( ak_ptr_is_equal( gamma, t128, sizeof( t128 ))) printf("Ok\n\n");
      else { printf("Wrong\n\n"); return EXIT_FAILURE; }
 
 
    gftest( ak_gf256_mul_uint64, "ak_gf256_mul_uint64", 256, gamma );
- #ifdef AK_HAVE_BUILTIN_CLMULEPI64
-   gftest( ak_gf256_mul_pcmulqdq, "ak_gf256_mul_pcmulqdq", 256, delta );
+  /* реализация, выбранная библиотекой во время работы */
+   gftest( ak_gf256_mul, "ak_gf256_mul", 256, delta );
    printf(" dual test is ");
    if( ak_ptr_is_equal( gamma, delta, 32 )) printf("Ok\n");
      else { printf("Wrong\n"); return EXIT_FAILURE; }
- #endif
    printf(" const value test is ");
    if( ak_ptr_is_equal( gamma, t256, sizeof( t256 ))) printf("Ok\n\n");
      else { printf("Wrong\n\n"); return EXIT_FAILURE; }
 
 
    gftest( ak_gf512_mul_uint64, "", 512, gamma );
- #ifdef AK_HAVE_BUILTIN_CLMULEPI64
-   gftest( ak_gf512_mul_pcmulqdq, "", 512, delta );
+  /* реализация, выбранная библиотекой во время работы */
+   gftest( ak_gf512_mul, "ak_gf512_mul", 512, delta );
    printf(" dual test is ");
    if( ak_ptr_is_equal( gamma, delta, 64 )) printf("Ok\n");
      else { printf("Wrong\n"); return EXIT_FAILURE; }
- #endif
    printf(" const value test is ");
    if( ak_ptr_is_equal( gamma, t512, 64 )) printf("Ok\n\n");
      else { printf("Wrong\n\n"); return EXIT_FAILURE; }
 
- return EXIT_SUCCESS;
+  /* суммы попарных произведений с отложенным приведением */
+   if( !sumtest( ak_gf256_mul_uint64, ak_gf256_mul_sum, "ak_gf256_mul_sum", 256, 31 ))
+     return EXIT_FAILURE;
+   if( !sumtest( ak_gf512_mul_uint64, ak_gf512_mul_sum, "ak_gf512_mul_sum", 512, 31 ))
+     return EXIT_FAILURE;
+   if( !sumtest( ak_gf512_mul_uint64, ak_gf512_mul_sum_uint64, "ak_gf512_mul_sum_uint64", 512, 1 ))
+     return EXIT_FAILURE;
+   printf("\n");
+
+  /* принудительно выбираем переносимую реализацию */
+   ak_libakrypt_set_cpu_level( cpu_level_generic );
+   memset( delta, 0, sizeof( delta ));
+   gftest( ak_gf128_mul, "ak_gf128_mul, generic level", 128, delta );
+   printf(" forced level test is ");
+   if(( ak_libakrypt_get_cpu_level() == cpu_level_generic ) &&
+      ak_ptr_is_equal( delta, t128, sizeof( t128 ))) printf("Ok\n\n");
+     else { printf("Wrong\n\n"); return EXIT_FAILURE; }
+   if( !sumtest( ak_gf256_mul_uint64, ak_gf256_mul_sum, "ak_gf256_mul_sum, generic level", 256, 31 ))
+     return EXIT_FAILURE;
+   if( !sumtest( ak_gf512_mul_uint64, ak_gf512_mul_sum, "ak_gf512_mul_sum, generic level", 512, 31 ))
+     return EXIT_FAILURE;
+   ak_libakrypt_set_cpu_level( cpu_level_avx2 );
+
+ return ak_libakrypt_destroy();
 }
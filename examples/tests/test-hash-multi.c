@@ -0,0 +1,140 @@
+/* ----------------------------------------------------------------------------------------------- */
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/*  длины сообщений подобраны так, чтобы в одном пакете оказались как пустые и короткие
+    сообщения, так и сообщения из нескольких блоков, обработка которых в разных дорожках
+    заканчивается в разные моменты времени                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t sizes[11] = { 0, 1, 63, 64, 65, 127, 128, 1000, 4099, 129, 2048 };
+ #define messages_count ( sizeof( sizes )/sizeof( size_t ))
+
+/* ----------------------------------------------------------------------------------------------- */
+/*  сравнение результата функции ak_hash_multi() с последовательным вызовом ak_hash_ptr()          */
+/* ----------------------------------------------------------------------------------------------- */
+ static int multi_test( ak_hash hctx, ak_uint8 *data, const char *name )
+{
+    size_t i, count;
+    ak_pointer in[messages_count];
+    ak_uint8 out[64], mout[64*messages_count];
+    size_t hsize = ak_hash_get_tag_size( hctx );
+    int exit_code = EXIT_SUCCESS;
+
+   /* сообщения располагаются в памяти со смещениями, чтобы различалось их содержимое */
+    for( i = 0; i < messages_count; i++ ) in[i] = data +i;
+
+   /* проверяем пакеты различной длины, в том числе не кратные количеству дорожек */
+    for( count = 1; count <= messages_count; count++ ) {
+       memset( mout, 0, sizeof( mout ));
+       if( ak_hash_multi( hctx, count, in, sizes, mout, hsize ) != ak_error_ok ) {
+         printf("%s: ak_hash_multi() with %u messages failed\n", name, (unsigned int) count );
+         exit_code = EXIT_FAILURE;
+         continue;
+       }
+       for( i = 0; i < count; i++ ) {
+          memset( out, 0, sizeof( out ));
+          ak_hash_ptr( hctx, in[i], sizes[i], out, hsize );
+          if( !ak_ptr_is_equal_with_log( out, mout +i*hsize, hsize )) {
+            printf("%s: message %u (%u octets) in batch of %u is wrong\n", name,
+                        (unsigned int) i, (unsigned int) sizes[i], (unsigned int) count );
+            exit_code = EXIT_FAILURE;
+          }
+       }
+    }
+    if( exit_code == EXIT_SUCCESS ) printf("%s multi Ok\n", name );
+  return exit_code;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*  сравнение результата функции ak_hash_file_list() с последовательным вызовом ak_hash_file()     */
+/* ----------------------------------------------------------------------------------------------- */
+ static int file_list_test( ak_hash hctx, ak_uint8 *data, const char *name, size_t threads )
+{
+    size_t i;
+    struct file fs;
+    char filenames[messages_count][32];
+    const char *list[messages_count];
+    ak_uint8 out[64], mout[64*messages_count];
+    size_t hsize = ak_hash_get_tag_size( hctx );
+    int exit_code = EXIT_SUCCESS;
+
+    for( i = 0; i < messages_count; i++ ) {
+       snprintf( filenames[i], sizeof( filenames[i] ), "hash-multi-%02u.dat", (unsigned int) i );
+       list[i] = filenames[i];
+       if( ak_file_create_to_write( &fs, filenames[i] ) != ak_error_ok ) return EXIT_FAILURE;
+       if( sizes[i] ) ak_file_write( &fs, data +i, sizes[i] );
+       ak_file_close( &fs );
+    }
+
+    ak_libakrypt_set_option( "threads_count", (ak_int64) threads );
+    memset( mout, 0, sizeof( mout ));
+    if( ak_hash_file_list( hctx, list, messages_count,
+                                              mout, hsize ) != ak_error_ok ) {
+      printf("%s: ak_hash_file_list() with %u threads failed\n", name, (unsigned int) threads );
+      exit_code = EXIT_FAILURE;
+    }
+    for( i = 0; i < messages_count; i++ ) {
+       memset( out, 0, sizeof( out ));
+       ak_hash_file( hctx, list[i], out, hsize );
+       if( !ak_ptr_is_equal_with_log( out, mout +i*hsize, hsize )) {
+         printf("%s: file %s with %u threads is wrong\n", name, list[i], (unsigned int) threads );
+         exit_code = EXIT_FAILURE;
+       }
+      /* результат для файла должен совпадать с результатом для области памяти */
+       memset( out, 0, sizeof( out ));
+       ak_hash_ptr( hctx, data +i, sizes[i], out, hsize );
+       if( !ak_ptr_is_equal_with_log( out, mout +i*hsize, hsize )) {
+         printf("%s: file %s differs from memory\n", name, list[i] );
+         exit_code = EXIT_FAILURE;
+       }
+       remove( list[i] );
+    }
+    ak_libakrypt_set_option( "threads_count", 0 );
+
+    if( exit_code == EXIT_SUCCESS )
+      printf("%s file list (%u threads) Ok\n", name, (unsigned int) threads );
+  return exit_code;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+    size_t i, size = 8192;
+    struct hash hctx;
+    ak_uint8 *data = NULL;
+    int exit_code = EXIT_SUCCESS;
+
+    ak_log_set_level( ak_log_standard );
+    if( ak_libakrypt_create( ak_function_log_stderr ) != ak_true ) return EXIT_FAILURE;
+
+    if(( data = malloc( size )) == NULL ) {
+      ak_libakrypt_destroy();
+      return EXIT_FAILURE;
+    }
+    for( i = 0; i < size; i++ ) data[i] = (ak_uint8)( i*13 + 5 );
+
+   /* Стрибог256 */
+    ak_hash_create_streebog256( &hctx );
+    if( multi_test( &hctx, data, "streebog256" ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    if( file_list_test( &hctx, data, "streebog256", 1 ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    if( file_list_test( &hctx, data, "streebog256", 3 ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    ak_hash_destroy( &hctx );
+
+   /* Стрибог512 */
+    ak_hash_create_streebog512( &hctx );
+    if( multi_test( &hctx, data, "streebog512" ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    if( file_list_test( &hctx, data, "streebog512", 1 ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    if( file_list_test( &hctx, data, "streebog512", 4 ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    ak_hash_destroy( &hctx );
+
+    free( data );
+    ak_libakrypt_destroy();
+  return exit_code;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                              test-hash-multi.c  */
+/* ----------------------------------------------------------------------------------------------- */
@@ -17,11 +17,84 @@
       (unsigned long int)ak_hmac_get_tag_size( ctx ), ctx->key.oid->name[0], ctx->key.oid->id[0] );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* повторное использование одного ключа (сохраненные состояния ipad/opad) и смена ключа            */
+/* ----------------------------------------------------------------------------------------------- */
+ int repeat_test( ak_oid oid )
+{
+   size_t i, tsize;
+   ak_uint8 key1[32], key2[80], data[200], out1[64], out2[64], out3[64];
+   ak_hmac ctx = ak_oid_new_object( oid ), ctx2 = ak_oid_new_object( oid );
+   int result = EXIT_FAILURE;
+
+   for( i = 0; i < sizeof( key1 ); i++ ) key1[i] = (ak_uint8)( i+1 );
+   for( i = 0; i < sizeof( key2 ); i++ ) key2[i] = (ak_uint8)( 3*i+7 );
+   for( i = 0; i < sizeof( data ); i++ ) data[i] = (ak_uint8)( 11*i );
+   tsize = ak_hmac_get_tag_size( ctx );
+
+   ak_hmac_set_key( ctx, key1, sizeof( key1 ));
+   for( i = 0; i < 3; i++ ) { /* первое вычисление заполняет сохраненные состояния */
+      memset( out1, 0, sizeof( out1 ));
+      ak_hmac_ptr( ctx, data, sizeof( data ) - i*70, out1, sizeof( out1 ));
+      ak_hmac_set_key( ctx2, key1, sizeof( key1 ));
+      memset( out2, 0, sizeof( out2 ));
+      ak_hmac_ptr( ctx2, data, sizeof( data ) - i*70, out2, sizeof( out2 ));
+      if( !ak_ptr_is_equal_with_log( out1, out2, tsize )) goto labex;
+   }
+
+  /* после смены ключа должны использоваться новые состояния */
+   ak_hmac_set_key( ctx, key2, sizeof( key2 ));
+   memset( out3, 0, sizeof( out3 ));
+   ak_hmac_ptr( ctx, data, sizeof( data ), out3, sizeof( out3 ));
+   ak_hmac_set_key( ctx2, key2, sizeof( key2 ));
+   memset( out2, 0, sizeof( out2 ));
+   ak_hmac_ptr( ctx2, data, sizeof( data ), out2, sizeof( out2 ));
+   if( !ak_ptr_is_equal_with_log( out3, out2, tsize )) goto labex;
+
+   printf("%s: repeated usage of the key is Ok\n", oid->name[0] );
+   result = EXIT_SUCCESS;
+
+  labex:
+   ak_oid_delete_object( oid, ctx2 );
+   ak_oid_delete_object( oid, ctx );
+  return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* одновременная выработка ключей из нескольких паролей                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ int pbkdf2_multi_test( size_t threads )
+{
+   size_t i, j;
+   ak_uint8 data[9][100], out[9*48], out2[48];
+   ak_pointer pass[9], salt[9];
+   size_t pass_size[9], salt_size[9];
+
+   ak_libakrypt_set_option( "threads_count", threads );
+   for( i = 0; i < 9; i++ ) {
+      for( j = 0; j < sizeof( data[i] ); j++ ) data[i][j] = (ak_uint8)( 5*i+j );
+      pass[i] = data[i]; pass_size[i] = 1 + 11*i; /* пароли длиннее 64 октетов хешируются */
+      salt[i] = data[i]+7; salt_size[i] = 3*i;
+   }
+   if( ak_hmac_pbkdf2_streebog512_multi( 9, pass, pass_size,
+                                               salt, salt_size, 100, 48, out ) != ak_error_ok ) {
+     printf("pbkdf2: incorrect derivation of several keys\n");
+     return EXIT_FAILURE;
+   }
+   for( i = 0; i < 9; i++ ) {
+      ak_hmac_pbkdf2_streebog512( pass[i], pass_size[i], salt[i], salt_size[i], 100, 48, out2 );
+      if( !ak_ptr_is_equal_with_log( out +i*48, out2, 48 )) return EXIT_FAILURE;
+   }
+   printf("pbkdf2: derivation of several keys (%u threads) is Ok\n", (unsigned int) threads );
+  return EXIT_SUCCESS;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
   ak_oid oid;
   ak_pointer ptr;
+  int result = EXIT_SUCCESS;
 
   /* проверяем создание/удаление контекстов с алгоритмами hmac */
    function( ptr = ak_oid_new_object( oid = ak_oid_find_by_name( "nmac-streebog" )));
@@ -33,10 +106,19 @@
    function( ptr = ak_oid_new_object( oid = ak_oid_find_by_name( "hmac-streebog512" )));
    ak_oid_delete_object( oid, ptr );
 
+  /* проверяем повторное использование ключа */
+   if( repeat_test( ak_oid_find_by_name( "nmac-streebog" )) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+   if( repeat_test( ak_oid_find_by_name( "hmac-streebog256" )) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+   if( repeat_test( ak_oid_find_by_name( "hmac-streebog512" )) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+  /* проверяем выработку ключей из нескольких паролей */
+   if( pbkdf2_multi_test( 1 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+   if( pbkdf2_multi_test( 3 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
   /* проверяем выработку производной ключевой информации с исопльзованием указанных алгоритмов */
   // ak_skey_derive_key_to_ptr
 
- return EXIT_SUCCESS;
+ return result;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -0,0 +1,210 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест функций вычисления контрольных сумм ключевой информации                                   */
+/*                                                                                                 */
+/*  результаты функций ak_ptr_fletcher32() и ak_ptr_fletcher32_xor() сравниваются с побайтными     */
+/*  реализациями для данных различной длины и выравнивания; также измеряется время выработки       */
+/*  и проверки контрольных сумм для ключей различных типов                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* побайтная реализация модифицированного алгоритма Флетчера (с операцией xor) */
+ static ak_uint32 fletcher32_xor( const ak_uint8 *ptr, const size_t size )
+{
+  ak_uint32 out = 0, sB = 0;
+  size_t idx = 0, cnt = size ^( size&0x1 );
+
+  while( idx < cnt ) {
+    out ^= ( ptr[idx] | (ak_uint32)(ptr[idx+1] << 8));
+    sB = (( sB ^= out )&0x8000) ? (sB << 1)^0x8BB7 : (sB << 1);
+    idx+= 2;
+  }
+  if( idx != size ) {
+    out ^= ptr[idx];
+    sB = (( sB ^= out )&0x8000) ? (sB << 1)^0x8BB7 : (sB << 1);
+  }
+ return out^( sB << 16 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* пословная реализация алгоритма Флетчера */
+ static ak_uint32 fletcher32( const ak_uint8 *data, const size_t size )
+{
+  ak_uint32 c0 = 0, c1 = 0, w = 0;
+  size_t i, len = size >> 2, tail = size - ( len << 2 );
+
+  for( i = 0; i < len; i++ ) {
+     memcpy( &w, data +4*i, 4 );
+     c0 += w;
+     c1 += c0;
+  }
+  if( tail ) {
+    ak_uint32 idx = 0, c2 = 0;
+    while( tail-- ) {
+        c2 <<= 8;
+        c2 += data[(len << 2)+(idx++)];
+    }
+    c0 += c2;
+    c1 += c0;
+  }
+ return ( c1&0xffff ) << 16 | ( c0&0xffff );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int checksum_test( void )
+{
+  size_t size, offset;
+  ak_uint32 x = 0, y = 0, steps = 0;
+  ak_uint8 *data = malloc( 4200 );
+  int result = EXIT_SUCCESS;
+
+  for( size = 0; size < 4200; size++ ) data[size] = (ak_uint8)( size*size*31 + size*7 + 0xa5 );
+  for( size = 1; size < 4096; size += ( size < 300 ) ? 1 : 97 ) {
+     for( offset = 0; offset < 4; offset++ ) {
+        ak_ptr_fletcher32_xor( data +offset, size, &x );
+        if( x != fletcher32_xor( data +offset, size )) {
+          printf("fletcher32_xor: size %u, offset %u [Wrong]\n",
+                                                   (unsigned int) size, (unsigned int) offset );
+          result = EXIT_FAILURE;
+        }
+        ak_ptr_fletcher32( data +offset, size, &y );
+        if( y != fletcher32( data +offset, size )) {
+          printf("fletcher32: size %u, offset %u [Wrong]\n",
+                                                   (unsigned int) size, (unsigned int) offset );
+          result = EXIT_FAILURE;
+        }
+        steps++;
+     }
+  }
+  if( result == EXIT_SUCCESS ) printf("checksums: %u tests [Ok]\n", steps );
+  free( data );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* время выработки и проверки контрольной суммы ключа, при ошибке возвращается -1 */
+ double icode_time( ak_skey skey, size_t count )
+{
+  size_t i = 0;
+  clock_t time = clock();
+
+  for( i = 0; i < count; i++ ) {
+     skey->set_icode( skey );
+     if( !skey->check_icode( skey )) return -1.0;
+  }
+  time = clock() - time;
+ return (double) time / (double) CLOCKS_PER_SEC;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int icode_test( ak_skey skey, const char *name, size_t count, bool_t xor_icode )
+{
+  ak_uint32 x = 0;
+  double time = 0;
+
+ /* для ключей с контрольной суммой fletcher32_xor сверяем значение с побайтной реализацией */
+  if( xor_icode ) {
+    skey->set_icode( skey );
+    x = fletcher32_xor( skey->key, skey->key_size )^
+                                       fletcher32_xor( skey->key +skey->key_size, skey->key_size );
+    if( x != skey->icode ) {
+      printf("%s: icode value [Wrong]\n", name );
+      return EXIT_FAILURE;
+    }
+  }
+  if(( time = icode_time( skey, count )) < 0 ) {
+    printf("%s: icode check [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+  printf("%s: %u bytes key, %u set/check pairs [Ok] (%f sec)\n",
+                           name, (unsigned int) skey->key_size, (unsigned int) count, time );
+ return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int long_test( size_t size, size_t count )
+{
+  size_t i = 0;
+  ak_uint32 x = 0, y = 0;
+  clock_t time_ref, time_lib;
+  ak_uint8 *data = malloc( size );
+
+  for( i = 0; i < size; i++ ) data[i] = (ak_uint8)( i*17 + 3 );
+  time_ref = clock();
+  for( i = 0; i < count; i++ ) { data[0] = (ak_uint8)i; x ^= fletcher32_xor( data, size ); }
+  time_ref = clock() - time_ref;
+
+  time_lib = clock();
+  for( i = 0; i < count; i++ ) {
+     ak_uint32 z = 0;
+     data[0] = (ak_uint8)i; ak_ptr_fletcher32_xor( data, size, &z ); y ^= z;
+  }
+  time_lib = clock() - time_lib;
+  free( data );
+
+  if( x != y ) {
+    printf("fletcher32_xor: %u bytes [Wrong]\n", (unsigned int) size );
+    return EXIT_FAILURE;
+  }
+  printf("fletcher32_xor: %u bytes, %u times [Ok] (bytewise: %f sec, library: %f sec)\n",
+                                                   (unsigned int) size, (unsigned int) count,
+                                              (double) time_ref / (double) CLOCKS_PER_SEC,
+                                              (double) time_lib / (double) CLOCKS_PER_SEC );
+ return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  struct bckey kuznechik, magma;
+  struct hmac hmac;
+  struct random generator;
+  int result = EXIT_SUCCESS;
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* сравнение с побайтными реализациями для переносимой реализации и реализации,
+    выбранной по результатам опроса процессора */
+  ak_libakrypt_set_cpu_level( cpu_level_generic );
+  if( checksum_test() != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  ak_libakrypt_set_cpu_level( cpu_level_avx2 );
+  if( checksum_test() != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+ /* время вычисления контрольных сумм для различных типов ключей */
+  ak_random_create_lcg( &generator );
+
+  ak_bckey_create_kuznechik( &kuznechik );
+  ak_bckey_set_key_random( &kuznechik, &generator );
+  if( icode_test( &kuznechik.key, "kuznechik", 200000, ak_true ) != EXIT_SUCCESS )
+    result = EXIT_FAILURE;
+  ak_bckey_destroy( &kuznechik );
+
+  ak_bckey_create_magma( &magma );
+  ak_bckey_set_key_random( &magma, &generator );
+  if( icode_test( &magma.key, "magma", 200000, ak_false ) != EXIT_SUCCESS )
+    result = EXIT_FAILURE;
+  ak_bckey_destroy( &magma );
+
+  ak_hmac_create_streebog512( &hmac );
+  ak_hmac_set_key_random( &hmac, &generator );
+  if( icode_test( &hmac.key, "hmac-streebog512", 200000, ak_true ) != EXIT_SUCCESS )
+    result = EXIT_FAILURE;
+  ak_hmac_destroy( &hmac );
+
+  ak_hmac_create_nmac( &hmac );
+  ak_hmac_set_key_random( &hmac, &generator );
+  if( icode_test( &hmac.key, "nmac-streebog", 200000, ak_true ) != EXIT_SUCCESS )
+    result = EXIT_FAILURE;
+  ak_hmac_destroy( &hmac );
+
+ /* время вычисления контрольной суммы для больших фрагментов ключевой информации */
+  if( long_test( 4096, 20000 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
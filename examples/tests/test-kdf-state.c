@@ -51,6 +51,71 @@
   ak_kdf_state_destroy( &ks );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* контекст содержит секретный ключ, выравненный по границе 32 байт */
+#ifdef AK_HAVE_STDALIGN_H
+ #ifndef AK_HAVE_WINDOWS_H
+  #define states_malloc( size ) aligned_alloc( 32, size )
+ #endif
+#endif
+#ifndef states_malloc
+ #define states_malloc( size ) malloc( size )
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/* выработка ключевой информации для массива контекстов сравнивается
+   с последовательными вызовами функции ak_kdf_state_next() для каждого контекста                  */
+ int multi_test( kdf_t type, size_t count, size_t size )
+{
+  size_t i = 0;
+  ak_uint8 lseed[32];
+  int result = EXIT_FAILURE;
+  struct kdf_state *ks = states_malloc( 2*count*sizeof( struct kdf_state ));
+  ak_kdf_state *pks = malloc( count*sizeof( ak_kdf_state ));
+  ak_uint8 *out = malloc( 2*count*size ), *out2 = malloc( 2*count*size );
+
+  memcpy( lseed, seed, 32 );
+  for( i = 0; i < count; i++ ) {
+     lseed[0] = ( ak_uint8 )i;
+     if(( ak_kdf_state_create( ks +i, kin, 32, type,
+                                      label, 77, lseed, 32, iv, 64, 32768 ) != ak_error_ok ) ||
+        ( ak_kdf_state_create( ks +count +i, kin, 32, type,
+                                      label, 77, lseed, 32, iv, 64, 32768 ) != ak_error_ok )) {
+       printf("multi: incorrect creation of state %u\n", (unsigned int) i );
+       count = i; /* удаляем только созданные контексты */
+       goto labex;
+     }
+     pks[i] = ks +count +i;
+  }
+
+ /* два фрагмента подряд, чтобы проверить сцепление блоков */
+  for( i = 0; i < count; i++ ) {
+     ak_kdf_state_next( ks +i, out +i*size, size );
+     ak_kdf_state_next( ks +i, out +( count+i )*size, size );
+  }
+  if(( ak_kdf_state_next_multi( pks, count, out2, size ) != ak_error_ok ) ||
+     ( ak_kdf_state_next_multi( pks, count, out2 +count*size, size ) != ak_error_ok )) {
+    printf("multi: incorrect generation of key information\n");
+    goto labex;
+  }
+  if( !ak_ptr_is_equal_with_log( out, out2, 2*count*size )) {
+    printf("multi: 0x%02X, %u states, %u bytes [Wrong]\n",
+                                              type, (unsigned int) count, (unsigned int) size );
+    goto labex;
+  }
+  printf("multi: 0x%02X, %u states, %u bytes [Ok]\n",
+                                              type, (unsigned int) count, (unsigned int) size );
+  result = EXIT_SUCCESS;
+
+  labex:
+    for( i = 0; i < count; i++ ) {
+       ak_kdf_state_destroy( ks +i );
+       ak_kdf_state_destroy( ks +count +i );
+    }
+    free( out2 ); free( out ); free( pks ); free( ks );
+ return result;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
@@ -142,6 +207,16 @@
   if( strncmp( ptr, "7021e470615353420609e2236d253140b10c7309565f7790516c9202b1708b47ec1b80d5e8e260c18124", 42 ) != 0 )
     return EXIT_FAILURE;
 
+/* массивы контекстов */
+  printf("Multiple states:\n");
+  ak_libakrypt_set_option( "threads_count", 1 );
+  if( multi_test( xor_cmac_magma_kdf, 5, 42 ) != EXIT_SUCCESS ) return EXIT_FAILURE;
+  if( multi_test( xor_hmac256_kdf, 5, 42 ) != EXIT_SUCCESS ) return EXIT_FAILURE;
+  ak_libakrypt_set_option( "threads_count", 4 );
+  if( multi_test( xor_cmac_kuznechik_kdf, 33, 40 ) != EXIT_SUCCESS ) return EXIT_FAILURE;
+  if( multi_test( xor_hmac512_kdf, 33, 100 ) != EXIT_SUCCESS ) return EXIT_FAILURE;
+  if( multi_test( xor_nmac_kdf, 17, 64 ) != EXIT_SUCCESS ) return EXIT_FAILURE;
+
   ak_libakrypt_destroy();
  return EXIT_SUCCESS;
 }
@@ -2,6 +2,72 @@
  #include <stdlib.h>
  #include <libakrypt.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/*  сравнение результатов обработки файла, объем которого превышает размер буффера,
+    при всех способах потокового чтения (последовательное чтение, чтение с опережением,
+    отображение в память, io_uring)                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static int stream_test( void )
+{
+    struct file fs;
+    struct hash hctx;
+    struct bckey key;
+    int method = 0, exit_code = EXIT_SUCCESS;
+    size_t i, j, size = 3*65536 + 4321;
+    ak_int64 offsets[4] = { 0, 1, 65536, 70001 }, sizes[3] = { -1, 65536, 131079 };
+    ak_uint8 *data = malloc( size ), out[32], outf[32];
+
+    for( i = 0; i < size; i++ ) data[i] = (ak_uint8)( i*7 + 3 );
+    ak_file_create_to_write( &fs, "hello.stream" );
+    ak_file_write( &fs, data, size );
+    ak_file_close( &fs );
+
+   /* потоковое чтение используется для файлов любого объема */
+    ak_libakrypt_set_option( "file_stream_threshold", 0 );
+    ak_libakrypt_set_option( "file_stream_buffer_size", 65536 );
+
+    ak_hash_create_streebog256( &hctx );
+    ak_bckey_create_kuznechik( &key );
+    ak_bckey_set_key_from_password( &key, "password", 8, "salt", 4 );
+    for( method = 0; method < 4; method++ ) {
+       ak_libakrypt_set_option( "file_stream_method", method );
+       for( i = 0; i < 4; i++ ) {
+          for( j = 0; j < 3; j++ ) {
+             size_t len = ( sizes[j] < 0 ) ? size - (size_t)offsets[i] :
+                                       ak_min( (size_t)sizes[j], size - (size_t)offsets[i] );
+
+             ak_hash_ptr( &hctx, data +offsets[i], len, out, 32 );
+             ak_hash_file_offset( &hctx, "hello.stream", offsets[i], sizes[j], outf, 32 );
+             if( !ak_ptr_is_equal_with_log( out, outf, 32 )) {
+               printf("stream hash = %d, %d No (method %d)\n", (int) i, (int) j, method );
+               exit_code = EXIT_FAILURE;
+             }
+
+             memset( out, 0, sizeof( out ));
+             memset( outf, 0, sizeof( outf ));
+             ak_bckey_cmac( &key, data +offsets[i], len, out, key.bsize );
+             ak_bckey_cmac_file_offset( &key, "hello.stream", offsets[i], sizes[j], outf, key.bsize );
+             if( !ak_ptr_is_equal_with_log( out, outf, key.bsize )) {
+               printf("stream cmac = %d, %d No (method %d)\n", (int) i, (int) j, method );
+               exit_code = EXIT_FAILURE;
+             }
+          }
+       }
+    }
+    ak_bckey_destroy( &key );
+    ak_hash_destroy( &hctx );
+
+   /* возвращаем значения по-умолчанию */
+    ak_libakrypt_set_option( "file_stream_method", 1 );
+    ak_libakrypt_set_option( "file_stream_threshold", 1048576 );
+    ak_libakrypt_set_option( "file_stream_buffer_size", 1048576 );
+    free( data );
+
+    if( exit_code == EXIT_SUCCESS ) printf("stream Ok\n");
+     else printf("stream Wrong\n");
+  return exit_code;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
@@ -156,6 +222,9 @@
        goto labex;
      }
 
+   /* потоковая обработка больших файлов */
+    if( stream_test() != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+
     labex:
     ak_libakrypt_destroy();
 
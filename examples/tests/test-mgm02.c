@@ -0,0 +1,134 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест сравнивает результаты режима MGM при обработке данных одним вызовом (в этом случае
+    128-битный шифр обрабатывает данные пачками блоков с однократным приведением суммы
+    произведений) и при поблочной обработке тех же данных последовательными вызовами
+    функций обновления; проверяются зашифрование, расшифрование и выработка имитовставки
+    для всех длин данных от 1 до 9 блоков с неполным последним блоком
+
+    test-mgm02.c                                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+ #define max_length  ( 10*16 -1 )
+
+ static ak_uint8 ekey[32] = {
+     0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4, 0xf3, 0xf2, 0xf1, 0xf0,
+     0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+
+ static ak_uint8 akey[32] = {
+     0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+     0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88 };
+
+ static ak_uint8 iv[16] = {
+     0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 };
+
+/* ----------------------------------------------------------------------------------------------- */
+/* обработка данных: если step равен нулю, то данные передаются одним вызовом,
+   иначе - фрагментами длины step октетов; mode: 0 - зашифрование, 1 - расшифрование,
+   2 - только выработка имитовставки */
+ static int process( ak_aead ctx, int mode, ak_uint8 *adata, size_t asize,
+                   ak_uint8 *in, ak_uint8 *out, size_t size, size_t step, ak_uint8 *tag )
+{
+  int error = ak_error_ok;
+  size_t offset = 0, len = 0;
+
+  if(( error = ak_aead_clean( ctx, iv, ( size_t ) ak_aead_get_iv_size( ctx ))) != ak_error_ok )
+    return error;
+
+  for( offset = 0; offset < asize; offset += len ) {
+     len = step ? ak_min( step, asize - offset ) : asize;
+     if(( error = ak_aead_auth_update( ctx, adata +offset, len )) != ak_error_ok ) return error;
+  }
+  for( offset = 0; offset < size; offset += len ) {
+     len = step ? ak_min( step, size - offset ) : size;
+     switch( mode ) {
+       case 0: error = ak_aead_encrypt_update( ctx, in +offset, out +offset, len ); break;
+       case 1: error = ak_aead_decrypt_update( ctx, in +offset, out +offset, len ); break;
+       default: error = ak_aead_auth_update( ctx, in +offset, len ); break;
+     }
+     if( error != ak_error_ok ) return error;
+  }
+ return ak_aead_finalize( ctx, tag, ( size_t ) ak_aead_get_tag_size( ctx ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int compare_test( ak_aead ctx, const char *name )
+{
+  size_t size = 0, bsize = ( size_t ) ak_aead_get_block_size( ctx ),
+                   tsize = ( size_t ) ak_aead_get_tag_size( ctx );
+  ak_uint8 adata[max_length], plain[max_length], out1[max_length], out2[max_length],
+           back[max_length], tag1[16], tag2[16];
+  int exit_code = EXIT_SUCCESS;
+
+  for( size = 0; size < max_length; size++ ) {
+     adata[size] = ( ak_uint8 )( 3*size + 1 );
+     plain[size] = ( ak_uint8 )( 7*size + 5 );
+  }
+  ak_aead_set_keys( ctx, ekey, 32, akey, 32 );
+
+  for( size = 1; size <= max_length; size++ ) {
+    /* зашифрование */
+     memset( out1, 0, sizeof( out1 )); memset( out2, 0, sizeof( out2 ));
+     if(( process( ctx, 0, adata, size, plain, out1, size, 0, tag1 ) != ak_error_ok ) ||
+        ( process( ctx, 0, adata, size, plain, out2, size, bsize, tag2 ) != ak_error_ok ) ||
+        ( memcmp( out1, out2, size ) != 0 ) || ( memcmp( tag1, tag2, tsize ) != 0 )) {
+       printf("%s: encryption of %u octets [Wrong]\n", name, (unsigned int) size );
+       exit_code = EXIT_FAILURE;
+       continue;
+     }
+    /* расшифрование */
+     memset( back, 0, sizeof( back ));
+     if(( process( ctx, 1, adata, size, out1, back, size, 0, tag2 ) != ak_error_ok ) ||
+        ( memcmp( back, plain, size ) != 0 ) || ( memcmp( tag1, tag2, tsize ) != 0 )) {
+       printf("%s: decryption of %u octets [Wrong]\n", name, (unsigned int) size );
+       exit_code = EXIT_FAILURE;
+     }
+     memset( back, 0, sizeof( back ));
+     if(( process( ctx, 1, adata, size, out1, back, size, bsize, tag2 ) != ak_error_ok ) ||
+        ( memcmp( back, plain, size ) != 0 ) || ( memcmp( tag1, tag2, tsize ) != 0 )) {
+       printf("%s: blockwise decryption of %u octets [Wrong]\n", name, (unsigned int) size );
+       exit_code = EXIT_FAILURE;
+     }
+    /* выработка имитовставки без шифрования */
+     if(( process( ctx, 2, NULL, 0, plain, NULL, size, 0, tag1 ) != ak_error_ok ) ||
+        ( process( ctx, 2, NULL, 0, plain, NULL, size, bsize, tag2 ) != ak_error_ok ) ||
+        ( memcmp( tag1, tag2, tsize ) != 0 )) {
+       printf("%s: authentication of %u octets [Wrong]\n", name, (unsigned int) size );
+       exit_code = EXIT_FAILURE;
+     }
+  }
+  if( exit_code == EXIT_SUCCESS )
+    printf("%s: lengths from 1 to %u octets [Ok]\n", name, (unsigned int) max_length );
+ return exit_code;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  struct aead ctx;
+  int exit_code = EXIT_SUCCESS;
+
+  ak_log_set_level( ak_log_standard );
+  if( ak_libakrypt_create( ak_function_log_stderr ) != ak_true ) return EXIT_FAILURE;
+
+  if( ak_aead_create_mgm_kuznechik( &ctx, ak_true ) == ak_error_ok ) {
+    if( compare_test( &ctx, "mgm-kuznechik" ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    ak_aead_destroy( &ctx );
+  } else exit_code = EXIT_FAILURE;
+
+  if( ak_aead_create_mgm_magma( &ctx, ak_true ) == ak_error_ok ) {
+    if( compare_test( &ctx, "mgm-magma" ) != EXIT_SUCCESS ) exit_code = EXIT_FAILURE;
+    ak_aead_destroy( &ctx );
+  } else exit_code = EXIT_FAILURE;
+
+  ak_libakrypt_destroy();
+ return exit_code;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                 test-mgm02.c    */
+/* ----------------------------------------------------------------------------------------------- */
@@ -0,0 +1,304 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест выработки электронной подписи с использованием пула вычисленных заранее пар (k, r)        */
+/*                                                                                                 */
+/*  подписи, выработанные с использованием пула, проверяются функцией ak_verifykey_verify_hash();  */
+/*  проверяется, что каждая пара используется только один раз, и сравнивается время выработки      */
+/*  подписи с пулом и без него; также проверяется пополнение пула в фоновом режиме, то, что        */
+/*  пары не используются после смены эллиптической кривой, и то, что дочерний процесс              */
+/*  не использует пары, унаследованные от родительского процесса                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+#ifdef AK_HAVE_UNISTD_H
+ #ifndef AK_HAVE_WINDOWS_H
+  #include <unistd.h>
+  #include <sys/wait.h>
+  #define TEST_FORK
+ #endif
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/* выработка count подписей (время выработки помещается в time) и их последующая проверка;
+   значения r сохраняются в массиве rs */
+ static bool_t sign_values( ak_signkey sk, ak_verifykey pk, ak_random generator,
+                                                   size_t count, ak_uint8 *rs, clock_t *time )
+{
+  size_t i = 0, hsize = sk->ctx.data.sctx.hsize;
+  ak_uint8 *hashes = malloc( count*hsize ), *signs = malloc( 2*count*hsize );
+  bool_t result = ak_false;
+  clock_t start;
+
+  ak_random_ptr( generator, hashes, count*hsize );
+  start = clock();
+  for( i = 0; i < count; i++ )
+     if( ak_signkey_sign_hash( sk, generator, hashes +i*hsize, hsize,
+                                               signs +2*i*hsize, 2*hsize ) != ak_error_ok ) goto labex;
+  if( time != NULL ) *time = clock() - start;
+  for( i = 0; i < count; i++ ) {
+     if( !ak_verifykey_verify_hash( pk, hashes +i*hsize, hsize, signs +2*i*hsize )) goto labex;
+     if( rs != NULL ) memcpy( rs +i*hsize, signs +( 2*i+1 )*hsize, hsize );
+  }
+  result = ak_true;
+
+  labex:
+   free( signs ); free( hashes );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int pool_test( ak_wcurve wc, ak_random generator, size_t count )
+{
+  size_t i = 0, j = 0, hsize = 8*wc->size;
+  struct signkey sk;
+  struct verifykey pk;
+  clock_t time_fill, time_pool, time_plain;
+  ak_uint8 *rs = malloc( count*hsize );
+  const char *name = ak_oid_find_by_data( wc )->name[0];
+  int result = EXIT_FAILURE;
+
+  if( wc->size == ak_mpzn256_size ) ak_signkey_create_streebog256( &sk );
+   else ak_signkey_create_streebog512( &sk );
+  ak_signkey_set_curve( &sk, wc );
+  ak_signkey_set_key_random( &sk, generator );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+
+ /* заполняем пул в два приема: количество пар не может превысить размер пула */
+  if( ak_signkey_create_pool( &sk, count ) != ak_error_ok ) goto labex;
+  time_fill = clock();
+  ak_signkey_fill_pool( &sk, generator, count/2 );
+  if( ak_signkey_get_pool_count( &sk ) != count/2 ) {
+    printf("%s: count of pairs after fill [Wrong]\n", name );
+    goto labex;
+  }
+  ak_signkey_fill_pool( &sk, generator, 0 );
+  time_fill = clock() - time_fill;
+  if( ak_signkey_get_pool_count( &sk ) != count ) {
+    printf("%s: count of pairs after full fill [Wrong]\n", name );
+    goto labex;
+  }
+
+ /* вырабатываем подписи, используя все пары из пула */
+  if( !sign_values( &sk, &pk, generator, count, rs, &time_pool )) {
+    printf("%s: signature with pool [Wrong]\n", name );
+    goto labex;
+  }
+  if( ak_signkey_get_pool_count( &sk ) != 0 ) {
+    printf("%s: count of pairs after signing [Wrong]\n", name );
+    goto labex;
+  }
+  for( i = 0; i < count; i++ )
+     for( j = i+1; j < count; j++ )
+        if( memcmp( rs +i*hsize, rs +j*hsize, hsize ) == 0 ) {
+          printf("%s: pair is used twice [Wrong]\n", name );
+          goto labex;
+        }
+
+ /* пул пуст, подписи вырабатываются обычным образом */
+  if( !sign_values( &sk, &pk, generator, count, NULL, &time_plain )) {
+    printf("%s: signature with empty pool [Wrong]\n", name );
+    goto labex;
+  }
+
+  printf("%s: %u signatures [Ok] (fill: %f sec, sign with pool: %f sec, without pool: %f sec)\n",
+                                                       name, (unsigned int) count,
+                                              (double) time_fill / (double) CLOCKS_PER_SEC,
+                                              (double) time_pool / (double) CLOCKS_PER_SEC,
+                                             (double) time_plain / (double) CLOCKS_PER_SEC );
+  result = EXIT_SUCCESS;
+
+  labex:
+   ak_verifykey_destroy( &pk );
+   ak_signkey_destroy( &sk );
+   free( rs );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* пополнение пула в фоновом режиме */
+ int refill_test( ak_random generator, size_t count )
+{
+  size_t i = 0;
+  struct signkey sk;
+  struct verifykey pk;
+  struct random refill;
+  struct timespec delay = { 0, 1000000 };
+  int error = ak_error_ok, result = EXIT_FAILURE;
+
+  ak_signkey_create_streebog256( &sk );
+  ak_signkey_set_key_random( &sk, generator );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+  ak_random_create_lcg( &refill );
+  ak_signkey_create_pool( &sk, count );
+
+  if(( error = ak_signkey_start_pool_refill( &sk, &refill, count/2 )) != ak_error_ok ) {
+    if( error == ak_error_undefined_function ) {
+      printf("refill: library was compiled without threads [Skipped]\n");
+      result = EXIT_SUCCESS;
+    } else printf("refill: start of thread [Wrong]\n");
+    goto labex;
+  }
+ /* ждем, пока количество пар не достигнет порогового значения, и вырабатываем подписи пачками;
+    после каждой пачки поток пополняет пул */
+  for( i = 0; i < 4; i++ ) {
+     while( ak_signkey_get_pool_count( &sk ) < count/2 ) nanosleep( &delay, NULL );
+     if( !sign_values( &sk, &pk, generator, count/2 + i, NULL, NULL )) {
+       printf("refill: signature with pool [Wrong]\n");
+       goto labex;
+     }
+  }
+  while( ak_signkey_get_pool_count( &sk ) < count/2 ) nanosleep( &delay, NULL );
+  printf("refill: %u bursts of signatures [Ok]\n", (unsigned int) i );
+  result = EXIT_SUCCESS;
+
+  labex:
+   ak_verifykey_destroy( &pk );
+   ak_signkey_destroy( &sk ); /* поток завершается при уничтожении ключа */
+   ak_random_destroy( &refill );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* пары, вычисленные для одной кривой, не должны использоваться после смены кривой того же размера */
+ int curve_test( ak_random generator, size_t count )
+{
+  struct signkey sk;
+  struct verifykey pk;
+  ak_wcurve wa = ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+            wb = ( ak_wcurve ) &id_rfc4357_gost_3410_2001_paramSetB;
+  int result = EXIT_FAILURE;
+
+  ak_signkey_create_streebog256( &sk );
+  ak_signkey_set_curve( &sk, wa );
+  ak_signkey_create_pool( &sk, count );
+  ak_signkey_fill_pool( &sk, generator, 0 );
+
+ /* смена кривой функцией ak_signkey_set_curve() уничтожает пул */
+  ak_signkey_set_curve( &sk, wb );
+  ak_signkey_set_key_random( &sk, generator );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+  if( ak_signkey_get_pool_count( &sk ) != 0 ) {
+    printf("curve: pool is not destroyed after change of curve [Wrong]\n");
+    goto labex;
+  }
+  if( !sign_values( &sk, &pk, generator, 2, NULL, NULL )) {
+    printf("curve: signature after change of curve [Wrong]\n");
+    goto labex;
+  }
+  ak_verifykey_destroy( &pk );
+
+ /* то же для функции ak_signkey_set_curve_str() */
+  ak_signkey_set_curve( &sk, wa );
+  ak_signkey_create_pool( &sk, count );
+  ak_signkey_fill_pool( &sk, generator, 0 );
+  ak_signkey_set_curve_str( &sk, ak_oid_find_by_data( wb )->name[0] );
+  ak_signkey_set_key_random( &sk, generator );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+  if( ak_signkey_get_pool_count( &sk ) != 0 ) {
+    printf("curve: pool is not destroyed after change of curve by name [Wrong]\n");
+    goto labex;
+  }
+  if( !sign_values( &sk, &pk, generator, 2, NULL, NULL )) {
+    printf("curve: signature after change of curve by name [Wrong]\n");
+    goto labex;
+  }
+  ak_verifykey_destroy( &pk );
+
+ /* пул, вычисленный для другой кривой, не используется при выработке подписи */
+  ak_signkey_set_curve( &sk, wa );
+  ak_signkey_create_pool( &sk, count );
+  ak_signkey_fill_pool( &sk, generator, 0 );
+  sk.key.data = wb;
+  ak_signkey_set_key_random( &sk, generator );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+  if( !sign_values( &sk, &pk, generator, 2, NULL, NULL ) ||
+                                                 ( ak_signkey_get_pool_count( &sk ) != count )) {
+    printf("curve: signature with pool of other curve [Wrong]\n");
+    goto labex;
+  }
+  printf("curve: pool is not used after change of curve [Ok]\n");
+  result = EXIT_SUCCESS;
+
+  labex:
+   ak_verifykey_destroy( &pk );
+   ak_signkey_destroy( &sk );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* пул, унаследованный дочерним процессом, должен быть пуст */
+ int fork_test( ak_random generator, size_t count )
+{
+  struct signkey sk;
+  struct verifykey pk;
+  int result = EXIT_FAILURE;
+#ifdef TEST_FORK
+  pid_t pid;
+  int status = 0;
+#endif
+
+  ak_signkey_create_streebog256( &sk );
+  ak_signkey_set_key_random( &sk, generator );
+  ak_verifykey_create_from_signkey( &pk, &sk );
+  ak_signkey_create_pool( &sk, count );
+  ak_signkey_fill_pool( &sk, generator, 0 );
+
+#ifdef TEST_FORK
+  if(( pid = fork()) < 0 ) {
+    printf("fork: creation of child process [Wrong]\n");
+    goto labex;
+  }
+  if( pid == 0 ) { /* дочерний процесс */
+    struct random lcg;
+    bool_t ok = ( ak_signkey_get_pool_count( &sk ) == 0 );
+    ak_random_create_lcg( &lcg );
+    ok = ok && sign_values( &sk, &pk, &lcg, 2, NULL, NULL );
+    ak_random_destroy( &lcg );
+    _exit( ok ? EXIT_SUCCESS : EXIT_FAILURE );
+  }
+  if(( waitpid( pid, &status, 0 ) != pid ) || !WIFEXITED( status ) ||
+                                                       ( WEXITSTATUS( status ) != EXIT_SUCCESS )) {
+    printf("fork: child process uses inherited pool [Wrong]\n");
+    goto labex;
+  }
+  if( ak_signkey_get_pool_count( &sk ) != count ) {
+    printf("fork: count of pairs in parent process [Wrong]\n");
+    goto labex;
+  }
+  printf("fork: inherited pool is wiped in child process [Ok]\n");
+#else
+  printf("fork: function fork() is not available [Skipped]\n");
+#endif
+  result = EXIT_SUCCESS;
+
+#ifdef TEST_FORK
+  labex:
+#endif
+   ak_verifykey_destroy( &pk );
+   ak_signkey_destroy( &sk );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  struct random generator;
+  int result = EXIT_SUCCESS;
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_create_lcg( &generator );
+
+  if( pool_test(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+                                           &generator, 100 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( pool_test(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetB,
+                                            &generator, 50 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( refill_test( &generator, 32 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( curve_test( &generator, 8 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( fork_test( &generator, 8 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
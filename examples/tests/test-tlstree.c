@@ -0,0 +1,95 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест выработки производных ключей по алгоритму tlstree                                         */
+/*                                                                                                 */
+/*  последовательность ключей, выработанная функцией ak_tlstree_state_get_keys(), сравнивается     */
+/*  с результатом последовательных вызовов ak_tlstree_state_next(); также сравнивается время       */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint8 master[32] = {
+     0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+     0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88 };
+
+/* ----------------------------------------------------------------------------------------------- */
+ int sequence_test( kdf_t type, const char *name, ak_uint64 first, size_t count )
+{
+    size_t i = 0, b32 = ( type == kdf512 ) ? 64 : 32;
+    struct tlstree_state ctx;
+    clock_t time_next, time_batch;
+    ak_uint8 *keys = malloc( count*b32 ), *keys2 = malloc( count*b32 );
+    int result = EXIT_FAILURE;
+
+   /* последовательные вызовы функции next */
+    time_next = clock();
+    if( ak_tlstree_state_create( type, &ctx, master, 32,
+                                        first, tlstree_with_libakrypt_65536 ) != ak_error_ok ) {
+      printf("%s: incorrect creation of tlstree context\n", name );
+      goto labex;
+    }
+    for( i = 0; i < count; i++ ) {
+       memcpy( keys +i*b32, ak_tlstree_state_get_key( &ctx ), b32 );
+       ak_tlstree_state_next( &ctx );
+    }
+    ak_tlstree_state_destroy( &ctx );
+    time_next = clock() - time_next;
+
+   /* выработка последовательности ключей одним вызовом */
+    time_batch = clock();
+    if( ak_tlstree_state_create( type, &ctx, master, 32,
+                                            0, tlstree_with_libakrypt_65536 ) != ak_error_ok ) {
+      printf("%s: incorrect creation of tlstree context\n", name );
+      goto labex;
+    }
+    if( ak_tlstree_state_get_keys( &ctx, first, count, keys2, count*b32 ) != ak_error_ok ) {
+      printf("%s: incorrect creation of key sequence\n", name );
+      goto labex;
+    }
+    time_batch = clock() - time_batch;
+    if(( ctx.key_number != first + count - 1 ) ||
+       !ak_ptr_is_equal( ak_tlstree_state_get_key( &ctx ), keys +( count-1 )*b32, b32 )) {
+      printf("%s: wrong state of context after key sequence\n", name );
+      ak_tlstree_state_destroy( &ctx );
+      goto labex;
+    }
+    ak_tlstree_state_destroy( &ctx );
+
+    if( !ak_ptr_is_equal_with_log( keys, keys2, count*b32 )) {
+      printf("%s: %u keys [Wrong]\n", name, (unsigned int) count );
+      goto labex;
+    }
+    printf("%s: %u keys [Ok] (next: %f sec, sequence: %f sec)\n", name, (unsigned int) count,
+                                              (double) time_next / (double) CLOCKS_PER_SEC,
+                                              (double) time_batch / (double) CLOCKS_PER_SEC );
+    result = EXIT_SUCCESS;
+
+  labex:
+    free( keys2 ); free( keys );
+  return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+    int result = EXIT_SUCCESS;
+
+    if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+   /* контрольные примеры, произвольный доступ и последовательность ключей */
+    if( ak_libakrypt_test_tlstree() != ak_true ) {
+      printf("tlstree self test [Wrong]\n");
+      result = EXIT_FAILURE;
+    } else printf("tlstree self test [Ok]\n");
+
+   /* диапазоны пересекают границы групп из 256 и 4096 ключей */
+    if( sequence_test( kdf256, "kdf256", 3900, 1000 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+    if( sequence_test( kdf512, "kdf512", 4000, 300 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+    if( sequence_test( kdfnmac, "kdfnmac", 65500, 100 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+    ak_libakrypt_destroy();
+  return result;
+}
@@ -0,0 +1,110 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест пакетной проверки электронных подписей                                                    */
+/*                                                                                                 */
+/*  результаты функции ak_verifykey_verify_hash_batch() сравниваются с результатами                */
+/*  последовательных вызовов ak_verifykey_verify_hash() для подписей, выработанных несколькими     */
+/*  ключами на разных кривых (часть подписей намеренно искажается); также сравнивается время       */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* количество ключей: два на 256-ти битной кривой, один на 512-ти битной кривой и копия первого */
+ #define keys_count  (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+ int batch_test( ak_random generator, size_t count, size_t threads )
+{
+  size_t i = 0;
+  struct signkey sk[keys_count-1];
+  struct verifykey pk[keys_count];
+  struct verify_item *items = malloc( count*sizeof( struct verify_item ));
+  ak_uint8 *hashes = malloc( count*64 ), *signs = malloc( count*128 );
+  bool_t *results = malloc( count*sizeof( bool_t ));
+  clock_t time_single, time_batch;
+  int result = EXIT_FAILURE;
+
+  ak_signkey_create_streebog256( sk );
+  ak_signkey_set_curve( sk, ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA );
+  ak_signkey_create_streebog256( sk+1 );
+  ak_signkey_set_curve( sk+1, ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetB );
+  ak_signkey_create_streebog512( sk+2 );
+  ak_signkey_set_curve( sk+2, ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA );
+  for( i = 0; i < keys_count-1; i++ ) {
+     ak_signkey_set_key_random( sk+i, generator );
+     ak_verifykey_create_from_signkey( pk+i, sk+i );
+  }
+  ak_verifykey_create_from_signkey( pk+keys_count-1, sk ); /* второй контекст для того же ключа */
+
+ /* вырабатываем подписи и искажаем каждую седьмую */
+  ak_random_ptr( generator, hashes, count*64 );
+  for( i = 0; i < count; i++ ) {
+     size_t k = ( i*5 )%keys_count, s = ( k == keys_count-1 ) ? 0 : k;
+     items[i].key = pk+k;
+     items[i].hash = hashes +i*64;
+     items[i].hsize = 8*pk[k].wc->size;
+     items[i].sign = signs +i*128;
+     ak_signkey_sign_hash( sk+s, generator, items[i].hash, items[i].hsize, items[i].sign, 128 );
+     if( i%7 == 3 ) (( ak_uint8 *)items[i].sign)[i%( 2*items[i].hsize )] ^= 0x10;
+  }
+  items[1].hsize = 7; /* некорректная длина хеш-кода */
+
+ /* последовательная проверка */
+  time_single = clock();
+  for( i = 0; i < count; i++ ) {
+     bool_t res = ( items[i].hsize == 8*items[i].key->wc->size ) ?
+                     ak_verifykey_verify_hash( items[i].key, items[i].hash, items[i].hsize,
+                                                                      items[i].sign ) : ak_false;
+     if( res != (( i%7 != 3 ) && ( i != 1 ))) {
+       printf("signature %u: sequential verification [Wrong]\n", (unsigned int) i );
+       goto labex;
+     }
+  }
+  time_single = clock() - time_single;
+
+ /* пакетная проверка */
+  ak_libakrypt_set_option( "threads_count", threads );
+  time_batch = clock();
+  if( ak_verifykey_verify_hash_batch( items, count, results ) != ak_error_ok ) {
+    printf("incorrect batch verification\n");
+    goto labex;
+  }
+  time_batch = clock() - time_batch;
+  for( i = 0; i < count; i++ ) {
+     if( results[i] != (( i%7 != 3 ) && ( i != 1 ))) {
+       printf("signature %u: batch verification [Wrong]\n", (unsigned int) i );
+       goto labex;
+     }
+  }
+  printf("%u signatures, %u threads [Ok] (sequential: %f sec, batch: %f sec)\n",
+                                              (unsigned int) count, (unsigned int) threads,
+                                            (double) time_single / (double) CLOCKS_PER_SEC,
+                                             (double) time_batch / (double) CLOCKS_PER_SEC );
+  result = EXIT_SUCCESS;
+
+  labex:
+   for( i = 0; i < keys_count; i++ ) ak_verifykey_destroy( pk+i );
+   for( i = 0; i < keys_count-1; i++ ) ak_signkey_destroy( sk+i );
+   free( results ); free( signs ); free( hashes ); free( items );
+  return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  struct random generator;
+  int result = EXIT_SUCCESS;
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_create_lcg( &generator );
+
+  if( batch_test( &generator, 100, 1 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( batch_test( &generator, 300, 4 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
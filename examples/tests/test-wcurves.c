@@ -0,0 +1,483 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест вычисления кратных образующей точки эллиптической кривой                                  */
+/*                                                                                                 */
+/*  результат функции ak_wpoint_pow_base(), использующей таблицы кратных точек, сравнивается       */
+/*  с результатом функции ak_wpoint_pow() (лесенка Монтгомери) для всех известных кривых;          */
+/*  аналогично проверяется функция ak_wpoint_pow2(), вычисляющая сумму двух кратных точек;         */
+/*  результаты специализированных реализаций операций Монтгомери сравниваются с реализацией для     */
+/*  модулей произвольного размера; обратные вычеты, вычисляемые алгоритмами safegcd и бинарным      */
+/*  алгоритмом Евклида, сравниваются с возведением в степень; для кривых, допускающих              */
+/*  представление в искривленной форме Эдвардса, результаты вычислений на кривой Эдвардса          */
+/*  сравниваются с вычислениями на кривой в форме Вейерштрасса; также сравнивается время           */
+/*  выработки и проверки подписи                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t compare_pow( ak_wcurve wc, ak_uint64 *k )
+{
+  struct wpoint p, q1, q2;
+
+  ak_wpoint_set( &p, wc ); /* копия образующей точки */
+  ak_wpoint_pow( &q1, &p, k, wc->size, wc );
+  ak_wpoint_reduce( &q1, wc );
+  ak_wpoint_pow_base( &q2, k, wc->size, wc );
+  ak_wpoint_reduce( &q2, wc );
+
+  if( ak_mpzn_cmp( q1.x, q2.x, wc->size ) || ak_mpzn_cmp( q1.y, q2.y, wc->size ) ||
+                                                    ak_mpzn_cmp( q1.z, q2.z, wc->size )) {
+    printf("k = %s [Wrong]\n", ak_mpzn_to_hexstr( k, wc->size ));
+    return ak_false;
+  }
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t compare_pow2( ak_wcurve wc, ak_uint64 *k1, ak_wpoint p2, ak_uint64 *k2 )
+{
+  struct wpoint p, q1, q2, q3;
+
+  ak_wpoint_set( &p, wc );
+  ak_wpoint_pow( &q1, &p, k1, wc->size, wc );
+  ak_wpoint_pow( &q2, p2, k2, wc->size, wc );
+  ak_wpoint_add( &q1, &q2, wc );
+  ak_wpoint_reduce( &q1, wc );
+  ak_wpoint_pow2( &q2, NULL, k1, p2, k2, wc->size, wc );
+  ak_wpoint_reduce( &q2, wc );
+  ak_wpoint_pow2( &q3, &p, k1, p2, k2, wc->size, wc );
+  ak_wpoint_reduce( &q3, wc );
+
+  if( ak_mpzn_cmp( q1.x, q2.x, wc->size ) || ak_mpzn_cmp( q1.y, q2.y, wc->size ) ||
+      ak_mpzn_cmp( q1.z, q2.z, wc->size ) || ak_mpzn_cmp( q1.x, q3.x, wc->size ) ||
+      ak_mpzn_cmp( q1.y, q3.y, wc->size ) || ak_mpzn_cmp( q1.z, q3.z, wc->size )) {
+    printf("k1 = %s, ", ak_mpzn_to_hexstr( k1, wc->size ));
+    printf("k2 = %s [Wrong]\n", ak_mpzn_to_hexstr( k2, wc->size ));
+    return ak_false;
+  }
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int curve_test( ak_oid oid, ak_random generator )
+{
+  size_t i = 0;
+  ak_mpzn512 k, k2;
+  struct wpoint p2;
+  ak_wcurve wc = oid->data;
+  int result = EXIT_FAILURE;
+
+ /* граничные значения */
+  ak_mpzn_set_ui( k, wc->size, 0 );
+  if( !compare_pow( wc, k )) goto labex;
+  ak_mpzn_set_ui( k, wc->size, 1 );
+  if( !compare_pow( wc, k )) goto labex;
+  ak_mpzn_set_ui( k, wc->size, 2 );
+  if( !compare_pow( wc, k )) goto labex;
+  ak_mpzn_set( k, wc->q, wc->size );
+  if( !compare_pow( wc, k )) goto labex;
+  ak_mpzn_set_ui( k, wc->size, 1 );
+  ak_mpzn_sub( k, wc->q, k, wc->size );
+  if( !compare_pow( wc, k )) goto labex;
+  memset( k, 0xff, sizeof( ak_uint64 )*wc->size );
+  if( !compare_pow( wc, k )) goto labex;
+  k[0] ^= 1;
+  if( !compare_pow( wc, k )) goto labex;
+
+ /* случайные значения */
+  for( i = 0; i < 16; i++ ) {
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     if( !compare_pow( wc, k )) goto labex;
+  }
+
+ /* суммы кратных точек: совпадающие точки, взаимно уничтожающиеся слагаемые и случайные значения */
+  ak_wpoint_set( &p2, wc );
+  ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+  if( !compare_pow2( wc, k, &p2, k )) goto labex;
+  ak_mpzn_sub( k2, wc->q, k, wc->size );
+  if( !compare_pow2( wc, k, &p2, k2 )) goto labex;
+  ak_mpzn_set_ui( k2, wc->size, 0 );
+  if( !compare_pow2( wc, k, &p2, k2 )) goto labex;
+  ak_mpzn_set_ui( k2, wc->size, 1 );
+  ak_mpzn_sub( k2, wc->q, k2, wc->size );
+  if( !compare_pow2( wc, k2, &p2, k2 )) goto labex;
+  memset( k2, 0xff, sizeof( ak_uint64 )*wc->size );
+  if( !compare_pow2( wc, k2, &p2, k2 )) goto labex;
+  for( i = 0; i < 16; i++ ) {
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_wpoint_pow_base( &p2, k, wc->size, wc );
+     ak_wpoint_reduce( &p2, wc );
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_mpzn_set_random_modulo( k2, wc->q, wc->size, generator );
+     if( !compare_pow2( wc, k, &p2, k2 )) goto labex;
+  }
+  printf("%s: [Ok]\n", oid->name[0] );
+  result = EXIT_SUCCESS;
+
+  labex:
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int montgomery_test( ak_wcurve wc, ak_random generator, cpu_level_t level )
+{
+  size_t i = 0;
+  int result = EXIT_SUCCESS;
+  ak_mpzn512 x, y, z1, z2, a1, a2;
+
+  for( i = 0; i < 4096; i++ ) {
+     if( i < 2 ) { /* максимальные значения вычетов */
+       ak_mpzn_set_ui( x, wc->size, 1 );
+       ak_mpzn_sub( x, wc->p, x, wc->size );
+       if( i ) ak_mpzn_set( y, x, wc->size ); else ak_mpzn_set_ui( y, wc->size, 0 );
+     } else {
+         ak_mpzn_set_random_modulo( x, wc->p, wc->size, generator );
+         ak_mpzn_set_random_modulo( y, wc->p, wc->size, generator );
+       }
+     ak_libakrypt_set_option( "use_fixed_size_montgomery", 0 );
+     ak_libakrypt_set_cpu_level( level );
+     ak_mpzn_mul_montgomery( z1, x, y, wc->p, wc->n, wc->size );
+     ak_mpzn_add_montgomery( a1, x, y, wc->p, wc->size );
+
+     ak_libakrypt_set_option( "use_fixed_size_montgomery", 1 );
+     ak_libakrypt_set_cpu_level( level );
+     ak_mpzn_mul_montgomery( z2, x, y, wc->p, wc->n, wc->size );
+     ak_mpzn_add_montgomery( a2, x, y, wc->p, wc->size );
+
+     if( ak_mpzn_cmp( z1, z2, wc->size ) || ak_mpzn_cmp( a1, a2, wc->size )) {
+       printf("x = %s, ", ak_mpzn_to_hexstr( x, wc->size ));
+       printf("y = %s [Wrong]\n", ak_mpzn_to_hexstr( y, wc->size ));
+       result = EXIT_FAILURE;
+       break;
+     }
+  }
+  if( result == EXIT_SUCCESS ) printf("%s: montgomery arithmetic, level %d [Ok]\n",
+                                               ak_oid_find_by_data( wc )->name[0], (int) level );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int inverse_test( ak_wcurve wc, bool_t order, ak_random generator, size_t count )
+{
+  size_t i = 0, size = wc->size;
+  ak_uint64 *m = order ? wc->q : wc->p, *r2 = order ? wc->r2q : wc->r2, n0 = order ? wc->nq : wc->n;
+  ak_uint64 *x = malloc( 4*count*size*sizeof( ak_uint64 )),
+            *z1 = x +count*size, *z2 = z1 +count*size, *z3 = z2 +count*size;
+  ak_mpzn512 u;
+  clock_t time_pow, time_ct, time_var;
+  int result = EXIT_SUCCESS;
+
+ /* граничные значения и случайные вычеты */
+  for( i = 0; i < count; i++ ) {
+     switch( i ) {
+       case 0: ak_mpzn_set_ui( x, size, 0 ); break;
+       case 1: ak_mpzn_set_ui( x +size, size, 1 ); break;
+       case 2: ak_mpzn_set_ui( x +2*size, size, 2 ); break;
+       case 3: ak_mpzn_set_ui( u, size, 1 ); ak_mpzn_sub( x +3*size, m, u, size ); break;
+       default: ak_mpzn_set_random_modulo( x +i*size, m, size, generator );
+     }
+  }
+  ak_mpzn_set_ui( u, size, 2 );
+  ak_mpzn_sub( u, m, u, size );
+
+  time_pow = clock();
+  for( i = 0; i < count; i++ )
+     ak_mpzn_modpow_montgomery( z1 +i*size, x +i*size, u, m, n0, size );
+  time_pow = clock() - time_pow;
+
+  time_ct = clock();
+  for( i = 0; i < count; i++ )
+     ak_mpzn_inverse_montgomery( z2 +i*size, x +i*size, m, n0, r2, size );
+  time_ct = clock() - time_ct;
+
+  time_var = clock();
+  for( i = 0; i < count; i++ )
+     ak_mpzn_inverse_montgomery_vartime( z3 +i*size, x +i*size, m, n0, r2, size );
+  time_var = clock() - time_var;
+
+  for( i = 0; i < count; i++ ) {
+     if( ak_mpzn_cmp( z1 +i*size, z2 +i*size, size ) ||
+                                              ak_mpzn_cmp( z1 +i*size, z3 +i*size, size )) {
+       printf("x = %s [Wrong]\n", ak_mpzn_to_hexstr( x +i*size, size ));
+       result = EXIT_FAILURE;
+       break;
+     }
+  }
+  if( result == EXIT_SUCCESS )
+    printf("%s: inverse mod %c, %u values [Ok] (modpow: %f sec, safegcd: %f sec, binary: %f sec)\n",
+               ak_oid_find_by_data( wc )->name[0], order ? 'q' : 'p', (unsigned int) count,
+                                              (double) time_pow / (double) CLOCKS_PER_SEC,
+                                              (double) time_ct / (double) CLOCKS_PER_SEC,
+                                              (double) time_var / (double) CLOCKS_PER_SEC );
+  free( x );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вычисление [k1]P, [k1]P + [k2]Q при выключенном (edwards = 0) или включенном использовании
+   кривой Эдвардса; результаты приводятся к аффинной форме и помещаются в массив r */
+ static void edwards_pow( ak_wcurve wc, int edwards, ak_uint64 *k1,
+                                                      ak_wpoint p2, ak_uint64 *k2, ak_wpoint r )
+{
+  struct wpoint p;
+
+  ak_libakrypt_set_option( "use_twisted_edwards", edwards );
+  ak_wpoint_set( &p, wc );
+  ak_wpoint_pow( r, &p, k1, wc->size, wc );
+  ak_wpoint_pow_base( r+1, k1, wc->size, wc );
+  ak_wpoint_pow2( r+2, NULL, k1, p2, k2, wc->size, wc );
+  ak_wpoint_pow2( r+3, &p, k1, p2, k2, wc->size, wc );
+  ak_wpoint_pow( r+4, p2, k2, wc->size, wc );
+  ak_wpoint_reduce( r, wc );
+  ak_wpoint_reduce( r+1, wc );
+  ak_wpoint_reduce( r+2, wc );
+  ak_wpoint_reduce( r+3, wc );
+  ak_wpoint_reduce( r+4, wc );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t compare_edwards( ak_wcurve wc, ak_uint64 *k1, ak_wpoint p2, ak_uint64 *k2 )
+{
+  size_t i = 0;
+  struct wpoint r1[5], r2[5];
+
+  edwards_pow( wc, 0, k1, p2, k2, r1 );
+  edwards_pow( wc, 1, k1, p2, k2, r2 );
+  for( i = 0; i < 5; i++ ) {
+     if( ak_mpzn_cmp( r1[i].x, r2[i].x, wc->size ) || ak_mpzn_cmp( r1[i].y, r2[i].y, wc->size ) ||
+         ak_mpzn_cmp( r1[i].z, r2[i].z, wc->size )) {
+       printf("k1 = %s, ", ak_mpzn_to_hexstr( k1, wc->size ));
+       printf("k2 = %s [Wrong, case %u]\n", ak_mpzn_to_hexstr( k2, wc->size ), (unsigned int) i );
+       return ak_false;
+     }
+  }
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* проверка отображения точек в кривую Эдвардса, операций с точками этой кривой и сравнение
+   кратных точек, вычисленных на кривой Эдвардса и на кривой в форме Вейерштрасса */
+ int edwards_test( ak_wcurve wc, ak_random generator )
+{
+  size_t i = 0;
+  ak_mpzn512 k, k2;
+  ak_mpznmax one = ak_mpznmax_one;
+  struct wpoint p, q, p2;
+  struct epoint ep, eq;
+  ak_ecurve ed = NULL;
+  const char *name = ak_oid_find_by_data( wc )->name[0];
+
+  ak_libakrypt_set_option( "use_twisted_edwards", 1 );
+  if(( ed = ak_wcurve_get_ecurve( wc )) == NULL ) {
+    printf("%s: twisted edwards curve not found [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+
+ /* образ образующей точки, удвоение и сложение точек */
+  ak_wpoint_set( &p, wc );
+  ak_epoint_set_wpoint( &ep, &p, ed );
+  if( !ak_epoint_is_ok( &ep, ed )) {
+    printf("%s: image of base point [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+  memcpy( &eq, &ep, sizeof( struct epoint ));
+  ak_epoint_add( &eq, &ep, ed );
+  ak_epoint_double( &ep, ed );
+  ak_wpoint_set_epoint( &p2, &ep, ed );
+  ak_wpoint_reduce( &p2, wc );
+  ak_wpoint_set_epoint( &q, &eq, ed );
+  ak_wpoint_reduce( &q, wc );
+  ak_wpoint_double( &p, wc );
+  ak_wpoint_reduce( &p, wc );
+  if( !ak_epoint_is_ok( &ep, ed ) || !ak_epoint_is_ok( &eq, ed ) ||
+      ak_mpzn_cmp( p.x, p2.x, wc->size ) || ak_mpzn_cmp( p.y, p2.y, wc->size ) ||
+      ak_mpzn_cmp( p.x, q.x, wc->size ) || ak_mpzn_cmp( p.y, q.y, wc->size )) {
+    printf("%s: doubling of base point [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+
+ /* нейтральный элемент и точка второго порядка (t, 0) */
+  ak_wpoint_set_as_unit( &p, wc );
+  ak_epoint_set_wpoint( &ep, &p, ed );
+  ak_wpoint_set_epoint( &q, &ep, ed );
+  if( !ak_epoint_is_ok( &ep, ed ) || !ak_mpzn_cmp_ui( q.z, wc->size, 0 )) {
+    printf("%s: unit point [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+  ak_mpzn_mul_montgomery( p.x, ed->t, one, wc->p, wc->n, wc->size );
+  ak_mpzn_set_ui( p.y, wc->size, 0 );
+  ak_mpzn_set_ui( p.z, wc->size, 1 );
+  ak_epoint_set_wpoint( &ep, &p, ed );
+  ak_wpoint_set_epoint( &q, &ep, ed );
+  ak_wpoint_reduce( &q, wc );
+  if( !ak_wpoint_is_ok( &p, wc ) || !ak_epoint_is_ok( &ep, ed ) ||
+      ak_mpzn_cmp( p.x, q.x, wc->size ) || !ak_mpzn_cmp_ui( q.y, wc->size, 0 )) {
+    printf("%s: point of order two [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+  memcpy( &eq, &ep, sizeof( struct epoint ));
+  ak_epoint_add( &eq, &ep, ed );
+  ak_wpoint_set_epoint( &q, &eq, ed );
+  if( !ak_mpzn_cmp_ui( q.z, wc->size, 0 )) {
+    printf("%s: sum of points of order two [Wrong]\n", name );
+    return EXIT_FAILURE;
+  }
+
+ /* граничные и случайные значения кратностей */
+  ak_wpoint_set( &p2, wc );
+  ak_mpzn_set_ui( k, wc->size, 0 );
+  ak_mpzn_set_ui( k2, wc->size, 1 );
+  if( !compare_edwards( wc, k, &p2, k2 )) return EXIT_FAILURE;
+  ak_mpzn_sub( k, wc->q, k2, wc->size );
+  if( !compare_edwards( wc, k, &p2, k2 )) return EXIT_FAILURE;
+  memset( k, 0xff, sizeof( ak_uint64 )*wc->size );
+  if( !compare_edwards( wc, k, &p2, k )) return EXIT_FAILURE;
+  for( i = 0; i < 16; i++ ) {
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_wpoint_pow_base( &p2, k, wc->size, wc );
+     ak_wpoint_reduce( &p2, wc );
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_mpzn_set_random_modulo( k2, wc->q, wc->size, generator );
+     if( !compare_edwards( wc, k, &p2, k2 )) return EXIT_FAILURE;
+  }
+  ak_libakrypt_set_option( "use_twisted_edwards", 1 );
+  printf("%s: twisted edwards curve [Ok]\n", name );
+ return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int sign_test( ak_wcurve wc, ak_random generator, size_t count )
+{
+  size_t i = 0;
+  ak_mpzn512 k, e;
+  struct wpoint p, q;
+  ak_uint8 sign[128], hash[64];
+  struct signkey sk;
+  struct verifykey pk;
+  clock_t time_ladder, time_table, time_sum, time_verify;
+  int result = EXIT_SUCCESS;
+
+  if( wc->size == ak_mpzn256_size ) ak_signkey_create_streebog256( &sk );
+   else ak_signkey_create_streebog512( &sk );
+  ak_signkey_set_curve( &sk, wc );
+  ak_signkey_set_key_random( &sk, generator );
+  ak_mpzn_set_random_modulo( e, wc->q, wc->size, generator );
+
+ /* время вычисления кратной точки с помощью лесенки Монтгомери */
+  ak_wpoint_set( &p, wc );
+  time_ladder = clock();
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_wpoint_pow( &q, &p, k, wc->size, wc );
+  }
+  time_ladder = clock() - time_ladder;
+
+ /* время выработки подписи */
+  time_table = clock();
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_signkey_sign_const_values( &sk, k, e, sign );
+  }
+  time_table = clock() - time_table;
+
+ /* время вычисления суммы кратных точек без использования функции ak_wpoint_pow2() */
+  ak_verifykey_create_from_signkey( &pk, &sk );
+  time_sum = clock();
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     ak_wpoint_pow_base( &p, k, wc->size, wc );
+     ak_wpoint_pow( &q, &pk.qpoint, k, wc->size, wc );
+     ak_wpoint_add( &p, &q, wc );
+  }
+  time_sum = clock() - time_sum;
+
+ /* время проверки подписи для одного и того же открытого ключа */
+  ak_random_ptr( generator, hash, sizeof( hash ));
+  ak_signkey_sign_hash( &sk, generator, hash, sizeof( ak_uint64 )*wc->size, sign, sizeof( sign ));
+  time_verify = clock();
+  for( i = 0; i < count; i++ ) {
+     if( !ak_verifykey_verify_hash( &pk, hash, sizeof( ak_uint64 )*wc->size, sign )) {
+       printf("%s: verification of signature [Wrong]\n", ak_oid_find_by_data( wc )->name[0] );
+       result = EXIT_FAILURE;
+       break;
+     }
+  }
+  time_verify = clock() - time_verify;
+  hash[0] ^= 0x1;
+  if( ak_verifykey_verify_hash( &pk, hash, sizeof( ak_uint64 )*wc->size, sign )) {
+    printf("%s: verification of wrong signature [Wrong]\n", ak_oid_find_by_data( wc )->name[0] );
+    result = EXIT_FAILURE;
+  }
+  ak_verifykey_destroy( &pk );
+  ak_signkey_destroy( &sk );
+
+  printf("%s: %u times (ladder: %f sec, sign with table: %f sec)\n",
+                                ak_oid_find_by_data( wc )->name[0], (unsigned int) count,
+                                         (double) time_ladder / (double) CLOCKS_PER_SEC,
+                                         (double) time_table / (double) CLOCKS_PER_SEC );
+  printf("%s: %u times (table and ladder: %f sec, verify with wnaf: %f sec)\n",
+                                ak_oid_find_by_data( wc )->name[0], (unsigned int) count,
+                                            (double) time_sum / (double) CLOCKS_PER_SEC,
+                                         (double) time_verify / (double) CLOCKS_PER_SEC );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  ak_oid oid = NULL;
+  struct random generator;
+  int result = EXIT_SUCCESS, level = 0;
+
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_create_lcg( &generator );
+
+ /* перебираем все известные кривые */
+  oid = ak_oid_find_by_mode( wcurve_params );
+  do {
+       if( curve_test( oid, &generator ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  } while(( oid = ak_oid_findnext_by_mode( oid, wcurve_params )) != NULL );
+
+ /* специализированные реализации операций Монтгомери для всех уровней реализации */
+  for( level = cpu_level_generic; level <= cpu_level_avx2; level++ ) {
+     oid = ak_oid_find_by_mode( wcurve_params );
+     do {
+          if( montgomery_test( oid->data, &generator, level ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+     } while(( oid = ak_oid_findnext_by_mode( oid, wcurve_params )) != NULL );
+  }
+  ak_libakrypt_set_cpu_level( cpu_level_avx2 );
+
+ /* вычисление обратных вычетов по модулям p и q */
+  oid = ak_oid_find_by_mode( wcurve_params );
+  do {
+       if( inverse_test( oid->data, ak_false, &generator, 1000 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+       if( inverse_test( oid->data, ak_true, &generator, 1000 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  } while(( oid = ak_oid_findnext_by_mode( oid, wcurve_params )) != NULL );
+
+ /* кривые, допускающие представление в искривленной форме Эдвардса */
+  if( edwards_test(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+                                                &generator ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( edwards_test(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetC,
+                                                &generator ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+ /* сравнение времени */
+  if( sign_test(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+                                           &generator, 100 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  if( sign_test(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA,
+                                            &generator, 50 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  for( level = 0; level <= 1; level++ ) {
+     printf("use_twisted_edwards = %d\n", level );
+     ak_libakrypt_set_option( "use_twisted_edwards", level );
+     if( sign_test(( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+                                           &generator, 100 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+     if( sign_test(( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetC,
+                                            &generator, 50 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+  }
+
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
@@ -0,0 +1,93 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  тест шифрования последовательности независимых секторов в режиме xts                         */
+/*                                                                                                 */
+/*  результат функции ak_bckey_encrypt_xts_sectors() сравнивается с результатом                    */
+/*  последовательного вызова функции ak_bckey_encrypt_xts() для каждого сектора                    */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint8 ekey[32] = {
+     0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+     0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88 };
+ static ak_uint8 akey[32] = {
+     0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+     0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+
+/* ----------------------------------------------------------------------------------------------- */
+ int sectors_test( ak_function_bckey_create *create, size_t count, size_t sector_size )
+{
+    size_t i = 0, size = count*sector_size;
+    struct bckey ekc, akc;
+    ak_uint64 sector = 0xfffffffffffffff0LL, number = 0;
+    ak_uint8 *data = malloc( size ), *out = malloc( size ), *out2 = malloc( size );
+    int result = EXIT_FAILURE;
+
+    create( &ekc ); ak_bckey_set_key( &ekc, ekey, 32 );
+    create( &akc ); ak_bckey_set_key( &akc, akey, 32 );
+    for( i = 0; i < size; i++ ) data[i] = (ak_uint8)( i*13 + 7 );
+
+   /* шифруем каждый сектор отдельно */
+    for( i = 0; i < count; i++ ) {
+       number = sector + i;
+      #ifdef AK_BIG_ENDIAN
+       number = bswap_64( number );
+      #endif
+       ak_bckey_encrypt_xts( &ekc, &akc, data +i*sector_size,
+                                     out +i*sector_size, sector_size, &number, sizeof( number ));
+    }
+   /* шифруем все сектора одним вызовом */
+    if( ak_bckey_encrypt_xts_sectors( &ekc, &akc,
+                                      data, out2, size, sector, sector_size ) != ak_error_ok ) {
+      printf("%s: wrong encryption of %u sectors\n", ekc.key.oid->name[0], (unsigned int) count );
+      goto labex;
+    }
+    if( !ak_ptr_is_equal_with_log( out, out2, size )) {
+      printf("%s: %u sectors of %u bytes [Wrong]\n",
+                          ekc.key.oid->name[0], (unsigned int) count, (unsigned int) sector_size );
+      goto labex;
+    }
+   /* расшифровываем на месте */
+    if( ak_bckey_decrypt_xts_sectors( &ekc, &akc,
+                                      out2, out2, size, sector, sector_size ) != ak_error_ok ) {
+      printf("%s: wrong decryption of %u sectors\n", ekc.key.oid->name[0], (unsigned int) count );
+      goto labex;
+    }
+    if( !ak_ptr_is_equal_with_log( data, out2, size )) {
+      printf("%s: decryption of %u sectors [Wrong]\n", ekc.key.oid->name[0], (unsigned int) count );
+      goto labex;
+    }
+    printf("%s: %u sectors of %u bytes [Ok]\n",
+                          ekc.key.oid->name[0], (unsigned int) count, (unsigned int) sector_size );
+    result = EXIT_SUCCESS;
+
+  labex:
+    ak_bckey_destroy( &akc );
+    ak_bckey_destroy( &ekc );
+    free( out2 ); free( out ); free( data );
+  return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+    int result = EXIT_SUCCESS;
+
+    if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+   /* однопоточная обработка */
+    ak_libakrypt_set_option( "threads_count", 1 );
+    if( sectors_test( ak_bckey_create_kuznechik, 7, 512 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+    if( sectors_test( ak_bckey_create_magma, 7, 520 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+   /* многопоточная обработка (при наличии поддержки потоков) */
+    ak_libakrypt_set_option( "threads_count", 4 );
+    if( sectors_test( ak_bckey_create_kuznechik, 131, 4096 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+    if( sectors_test( ak_bckey_create_magma, 67, 4096 ) != EXIT_SUCCESS ) result = EXIT_FAILURE;
+
+    ak_libakrypt_destroy();
+  return result;
+}
@@ -48,6 +48,45 @@
  static ak_uint8 iv128[16] = {
     0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 };
 
+/* ----------------------------------------------------------------------------------------------- */
+ int large_message_test( ak_bckey ekey, ak_bckey ikey )
+{
+  size_t i, asize = 65536*4 +7, size = 65536*5 +13;
+  ak_uint8 *adata = malloc( asize ), *data = malloc( size ),
+           *out = malloc( size ), *out2 = malloc( size ), icode[16], icode2[16];
+  int error = ak_error_not_equal_data;
+
+  for( i = 0; i < asize; i++ ) adata[i] = (ak_uint8)( i*7 + 1 );
+  for( i = 0; i < size; i++ ) data[i] = (ak_uint8)( i*13 + 5 );
+
+  ak_libakrypt_set_option( "threads_count", 1 );
+  ak_bckey_encrypt_xtsmac( ekey, ikey, adata, asize, data, out, size,
+                                                        iv128, sizeof( iv128 ), icode, 16 );
+  ak_libakrypt_set_option( "threads_count", 4 );
+  ak_bckey_encrypt_xtsmac( ekey, ikey, adata, asize, data, out2, size,
+                                                       iv128, sizeof( iv128 ), icode2, 16 );
+  if( !ak_ptr_is_equal_with_log( out, out2, size ) || !ak_ptr_is_equal_with_log( icode, icode2, 16 )) {
+    printf("large message encryption [Wrong]\n");
+    goto labex;
+  }
+  if(( error = ak_bckey_decrypt_xtsmac( ekey, ikey, adata, asize, out2, out, size,
+                                               iv128, sizeof( iv128 ), icode, 16 )) != ak_error_ok ) {
+    printf("large message integrity code [Wrong]\n");
+    goto labex;
+  }
+  if( !ak_ptr_is_equal_with_log( data, out, size )) {
+    printf("large message decryption [Wrong]\n");
+    error = ak_error_not_equal_data;
+    goto labex;
+  }
+  printf("large message (%u octets) [Ok]\n", (unsigned int) size );
+
+  labex:
+   ak_libakrypt_set_option( "threads_count", 0 );
+   free( out2 ); free( out ); free( data ); free( adata );
+  return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
@@ -149,6 +188,9 @@
      printf("\n");
   }
 
+ /* сравниваем последовательную и многопоточную обработку длинного сообщения */
+  if( large_message_test( &ekey, &ikey ) != ak_error_ok ) goto exlab;
+
  /* удаляем ключи и завершаем работу с библиотекой */
   result = EXIT_SUCCESS;
   exlab:
@@ -8,25 +8,18 @@
  #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \details Функция вычисляет новое значение секретного ключа в соответствии с соотношениями
-    из раздела 4.1, см. Р 1323565.1.017—2018.
-    После выработки новое значение помещается вместо старого.
-    Одновременно, изменяется ресурс нового ключа: его тип принимает значение - \ref key_using_resource,
-    а счетчик принимает значение, определяемое одной из опций
-
-     - `ackpm_section_magma_block_count`,
-     - `ackpm_section_kuznechik_block_count`.
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
-    @param bkey Контекст ключа алгоритма блочного шифрования, для которого вычисляется
-    новое значение. Контекст должен быть инициализирован и содержать ключевое значение.
-    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
-    возвращается \ref ak_error_ok (ноль)                                                           */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_bckey_next_acpkm_key( ak_bckey bkey )
+/*! \brief Функция вычисляет значение следующего ключа ACPKM без его присвоения контексту.
+    \details Вычисленное значение помещается в массив new_key (длиной 32 октета),
+    в переменную counter помещается ресурс нового ключа.                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_acpkm_key_value( ak_bckey bkey, ak_uint8 *new_key, ssize_t *counter )
 {
-  ssize_t counter = 0;
-  int error = ak_error_ok;
-  ak_uint8 new_key[32], acpkm[32] = {
+  ak_uint8 acpkm[32] = {
      0x9f, 0x9e, 0x9d, 0x9c, 0x9b, 0x9a, 0x99, 0x98, 0x97, 0x96, 0x95, 0x94, 0x93, 0x92, 0x91, 0x90,
      0x8f, 0x8e, 0x8d, 0x8c, 0x8b, 0x8a, 0x89, 0x88, 0x87, 0x86, 0x85, 0x84, 0x83, 0x82, 0x81, 0x80 };
 
@@ -46,16 +39,42 @@
          bkey->encrypt( &bkey->key, acpkm +8, new_key +8 );
          bkey->encrypt( &bkey->key, acpkm +16, new_key +16 );
          bkey->encrypt( &bkey->key, acpkm +24, new_key +24 );
-         counter = ak_libakrypt_get_option_by_name( "acpkm_section_magma_block_count" );
+         *counter = ak_libakrypt_get_option_by_name( "acpkm_section_magma_block_count" );
          break;
       case 16: /* шифр с длиной блока 128 бит */
          bkey->encrypt( &bkey->key, acpkm, new_key );
          bkey->encrypt( &bkey->key, acpkm +16, new_key +16 );
-         counter = ak_libakrypt_get_option_by_name( "acpkm_section_kuznechik_block_count" );
+         *counter = ak_libakrypt_get_option_by_name( "acpkm_section_kuznechik_block_count" );
          break;
       default: return ak_error_message( ak_error_wrong_block_cipher,
                                            __func__ , "incorrect block size of block cipher key" );
    }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \details Функция вычисляет новое значение секретного ключа в соответствии с соотношениями
+    из раздела 4.1, см. Р 1323565.1.017—2018.
+    После выработки новое значение помещается вместо старого.
+    Одновременно, изменяется ресурс нового ключа: его тип принимает значение - \ref key_using_resource,
+    а счетчик принимает значение, определяемое одной из опций
+
+     - `ackpm_section_magma_block_count`,
+     - `ackpm_section_kuznechik_block_count`.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования, для которого вычисляется
+    новое значение. Контекст должен быть инициализирован и содержать ключевое значение.
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_next_acpkm_key( ak_bckey bkey )
+{
+  ssize_t counter = 0;
+  ak_uint8 new_key[32];
+  int error = ak_error_ok;
+
+  if(( error = ak_bckey_acpkm_key_value( bkey, new_key, &counter )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect generation of acpkm key value" );
 
  /* присваиваем ключу значение */
   if(( error = ak_bckey_set_key( bkey, new_key, bkey->key.key_size )) != ak_error_ok )
@@ -68,17 +87,284 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \details Функция создает контекст dkey и присваивает ему значение ключа, следующего в цепочке
+    ACPKM за ключом skey. Контекст skey не изменяется.
+
+    @param skey Контекст ключа, по которому вырабатывается новое значение.
+    @param dkey Контекст, в котором создается производный ключ. Контекст не должен быть
+    инициализирован ранее.
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_create_next_acpkm_key( ak_bckey skey, ak_bckey dkey )
+{
+  ssize_t counter = 0;
+  ak_uint8 new_key[32];
+  int error = ak_error_ok;
+
+  if(( error = ak_bckey_acpkm_key_value( skey, new_key, &counter )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect generation of acpkm key value" );
+
+  if(( error = (( ak_function_bckey_create *)
+                               skey->key.oid->func.first.create )( dkey )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of block cipher context" );
+    goto labex;
+  }
+  if(( error = ak_bckey_set_key( dkey, new_key, skey->key.key_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect assigning of acpkm key value" );
+    ak_bckey_destroy( dkey );
+    goto labex;
+  }
+  dkey->key.resource.value.type = key_using_resource;
+  dkey->key.resource.value.counter = counter;
+
+  labex: ak_ptr_wipe( new_key, sizeof( new_key ), &skey->key.generator );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                  заблаговременная выработка ключей секций в режиме ACPKM                        */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество ключей, вырабатываемых заблаговременно. */
+ #define ak_acpkm_lookahead_max_count (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Кольцевая очередь ключей секций режима ACPKM.
+
+    Очередь содержит ключ текущей секции, ключи, готовые к использованию, а также ключ,
+    используемый для выработки следующего значения (он остается закрытым для шифрующей стороны
+    до тех пор, пока по нему не будет выработан следующий ключ). Все ключи хранятся в виде
+    полноценных контекстов struct bckey, т.е. в маскированном виде с установленным
+    кодом целостности.
+
+    Ключ с номером i хранится в элементе keys[i % depth].                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct acpkm_lookahead {
+  /*! \brief Массив ключей секций */
+   struct bckey keys[ ak_acpkm_lookahead_max_count + 2 ];
+  /*! \brief Размер кольцевой очереди */
+   size_t depth;
+  /*! \brief Общее количество ключей, необходимых для обработки сообщения */
+   size_t total;
+  /*! \brief Количество выработанных ключей */
+   size_t derived;
+  /*! \brief Количество ключей, доступных шифрующей стороне */
+   size_t ready;
+  /*! \brief Номер ключа, используемого для шифрования текущей секции */
+   size_t used;
+  /*! \brief Код ошибки, возникшей при выработке ключей */
+   int error;
+ #ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Флаг использования вспомогательного потока */
+   bool_t threaded;
+  /*! \brief Флаг досрочной остановки вспомогательного потока */
+   bool_t stop;
+  /*! \brief Вспомогательный поток, вырабатывающий ключи */
+   pthread_t thread;
+  /*! \brief Мьютекс, защищающий счетчики очереди */
+   pthread_mutex_t mutex;
+  /*! \brief Условная переменная, сигнализирующая об изменении счетчиков очереди */
+   pthread_cond_t cond;
+ #endif
+ } *ak_acpkm_lookahead;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка одного ключа очереди.
+    \details Ключ с номером derived вырабатывается по ключу с номером derived-1, который
+    до этого момента недоступен шифрующей стороне. После выработки ключ derived-1 становится
+    доступным для использования. Функция вызывается только при наличии свободного места в очереди.  */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_acpkm_lookahead_derive( ak_acpkm_lookahead la )
+{
+  int error = ak_bckey_create_next_acpkm_key( &la->keys[( la->derived -1 )%la->depth],
+                                                            &la->keys[ la->derived%la->depth ] );
+  if( error != ak_error_ok ) return error;
+  la->derived++;
+  la->ready = ( la->derived == la->total ) ? la->total : la->derived -1;
+ return ak_error_ok;
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока, заблаговременно вырабатывающего ключи секций. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_acpkm_lookahead_thread( void *ptr )
+{
+  int error = ak_error_ok;
+  ak_acpkm_lookahead la = ( ak_acpkm_lookahead )ptr;
+
+  for( ;; ) {
+    pthread_mutex_lock( &la->mutex );
+    while(( !la->stop ) && ( la->derived < la->total ) &&
+                                            ( la->derived - la->used + 1 > la->depth ))
+      pthread_cond_wait( &la->cond, &la->mutex );
+    if(( la->stop ) || ( la->derived >= la->total )) {
+      pthread_mutex_unlock( &la->mutex );
+      break;
+    }
+    pthread_mutex_unlock( &la->mutex );
+
+   /* выработка ключа производится без блокировки:
+      используемые элементы очереди недоступны шифрующей стороне */
+    error = ak_bckey_create_next_acpkm_key( &la->keys[( la->derived -1 )%la->depth],
+                                                            &la->keys[ la->derived%la->depth ] );
+    pthread_mutex_lock( &la->mutex );
+    if( error == ak_error_ok ) {
+      la->derived++;
+      la->ready = ( la->derived == la->total ) ? la->total : la->derived -1;
+    } else la->error = error;
+    pthread_cond_broadcast( &la->cond );
+    pthread_mutex_unlock( &la->mutex );
+    if( error != ak_error_ok ) break;
+  }
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Инициализация очереди ключей секций.
+    \details Функция создает копию исходного ключа (ключ нулевой секции) и вырабатывает
+    ключ первой секции; при наличии поддержки потоков запускается вспомогательный поток,
+    вырабатывающий остальные ключи.
+
+    @param la Контекст очереди
+    @param bkey Исходный ключ
+    @param total Общее количество ключей секций, необходимых для обработки сообщения
+    @param count Количество ключей, вырабатываемых заблаговременно; нулевое значение
+    означает, что ключи вырабатываются в момент смены секции.
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_acpkm_lookahead_create( ak_acpkm_lookahead la, ak_bckey bkey,
+                                                                   size_t total, size_t count )
+{
+  int error = ak_error_ok;
+
+  la->total = ak_max( total, 1 );
+  la->depth = ( count > 0 ) ? ak_min( count, ak_acpkm_lookahead_max_count ) +2 : 1;
+  la->derived = la->ready = 1;
+  la->used = 0;
+  la->error = ak_error_ok;
+ #ifdef AK_HAVE_PTHREAD_H
+  la->threaded = la->stop = ak_false;
+ #endif
+
+  if(( error = ak_bckey_create_and_set_bckey( &la->keys[0], bkey )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect key duplication" );
+  if(( la->depth == 1 ) || ( la->total == 1 )) return ak_error_ok;
+
+ /* ключ первой секции вырабатывается сразу, поскольку ключ нулевой секции
+    с этого момента используется для шифрования */
+  if(( error = ak_acpkm_lookahead_derive( la )) != ak_error_ok ) {
+    ak_bckey_destroy( &la->keys[0] );
+    return ak_error_message( error, __func__, "incorrect generation of the first section key" );
+  }
+
+ #ifdef AK_HAVE_PTHREAD_H
+  if( la->derived < la->total ) {
+    pthread_mutex_init( &la->mutex, NULL );
+    pthread_cond_init( &la->cond, NULL );
+    if( pthread_create( &la->thread, NULL, ak_acpkm_lookahead_thread, la ) == 0 )
+      la->threaded = ak_true;
+     else {
+       pthread_cond_destroy( &la->cond );
+       pthread_mutex_destroy( &la->mutex );
+     }
+  }
+ #endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переход к ключу следующей секции.
+    \details В случае, если заблаговременная выработка ключей не используется, функция
+    изменяет значение текущего ключа. В противном случае, текущий ключ уничтожается,
+    а его место занимает заранее выработанный ключ следующей секции.
+
+    @param la Контекст очереди
+    @param key Указатель, в который помещается адрес ключа следующей секции
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_acpkm_lookahead_next( ak_acpkm_lookahead la, ak_bckey *key )
+{
+  int error = ak_error_ok;
+
+  if( la->depth == 1 ) return ak_bckey_next_acpkm_key( *key = &la->keys[0] );
+  if( la->used + 1 >= la->total ) return ak_error_message( ak_error_wrong_index, __func__,
+                                                             "all section keys are already used" );
+ #ifdef AK_HAVE_PTHREAD_H
+  if( la->threaded ) {
+    pthread_mutex_lock( &la->mutex );
+    while(( la->ready <= la->used + 1 ) && ( la->error == ak_error_ok ))
+      pthread_cond_wait( &la->cond, &la->mutex );
+    error = la->error;
+    pthread_mutex_unlock( &la->mutex );
+    if( error != ak_error_ok )
+      return ak_error_message( error, __func__, "incorrect generation of section key" );
+
+    ak_bckey_destroy( &la->keys[ la->used%la->depth ] );
+    pthread_mutex_lock( &la->mutex );
+    la->used++;
+    pthread_cond_broadcast( &la->cond );
+    pthread_mutex_unlock( &la->mutex );
+
+    *key = &la->keys[ la->used%la->depth ];
+    return ak_error_ok;
+  }
+ #endif
+
+ /* в однопоточном режиме очередь заполняется целиком в момент ее исчерпания */
+  if( la->ready <= la->used + 1 ) {
+    while(( la->derived < la->total ) && ( la->derived - la->used + 1 <= la->depth )) {
+      if(( error = ak_acpkm_lookahead_derive( la )) != ak_error_ok )
+        return ak_error_message( error, __func__, "incorrect generation of section key" );
+    }
+  }
+  ak_bckey_destroy( &la->keys[ la->used%la->depth ] );
+  *key = &la->keys[ ++la->used%la->depth ];
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Уничтожение очереди ключей секций, включая все ключи, выработанные заблаговременно. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_acpkm_lookahead_destroy( ak_acpkm_lookahead la )
+{
+  size_t idx = 0;
+
+ #ifdef AK_HAVE_PTHREAD_H
+  if( la->threaded ) {
+    pthread_mutex_lock( &la->mutex );
+    la->stop = ak_true;
+    pthread_cond_broadcast( &la->cond );
+    pthread_mutex_unlock( &la->mutex );
+    pthread_join( la->thread, NULL );
+    pthread_cond_destroy( &la->cond );
+    pthread_mutex_destroy( &la->mutex );
+    la->threaded = ak_false;
+  }
+ #endif
+ /* уничтожаем все ключи, от текущего до последнего выработанного */
+  for( idx = la->used; idx < la->derived; idx++ ) ak_bckey_destroy( &la->keys[ idx%la->depth ] );
+  la->used = la->derived = la->ready = 0;
+
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_LITTLE_ENDIAN
   #define acpkm_block64 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
+              ckey->encrypt( &ckey->key, ctr, yaout );\
               ctr[0] += 1;\
               ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
               outptr++; inptr++;\
            }
 
   #define acpkm_block128 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
+              ckey->encrypt( &ckey->key, ctr, yaout );\
               if(( ctr[0] += 1 ) == 0 ) ctr[1]++;\
               ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
               ((ak_uint64 *) outptr)[1] = yaout[1] ^ ((ak_uint64 *) inptr)[1];\
@@ -87,14 +373,14 @@
 
 #else
   #define acpkm_block64 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
+              ckey->encrypt( &ckey->key, ctr, yaout );\
               ctr[0] = bswap_64( ctr[0] ); ctr[0] += 1; ctr[0] = bswap_64( ctr[0] );\
               ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
               outptr++; inptr++;\
            }
 
   #define acpkm_block128 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
+              ckey->encrypt( &ckey->key, ctr, yaout );\
               ctr[0] = bswap_64( ctr[0] ); ctr[0] += 1; ctr[0] = bswap_64( ctr[0] );\
               if( ctr[0] == 0 ) { \
                 ctr[1] = bswap_64( ctr[0] ); ctr[1] += 1; ctr[1] = bswap_64( ctr[0] );\
@@ -106,46 +392,19 @@
 #endif
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! В режиме `ACPKM` для шифрования используется операция гаммирования - операция сложения
-    открытого (зашифровываемого) текста с гаммой, вырабатываемой шифром, по модулю два.
-    Поэтому, для зашифрования и расшифрования информациии используется одна и та же функция.
-
-    В процессе шифрования исходные данные разбиваются на секции фиксированной длины, после чего
-    каждая секция шифруется на своем ключе. Длина секции является параметром алгоритма и
-    не должна превосходить величины, определяемой одной из следующих технических характеристик
-    (опций)
-
-     - `ackpm_section_magma_block_count`,
-     - `ackpm_section_kuznechik_block_count`.
-
-    Значение синхропосылки `iv` копируется во временную область памяти и, в ходе выполнения
-    функции, не изменяется. Повторный вызов функции ak_bckey_ctr_acpkm() с нулевым
-    указатетем на синхропосылу, как в случае функции ak_bckey_ctr(), не допускается.
-
-    @param bkey Контекст ключа алгоритма блочного шифрования,
-    используемый для шифрования и порождения цепочки производных ключей.
-    @param in Указатель на область памяти, где хранятся входные
-    (зашифровываемые/расшифровываемые) данные
-    @param out Указатель на область памяти, куда помещаются выходные
-    (расшифровываемые/зашифровываемые) данные; этот указатель может совпадать с in
-    @param size Размер зашировываемых данных (в байтах). Длина зашифровываемых данных может
-    принимать любое значение, не превосходящее \f$ 2^{\frac{8n}{2}-1}\f$, где \f$ n \f$
-    длина блока алгоритма шифрования (8 или 16 байт).
+/*! \brief Зашифрование/расшифрование информации в режиме `ACPKM` с заданным количеством
+    ключей секций, вырабатываемых заблаговременно.
 
-    @param section_size Размер одной секции в байтах. Данная величина должна быть кратна длине блока
-    используемого алгоритма шифрования.
-
-    @param iv имитовставка
-    @param iv_size длина имитовставки (в байтах)
-
-    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
-    возвращается \ref ak_error_ok (ноль)                                                           */
+    Параметры функции совпадают с параметрами функции ak_bckey_ctr_acpkm(); количество
+    заблаговременно вырабатываемых ключей `count` передается явно, а не считывается
+    из опции `acpkm_lookahead_key_count`.                                                          */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_bckey_ctr_acpkm( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
-                                                 size_t section_size, ak_pointer iv, size_t iv_size)
+ static int ak_bckey_ctr_acpkm_lookahead( ak_bckey bkey, ak_pointer in, ak_pointer out,
+             size_t size, size_t section_size, ak_pointer iv, size_t iv_size, const size_t count )
 {
-  struct bckey nkey;
+  ak_bckey ckey = NULL;
   int error = ak_error_ok;
+  struct acpkm_lookahead la;
   ssize_t j = 0, sections = 0, tail = 0, seclen = 0, maxseclen = 0, mcount = 0;
   ak_uint64 yaout[2], *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out, ctr[2] = { 0, 0 };
 
@@ -201,25 +460,30 @@
        else bkey->key.resource.value.counter--;
      }
 
- /* теперь размножаем исходный ключ */
-  if(( error = ak_bckey_create_and_set_bckey( &nkey, bkey )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect key duplication" );
+ /* определяем количество секций */
+  sections = ( ssize_t )( size/section_size );
+  tail = ( ssize_t )( size - ( size_t )( sections*seclen )*bkey->bsize );
+
+ /* теперь размножаем исходный ключ и, при необходимости, готовим ключи следующих секций */
+  if(( error = ak_acpkm_lookahead_create( &la, bkey,
+                                       ( size_t )( sections + ( tail > 0 )), count )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of section keys" );
  /* и меняем ресурс для производного ключа */
-  nkey.key.resource.value.counter = maxseclen;
+  ckey = &la.keys[0];
+  ckey->key.resource.value.counter = maxseclen;
 
  /* дальнейшие криптографические действия применяются к новому экземпляру ключа */
-  sections = ( ssize_t )( size/section_size );
-  tail = ( ssize_t )( size - ( size_t )( sections*seclen )*nkey.bsize );
   if( sections > 0 ) {
     do{
-       switch( nkey.bsize ) { /* обрабатываем одну секцию */
+       switch( ckey->bsize ) { /* обрабатываем одну секцию */
          case 8: for( j = 0; j < seclen; j++ ) acpkm_block64; break;
          case 16: for( j = 0; j < seclen; j++ ) acpkm_block128; break;
          default: ak_error_message( ak_error_wrong_block_cipher,
                                            __func__ , "incorrect block size of block cipher key" );
        }
-      /* вычисляем следующий ключ */
-       if(( error = ak_bckey_next_acpkm_key( &nkey )) != ak_error_ok ) {
+      /* переходим к ключу следующей секции (после последней секции ключ нужен только для хвоста) */
+       if(( sections == 1 ) && ( tail == 0 )) break;
+       if(( error = ak_acpkm_lookahead_next( &la, &ckey )) != ak_error_ok ) {
          ak_error_message_fmt( error, __func__, "incorrect key generation after %u sections",
                                                                          (unsigned int) sections );
          goto labex;
@@ -228,8 +492,8 @@
   } /* конец обработки случая, когда sections > 0 */
 
   if( tail ) { /* теперь обрабатываем фрагмент данных, не кратный длине секции */
-    if(( seclen = tail/(ssize_t)( nkey.bsize )) > 0 ) {
-       switch( nkey.bsize ) { /* обрабатываем данные, кратные длине блока */
+    if(( seclen = tail/(ssize_t)( ckey->bsize )) > 0 ) {
+       switch( ckey->bsize ) { /* обрабатываем данные, кратные длине блока */
          case 8: for( j = 0; j < seclen; j++ ) acpkm_block64; break;
          case 16: for( j = 0; j < seclen; j++ ) acpkm_block128; break;
          default: ak_error_message( ak_error_wrong_block_cipher,
@@ -238,17 +502,108 @@
     }
   /* остался последний фрагмент, длина которого меньше длины блока
                       в качестве гаммы мы используем старшие байты */
-    if(( tail -= seclen*(ssize_t)( nkey.bsize )) > 0 ) {
-      nkey.encrypt( &nkey.key, ctr, yaout );
+    if(( tail -= seclen*(ssize_t)( ckey->bsize )) > 0 ) {
+      ckey->encrypt( &ckey->key, ctr, yaout );
       for( j = 0; j < tail; j++ ) ((ak_uint8 *) outptr)[j] =
-                         ((ak_uint8 *)yaout)[(ssize_t)nkey.bsize-tail+j] ^ ((ak_uint8 *) inptr)[j];
+                         ((ak_uint8 *)yaout)[(ssize_t)ckey->bsize-tail+j] ^ ((ak_uint8 *) inptr)[j];
     }
   }
 
-  labex: ak_bckey_destroy( &nkey );
+  labex: ak_acpkm_lookahead_destroy( &la );
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! В режиме `ACPKM` для шифрования используется операция гаммирования - операция сложения
+    открытого (зашифровываемого) текста с гаммой, вырабатываемой шифром, по модулю два.
+    Поэтому, для зашифрования и расшифрования информациии используется одна и та же функция.
+
+    В процессе шифрования исходные данные разбиваются на секции фиксированной длины, после чего
+    каждая секция шифруется на своем ключе. Длина секции является параметром алгоритма и
+    не должна превосходить величины, определяемой одной из следующих технических характеристик
+    (опций)
+
+     - `ackpm_section_magma_block_count`,
+     - `ackpm_section_kuznechik_block_count`.
+
+    Значение синхропосылки `iv` копируется во временную область памяти и, в ходе выполнения
+    функции, не изменяется. Повторный вызов функции ak_bckey_ctr_acpkm() с нулевым
+    указатетем на синхропосылу, как в случае функции ak_bckey_ctr(), не допускается.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования,
+    используемый для шифрования и порождения цепочки производных ключей.
+    @param in Указатель на область памяти, где хранятся входные
+    (зашифровываемые/расшифровываемые) данные
+    @param out Указатель на область памяти, куда помещаются выходные
+    (расшифровываемые/зашифровываемые) данные; этот указатель может совпадать с in
+    @param size Размер зашировываемых данных (в байтах). Длина зашифровываемых данных может
+    принимать любое значение, не превосходящее \f$ 2^{\frac{8n}{2}-1}\f$, где \f$ n \f$
+    длина блока алгоритма шифрования (8 или 16 байт).
+
+    @param section_size Размер одной секции в байтах. Данная величина должна быть кратна длине блока
+    используемого алгоритма шифрования.
+
+    @param iv имитовставка
+    @param iv_size длина имитовставки (в байтах)
+
+    \note Ключи секций могут вырабатываться заблаговременно, см. опцию `acpkm_lookahead_key_count`
+    (по умолчанию заблаговременная выработка не используется).
+    В этом случае, при смене секции, ранее выработанный ключ используется вместо выработки нового
+    значения. При сборке библиотеки с поддержкой потоков ключи вырабатываются во вспомогательном
+    потоке, создаваемом при каждом вызове функции, параллельно с шифрованием данных.
+    Результат шифрования от способа выработки ключей не зависит.
+
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_ctr_acpkm( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                                                 size_t section_size, ak_pointer iv, size_t iv_size)
+{
+ return ak_bckey_ctr_acpkm_lookahead( bkey, in, out, size, section_size, iv, iv_size,
+                      ( size_t ) ak_libakrypt_get_option_by_name( "acpkm_lookahead_key_count" ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает результаты шифрования в режиме ACPKM, полученные с заблаговременной
+    выработкой ключей секций и без нее.
+    \details Шифруется фрагмент данных, содержащий большое количество секций минимальной длины
+    и неполную последнюю секцию.                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_libakrypt_test_acpkm_lookahead( ak_function_bckey_create *create,
+                                                                 ak_uint8 *skey, size_t skey_size )
+{
+  size_t i = 0;
+  struct bckey key;
+  bool_t result = ak_false;
+  int error = ak_error_ok;
+  ak_uint8 iv[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0 };
+  ak_uint8 in[4111], out0[4111], out1[4111];
+
+  for( i = 0; i < sizeof( in ); i++ ) in[i] = ( ak_uint8 )( i*7 +1 );
+  if(( error = create( &key )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of secret key" );
+    return ak_false;
+  }
+  if(( error = ak_bckey_set_key( &key, skey, skey_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect assigning a key value" ); goto labex; }
+
+  if(( error = ak_bckey_ctr_acpkm_lookahead( &key, in, out0, sizeof( in ),
+                                     4*key.bsize, iv, sizeof( iv ), 0 )) != ak_error_ok ) goto labex;
+  if(( error = ak_bckey_ctr_acpkm_lookahead( &key, in, out1, sizeof( in ),
+                                     4*key.bsize, iv, sizeof( iv ), 3 )) != ak_error_ok ) goto labex;
+  if( memcmp( out0, out1, sizeof( in )) != 0 ) {
+    ak_error_message( ak_error_not_equal_data, __func__,
+                                     "different results with and without section keys lookahead" );
+    goto labex;
+  }
+  result = ak_true;
+
+  labex:
+   if( error != ak_error_ok ) ak_error_message( error, __func__, "incorrect acpkm encryption" );
+   ak_bckey_destroy( &key );
+ return result;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_libakrypt_test_acpkm( void )
 {
@@ -364,6 +719,16 @@
     return ak_false;
   }
 
+ /* 3. Проверяем совпадение результатов при заблаговременной выработке ключей секций */
+  if( !ak_libakrypt_test_acpkm_lookahead( ak_bckey_create_magma, skey, sizeof( skey ))) {
+    ak_error_message( ak_error_ok, __func__ , "acpkm lookahead test for magma is wrong" );
+    return ak_false;
+  }
+  if( !ak_libakrypt_test_acpkm_lookahead( ak_bckey_create_kuznechik, skey, sizeof( skey ))) {
+    ak_error_message( ak_error_ok, __func__ , "acpkm lookahead test for kuznechik is wrong" );
+    return ak_false;
+  }
+
  return ak_true;
 }
 
@@ -1259,6 +1259,9 @@
     теперь ключ можно использовать в криптографических алгоритмах */
    skey->flags |= key_flag_set_key;
 
+  /* для ключей hmac сбрасываем ранее вычисленные состояния функции хеширования */
+   if( skey->oid->engine == hmac_function ) ak_hmac_wipe_internal_states(( ak_hmac )skey );
+
   /* для ключей блочного шифрования выполняем развертку раундовых ключей */
    if( skey->oid->engine == block_cipher ) {
      if( ((ak_bckey)skey)->schedule_keys != NULL ) {
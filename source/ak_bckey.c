@@ -52,6 +52,8 @@
   bkey->ivector_size =  0;
   bkey->encrypt =       NULL;
   bkey->decrypt =       NULL;
+  bkey->encrypt_blocks = NULL;
+  bkey->decrypt_blocks = NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
 
@@ -86,6 +88,8 @@
   bkey->bsize =            0;
   bkey->encrypt =       NULL;
   bkey->decrypt =       NULL;
+  bkey->encrypt_blocks = NULL;
+  bkey->decrypt_blocks = NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
 
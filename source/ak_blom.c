@@ -4,6 +4,9 @@
 /*  Файл ak_blom.с                                                                                 */
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup skey-blom-doc Реализация схемы Блома распределения ключевой информации
@@ -58,8 +61,13 @@
   \f\[ Kab = f_a\left( \texttt{Streebog}_n(IDb) \right). \f\]
 
   Создание ключа абонента \f$ Ka \f$ выполняется с помощью функции ak_blomkey_create_abonent_key().
+  Для выработки ключей большого количества абонентов предназначены функции
+  ak_blomkey_create_abonent_keys() и ak_blomkey_export_abonent_keys_to_files_with_password(),
+  вычисляющие ключи группы абонентов как произведение матриц.
 
   Создание ключа парной связи \f$ Kab \f$ - с помощью функции ak_blomkey_create_pairwise_key_as_ptr().
+  Ключи парной связи с большим количеством абонентов вырабатываются
+  функцией ak_blomkey_create_pairwise_keys_as_ptr().
 
   Удаление созданных ключей выполняется с помощью функции ak_blomkey_destroy().
 
@@ -158,6 +166,100 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция инициализирует контекст ключа абонента и вычисляет степени хеш-кода
+    его идентификатора.
+
+    Функция создает контекст хеш-функции, выделяет память под ключевые данные и помещает
+    в массив `powers` элементы \f$ 1, h, h^2, \ldots, h^{m-1} \f$, где
+    \f$ h = \texttt{Streebog}_n(ID) \f$, а \f$ m \f$ - размер мастер-ключа.
+    Проверка целостности мастер-ключа функцией не выполняется.
+
+    \param bkey указатель на контекст создаваемого ключа абонента
+    \param matrix указатель на контекст мастер-ключа
+    \param id указатель на идентификатор абонента
+    \param idsize длина идентификатора (в октетах)
+    \param powers массив для хранения (`matrix->size`) элементов конечного поля
+    \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха,
+    в противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blomkey_create_abonent_powers( ak_blomkey bkey, ak_blomkey matrix,
+                                          ak_pointer id, const size_t idsize, ak_uint8 *powers )
+{
+  ak_uint8 value[64];
+  ak_uint32 column = 0;
+  int error = ak_error_ok;
+  size_t memsize = matrix->size*matrix->count;
+
+  memset( bkey, 0, sizeof( struct blomkey ));
+  if(( id == NULL ) || ( !idsize )) return ak_error_message( ak_error_undefined_value, __func__,
+                                                          "using undefined abonent's identifier" );
+  bkey->count = matrix->count;
+  bkey->size = matrix->size;
+  bkey->type = blom_abonent_key;
+
+ /* создаем контекст хеш-функции */
+  if(( error = ak_hash_create_oid( &bkey->ctx, matrix->ctx.oid )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of hash function context" );
+ /* формируем хэш от идентификатора */
+  if(( error = ak_hash_ptr( &bkey->ctx, id, idsize, value, bkey->count )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect evauation of initial hash value" );
+
+ /* формируем память для ключевых данных */
+  if(( bkey->data = malloc( memsize + 16 )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  memset( bkey->data, 0, memsize + 16 );
+
+ /* вычисляем степени хеш-кода */
+  memset( powers, 0, memsize );
+  powers[0] = 1;
+  for( column = 1; column < bkey->size; column++ ) {
+     ak_uint8 *prev = powers +( column-1 )*bkey->count;
+     if( bkey->count == ak_galois256_size ) ak_gf256_mul( prev +bkey->count, prev, value );
+      else ak_gf512_mul( prev +bkey->count, prev, value );
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет ключевые данные для нескольких абонентов.
+
+    Ключевые данные абонентов вычисляются как произведение мастер-ключа на матрицу,
+    строками которой являются степени хеш-кодов идентификаторов абонентов.
+    Каждая строка мастер-ключа используется для всех абонентов, после чего обрабатывается
+    следующая строка; элементы результата вычисляются как суммы попарных произведений
+    с отложенным приведением, см. функции ak_gf256_mul_sum() и ak_gf512_mul_sum().
+
+    \param matrix указатель на контекст мастер-ключа
+    \param keys массив из `count` контекстов ключей абонентов
+    \param powers массив из `count` строк, вычисленных функцией ak_blomkey_create_abonent_powers()
+    \param count количество абонентов
+    \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха,
+    в противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blomkey_set_abonent_data( ak_blomkey matrix, ak_blomkey keys,
+                                                            ak_uint8 *powers, const size_t count )
+{
+  size_t i = 0;
+  ak_uint32 row = 0;
+  int error = ak_error_ok;
+  size_t memsize = matrix->size*matrix->count;
+
+  for( row = 0; row < matrix->size; row++ ) {
+     ak_uint8 *line = matrix->data + row*memsize;
+     for( i = 0; i < count; i++ ) {
+        if( matrix->count == ak_galois256_size )
+          ak_gf256_mul_sum( keys[i].data + row*matrix->count, line, powers +i*memsize, matrix->size );
+         else
+          ak_gf512_mul_sum( keys[i].data + row*matrix->count, line, powers +i*memsize, matrix->size );
+     }
+  }
+  for( i = 0; i < count; i++ )
+     if(( error = ak_hash_ptr( &keys[i].ctx, keys[i].data, memsize,
+                                                         keys[i].icode, 32 )) != ak_error_ok ) break;
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Вырабатываемый ключ предназначается для конкретного абонента и
     однозначно зависит от его идентификатора и мастер-ключа.
@@ -171,10 +273,7 @@
  int ak_blomkey_create_abonent_key( ak_blomkey bkey, ak_blomkey matrix,
                                                                ak_pointer id, const size_t idsize )
 {
-  ak_uint8 value[64];
-  size_t memsize = 0;
-  ak_int32 column = 0;
-  ak_uint32 i, row = 0;
+  ak_uint8 *powers = NULL;
   int error = ak_error_ok;
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
@@ -188,36 +287,356 @@
   if( !ak_blomkey_check_icode( matrix ))
     return ak_error_message( ak_error_get_value(), __func__, "using wrong blom master key" );
 
-  memset( bkey, 0, sizeof( struct blomkey ));
-  bkey->count = matrix->count;
-  bkey->size = matrix->size;
-  bkey->type = blom_abonent_key;
+  if(( powers = malloc( matrix->size*matrix->count )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  if(( error = ak_blomkey_create_abonent_powers( bkey, matrix, id, idsize, powers )) == ak_error_ok )
+    error = ak_blomkey_set_abonent_data( matrix, bkey, powers, 1 );
+  if( error != ak_error_ok ) ak_blomkey_destroy( bkey );
 
- /* создаем контекст хеш-функции */
-  if(( error = ak_hash_create_oid( &bkey->ctx, matrix->ctx.oid )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect creation of hash function context" );
- /* формируем хэш от идентификатора */
-  if(( error = ak_hash_ptr( &bkey->ctx, id, idsize, value, bkey->count )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect evauation of initial hash value" );
+  free( powers );
+ return error;
+}
 
- /* формируем ключевые данные */
-  if(( bkey->data = malloc( ( memsize = bkey->size*matrix->count ) + 16 )) == NULL )
-    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество абонентов, ключи которых (или ключи парной связи с которыми)
+    вычисляются совместно. */
+ #define ak_blomkey_batch_block (16)
 
-  memset( bkey->data, 0, memsize + 16 );
-  for( row = 0; row < bkey->size; row++ ) { /* схема Горнера для вычисления значений многочлена */
-     ak_uint8 *sum = bkey->data + row*bkey->count;
-     memset( sum, 0, bkey->count );
-     for( column = bkey->size - 1; column >= 0; column-- ) {
-        ak_uint8 *key = ak_blomkey_get_element_by_index( matrix, row, column );
-        if( bkey->count == ak_galois256_size ) ak_gf256_mul( sum, sum, value );
-         else ak_gf512_mul( sum, sum, value );
-        for( i = 0; i < ( bkey->count >> 3 ); i++ ) ((ak_uint64 *)sum)[i] ^= ((ak_uint64 *)key)[i];
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет ключи парной связи абонента с несколькими абонентами.
+
+    Многочлен \f$ f_a(x) \f$, определяемый ключом абонента, вычисляется по схеме Горнера
+    одновременно во всех точках \f$ \texttt{Streebog}_n(IDb) \f$: каждый коэффициент
+    многочлена извлекается из памяти один раз, а независимые умножения для разных абонентов
+    выполняются процессором параллельно. Проверка целостности ключа абонента функцией
+    не выполняется.
+
+    \param bkey указатель на контекст ключа абонента
+    \param ctx контекст хеш-функции, используемый для вычисления хеш-кодов идентификаторов
+    \param ids массив из `count` указателей на идентификаторы абонентов
+    \param idsizes массив из `count` длин идентификаторов (в октетах)
+    \param count количество абонентов, не превосходящее \ref ak_blomkey_batch_block
+    \param keys область памяти размером `count`*`bkey->count` октетов для ключей парной связи
+    \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха,
+    в противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blomkey_set_pairwise_keys( ak_blomkey bkey, ak_hash ctx, ak_pointer *ids,
+                                     const size_t *idsizes, const size_t count, ak_uint8 *keys )
+{
+  ak_int32 row = 0;
+  size_t i = 0, j = 0;
+  int error = ak_error_ok;
+  ak_uint8 values[ak_blomkey_batch_block*64];
+
+ /* формируем хэш от идентификаторов */
+  for( j = 0; j < count; j++ ) {
+     if(( ids[j] == NULL ) || ( !idsizes[j] )) return ak_error_message( ak_error_undefined_value,
+                                                __func__, "using undefined abonent's identifier" );
+     if(( error = ak_hash_ptr( ctx, ids[j], idsizes[j],
+                                         values +j*bkey->count, bkey->count )) != ak_error_ok )
+       return ak_error_message( error, __func__, "incorrect evauation of initial hash value" );
+  }
+
+  memset( keys, 0, count*bkey->count );
+  for( row = bkey->size - 1; row >= 0; row-- ) {
+     ak_uint64 *element = ( ak_uint64 *)( bkey->data + row*bkey->count );
+     for( j = 0; j < count; j++ ) {
+        ak_uint8 *key = keys +j*bkey->count;
+        if( bkey->count == ak_galois256_size ) ak_gf256_mul( key, key, values +j*bkey->count );
+          else ak_gf512_mul( key, key, values +j*bkey->count );
+        for( i = 0; i < ( bkey->count >> 3 ); i++ ) ((ak_uint64 *)key)[i] ^= element[i];
      }
   }
+ return ak_error_ok;
+}
 
-  if(( error = ak_hash_ptr( &bkey->ctx, bkey->data, memsize,
-                                    bkey->icode, 32 )) != ak_error_ok ) ak_blomkey_destroy( bkey );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на выработку группы ключей абонентов. */
+ typedef struct blom_batch {
+  /*! \brief Мастер-ключ (ключ абонента при выработке ключей парной связи). */
+   ak_blomkey matrix;
+  /*! \brief Массив создаваемых ключей (NULL, если ключи сразу экспортируются в файлы). */
+   ak_blomkey keys;
+  /*! \brief Массив указателей на идентификаторы абонентов. */
+   ak_pointer *ids;
+  /*! \brief Массив длин идентификаторов. */
+   const size_t *idsizes;
+  /*! \brief Общее количество абонентов. */
+   size_t count;
+  /*! \brief Номер первого блока абонентов, обрабатываемого заданием. */
+   size_t first;
+  /*! \brief Шаг перебора блоков абонентов. */
+   size_t step;
+  /*! \brief Пароль для экспорта ключей. */
+   const char *password;
+  /*! \brief Длина пароля. */
+   size_t pass_size;
+  /*! \brief Память для имен созданных файлов. */
+   char *filenames;
+  /*! \brief Размер памяти для имени одного файла. */
+   size_t fsize;
+  /*! \brief Память для ключей парной связи (NULL, если вырабатываются ключи абонентов). */
+   ak_uint8 *pairwise;
+  /*! \brief Код ошибки, возникшей при выполнении задания. */
+   int error;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что задание выполняется вспомогательным потоком. */
+   bool_t threaded;
+#endif
+} *ak_blom_batch;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно вычисляет блоки ключей парной связи, входящие в задание.
+
+    Ключ абонента используется всеми потоками только для чтения; для вычисления хеш-кодов
+    идентификаторов каждое задание создает собственный контекст хеш-функции.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_blom_batch_pairwise_update( ak_blom_batch bb )
+{
+  size_t i = 0, n = 0;
+  struct hash ctx;
+  int error = ak_error_ok;
+
+  if(( error = ak_hash_create_oid( &ctx, bb->matrix->ctx.oid )) != ak_error_ok ) {
+    bb->error = ak_error_message( error, __func__, "incorrect creation of hash function context" );
+    return;
+  }
+  for( i = bb->first*ak_blomkey_batch_block; i < bb->count;
+                                                       i += bb->step*ak_blomkey_batch_block ) {
+     n = ak_min( ak_blomkey_batch_block, bb->count - i );
+     if(( error = ak_blomkey_set_pairwise_keys( bb->matrix, &ctx, bb->ids +i, bb->idsizes +i,
+                                   n, bb->pairwise +i*bb->matrix->count )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect calculation of pairwise keys" );
+       break;
+     }
+  }
+  ak_hash_destroy( &ctx );
+  bb->error = error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно обрабатывает блоки абонентов, входящие в задание.
+
+    Для каждого блока вычисляются степени хеш-кодов идентификаторов и ключевые данные абонентов;
+    при экспорте созданные ключи сразу сохраняются в файлы и уничтожаются, после чего
+    обрабатывается следующий блок.                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_blom_batch_update( ak_blom_batch bb )
+{
+  int error = ak_error_ok;
+  ak_uint8 *powers = NULL;
+  struct blomkey local[ak_blomkey_batch_block];
+  size_t i = 0, j = 0, n = 0, memsize = bb->matrix->size*bb->matrix->count;
+
+  if( bb->pairwise != NULL ) {
+    ak_blom_batch_pairwise_update( bb );
+    return;
+  }
+  if(( powers = malloc( ak_blomkey_batch_block*memsize )) == NULL ) {
+    bb->error = ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    return;
+  }
+  for( i = bb->first*ak_blomkey_batch_block; i < bb->count;
+                                                       i += bb->step*ak_blomkey_batch_block ) {
+     ak_blomkey keys = ( bb->keys == NULL ) ? local : bb->keys +i;
+     n = ak_min( ak_blomkey_batch_block, bb->count - i );
+
+     for( j = 0; j < n; j++ ) {
+        if(( error = ak_blomkey_create_abonent_powers( keys +j, bb->matrix,
+                                   bb->ids[i+j], bb->idsizes[i+j], powers +j*memsize )) != ak_error_ok ) {
+          ak_error_message( error, __func__, "incorrect creation of abonent's key" );
+          ak_blomkey_destroy( keys +j );
+          for( ; j > 0; j-- ) ak_blomkey_destroy( keys +j-1 );
+          break;
+        }
+     }
+     if( error != ak_error_ok ) break;
+     if(( error = ak_blomkey_set_abonent_data( bb->matrix, keys, powers, n )) != ak_error_ok )
+       ak_error_message( error, __func__, "incorrect calculation of abonent's keys" );
+
+     if( bb->keys == NULL ) { /* экспортируем и уничтожаем созданные ключи */
+       for( j = 0; j < n; j++ ) {
+          if(( error == ak_error_ok ) &&
+             (( error = ak_blomkey_export_to_file_with_password( keys +j, bb->password,
+                     bb->pass_size, bb->filenames +( i+j )*bb->fsize, bb->fsize )) != ak_error_ok ))
+            ak_error_message( error, __func__, "incorrect export of abonent's key" );
+          ak_blomkey_destroy( keys +j );
+       }
+     }
+      else if( error != ak_error_ok ) {
+             for( j = 0; j < n; j++ ) ak_blomkey_destroy( keys +j );
+           }
+     if( error != ak_error_ok ) break;
+  }
+  bb->error = error;
+  free( powers );
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_blom_batch_thread( void *ptr )
+{
+  ak_blom_batch_update(( ak_blom_batch )ptr );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция распределяет выработку ключей между несколькими потоками. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blom_batch_run( ak_blom_batch main_task )
+{
+  size_t threads = 1, blocks = ( main_task->count + ak_blomkey_batch_block - 1 )/ak_blomkey_batch_block;
+#ifdef AK_HAVE_PTHREAD_H
+  size_t i = 0;
+  ak_blom_batch tasks = NULL;
+#endif
+
+  threads = ak_max( 1, ak_min( ak_libakrypt_get_threads_count(), blocks ));
+  main_task->first = 0;
+  main_task->step = threads;
+  main_task->error = ak_error_ok;
+#ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && (( tasks = malloc(( threads-1 )*sizeof( struct blom_batch ))) != NULL )) {
+    for( i = 0; i < threads-1; i++ ) {
+       tasks[i] = *main_task;
+       tasks[i].first = i+1;
+       tasks[i].threaded = ak_false;
+       if( pthread_create( &tasks[i].thread, NULL, ak_blom_batch_thread, tasks+i ) == 0 )
+         tasks[i].threaded = ak_true;
+        else {
+          ak_error_message( ak_error_undefined_function, __func__, "wrong creation of a thread" );
+         /* обрабатываем задание самостоятельно */
+          ak_blom_batch_update( tasks+i );
+        }
+    }
+    ak_blom_batch_update( main_task );
+    for( i = 0; i < threads-1; i++ ) {
+       if( tasks[i].threaded ) pthread_join( tasks[i].thread, NULL );
+       if( main_task->error == ak_error_ok ) main_task->error = tasks[i].error;
+    }
+    free( tasks );
+  }
+   else {
+     main_task->step = 1;
+     ak_blom_batch_update( main_task );
+   }
+#else
+  main_task->step = 1;
+  ak_blom_batch_update( main_task );
+#endif
+ return main_task->error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключи для `count` абонентов; результат совпадает с результатом
+    последовательных вызовов функции ak_blomkey_create_abonent_key().
+
+    Целостность мастер-ключа проверяется один раз. Абоненты разбиваются на блоки,
+    для каждого блока ключевые данные вычисляются как произведение мастер-ключа на матрицу
+    степеней хеш-кодов идентификаторов. При наличии поддержки потоков блоки распределяются
+    между несколькими потоками (количество потоков определяется опцией `threads_count`).
+
+    \param bkeys массив из `count` контекстов создаваемых ключей абонентов
+    \param matrix указатель на контекст мастер-ключа
+    \param ids массив из `count` указателей на идентификаторы абонентов
+    \param idsizes массив из `count` длин идентификаторов (в октетах)
+    \param count количество абонентов
+    \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха,
+    в противном случае возвращается код ошибки; при этом ни один из ключей не создается.          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_blomkey_create_abonent_keys( ak_blomkey bkeys, ak_blomkey matrix,
+                           ak_pointer *ids, const size_t *idsizes, const size_t count )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+  struct blom_batch task;
+
+  if( bkeys == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                 "using null pointer to array of abonent's keys" );
+  if( matrix == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                         "using null pointer to blom master key" );
+  if( matrix->type != blom_matrix_key ) return ak_error_message( ak_error_wrong_key_type,
+                                                   __func__, "incorrect type of blom secret key" );
+  if(( ids == NULL ) || ( idsizes == NULL )) return ak_error_message( ak_error_null_pointer,
+                                          __func__, "using null pointer to array of identifiers" );
+  if( !count ) return ak_error_ok;
+  if( !ak_blomkey_check_icode( matrix ))
+    return ak_error_message( ak_error_get_value(), __func__, "using wrong blom master key" );
+
+  memset( bkeys, 0, count*sizeof( struct blomkey ));
+  memset( &task, 0, sizeof( struct blom_batch ));
+  task.matrix = matrix;
+  task.keys = bkeys;
+  task.ids = ids;
+  task.idsizes = idsizes;
+  task.count = count;
+  if(( error = ak_blom_batch_run( &task )) != ak_error_ok ) {
+   /* уничтожаем ключи, созданные другими потоками */
+    for( i = 0; i < count; i++ )
+       if( bkeys[i].data != NULL ) ak_blomkey_destroy( bkeys +i );
+    return ak_error_message( error, __func__, "incorrect creation of abonent's keys" );
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключи для `count` абонентов и сохраняет каждый из них в отдельный
+    файл с помощью функции ak_blomkey_export_to_file_with_password(); ключи в памяти
+    не накапливаются.
+
+    Абоненты разбиваются на блоки, ключи которых вычисляются одним умножением матриц.
+    Ключи каждого блока экспортируются сразу после вычисления; при наличии поддержки потоков
+    блоки обрабатываются несколькими потоками, так что экспорт одних ключей выполняется
+    одновременно с вычислением других.
+
+    \param matrix указатель на контекст мастер-ключа
+    \param ids массив из `count` указателей на идентификаторы абонентов
+    \param idsizes массив из `count` длин идентификаторов (в октетах)
+    \param count количество абонентов
+    \param password пароль, из которого вырабатываются ключи шифрования ключей
+    \param pass_size длина пароля (в октетах)
+    \param filenames указатель на область памяти размером `count`*`fsize` октетов,
+    в которую помещаются сформированные имена файлов; имя файла с ключом абонента
+    с номером `i` располагается по смещению `i`*`fsize`.
+    \param fsize размер памяти для имени одного файла
+    \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха,
+    в противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_blomkey_export_abonent_keys_to_files_with_password( ak_blomkey matrix,
+                           ak_pointer *ids, const size_t *idsizes, const size_t count,
+                const char *password, const size_t pass_size, char *filenames, const size_t fsize )
+{
+  int error = ak_error_ok;
+  struct blom_batch task;
+
+  if( matrix == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                         "using null pointer to blom master key" );
+  if( matrix->type != blom_matrix_key ) return ak_error_message( ak_error_wrong_key_type,
+                                                   __func__, "incorrect type of blom secret key" );
+  if(( ids == NULL ) || ( idsizes == NULL )) return ak_error_message( ak_error_null_pointer,
+                                          __func__, "using null pointer to array of identifiers" );
+  if(( filenames == NULL ) || ( !fsize )) return ak_error_message( ak_error_null_pointer,
+                                              __func__, "using undefined memory for file names" );
+  if( !count ) return ak_error_ok;
+  if( !ak_blomkey_check_icode( matrix ))
+    return ak_error_message( ak_error_get_value(), __func__, "using wrong blom master key" );
+
+  memset( &task, 0, sizeof( struct blom_batch ));
+  task.matrix = matrix;
+  task.ids = ids;
+  task.idsizes = idsizes;
+  task.count = count;
+  task.password = password;
+  task.pass_size = pass_size;
+  task.filenames = filenames;
+  task.fsize = fsize;
+  if(( error = ak_blom_batch_run( &task )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect export of abonent's keys" );
  return error;
 }
 
@@ -300,9 +719,6 @@
  int ak_blomkey_create_pairwise_key_as_ptr( ak_blomkey bkey,
                                ak_pointer id, const size_t idsize, ak_pointer key, size_t keysize )
 {
-  ak_uint32 i = 0;
-  ak_int32 row = 0;
-  ak_uint8 value[64];
   int error = ak_error_ok;
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
@@ -318,21 +734,67 @@
   if( !ak_blomkey_check_icode( bkey ))
     return ak_error_message( ak_error_get_value(), __func__, "using wrong blom master key" );
 
- /* формируем хэш от идентификатора */
-  if(( error = ak_hash_ptr( &bkey->ctx, id, idsize, value, bkey->count )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect evauation of initial hash value" );
-
-  memset( key, 0, bkey->count );
-  for( row = bkey->size - 1; row >= 0; row-- ) {
-     ak_uint8 *element = ak_blomkey_get_element_by_index( bkey, row, 0 );
-     if( bkey->count == ak_galois256_size ) ak_gf256_mul( key, key, value );
-       else ak_gf512_mul( key, key, value );
-     for( i = 0; i < ( bkey->count >> 3 ); i++ ) ((ak_uint64 *)key)[i] ^= ((ak_uint64 *)element)[i];
-  }
+  if(( error = ak_blomkey_set_pairwise_keys( bkey, &bkey->ctx,
+                                              &id, &idsize, 1, key )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect calculation of pairwise key" );
 
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключи парной связи абонента с `count` абонентами; результат совпадает
+    с результатом последовательных вызовов функции ak_blomkey_create_pairwise_key_as_ptr().
+
+    Целостность ключа абонента проверяется один раз. Многочлен, определяемый ключом абонента,
+    вычисляется одновременно в точках, соответствующих блоку идентификаторов; при наличии
+    поддержки потоков блоки распределяются между несколькими потоками
+    (количество потоков определяется опцией `threads_count`).
+
+    \param bkey указатель на контекст ключа абонента
+    \param ids массив из `count` указателей на идентификаторы абонентов, с которыми
+    вырабатываются ключи парной связи
+    \param idsizes массив из `count` длин идентификаторов (в октетах)
+    \param count количество абонентов
+    \param keys указатель на область памяти, в которую помещаются ключи парной связи;
+    ключ для абонента с номером `i` располагается по смещению `i`*`bkey->count`.
+    \param keysize размер доступной области памяти (в октетах); данное значение должно быть
+     не менее, чем `count`*`bkey->count`
+    \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха,
+    в противном случае возвращается код ошибки; при этом область памяти `keys` обнуляется.        */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_blomkey_create_pairwise_keys_as_ptr( ak_blomkey bkey, ak_pointer *ids,
+                       const size_t *idsizes, const size_t count, ak_pointer keys, size_t keysize )
+{
+  int error = ak_error_ok;
+  struct blom_batch task;
+
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to abonent's key" );
+  if( bkey->type != blom_abonent_key ) return ak_error_message( ak_error_wrong_key_type,
+                                                   __func__, "incorrect type of blom secret key" );
+  if(( ids == NULL ) || ( idsizes == NULL )) return ak_error_message( ak_error_null_pointer,
+                                          __func__, "using null pointer to array of identifiers" );
+  if( keys == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to array of pairwise keys" );
+  if( keysize/bkey->count < count ) return ak_error_message( ak_error_wrong_length, __func__,
+                                           "insufficient memory size for storing pairwise keys" );
+  if( !count ) return ak_error_ok;
+  if( !ak_blomkey_check_icode( bkey ))
+    return ak_error_message( ak_error_get_value(), __func__, "using wrong blom abonent's key" );
+
+  memset( &task, 0, sizeof( struct blom_batch ));
+  task.matrix = bkey;
+  task.ids = ids;
+  task.idsizes = idsizes;
+  task.count = count;
+  task.pairwise = keys;
+  if(( error = ak_blom_batch_run( &task )) != ak_error_ok ) {
+    memset( keys, 0, count*bkey->count );
+    return ak_error_message( error, __func__, "incorrect creation of pairwise keys" );
+  }
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param bkey указатель на контекст мастер-ключа или ключа абонента
     \param row номер строки
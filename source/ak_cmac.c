@@ -8,6 +8,92 @@
  #ifdef AK_HAVE_ERRNO_H
   #include <errno.h>
  #endif
+ #ifdef AK_HAVE_STDALIGN_H
+  #include <stdalign.h>
+ #endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает дополнительные ключи, накладываемые на последний блок сообщения:
+    `k1` используется для полного блока, `k2` -- для неполного.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_bckey_cmac_subkeys( ak_bckey bkey, const ak_int64 oc, ak_uint64 *k1, ak_uint64 *k2 )
+{
+  ak_int64
+        #ifdef AK_LITTLE_ENDIAN
+           one64[2] = { 0x02, 0x00 };
+        #else
+           one64[2] = { 0x0200000000000000LL, 0x00 };
+        #endif
+
+  k1[0] = k1[1] = 0;
+  k2[0] = k2[1] = 0;
+  bkey->encrypt( &bkey->key, k1, k1 );
+  switch( bkey->bsize ) {
+   case  8 :
+            if( oc ) k1[0] = bswap_64( k1[0] );
+            ak_gf64_mul( k1, k1, one64 );
+            ak_gf64_mul( k2, k1, one64 );
+          break;
+
+   case 16 :
+            if( oc ) {
+              ak_uint64 tmp = bswap_64( k1[0] );
+              k1[0] = bswap_64( k1[1] );
+              k1[1] = tmp;
+            }
+            ak_gf128_mul( k1, k1, one64 );
+            ak_gf128_mul( k2, k1, one64 );
+          break;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция накладывает на текущее состояние `yaout` последний (возможно, неполный)
+    блок сообщения длины `tail` октетов вместе с соответствующим дополнительным ключом.
+    При `tail` равном нулю указатель `inptr` не используется и может быть равен `NULL`.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_bckey_cmac_last_block( ak_bckey bkey, const ak_int64 oc, ak_uint64 *yaout,
+                       const ak_uint64 *k1, const ak_uint64 *k2, ak_uint64 *inptr, ak_int64 tail )
+{
+  ak_int64 i = 0;
+  ak_uint64 akey[2];
+
+  if( tail < (ak_int64) bkey->bsize ) {
+    akey[0] = k2[0]; akey[1] = k2[1];
+    ((ak_uint8 *)akey)[tail] ^= 0x80;
+  }
+   else { akey[0] = k1[0]; akey[1] = k1[1]; }
+
+  switch( bkey->bsize ) {
+   case  8 :
+            if( oc ) {
+              ak_int64 xlen = (8 - tail) << 3;
+              yaout[0] ^= bswap_64( akey[0] );
+             /* мы заменяем цикл
+                    for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[7-i] ^= ((ak_uint8 *)inptr)[tail-1-i];
+                на двоичный сдвиг; для сообщения нулевой длины данные отсутствуют */
+              if( tail ) yaout[0] ^= (((*inptr) >> xlen) << xlen );
+            }
+              else {
+               yaout[0] ^= akey[0];
+               for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[i] ^= ((ak_uint8 *)inptr)[i];
+              }
+          break;
+
+   case 16 :
+            if( oc ) {
+               yaout[0] ^= bswap_64( akey[1] );
+               yaout[1] ^= bswap_64( akey[0] );
+               for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[15-i] ^= ((ak_uint8 *)inptr)[tail-1-i];
+            }
+             else {
+              yaout[0] ^= akey[0];
+              yaout[1] ^= akey[1];
+              for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[i] ^= ((ak_uint8 *)inptr)[i];
+             }
+          break;
+  }
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет имитовставку от заданной области памяти фиксированного размера.
@@ -34,14 +120,9 @@
                                           const size_t size, ak_pointer out, const size_t out_size )
 {
   ak_int64 i = 0, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" ),
-        #ifdef AK_LITTLE_ENDIAN
-           one64[2] = { 0x02, 0x00 },
-        #else
-           one64[2] = { 0x0200000000000000LL, 0x00 },
-        #endif
            blocks = (ak_int64)size/bkey->bsize,
            tail = (ak_int64)size%bkey->bsize;
- ak_uint64 yaout[2], akey[2], *inptr = (ak_uint64 *)in;
+ ak_uint64 yaout[2], akey[2], k1[2], k2[2], *inptr = (ak_uint64 *)in;
 
  /* мы разрешаем вычисление имитовставки от данных нулевой длины
   if( !size ) return ak_error_message( ak_error_zero_length, __func__,
@@ -63,7 +144,6 @@
    else /* уменьшаем ресурс ключа */
      bkey->key.resource.value.counter -= ak_max( 1, ( blocks + ( tail > 0 )));
 
-  memset( akey, 0, sizeof( akey ));
   memset( yaout, 0, sizeof( yaout ));
  /* последний блок всегда существует, за исключением случая, когда входные данные равны нулю */
   if(( tail == 0 ) && ( blocks > 0 )) { tail = bkey->bsize; blocks--; }
@@ -76,31 +156,6 @@
                yaout[0] ^= inptr[0];
                bkey->encrypt( &bkey->key, yaout, yaout );
             }
-
-          /* теперь ключи для завершения алгоритма */
-            bkey->encrypt( &bkey->key, akey, akey );
-            if( oc ) akey[0] = bswap_64( akey[0] );
-            ak_gf64_mul( akey, akey, one64 );
-
-            if( tail < (ak_int64) bkey->bsize ) {
-              ak_gf64_mul( akey, akey, one64 );
-              ((ak_uint8 *)akey)[tail] ^= 0x80;
-            }
-
-          /* теперь шифруем последний блок */
-            if( oc ) {
-              ak_int64 xlen = (8 - tail) << 3;
-              yaout[0] ^= bswap_64( akey[0] );
-             /* мы заменяем цикл
-                    for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[7-i] ^= ((ak_uint8 *)inptr)[tail-1-i];
-                на двоичный сдвиг */
-              yaout[0] ^= (((*inptr) >> xlen) << xlen );
-            }
-              else {
-               yaout[0] ^= akey[0];
-               for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[i] ^= ((ak_uint8 *)inptr)[i];
-              }
-            bkey->encrypt( &bkey->key, yaout, akey );
           break;
 
    case 16 :
@@ -110,35 +165,14 @@
                yaout[1] ^= inptr[1];
                bkey->encrypt( &bkey->key, yaout, yaout );
             }
-
-          /* вырабатываем ключи для завершения алгортма */
-            bkey->encrypt( &bkey->key, akey, akey );
-            if( oc ) {
-              ak_uint64 tmp = bswap_64( akey[0] );
-              akey[0] = bswap_64( akey[1] );
-              akey[1] = tmp;
-            }
-            ak_gf128_mul( akey, akey, one64 );
-            if( tail < (ak_int64) bkey->bsize ) {
-              ak_gf128_mul( akey, akey, one64 );
-              ((ak_uint8 *)akey)[tail] ^= 0x80;
-            }
-
-          /* теперь шифруем последний блок*/
-            if( oc ) {
-               yaout[0] ^= bswap_64( akey[1] );
-               yaout[1] ^= bswap_64( akey[0] );
-               for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[15-i] ^= ((ak_uint8 *)inptr)[tail-1-i];
-            }
-             else {
-              yaout[0] ^= akey[0];
-              yaout[1] ^= akey[1];
-              for( i = 0; i < tail; i++ ) ((ak_uint8 *)yaout)[i] ^= ((ak_uint8 *)inptr)[i];
-             }
-            bkey->encrypt( &bkey->key, yaout, akey );
           break;
   }
 
+ /* теперь ключи для завершения алгоритма и шифрование последнего блока */
+  ak_bckey_cmac_subkeys( bkey, oc, k1, k2 );
+  ak_bckey_cmac_last_block( bkey, oc, yaout, k1, k2, inptr, tail );
+  bkey->encrypt( &bkey->key, yaout, akey );
+
  /* копируем нужную часть результирующего массива и завершаем работу */
  if( oc ) memcpy( out, (ak_uint8 *)akey, ak_min( out_size, bkey->bsize ));
   else memcpy( out, (ak_uint8 *)akey+( out_size > bkey->bsize ? 0 : bkey->bsize-out_size ),
@@ -146,6 +180,150 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество сообщений, обрабатываемых одновременно функцией ak_bckey_cmac_multi(). */
+ #define ak_cmac_multi_lanes                   (8)
+
+/*! \brief Текущее состояние обработки одного сообщения в функции ak_bckey_cmac_multi(). */
+ typedef struct cmac_lane {
+  /*! \brief Порядковый номер сообщения. */
+   size_t idx;
+  /*! \brief Указатель на следующий необработанный блок сообщения. */
+   ak_uint64 *inptr;
+  /*! \brief Количество оставшихся блоков сообщения (без учета последнего). */
+   ak_int64 blocks;
+  /*! \brief Длина последнего блока сообщения. */
+   ak_int64 tail;
+} *ak_cmac_lane;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет имитовставки для `count` независимых сообщений, используя один и тот же ключ.
+    Результат совпадает с последовательным вызовом функции ak_bckey_cmac() для каждого сообщения.
+
+    Цепочки шифрования в режиме выработки имитовставки не допускают параллельной обработки
+    блоков одного сообщения, однако цепочки различных сообщений независимы. Функция одновременно
+    ведет до \ref ak_cmac_multi_lanes цепочек: на каждом шаге очередные блоки всех обрабатываемых
+    сообщений зашифровываются одним вызовом многоблочной функции зашифрования (при ее наличии),
+    а место завершенного сообщения сразу занимает следующее.
+
+    Проверка целостности ключа, изменение его ресурса, выработка дополнительных ключей
+    и перемаскирование ключа выполняются однократно для всей совокупности сообщений.
+
+    @param bkey Ключ алгоритма блочного шифрования, используемый для выработки имитовставки.
+    @param count Количество сообщений.
+    @param in Массив из `count` указателей на сообщения.
+    @param size Массив из `count` длин сообщений (в октетах); допускаются сообщения нулевой длины.
+    @param out Область памяти, куда последовательно помещаются `count` значений имитовставки,
+    каждое длины `out_size` октетов. Память должна быть заранее выделена.
+    @param out_size Ожидаемый размер одной имитовставки.
+
+   @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+   возвращается \ref ak_error_ok (ноль)                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_cmac_multi( ak_bckey bkey, const size_t count, ak_pointer *in,
+                                   const size_t *size, ak_pointer out, const size_t out_size )
+{
+  int error = ak_error_ok;
+  ak_int64 oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" ), total = 0;
+  size_t i = 0, j = 0, next = 0, active = 0, stride = 0;
+#ifdef AK_HAVE_STDALIGN_H
+ #ifndef AK_HAVE_WINDOWS_H
+  alignas(16)
+ #endif
+#endif
+  ak_uint64 y[2*ak_cmac_multi_lanes], akey[2], k1[2], k2[2];
+  struct cmac_lane lanes[ak_cmac_multi_lanes];
+  bool_t last[ak_cmac_multi_lanes];
+
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                            "using null pointer to secret key" );
+  if( !count ) return ak_error_ok;
+  if(( in == NULL ) || ( size == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                  __func__, "using null pointer to input data" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to result buffer" );
+  if( !out_size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                            "using zero length of result buffer" );
+ /* проверяем целостность ключа */
+  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                                  "incorrect integrity code of secret key value" );
+ /* уменьшаем значение ресурса ключа сразу для всех сообщений */
+  for( i = 0; i < count; i++ ) {
+     if(( size[i] > 0 ) && ( in[i] == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                   __func__, "using null pointer to a message" );
+     total += ak_max( 1, ( ak_int64 )(( size[i] + bkey->bsize - 1 )/bkey->bsize ));
+  }
+  if( bkey->key.resource.value.counter < total )
+    return ak_error_message( ak_error_low_key_resource, __func__ ,
+                                                              "low resource of block cipher key" );
+   else bkey->key.resource.value.counter -= total;
+
+ /* дополнительные ключи одинаковы для всех сообщений */
+  ak_bckey_cmac_subkeys( bkey, oc, k1, k2 );
+  stride = bkey->bsize >> 3;
+
+  while(( next < count ) || ( active > 0 )) {
+   /* заполняем освободившиеся места новыми сообщениями */
+    while(( active < ak_cmac_multi_lanes ) && ( next < count )) {
+       lanes[active].idx = next;
+       lanes[active].inptr = ( ak_uint64 *)in[next];
+       lanes[active].blocks = ( ak_int64 )( size[next]/bkey->bsize );
+       lanes[active].tail = ( ak_int64 )( size[next]%bkey->bsize );
+       if(( lanes[active].tail == 0 ) && ( lanes[active].blocks > 0 )) {
+         lanes[active].tail = bkey->bsize;
+         lanes[active].blocks--;
+       }
+       y[active*stride] = 0;
+       y[active*stride + stride-1] = 0;
+       active++; next++;
+    }
+
+   /* добавляем очередные блоки сообщений к текущим состояниям */
+    for( j = 0; j < active; j++ ) {
+       ak_uint64 *yptr = y + j*stride;
+       if(( last[j] = ( lanes[j].blocks == 0 ))) {
+         ak_bckey_cmac_last_block( bkey, oc, yptr, k1, k2, lanes[j].inptr, lanes[j].tail );
+         continue;
+       }
+       for( i = 0; i < stride; i++ ) yptr[i] ^= lanes[j].inptr[i];
+       lanes[j].inptr += stride;
+       lanes[j].blocks--;
+    }
+
+   /* зашифровываем все состояния одновременно */
+    if( bkey->encrypt_blocks != NULL ) bkey->encrypt_blocks( &bkey->key, y, y, active );
+     else for( j = 0; j < active; j++ ) bkey->encrypt( &bkey->key, y + j*stride, y + j*stride );
+
+   /* выводим результаты для завершенных сообщений и освобождаем их места */
+    for( j = active; j > 0; j-- ) {
+       ak_uint8 *optr = NULL;
+       if( !last[j-1] ) continue;
+
+       akey[0] = y[(j-1)*stride]; akey[1] = y[(j-1)*stride + stride-1];
+       optr = ( ak_uint8 *)out + lanes[j-1].idx*out_size;
+       if( oc ) memcpy( optr, (ak_uint8 *)akey, ak_min( out_size, bkey->bsize ));
+        else memcpy( optr, (ak_uint8 *)akey+( out_size > bkey->bsize ? 0 : bkey->bsize-out_size ),
+                                                                  ak_min( out_size, bkey->bsize ));
+       if( j < active ) { /* перемещаем последнее состояние на освободившееся место */
+         lanes[j-1] = lanes[active-1];
+         last[j-1] = last[active-1];
+         for( i = 0; i < stride; i++ ) y[(j-1)*stride + i] = y[(active-1)*stride + i];
+       }
+       active--;
+    }
+  }
+
+  ak_ptr_wipe( y, sizeof( y ), &bkey->key.generator );
+  ak_ptr_wipe( k1, sizeof( k1 ), &bkey->key.generator );
+  ak_ptr_wipe( k2, sizeof( k2 ), &bkey->key.generator );
+ /* перемаскируем ключ */
+  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong remasking of secret key" );
+
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Алгоритм вычисления имитовставки может быть представлен в виде последовательного вызова
     трех функций
@@ -446,6 +624,42 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Данные, передаваемые функции обработки фрагментов файла. */
+ struct bckey_cmac_file_stream {
+  /*! \brief Контекст ключа алгоритма блочного шифрования */
+   ak_bckey key;
+  /*! \brief Область памяти для результата */
+   ak_pointer out;
+  /*! \brief Размер области памяти для результата */
+   size_t out_size;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает очередной фрагмент файла, считанный функцией ak_file_read_stream();
+    последний фрагмент, содержащий не менее одного блока, завершает вычисление имитовставки.     */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_cmac_file_stream_function( const ak_pointer data, const size_t size,
+                                                                       bool_t last, ak_pointer ptr )
+{
+  int error = ak_error_ok;
+  struct bckey_cmac_file_stream *st = ( struct bckey_cmac_file_stream * ) ptr;
+  size_t qcnt = size / st->key->bsize,
+         tail = size - qcnt*st->key->bsize;
+
+  if( !last ) return ak_bckey_cmac_update( st->key, data, size );
+  if( tail == 0 ) {
+    if( qcnt > 0 ) { qcnt--; tail = st->key->bsize; }
+      else return ak_error_message( ak_error_read_data, __func__,
+                                                                "unexpected length of input data");
+  }
+  if( qcnt && (( error = ak_bckey_cmac_update( st->key, data,
+                                            qcnt*st->key->bsize )) != ak_error_ok ))
+    return ak_error_message( error, __func__, "incorrect updating of last fragment" );
+ return ak_bckey_cmac_finalize( st->key, ( ak_uint8 * )data + qcnt*st->key->bsize, tail,
+                                                                          st->out, st->out_size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \note Реализация данной функции не использует методы класса \ref mac, поскольку
     функция ak_bckey_cmac_finalize() не может принимать данные нелевой длины.
@@ -463,9 +677,9 @@
 {
   struct file file;
   int error = ak_error_ok;
+  file_stream_t method = file_stream_read;
   size_t block_size = 4096; /* оптимальная длина блока для Windows, по-прежнему, не ясна */
-  ak_int64 len = 0, readlen = 0;
-  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+  struct bckey_cmac_file_stream st;
 
  /* выполняем необходимые проверки */
   if( key == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -481,40 +695,15 @@
     ak_file_close( &file );
     return ak_bckey_cmac( key, NULL, 0, out, out_size );
   }
- /* готовим область для хранения данных */
-  block_size = ak_max( ( size_t )file.blksize, 512 );
- /* здесь мы выделяем локальный буффер для считывания/обработки данных */
-  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
-    ak_file_close( &file );
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
-                                                      "memory allocation error for local buffer" );
-  }
 
  /* теперь обрабатываем файл с данными */
   ak_bckey_cmac_clean( key );
-  read_label:
-   readlen += ( len = ( size_t ) ak_file_read( &file, localbuffer, block_size ));
-   if( readlen == file.size ) { /* считан последний большой блок */
-     size_t qcnt = len / key->bsize,
-            tail = len - qcnt*key->bsize;
-     if( tail == 0 ) {
-       if( qcnt > 0 ) { qcnt--; tail = key->bsize; }
-         else {
-           error = ak_error_message( ak_error_read_data, __func__,
-                                                           "unexpected length of input data");
-           goto labex;
-         }
-     }
-     if( qcnt ) ak_bckey_cmac_update( key, localbuffer, qcnt*key->bsize );
-     error = ak_bckey_cmac_finalize(key, localbuffer + qcnt*key->bsize, tail, out, out_size );
-   }
-    else {
-           ak_bckey_cmac_update( key, localbuffer, len );
-           goto read_label;
-         }
-  labex:
-   if( localbuffer != NULL ) ak_aligned_free( localbuffer );
-   ak_file_close( &file );
+  method = ak_libakrypt_get_file_stream_method( &file, file.size,
+                                                         ak_max( key->bsize, 512 ), &block_size );
+  st.key = key; st.out = out; st.out_size = out_size;
+  error = ak_file_read_stream( &file, 0, -1, block_size,
+                                                method, ak_bckey_cmac_file_stream_function, &st );
+  ak_file_close( &file );
  return error;
 }
 
@@ -542,10 +731,10 @@
 {
   struct file file;
   int error = ak_error_ok;
-  ssize_t result;
-  size_t len = 0, total_len = 0;
+  ak_int64 total_len = 0;
+  file_stream_t method = file_stream_read;
   size_t block_size = 4096; /* оптимальная длина блока для Windows, по-прежнему, не ясна */
-  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+  struct bckey_cmac_file_stream st;
 
  /* выполняем необходимые проверки */
   if( key == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -571,54 +760,14 @@
     return ak_bckey_cmac( key, NULL, 0, out, out_size );
   }
 
- /* сдвигаем указатель на заданое число байт */
-  if(( ak_file_lseek( &file, offset, SEEK_SET )) == -1 ) {
-    ak_file_close( &file );
-    return ak_error_message( ak_error_lseek_file, __func__, "incorrect seeking to offset" );
-  }
-
- /* готовим область для хранения данных */
-  block_size = ak_max( ( size_t )file.blksize, 512 );
- /* здесь мы выделяем локальный буффер для считывания/обработки данных */
-  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
-    ak_file_close( &file );
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
-                                                      "memory allocation error for local buffer" );
-  }
-
  /* теперь обрабатываем файл с данными */
   ak_bckey_cmac_clean( key );
-  read_label:
-   result = ak_file_read( &file, localbuffer, ak_min( total_len, block_size ));
-   if( result < 0 ) {
-     error = ak_error_message( ak_error_read_data, __func__,
-                                                        "incorrect reading a block of input data");
-     goto labex;
-   }
-    else len = ( size_t ) result;
-
-   if( len == total_len ) { /* считан последний большой блок */
-     size_t qcnt = len / key->bsize,
-            tail = len - qcnt*key->bsize;
-     if( tail == 0 ) {
-       if( qcnt > 0 ) { qcnt--; tail = key->bsize; }
-         else {
-           error = ak_error_message( ak_error_read_data, __func__,
-                                                           "unexpected length of input data");
-           goto labex;
-         }
-     }
-     if( qcnt ) ak_bckey_cmac_update( key, localbuffer, qcnt*key->bsize );
-     error = ak_bckey_cmac_finalize(key, localbuffer + qcnt*key->bsize, tail, out, out_size );
-   }
-    else {
-           ak_bckey_cmac_update( key, localbuffer, len );
-           total_len -= len;
-           goto read_label;
-         }
-  labex:
-   if( localbuffer != NULL ) ak_aligned_free( localbuffer );
-   ak_file_close( &file );
+  method = ak_libakrypt_get_file_stream_method( &file, total_len,
+                                                         ak_max( key->bsize, 512 ), &block_size );
+  st.key = key; st.out = out; st.out_size = out_size;
+  error = ak_file_read_stream( &file, offset, total_len, block_size,
+                                                method, ak_bckey_cmac_file_stream_function, &st );
+  ak_file_close( &file );
  return error;
 }
 
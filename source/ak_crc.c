@@ -6,6 +6,9 @@
 /*  базируется на коде https://github.com/torvalds/linux/blob/master/lib/gen_crc64table.c          */
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ #include <wmmintrin.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*                               Реализация функций класса crc64                                   */
@@ -154,17 +157,241 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
- static int ak_hash_context_crc64_update( ak_pointer data, const ak_pointer in, const size_t size )
+/*! \brief Таблицы для реализации slicing-by-16: таблица с номером k содержит значения crc64
+    от октета, за которым следуют k нулевых октетов; нулевая таблица совпадает с CRC64_TABLE. */
+ static ak_uint64 crc64_slice_table[16][256];
+/*! \brief Флаг того, что таблицы crc64_slice_table вычислены. */
+ static bool_t crc64_slice_table_ready = ak_false;
+
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+/*! \brief Константы свертки: \f$ x^{192}, x^{128}, x^{576}, x^{512} \pmod{p(x)} \f$. */
+ static ak_uint64 crc64_fold_k[4];
+/*! \brief Младшие 64 бита частного \f$ \lfloor x^{128}/p(x) \rfloor \f$ (константа Барретта). */
+ static ak_uint64 crc64_barrett_mu;
+/*! \brief Флаг использования команды pclmulqdq, устанавливается функцией
+    ak_hash_crc64_set_cpu_level(). */
+ static bool_t crc64_clmul_enabled = ak_false;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение двух многочленов по модулю многочлена crc64. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_crc64_mulmod( ak_uint64 a, ak_uint64 b )
+{
+  int i = 0;
+  ak_uint64 r = 0;
+
+  for( i = 63; i >= 0; i-- ) {
+     r = ( r << 1 ) ^ (( r >> 63 ) ? CRC64_ECMA182_POLY : 0 );
+     if(( b >> i )&1 ) r ^= a;
+  }
+ return r;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ x^n \pmod{p(x)} \f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_crc64_xpow( ak_uint64 n )
 {
-    size_t i = 0;
-    const ak_uint8 *_p = in;
-    ak_uint64 crc64 = *(ak_uint64 *)data;
+  ak_uint64 r = 1, x = 2;
 
-    for( i = 0; i < size; i++ ) {
-       ak_uint8 t = (( crc64 >> 56) ^ ( *_p++ )) & 0xFF;
-       crc64 = CRC64_TABLE[t] ^ (crc64 << 8);
+  while( n ) {
+    if( n&1 ) r = ak_crc64_mulmod( r, x );
+    x = ak_crc64_mulmod( x, x );
+    n >>= 1;
+  }
+ return r;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет таблицы, используемые для ускоренной реализации алгоритма crc64.
+    Вызывается один раз при инициализации библиотеки.
+
+    @return Функция возвращает \ref ak_error_ok.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_crc64_init_tables( void )
+{
+  size_t i = 0, k = 0;
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+  ak_uint64 r = 0, carry = 0, mu = 0;
+#endif
+
+  if( crc64_slice_table_ready ) return ak_error_ok;
+  memcpy( crc64_slice_table[0], CRC64_TABLE, sizeof( CRC64_TABLE ));
+  for( k = 1; k < 16; k++ )
+    for( i = 0; i < 256; i++ ) {
+       ak_uint64 t = crc64_slice_table[k-1][i];
+       crc64_slice_table[k][i] = CRC64_TABLE[t >> 56] ^ ( t << 8 );
     }
-    *(ak_uint64 *)data = crc64;
+
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+  crc64_fold_k[0] = ak_crc64_xpow( 192 );
+  crc64_fold_k[1] = ak_crc64_xpow( 128 );
+  crc64_fold_k[2] = ak_crc64_xpow( 576 );
+  crc64_fold_k[3] = ak_crc64_xpow( 512 );
+
+ /* делим x^{128} на p(x): старший бит частного (при x^{64}) не сохраняется */
+  for( i = 0; i <= 128; i++ ) {
+     carry = r >> 63;
+     r = ( r << 1 ) | ( i == 0 );
+     if( carry ) r ^= CRC64_ECMA182_POLY;
+     if( i > 64 ) mu = ( mu << 1 ) | carry;
+  }
+  crc64_barrett_mu = mu;
+#endif
+  crc64_slice_table_ready = ak_true;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Считывание восьми октетов как целого числа в формате big endian. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_crc64_load( const ak_uint8 *p )
+{
+  ak_uint64 w;
+  memcpy( &w, p, 8 );
+#ifdef AK_LITTLE_ENDIAN
+  return bswap_64( w );
+#else
+  return w;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Простейшая реализация: один октет за одно обращение к таблице. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_crc64_update_bytes( ak_uint64 crc64, const ak_uint8 *p, size_t size )
+{
+  while( size-- ) crc64 = CRC64_TABLE[(( crc64 >> 56 ) ^ ( *p++ ))&0xFF] ^ ( crc64 << 8 );
+ return crc64;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Реализация slicing-by-16 (с дополнительным шагом slicing-by-8 для хвоста). */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_crc64_update_slice( ak_uint64 crc64, const ak_uint8 *p, size_t size )
+{
+  ak_uint64 a, b;
+  const ak_uint64 (*t)[256] = ( const ak_uint64 (*)[256] ) crc64_slice_table;
+
+  while( size >= 16 ) {
+    a = ak_crc64_load( p ) ^ crc64;
+    b = ak_crc64_load( p+8 );
+    crc64 = t[15][a >> 56] ^ t[14][( a >> 48 )&0xFF] ^ t[13][( a >> 40 )&0xFF] ^
+            t[12][( a >> 32 )&0xFF] ^ t[11][( a >> 24 )&0xFF] ^ t[10][( a >> 16 )&0xFF] ^
+            t[9][( a >> 8 )&0xFF] ^ t[8][a&0xFF] ^
+            t[7][b >> 56] ^ t[6][( b >> 48 )&0xFF] ^ t[5][( b >> 40 )&0xFF] ^
+            t[4][( b >> 32 )&0xFF] ^ t[3][( b >> 24 )&0xFF] ^ t[2][( b >> 16 )&0xFF] ^
+            t[1][( b >> 8 )&0xFF] ^ t[0][b&0xFF];
+    p += 16; size -= 16;
+  }
+  if( size >= 8 ) {
+    a = ak_crc64_load( p ) ^ crc64;
+    crc64 = t[7][a >> 56] ^ t[6][( a >> 48 )&0xFF] ^ t[5][( a >> 40 )&0xFF] ^
+            t[4][( a >> 32 )&0xFF] ^ t[3][( a >> 24 )&0xFF] ^ t[2][( a >> 16 )&0xFF] ^
+            t[1][( a >> 8 )&0xFF] ^ t[0][a&0xFF];
+    p += 8; size -= 8;
+  }
+ return ak_crc64_update_bytes( crc64, p, size );
+}
+
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Считывание 16 октетов как многочлена степени не выше 127
+    (первый октет содержит старшие коэффициенты). */
+ #define ak_crc64_load128( p ) _mm_set_epi64x( (long long int) ak_crc64_load( p ), \
+                                               (long long int) ak_crc64_load( (p)+8 ))
+/*! \brief Свертка: \f$ x_h\cdot k_h \oplus x_l\cdot k_l \f$. */
+ #define ak_crc64_fold( x, k ) _mm_xor_si128( _mm_clmulepi64_si128( x, k, 0x11 ), \
+                                               _mm_clmulepi64_si128( x, k, 0x00 ))
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Реализация с использованием умножения многочленов (команда pclmulqdq).
+    \details Данные обрабатываются четырьмя независимыми 128-битными потоками, которые
+    сворачиваются на расстояние 64 октета; затем потоки сворачиваются в один и полученный
+    128-битный многочлен приводится по модулю \f$ p(x) \f$ с помощью алгоритма Барретта.
+    Функция предполагает, что размер данных не менее 64 октетов.                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_target_pclmul static ak_uint64 ak_crc64_update_clmul( ak_uint64 crc64,
+                                                                 const ak_uint8 *p, size_t size )
+{
+  ak_uint64 v[2], w[2], q;
+  __m128i x0, x1, x2, x3, t,
+          k1 = _mm_set_epi64x( (long long int) crc64_fold_k[0], (long long int) crc64_fold_k[1] ),
+          k4 = _mm_set_epi64x( (long long int) crc64_fold_k[2], (long long int) crc64_fold_k[3] );
+
+  x0 = _mm_xor_si128( ak_crc64_load128( p ), _mm_set_epi64x( (long long int) crc64, 0 ));
+  x1 = ak_crc64_load128( p+16 );
+  x2 = ak_crc64_load128( p+32 );
+  x3 = ak_crc64_load128( p+48 );
+  p += 64; size -= 64;
+
+  while( size >= 64 ) {
+    x0 = _mm_xor_si128( ak_crc64_fold( x0, k4 ), ak_crc64_load128( p ));
+    x1 = _mm_xor_si128( ak_crc64_fold( x1, k4 ), ak_crc64_load128( p+16 ));
+    x2 = _mm_xor_si128( ak_crc64_fold( x2, k4 ), ak_crc64_load128( p+32 ));
+    x3 = _mm_xor_si128( ak_crc64_fold( x3, k4 ), ak_crc64_load128( p+48 ));
+    p += 64; size -= 64;
+  }
+  x0 = _mm_xor_si128( ak_crc64_fold( x0, k1 ), x1 );
+  x0 = _mm_xor_si128( ak_crc64_fold( x0, k1 ), x2 );
+  x0 = _mm_xor_si128( ak_crc64_fold( x0, k1 ), x3 );
+  while( size >= 16 ) {
+    x0 = _mm_xor_si128( ak_crc64_fold( x0, k1 ), ak_crc64_load128( p ));
+    p += 16; size -= 16;
+  }
+
+ /* вычисляем x0(x)*x^{64} mod p(x) */
+  _mm_storeu_si128( (__m128i *)v, x0 );
+  t = _mm_clmulepi64_si128( _mm_set_epi64x( 0, (long long int) v[1] ), k1, 0x00 );
+  _mm_storeu_si128( (__m128i *)v, _mm_xor_si128( t, _mm_set_epi64x( (long long int) v[0], 0 )));
+ /* приведение Барретта */
+  t = _mm_clmulepi64_si128( _mm_set_epi64x( 0, (long long int) v[1] ),
+                                 _mm_set_epi64x( 0, (long long int) crc64_barrett_mu ), 0x00 );
+  _mm_storeu_si128( (__m128i *)w, t );
+  q = w[1] ^ v[1];
+  t = _mm_clmulepi64_si128( _mm_set_epi64x( 0, (long long int) q ),
+                                 _mm_set_epi64x( 0, (long long int) CRC64_ECMA182_POLY ), 0x00 );
+  _mm_storeu_si128( (__m128i *)w, t );
+  crc64 = v[0] ^ w[0];
+
+ return ak_crc64_update_slice( crc64, p, size );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выбор реализации в зависимости от длины данных и возможностей процессора. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_crc64_update( ak_uint64 crc64, const ak_uint8 *p, size_t size )
+{
+  if( !crc64_slice_table_ready ) return ak_crc64_update_bytes( crc64, p, size );
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+  if( crc64_clmul_enabled && ( size >= 64 )) return ak_crc64_update_clmul( crc64, p, size );
+#endif
+ return ak_crc64_update_slice( crc64, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается при инициализации библиотеки, а также при изменении уровня реализации
+    вычислительных ядер.
+
+    @param level Максимальный допустимый уровень реализации.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hash_crc64_set_cpu_level( cpu_level_t level )
+{
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+  crc64_clmul_enabled = (( level >= cpu_level_pclmul ) &&
+             ( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul )) ? ak_true : ak_false;
+#else
+  (void)level;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_context_crc64_update( ak_pointer data, const ak_pointer in, const size_t size )
+{
+    *(ak_uint64 *)data = ak_crc64_update( *(ak_uint64 *)data, in, size );
 
  return ak_error_ok;
 }
@@ -206,3 +433,96 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение crc64 для объединения двух последовательно расположенных
+    фрагментов данных \f$ A \| B \f$ по известным значениям crc64 для каждого из фрагментов.
+    Поскольку начальное значение crc64 равно нулю, выполнено равенство
+    \f$ crc(A \| B) = crc(A)\cdot x^{8|B|} \oplus crc(B) \pmod{p(x)} \f$; вычисление
+    требует \f$ O(\log |B|) \f$ умножений многочленов.
+
+    Функция позволяет вычислять контрольную сумму больших файлов, обрабатывая их
+    фрагменты независимо (например, в нескольких потоках).
+
+    @param crc1 Значение crc64 для первого фрагмента (восемь октетов, вычисленных функцией
+    хеширования crc64, интерпретируемые как целое число).
+    @param crc2 Значение crc64 для второго фрагмента.
+    @param size2 Длина второго фрагмента в октетах.
+    @return Значение crc64 для объединения фрагментов.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint64 ak_hash_crc64_combine( ak_uint64 crc1, ak_uint64 crc2, ak_uint64 size2 )
+{
+  ak_uint64 r = 1, x = ak_crc64_xpow( 8 );
+
+  if( !size2 ) return crc1;
+ /* вычисляем x^{8*size2}, не допуская переполнения при умножении size2 на 8 */
+  while( size2 ) {
+    if( size2&1 ) r = ak_crc64_mulmod( r, x );
+    x = ak_crc64_mulmod( x, x );
+    size2 >>= 1;
+  }
+ return ak_crc64_mulmod( crc1, r ) ^ crc2;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет значение crc64 на контрольном примере, совпадение результатов всех
+    реализаций алгоритма, а также корректность функции ak_hash_crc64_combine().
+
+    @return Если тестирование прошло успешно возвращается \ref ak_true (истина). В противном
+    случае возвращается \ref ak_false.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_crc64( void )
+{
+  size_t i = 0, j = 0;
+  ak_uint8 data[1031];
+  ak_uint64 value = 0, crc = 0, crc1 = 0, crc2 = 0;
+  int audit = ak_log_get_level();
+
+ /* контрольный пример */
+  if(( value = ak_crc64_update( 0, (ak_uint8 *)"123456789", 9 )) != 0x6C40DF5F0B497347LL ) {
+    ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                                "wrong crc64 value for control example (%016llx)", (unsigned long long)value );
+    return ak_false;
+  }
+
+ /* сравниваем реализации для различных длин и выравниваний */
+  for( i = 0; i < sizeof( data ); i++ ) data[i] = (ak_uint8)( i*i + 17*i + 5 );
+  for( i = 0; i < 19; i++ ) {
+     for( j = 0; j + i < sizeof( data ); j += 1 + j/3 ) {
+        value = ak_crc64_update_bytes( 0x0123456789abcdefLL, data+i, j );
+        if(( crc = ak_crc64_update( 0x0123456789abcdefLL, data+i, j )) != value ) {
+          ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                       "different crc64 values for offset %u and length %u",
+                                                            (unsigned int) i, (unsigned int) j );
+          return ak_false;
+        }
+       #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+       /* реализация с pclmulqdq проверяется независимо от выбранного уровня */
+        if(( j >= 64 ) && crc64_slice_table_ready &&
+           ( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul ) &&
+           ( ak_crc64_update_clmul( 0x0123456789abcdefLL, data+i, j ) != value )) {
+          ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                       "wrong pclmulqdq crc64 value for offset %u and length %u",
+                                                            (unsigned int) i, (unsigned int) j );
+          return ak_false;
+        }
+       #endif
+     }
+  }
+
+ /* проверяем вычисление crc64 для объединения фрагментов */
+  value = ak_crc64_update( 0, data, sizeof( data ));
+  for( i = 0; i < sizeof( data ); i += 97 ) {
+     crc1 = ak_crc64_update( 0, data, i );
+     crc2 = ak_crc64_update( 0, data+i, sizeof( data ) - i );
+     if( ak_hash_crc64_combine( crc1, crc2, sizeof( data ) - i ) != value ) {
+       ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                                  "wrong combination of crc64 values at offset %u", (unsigned int) i );
+       return ak_false;
+     }
+  }
+  if( audit >= ak_log_maximum )
+    ak_error_message( ak_error_ok, __func__ , "testing crc64 implementations is Ok" );
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
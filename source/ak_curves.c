@@ -4,9 +4,14 @@
 /*  Файл ak_curves.с                                                                               */
 /*  - содержит реализацию функций для работы с эллиптическими кривыми.                             */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
 #ifdef AK_HAVE_STRING_H
  #include <string.h>
 #else
@@ -15,6 +20,9 @@
 #ifdef AK_HAVE_STRINGS_H
  #include <strings.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет величину \f$\Delta \equiv -16(4a^3 + 27b^2) \pmod{p} \f$, зависящую
@@ -597,9 +605,7 @@
    return;
  }
 
- ak_mpzn_set_ui( u, ec->size, 2 );
- ak_mpzn_sub( u, ec->p, u, ec->size );
- ak_mpzn_modpow_montgomery( u, wp->z, u, ec->p, ec->n, ec->size ); // u <- z^{p-2} (mod p)
+ ak_mpzn_inverse_montgomery( u, wp->z, ec->p, ec->n, ec->r2, ec->size ); // u <- z^{-1} (mod p)
  ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
 
  ak_mpzn_mul_montgomery( wp->x, wp->x, u, ec->p, ec->n, ec->size );
@@ -608,26 +614,347 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
-    функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
-    равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
+/*       реализация операций с точками эллиптической кривой в искривленной форме Эдвардса          */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Кривая Эдвардса используется вместо кривой в форме Вейерштрасса, если значение опции
+    `use_twisted_edwards` равно единице, а коэффициенты и модуль кривой совпадают с параметрами
+    одной из кривых, для которых определена эквивалентная кривая в искривленной форме Эдвардса.
 
-    При вычислении используется метод `лесенки Монтгомери`, выравнивающий время работы алгоритма
-    вне зависимости от вида числа \f$ k \f$.
+    @param wc Эллиптическая кривая в короткой форме Вейерштрасса.
+    @return Указатель на параметры эквивалентной кривой или NULL, если такой кривой нет.          */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_ecurve ak_wcurve_get_ecurve( ak_wcurve wc )
+{
+  size_t i = 0;
+  static const struct ecurve *ecurves[] = {
+    &id_tc26_gost_3410_2012_256_paramSetA_edwards,
+    &id_tc26_gost_3410_2012_512_paramSetC_edwards,
+    NULL
+  };
+
+  if( wc == NULL ) return NULL;
+  if( ak_libakrypt_get_option_by_name( "use_twisted_edwards" ) != 1 ) return NULL;
+  for( i = 0; ecurves[i] != NULL; i++ ) {
+     ak_wcurve ec = ecurves[i]->wc;
+     if(( ec == wc ) || (( ec->size == wc->size ) &&
+        ( memcmp( ec->p, wc->p, ec->size*sizeof( ak_uint64 )) == 0 ) &&
+        ( memcmp( ec->a, wc->a, ec->size*sizeof( ak_uint64 )) == 0 ) &&
+        ( memcmp( ec->b, wc->b, ec->size*sizeof( ak_uint64 )) == 0 )))
+       return ( ak_ecurve ) ecurves[i];
+  }
+ return NULL;
+}
 
-    \b Для \b информации:
-     \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
-     \li Исходная точка \f$ P \f$ и результирующая точка \f$ Q \f$ могут совпадать.
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление разности вычетов \f$ z \equiv x - y \pmod{p} \f$. */
+ static inline void ak_ecurve_sub( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, ak_ecurve ed )
+{
+  ak_mpznmax u;
+  ak_mpzn_sub( u, ed->wc->p, y, ed->wc->size );
+  ak_mpzn_add_montgomery( z, x, u, ed->wc->p, ed->wc->size );
+}
 
-    @param wq Точка \f$ Q \f$, в которую помещается результат.
-    @param wp Точка \f$ P \f$, которая возводится в степень.
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Маска, все биты которой равны единице, если вычет равен нулю (без ветвлений). */
+ static inline ak_uint64 ak_ecurve_zero_mask( ak_uint64 *x, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 acc = 0;
+  for( i = 0; i < size; i++ ) acc |= x[i];
+ return (( acc|( 0 - acc )) >> 63 ) - 1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ep Точка, которой присваивается значение нейтрального элемента \f$ (0:1:0:1) \f$.
+    @param ed Эллиптическая кривая в искривленной форме Эдвардса.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_epoint_set_as_unit( ak_epoint ep, ak_ecurve ed )
+{
+  ak_mpzn_set_ui( ep->x, ed->wc->size, 0 );
+  ak_mpzn_set_ui( ep->y, ed->wc->size, 1 );
+  ak_mpzn_set_ui( ep->t, ed->wc->size, 0 );
+  ak_mpzn_set_ui( ep->z, ed->wc->size, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проективные координаты \f$ (U:V:W) \f$ образа точки кривой в форме Вейерштрасса.
+
+    Для точки \f$ (X:Y:Z) \f$ полагается \f$ A = X - tZ\f$, \f$ B = sZ \f$, тогда
+    \f$ U = A(A+B) \f$, \f$ V = (A-B)Y \f$, \f$ W = (A+B)Y \f$. Функция не применима
+    к бесконечно удаленной точке и точке второго порядка \f$ (t, 0) \f$.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_ecurve_map_wpoint( ak_uint64 *u, ak_uint64 *v, ak_uint64 *w,
+                                                                  ak_wpoint wp, ak_ecurve ed )
+{
+  ak_wcurve wc = ed->wc;
+  ak_mpznmax a, b, c;
+
+  ak_mpzn_mul_montgomery( a, ed->t, wp->z, wc->p, wc->n, wc->size );
+  ak_ecurve_sub( a, wp->x, a, ed );
+  ak_mpzn_mul_montgomery( b, ed->s, wp->z, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( c, a, b, wc->p, wc->size );
+  ak_ecurve_sub( b, a, b, ed );
+  ak_mpzn_mul_montgomery( u, a, c, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( v, b, wp->y, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( w, c, wp->y, wc->p, wc->n, wc->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет расширенные координаты образа точки кривой в короткой форме Вейерштрасса.
+    Бесконечно удаленная точка переводится в нейтральный элемент \f$ (0:1:0:1) \f$,
+    точка второго порядка \f$ (t, 0) \f$ - в точку \f$ (0:-1:0:1) \f$.
+
+    @param ep Точка кривой Эдвардса, в которую помещается результат.
+    @param wp Точка кривой в короткой форме Вейерштрасса.
+    @param ed Эллиптическая кривая в искривленной форме Эдвардса.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_epoint_set_wpoint( ak_epoint ep, ak_wpoint wp, ak_ecurve ed )
+{
+  ak_wcurve wc = ed->wc;
+  ak_mpznmax u, v, w;
+
+  if( ak_mpzn_cmp_ui( wp->z, wc->size, 0 )) {
+    ak_epoint_set_as_unit( ep, ed );
+    return;
+  }
+  if( ak_mpzn_cmp_ui( wp->y, wc->size, 0 )) {
+    ak_epoint_set_as_unit( ep, ed );
+    ak_mpzn_sub( ep->y, wc->p, ep->y, wc->size );
+    return;
+  }
+  ak_ecurve_map_wpoint( u, v, w, wp, ed );
+  ak_mpzn_mul_montgomery( ep->x, u, w, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->y, v, w, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->t, u, v, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->z, w, w, wc->p, wc->n, wc->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет проективные координаты образа точки \f$ (X:Y:T:Z) \f$ кривой Эдвардса
+    на кривой в короткой форме Вейерштрасса:
+    \f$ z = (Z-Y)X \f$, \f$ x = s(Z+Y)X + tz \f$, \f$ y = s(Z+Y)Z \f$.
+    Нейтральный элемент переводится в бесконечно удаленную точку, точка \f$ (0:-1:0:1) \f$ -
+    в точку второго порядка \f$ (t, 0) \f$; выбор результата выполняется без ветвлений.
+
+    @param wp Точка кривой в короткой форме Вейерштрасса, в которую помещается результат.
+    @param ep Точка кривой Эдвардса.
+    @param ed Эллиптическая кривая в искривленной форме Эдвардса.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_set_epoint( ak_wpoint wp, ak_epoint ep, ak_ecurve ed )
+{
+  size_t i = 0;
+  ak_wcurve wc = ed->wc;
+  ak_mpznmax a, b, one = ak_mpznmax_one;
+  ak_uint64 mask = 0;
+
+  ak_mpzn_add_montgomery( a, ep->z, ep->y, wc->p, wc->size );
+  ak_ecurve_sub( b, ep->z, ep->y, ed );
+  ak_mpzn_mul_montgomery( a, a, ed->s, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( wp->z, b, ep->x, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( wp->y, a, ep->z, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( a, a, ep->x, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( b, ed->t, wp->z, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( wp->x, a, b, wc->p, wc->size );
+
+ /* для точки второго порядка все три координаты равны нулю; заменяем их на (t:0:1) */
+  ak_mpzn_mul_montgomery( one, one, wc->r2, wc->p, wc->n, wc->size ); /* r (mod p) */
+  mask = ak_ecurve_zero_mask( wp->y, wc->size );
+  for( i = 0; i < wc->size; i++ ) {
+     wp->x[i] ^= mask&( wp->x[i]^ed->t[i] );
+     wp->z[i] ^= mask&( wp->z[i]^one[i] );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет выполнение сравнений \f$ (X^2 + Y^2)Z^2 \equiv Z^4 + dX^2Y^2 \pmod{p} \f$
+    и \f$ TZ \equiv XY \pmod{p} \f$.
+
+    @param ep Точка кривой Эдвардса.
+    @param ed Эллиптическая кривая в искривленной форме Эдвардса.
+    @return Функция возвращает \ref ak_true, если точка принадлежит кривой. В противном случае
+    возвращается \ref ak_false.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_epoint_is_ok( ak_epoint ep, ak_ecurve ed )
+{
+  ak_wcurve wc = ed->wc;
+  ak_mpznmax xx, yy, zz, l, r;
+
+  if( ak_mpzn_cmp_ui( ep->z, wc->size, 0 )) return ak_false;
+  ak_mpzn_mul_montgomery( xx, ep->x, ep->x, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( yy, ep->y, ep->y, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( zz, ep->z, ep->z, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( l, xx, yy, wc->p, wc->size );
+  ak_mpzn_mul_montgomery( l, l, zz, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( r, xx, yy, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( r, r, ed->d, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( zz, zz, zz, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( r, r, zz, wc->p, wc->size );
+  if( ak_mpzn_cmp( l, r, wc->size )) return ak_false;
+
+  ak_mpzn_mul_montgomery( l, ep->t, ep->z, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( r, ep->x, ep->y, wc->p, wc->n, wc->size );
+  if( ak_mpzn_cmp( l, r, wc->size )) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Точка кривой Эдвардса \f$ P = (X:Y:T:Z) \f$ заменяется значением \f$ 2P \f$.
+    Используются соотношения dbl-2008-hwcd из работы H.Hisil, K.Wong, G.Carter, E.Dawson
+    <a href="http://eprint.iacr.org/2008/522">Twisted Edwards curves revisited</a>, 2008,
+    применимые к любой точке кривой (4 умножения и 4 возведения в квадрат).
+
+    \code
+      A = X^2
+      B = Y^2
+      C = 2*Z^2
+      E = (X+Y)^2-A-B
+      G = A+B
+      F = G-C
+      H = A-B
+      X3 = E*F
+      Y3 = G*H
+      T3 = E*H
+      Z3 = F*G
+    \endcode
+
+    @param ep удваиваемая точка \f$ P \f$.
+    @param ed эллиптическая кривая, которой принадлежит точка \f$P\f$.                             */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_epoint_double( ak_epoint ep, ak_ecurve ed )
+{
+  ak_wcurve wc = ed->wc;
+  ak_mpznmax a, b, c, e, f, g, h;
+
+  ak_mpzn_mul_montgomery( a, ep->x, ep->x, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( b, ep->y, ep->y, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( c, ep->z, ep->z, wc->p, wc->n, wc->size );
+  ak_mpzn_lshift_montgomery( c, c, wc->p, wc->size );
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, wc->p, wc->size );
+  ak_mpzn_mul_montgomery( e, e, e, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( g, a, b, wc->p, wc->size );
+  ak_ecurve_sub( e, e, g, ed );
+  ak_ecurve_sub( f, g, c, ed );
+  ak_ecurve_sub( h, a, b, ed );
+  ak_mpzn_mul_montgomery( ep->x, e, f, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->y, g, h, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->t, e, h, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->z, f, g, wc->p, wc->n, wc->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точки \f$ P \f$ с точкой \f$ Q \f$, для которой вместо координаты
+    \f$ T_2 \f$ задано произведение \f$ dT_2 \f$.
+
+    Если указатель z2 равен NULL, то точка \f$ Q \f$ задана в аффинных координатах
+    (\f$ Z_2 \f$ равна единице в представлении Монтгомери) и одно умножение не выполняется.     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_add_prepared( ak_epoint ep, ak_uint64 *x2, ak_uint64 *y2,
+                                                  ak_uint64 *dt2, ak_uint64 *z2, ak_ecurve ed )
+{
+  ak_wcurve wc = ed->wc;
+  ak_mpznmax a, b, c, d, e, f, g, h;
+
+  ak_mpzn_mul_montgomery( a, ep->x, x2, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( b, ep->y, y2, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( c, ep->t, dt2, wc->p, wc->n, wc->size );
+  if( z2 == NULL ) ak_mpzn_set( d, ep->z, wc->size );
+   else ak_mpzn_mul_montgomery( d, ep->z, z2, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, wc->p, wc->size );
+  ak_mpzn_add_montgomery( f, x2, y2, wc->p, wc->size );
+  ak_mpzn_mul_montgomery( e, e, f, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( g, a, b, wc->p, wc->size );
+  ak_ecurve_sub( e, e, g, ed );
+  ak_ecurve_sub( f, d, c, ed );
+  ak_mpzn_add_montgomery( g, d, c, wc->p, wc->size );
+  ak_ecurve_sub( h, b, a, ed );
+  ak_mpzn_mul_montgomery( ep->x, e, f, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->y, g, h, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->t, e, h, wc->p, wc->n, wc->size );
+  ak_mpzn_mul_montgomery( ep->z, f, g, wc->p, wc->n, wc->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для двух точек кривой Эдвардса \f$ P = (X_1:Y_1:T_1:Z_1) \f$ и \f$ Q = (X_2:Y_2:T_2:Z_2)\f$
+    вычисляется сумма \f$ P+Q \f$, которая присваивается точке \f$ P\f$.
+    Используются полные формулы add-2008-hwcd из работы H.Hisil, K.Wong, G.Carter, E.Dawson
+    <a href="http://eprint.iacr.org/2008/522">Twisted Edwards curves revisited</a>, 2008.
+    Формулы применимы к любым двум точкам кривой, в том числе совпадающим, поэтому
+    функция не содержит ветвлений.
+
+    \code
+      A = X1*X2
+      B = Y1*Y2
+      C = T1*d*T2
+      D = Z1*Z2
+      E = (X1+Y1)*(X2+Y2)-A-B
+      F = D-C
+      G = D+C
+      H = B-A
+      X3 = E*F
+      Y3 = G*H
+      T3 = E*H
+      Z3 = F*G
+    \endcode
+
+    @param ep1 Точка \f$ P \f$, в которую помещается результат операции сложения; первое слагаемое
+    @param ep2 Точка \f$ Q \f$, второе слагаемое
+    @param ed Эллиптическая кривая, которой принадлежат складываемые точки                         */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_epoint_add( ak_epoint ep1, ak_epoint ep2, ak_ecurve ed )
+{
+  ak_mpznmax dt;
+
+  ak_mpzn_mul_montgomery( dt, ep2->t, ed->d, ed->wc->p, ed->wc->n, ed->wc->size );
+  ak_epoint_add_prepared( ep1, ep2->x, ep2->y, dt, ep2->z, ed );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для заданной точки \f$ P \f$ кривой Эдвардса и целого числа \f$ k \f$ функция вычисляет
+    кратную точку \f$ Q = [k]P\f$ методом `лесенки Монтгомери`. Поскольку формулы сложения
+    полны, время работы функции и порядок обращения к памяти не зависят от значения \f$ k \f$.
+
+    @param eq Точка \f$ Q \f$, в которую помещается результат.
+    @param ep Точка \f$ P \f$.
     @param k Степень кратности.
-    @param size Размер степени \f$ k \f$ в машинных словах - значение, как правило,
-    задаваемое константой \ref ak_mpzn256_size или \ref ak_mpzn512_size. В общем случае
-    может приниимать любое неотрицательное значение.
-    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ed Эллиптическая кривая в искривленной форме Эдвардса.                                  */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_wpoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
+ void ak_epoint_pow( ak_epoint eq, ak_epoint ep, ak_uint64 *k, size_t size, ak_ecurve ed )
+{
+  size_t l = 0;
+  ak_uint64 uk = 0, mask = 0;
+  long long int i, j;
+  struct epoint P[2];
+  ak_uint64 *w0 = ( ak_uint64 *)&P[0], *w1 = ( ak_uint64 *)&P[1], tmp;
+
+  ak_epoint_set_as_unit( &P[0], ed );
+  memcpy( &P[1], ep, sizeof( struct epoint ));
+  for( i = size-1; i >= 0; i-- ) {
+     uk = k[i];
+     for( j = 0; j < 64; j++ ) {
+       /* при единичном бите меняем точки местами, выполняем шаг лесенки и меняем обратно */
+        mask = 0 - ( uk >> 63 );
+        for( l = 0; l < sizeof( struct epoint )/sizeof( ak_uint64 ); l++ ) {
+           tmp = mask&( w0[l]^w1[l] ); w0[l] ^= tmp; w1[l] ^= tmp;
+        }
+        ak_epoint_add( &P[1], &P[0], ed );
+        ak_epoint_double( &P[0], ed );
+        for( l = 0; l < sizeof( struct epoint )/sizeof( ak_uint64 ); l++ ) {
+           tmp = mask&( w0[l]^w1[l] ); w0[l] ^= tmp; w1[l] ^= tmp;
+        }
+        uk <<= 1;
+     }
+  }
+  memcpy( eq, &P[0], sizeof( struct epoint ));
+  memset( P, 0, sizeof( P ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление кратной точки кривой в короткой форме Вейерштрасса
+    методом `лесенки Монтгомери`. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_pow_weierstrass( ak_wpoint wq, ak_wpoint wp,
+                                                       ak_uint64 *k, size_t size, ak_wcurve ec )
 {
   ak_uint64 uk = 0;
   long long int i, j;
@@ -650,6 +977,646 @@
   ak_wpoint_set_wpoint( wq, &Q, ec );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
+    функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
+    равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
+
+    При вычислении используется метод `лесенки Монтгомери`, выравнивающий время работы алгоритма
+    вне зависимости от вида числа \f$ k \f$. Если для кривой определена эквивалентная кривая
+    в искривленной форме Эдвардса (см. функцию ak_wcurve_get_ecurve()), то вычисления выполняются
+    на ней с помощью функции ak_epoint_pow().
+
+    \b Для \b информации:
+     \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+     \li Исходная точка \f$ P \f$ и результирующая точка \f$ Q \f$ могут совпадать.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$, которая возводится в степень.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах - значение, как правило,
+    задаваемое константой \ref ak_mpzn256_size или \ref ak_mpzn512_size. В общем случае
+    может приниимать любое неотрицательное значение.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  struct epoint ep;
+  ak_ecurve ed = ak_wcurve_get_ecurve( ec );
+
+  if( ed == NULL ) {
+    ak_wpoint_pow_weierstrass( wq, wp, k, size, ec );
+    return;
+  }
+  ak_epoint_set_wpoint( &ep, wp, ed );
+  ak_epoint_pow( &ep, &ep, k, size, ed );
+  ak_wpoint_set_epoint( wq, &ep, ed );
+  memset( &ep, 0, sizeof( struct epoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*               вычисление кратных образующей точки с помощью предвычисленных таблиц              */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ширина окна (в битах), используемая при вычислении кратных образующей точки. */
+ #define ak_wcurve_window_bits          (5)
+/*! \brief Количество нечетных кратных точки, хранящихся для одного окна. */
+ #define ak_wcurve_window_points       (16)
+
+/*! \brief Таблица кратных образующей точки эллиптической кривой.
+    \details Для каждого окна с номером \f$ i \f$ таблица содержит аффинные координаты точек
+    \f$ [(2j+1)32^i]P\f$, \f$ j = 0, \ldots, 15 \f$, где \f$ P \f$ образующая точка кривой.
+    Координаты хранятся в том же представлении, что и координаты образующей точки.
+    Если таблица вычислена для кривой Эдвардса, то для каждой точки хранятся аффинные
+    координаты \f$ u, v \f$ и произведение \f$ duv \f$ в представлении Монтгомери. */
+ typedef struct wcurve_table {
+  /*! \brief Следующая таблица в списке. */
+   struct wcurve_table *next;
+  /*! \brief Эллиптическая кривая, для которой вычислена таблица. */
+   ak_wcurve ec;
+  /*! \brief Эквивалентная кривая Эдвардса, для точек которой вычислена таблица (или NULL). */
+   ak_ecurve ed;
+  /*! \brief Копия модуля кривой, используемая для проверки соответствия таблицы кривой. */
+   ak_uint64 p[ak_mpzn512_size];
+  /*! \brief Копия коэффициента \f$ a \f$, используемая для проверки соответствия таблицы кривой. */
+   ak_uint64 a[ak_mpzn512_size];
+  /*! \brief Копия образующей точки, используемая для проверки соответствия таблицы кривой. */
+   struct wpoint point;
+  /*! \brief Количество окон. */
+   size_t count;
+  /*! \brief Координаты точек таблицы. */
+   ak_uint64 *data;
+} *ak_wcurve_table;
+
+/*! \brief Список вычисленных таблиц. */
+ static ak_wcurve_table ak_wcurve_tables = NULL;
+#ifdef AK_HAVE_PTHREAD_H
+ static pthread_mutex_t ak_wcurve_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет таблицу кратных образующей точки эллиптической кривой.
+
+    Кратные точки вычисляются в проективных координатах, после чего одновременно приводятся
+    к аффинной форме: для этого вычисляется лишь один обратный элемент (метод Монтгомери).
+
+    @param ec Эллиптическая кривая.
+    @param ed Эквивалентная кривая Эдвардса или NULL, если таблица вычисляется для точек
+    кривой в короткой форме Вейерштрасса.
+    @param count Количество окон.
+    @return Указатель на выделенную память с координатами точек или NULL в случае ошибки.      */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 *ak_wcurve_table_new( ak_wcurve ec, ak_ecurve ed, const size_t count )
+{
+  size_t i = 0, j = 0, total = count*ak_wcurve_window_points;
+  size_t words = ( ed == NULL ? 2 : 3 )*ec->size;
+  struct wpoint base, twice;
+  ak_mpznmax u, inv, one = ak_mpznmax_one;
+  ak_uint64 *data = NULL, *prod = NULL;
+  ak_wpoint pts = NULL;
+
+  if(( data = malloc( total*words*sizeof( ak_uint64 ))) == NULL ) goto labex;
+  if(( prod = malloc( total*ec->size*sizeof( ak_uint64 ))) == NULL ) goto labex;
+  if(( pts = malloc( total*sizeof( struct wpoint ))) == NULL ) goto labex;
+
+ /* вычисляем точки [(2j+1)32^i]P в проективных координатах */
+  ak_wpoint_set( &base, ec );
+  for( i = 0; i < count; i++ ) {
+     ak_wpoint row = pts +i*ak_wcurve_window_points;
+     ak_wpoint_set_wpoint( &twice, &base, ec );
+     ak_wpoint_double( &twice, ec );
+     ak_wpoint_set_wpoint( row, &base, ec );
+     for( j = 1; j < ak_wcurve_window_points; j++ ) {
+        ak_wpoint_set_wpoint( row +j, row +j-1, ec );
+        ak_wpoint_add( row +j, &twice, ec );
+     }
+    /* следующая база равна [31]B + B = [32]B */
+     ak_wpoint_add( &base, row +ak_wcurve_window_points-1, ec );
+  }
+ /* для кривой Эдвардса заменяем точки их образами (u:v:w) */
+  if( ed != NULL ) {
+    for( i = 0; i < total; i++ ) {
+       ak_ecurve_map_wpoint( u, inv, twice.z, pts +i, ed );
+       ak_mpzn_set( pts[i].x, u, ec->size );
+       ak_mpzn_set( pts[i].y, inv, ec->size );
+       ak_mpzn_set( pts[i].z, twice.z, ec->size );
+    }
+  }
+
+ /* одновременное приведение всех точек к аффинной форме */
+  ak_mpzn_set( prod, pts[0].z, ec->size );
+  for( i = 1; i < total; i++ )
+     ak_mpzn_mul_montgomery( prod +i*ec->size, prod +(i-1)*ec->size,
+                                                             pts[i].z, ec->p, ec->n, ec->size );
+  ak_mpzn_inverse_montgomery_vartime( inv,
+                                    prod +(total-1)*ec->size, ec->p, ec->n, ec->r2, ec->size );
+
+  for( i = total; i > 0; i-- ) {
+     ak_uint64 *x = data +( i-1 )*words, *y = x +ec->size;
+     if( i > 1 ) {
+       ak_mpzn_mul_montgomery( u, inv, prod +(i-2)*ec->size, ec->p, ec->n, ec->size );
+       ak_mpzn_mul_montgomery( inv, inv, pts[i-1].z, ec->p, ec->n, ec->size );
+     } else ak_mpzn_set( u, inv, ec->size );
+    /* теперь u содержит обратный элемент к z-координате точки с номером i-1;
+       координаты точек кривой Эдвардса остаются в представлении Монтгомери */
+     if( ed == NULL ) ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
+     ak_mpzn_mul_montgomery( x, pts[i-1].x, u, ec->p, ec->n, ec->size );
+     ak_mpzn_mul_montgomery( y, pts[i-1].y, u, ec->p, ec->n, ec->size );
+     if( ed != NULL ) {
+       ak_mpzn_mul_montgomery( y +ec->size, x, y, ec->p, ec->n, ec->size );
+       ak_mpzn_mul_montgomery( y +ec->size, y +ec->size, ed->d, ec->p, ec->n, ec->size );
+     }
+  }
+  ak_mpzn_set_ui( u, ec->size, 0 );
+  ak_mpzn_set_ui( inv, ec->size, 0 );
+  free( pts ); free( prod );
+ return data;
+
+  labex:
+   ak_error_message( ak_error_out_of_memory, __func__,
+                                          "incorrect memory allocation for table of curve points" );
+   if( pts != NULL ) free( pts );
+   if( prod != NULL ) free( prod );
+   if( data != NULL ) free( data );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает таблицу кратных образующей точки эллиптической кривой.
+    \details Таблица вычисляется при первом обращении и сохраняется до завершения работы
+    с библиотекой (вызова функции ak_libakrypt_destroy()).
+
+    @param ec Эллиптическая кривая.
+    @param ed Эквивалентная кривая Эдвардса или NULL.
+    @param count Количество окон таблицы.
+    @return Указатель на координаты точек таблицы или NULL в случае ошибки.                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 *ak_wcurve_get_table( ak_wcurve ec, ak_ecurve ed, const size_t count )
+{
+  ak_uint64 *data = NULL;
+  ak_wcurve_table wt = NULL;
+  size_t bytes = ec->size*sizeof( ak_uint64 );
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &ak_wcurve_tables_mutex );
+#endif
+  for( wt = ak_wcurve_tables; wt != NULL; wt = wt->next ) {
+     if(( wt->ec == ec ) && ( wt->ed == ed ) && ( wt->count == count ) &&
+        ( memcmp( wt->p, ec->p, bytes ) == 0 ) && ( memcmp( wt->a, ec->a, bytes ) == 0 ) &&
+        ( memcmp( wt->point.x, ec->point.x, bytes ) == 0 ) &&
+        ( memcmp( wt->point.y, ec->point.y, bytes ) == 0 ) &&
+        ( memcmp( wt->point.z, ec->point.z, bytes ) == 0 )) {
+       data = wt->data;
+       break;
+     }
+  }
+  if(( data == NULL ) && (( wt = calloc( 1, sizeof( struct wcurve_table ))) != NULL )) {
+    if(( wt->data = ak_wcurve_table_new( ec, ed, count )) != NULL ) {
+      wt->ec = ec;
+      wt->ed = ed;
+      wt->count = count;
+      memcpy( wt->p, ec->p, bytes );
+      memcpy( wt->a, ec->a, bytes );
+      ak_wpoint_set( &wt->point, ec );
+      wt->next = ak_wcurve_tables;
+      ak_wcurve_tables = wt;
+      data = wt->data;
+    }
+     else free( wt );
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &ak_wcurve_tables_mutex );
+#endif
+ return data;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается при завершении работы с библиотекой.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_destroy_tables( void )
+{
+  ak_wcurve_table wt = NULL;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &ak_wcurve_tables_mutex );
+#endif
+  while(( wt = ak_wcurve_tables ) != NULL ) {
+    ak_wcurve_tables = wt->next;
+    free( wt->data );
+    free( wt );
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &ak_wcurve_tables_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция извлекает из точки таблицы, соответствующей одному окну,
+    точку \f$ [\pm(2j+1)32^i]P \f$.
+    \details Для исключения зависимости времени выполнения и порядка обращения к памяти
+    от значения \f$ j \f$, функция просматривает все точки окна; отрицание точки
+    также выполняется без условных переходов.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_table_select( ak_wpoint wp, const ak_uint64 *row,
+                                         const ak_uint64 idx, const ak_uint64 neg, ak_wcurve ec )
+{
+  size_t j, l;
+  ak_mpznmax ny;
+  ak_uint64 mask = 0;
+
+  ak_mpzn_set_ui( wp->x, ec->size, 0 );
+  ak_mpzn_set_ui( wp->y, ec->size, 0 );
+  for( j = 0; j < ak_wcurve_window_points; j++, row += 2*ec->size ) {
+     mask = 0 - ( ak_uint64 )( j == idx );
+     for( l = 0; l < ec->size; l++ ) {
+        wp->x[l] |= row[l]&mask;
+        wp->y[l] |= row[ec->size +l]&mask;
+     }
+  }
+  ak_mpzn_sub( ny, ec->p, wp->y, ec->size );
+  mask = 0 - neg;
+  for( l = 0; l < ec->size; l++ ) wp->y[l] ^= mask&( wp->y[l]^ny[l] );
+  ak_mpzn_set_ui( wp->z, ec->size, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция извлекает из строки таблицы кривой Эдвардса точку \f$ [\pm(2j+1)32^i]P \f$.
+    \details В точку ep помещаются аффинные координаты \f$ u, v \f$ и, вместо координаты
+    \f$ t \f$, произведение \f$ duv \f$. Отрицание точки сводится к отрицанию
+    величин \f$ u \f$ и \f$ duv \f$.                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_ecurve_table_select( ak_epoint ep, const ak_uint64 *row,
+                                         const ak_uint64 idx, const ak_uint64 neg, ak_ecurve ed )
+{
+  size_t j, l, size = ed->wc->size;
+  ak_mpznmax nx, nt;
+  ak_uint64 mask = 0;
+
+  ak_mpzn_set_ui( ep->x, size, 0 );
+  ak_mpzn_set_ui( ep->y, size, 0 );
+  ak_mpzn_set_ui( ep->t, size, 0 );
+  for( j = 0; j < ak_wcurve_window_points; j++, row += 3*size ) {
+     mask = 0 - ( ak_uint64 )( j == idx );
+     for( l = 0; l < size; l++ ) {
+        ep->x[l] |= row[l]&mask;
+        ep->y[l] |= row[size +l]&mask;
+        ep->t[l] |= row[2*size +l]&mask;
+     }
+  }
+  ak_mpzn_sub( nx, ed->wc->p, ep->x, size );
+  ak_mpzn_sub( nt, ed->wc->p, ep->t, size );
+  mask = 0 - neg;
+  for( l = 0; l < size; l++ ) {
+     ep->x[l] ^= mask&( ep->x[l]^nx[l] );
+     ep->t[l] ^= mask&( ep->t[l]^nt[l] );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для образующей точки \f$ P \f$ эллиптической кривой и заданного целого числа \f$ k \f$
+    функция вычисляет кратную точку \f$ Q = [k]P \f$.
+
+    Для каждой кривой при первом обращении вычисляется таблица кратных точек
+    \f$ [(2j+1)32^i]P \f$, после чего число \f$ k \f$ (или \f$ k + q \f$, если \f$ k \f$ четно)
+    записывается в виде суммы \f$ \sum d_i 32^i\f$ с нечетными коэффициентами
+    \f$ d_i \in \{ \pm 1, \pm 3, \ldots, \pm 31 \}\f$. Поэтому вычисление кратной точки
+    требует только одного сложения на каждые пять бит числа \f$ k \f$ и не требует удвоений.
+    Количество сложений и порядок обращения к таблице не зависят от значения \f$ k \f$.
+
+    Если для кривой определена эквивалентная кривая в искривленной форме Эдвардса, то таблица
+    содержит точки кривой Эдвардса и сложение выполняется по полным формулам для этой кривой.
+    Если таблица не может быть вычислена, используется функция ak_wpoint_pow().
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах; должен совпадать с размером
+    параметров кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_base( ak_wpoint wq, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  long long int i = 0;
+  struct wpoint tp;
+  struct epoint ep, eq;
+  ak_ecurve ed = ak_wcurve_get_ecurve( ec );
+  ak_uint64 *data = NULL, t[ak_mpzn512_size+1], s[ak_mpzn512_size+1], mask, carry;
+  size_t l, count = ( 64*size + ak_wcurve_window_bits )/ak_wcurve_window_bits;
+  size_t words = ( ed == NULL ? 2 : 3 )*size;
+
+  if(( size != ec->size ) || (( data = ak_wcurve_get_table( ec, ed, count )) == NULL )) {
+    ak_wpoint_pow( wq, &ec->point, k, size, ec );
+    return;
+  }
+
+ /* вместо четного k используем нечетное k + q, поскольку [q]P = O */
+  carry = ak_mpzn_add( s, k, ec->q, size );
+  mask = ( k[0]&0x1 ) - 1;
+  for( l = 0; l < size; l++ ) t[l] = k[l]^( mask&( k[l]^s[l] ));
+  t[size] = mask&carry;
+
+ /* суммируем точки таблицы, начиная со старшего окна */
+  for( i = ( long long int )count-1; i >= 0; i-- ) {
+     size_t bit = ( size_t )i*ak_wcurve_window_bits, w = bit >> 6, sh = bit&0x3f;
+     ak_uint64 u = t[w] >> sh, neg = 0, d = 0;
+
+     if(( sh > 58 ) && ( w < size )) u |= t[w+1] << ( 64 - sh );
+     u = ( u&0x3f )|0x1;
+     if( i == ( long long int )count-1 ) d = u; /* старший коэффициент всегда положителен */
+      else {
+        neg = ( u >> 5 )^0x1;
+        d = (( u - 32 )^( 0 - neg )) + neg; /* абсолютное значение коэффициента u - 32 */
+      }
+     if( ed != NULL ) {
+       ak_ecurve_table_select( &ep, data +( size_t )i*ak_wcurve_window_points*words,
+                                                                             d >> 1, neg, ed );
+       if( i != ( long long int )count-1 )
+         ak_epoint_add_prepared( &eq, ep.x, ep.y, ep.t, NULL, ed );
+        else { /* аффинная точка: t = uv, z = 1 (в представлении Монтгомери) */
+          ak_mpzn_set( eq.x, ep.x, size );
+          ak_mpzn_set( eq.y, ep.y, size );
+          ak_mpzn_mul_montgomery( eq.t, ep.x, ep.y, ec->p, ec->n, size );
+          ak_mpzn_set_ui( eq.z, size, 1 );
+          ak_mpzn_mul_montgomery( eq.z, eq.z, ec->r2, ec->p, ec->n, size );
+        }
+     }
+      else {
+        ak_wcurve_table_select( i == ( long long int )count-1 ? wq : &tp,
+                                 data +( size_t )i*ak_wcurve_window_points*words, d >> 1, neg, ec );
+        if( i != ( long long int )count-1 ) ak_wpoint_add( wq, &tp, ec );
+      }
+  }
+  if( ed != NULL ) {
+    ak_wpoint_set_epoint( wq, &eq, ed );
+    memset( &ep, 0, sizeof( struct epoint ));
+    memset( &eq, 0, sizeof( struct epoint ));
+  }
+  memset( t, 0, sizeof( t ));
+  memset( s, 0, sizeof( s ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Представление числа в виде неприлегающей формы с окном ширины 5 (wNAF).
+
+    Число \f$ k \f$ записывается в виде суммы \f$ \sum d_i 2^i \f$, в которой каждый ненулевой
+    коэффициент \f$ d_i \in \{ \pm 1, \pm 3, \ldots, \pm 15 \}\f$ и за ним следуют
+    не менее четырех нулевых коэффициентов.
+
+    @param naf Массив, в который помещаются коэффициенты (младшие коэффициенты первыми);
+    должен содержать не менее \f$ 64\cdot size + 1\f$ элементов.
+    @param k Число \f$ k \f$.
+    @param size Размер числа \f$ k \f$ в машинных словах.
+    @return Функция возвращает количество коэффициентов.                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_wpoint_wnaf( signed char *naf, ak_uint64 *k, size_t size )
+{
+  size_t l, len = 0, top = size;
+  ak_uint64 t[ak_mpzn512_size+1];
+
+  memcpy( t, k, size*sizeof( ak_uint64 ));
+  t[size] = 0;
+  while(( top > 0 ) && ( t[top-1] == 0 )) top--;
+  while( top > 0 ) {
+     int d = 0;
+     if( t[0]&0x1 ) {
+       d = ( int )( t[0]&0x1f );
+       if( d > 15 ) { /* k = k + ( 32 - d ) */
+         d -= 32;
+         if(( t[0] += ( ak_uint64 )( -d )) < ( ak_uint64 )( -d ))
+           for( l = 1; l <= size; l++ ) if( ++t[l] ) break;
+         if(( top <= size ) && t[top] ) top++;
+       }
+        else t[0] -= ( ak_uint64 )d; /* обнуляем младшие биты */
+     }
+     naf[len++] = ( signed char )d;
+     for( l = 0; l+1 < top; l++ ) t[l] = ( t[l] >> 1 )^( t[l+1] << 63 );
+     t[top-1] >>= 1;
+     while(( top > 0 ) && ( t[top-1] == 0 )) top--;
+  }
+ return len;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет нечетные кратные \f$ [1]P, [3]P, \ldots, [15]P \f$ точки \f$ P \f$,
+    используемые функцией ak_wpoint_pow2_multiples().
+
+    @param wt Массив из \ref ak_wpoint_odd_multiples_count точек, в который помещается результат.
+    @param wp Точка \f$ P \f$.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_set_odd_multiples( ak_wpoint wt, ak_wpoint wp, ak_wcurve ec )
+{
+  size_t j = 0;
+  struct wpoint dp;
+
+  ak_wpoint_set_wpoint( &dp, wp, ec );
+  ak_wpoint_double( &dp, ec );
+  ak_wpoint_set_wpoint( wt, wp, ec );
+  for( j = 1; j < ak_wpoint_odd_multiples_count; j++ ) {
+     ak_wpoint_set_wpoint( wt+j, wt+j-1, ec );
+     ak_wpoint_add( wt+j, &dp, ec );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Нечетные кратные образующей точки эллиптической кривой.
+
+    Если для кривой уже вычислена таблица, используемая функцией ak_wpoint_pow_base(),
+    то кратные точки берутся из первой строки таблицы.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_set_base_multiples( ak_wpoint wt, ak_wcurve ec )
+{
+  size_t j = 0;
+  ak_uint64 *data = ak_wcurve_get_table( ec, NULL,
+                                   ( 64*ec->size + ak_wcurve_window_bits )/ak_wcurve_window_bits );
+
+  if( data == NULL ) {
+    ak_wpoint_set_odd_multiples( wt, &ec->point, ec );
+    return;
+  }
+  for( j = 0; j < ak_wpoint_odd_multiples_count; j++, data += 2*ec->size ) {
+     ak_mpzn_set( wt[j].x, data, ec->size );
+     ak_mpzn_set( wt[j].y, data +ec->size, ec->size );
+     ak_mpzn_set_ui( wt[j].z, ec->size, 1 );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет образы нечетных кратных точки на кривой Эдвардса.
+    \details Вместо координаты \f$ t \f$ каждой точки сохраняется произведение \f$ dt \f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_set_prepared_multiples( ak_epoint et, ak_wpoint wt, ak_ecurve ed )
+{
+  size_t j = 0;
+  ak_wcurve wc = ed->wc;
+
+  for( j = 0; j < ak_wpoint_odd_multiples_count; j++ ) {
+     ak_epoint_set_wpoint( et+j, wt+j, ed );
+     ak_mpzn_mul_montgomery( et[j].t, et[j].t, ed->d, wc->p, wc->n, wc->size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление суммы кратных точек \f$ [k_1]P_1 + [k_2]P_2\f$ на кривой Эдвардса.
+
+    Используется тот же метод, что и в функции ak_wpoint_pow2_multiples(). Если вместо кратных
+    точки \f$ P_1 \f$ передан указатель NULL, то кратные образующей точки берутся в аффинной
+    форме из первой строки таблицы, используемой функцией ak_wpoint_pow_base().                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_pow2_multiples( ak_wpoint wr, ak_wpoint wt1, ak_uint64 *k1,
+                                           ak_wpoint wt2, ak_uint64 *k2, size_t size, ak_ecurve ed )
+{
+  size_t j = 0;
+  long long int i = 0;
+  ak_wcurve wc = ed->wc;
+  bool_t affine = ak_false;
+  struct epoint er, tp;
+  ak_uint64 *data = NULL;
+  size_t len1, len2, len;
+  signed char naf1[64*ak_mpzn512_size+1], naf2[64*ak_mpzn512_size+1];
+  struct epoint et1[ak_wpoint_odd_multiples_count], et2[ak_wpoint_odd_multiples_count];
+  struct wpoint wt[ak_wpoint_odd_multiples_count];
+
+  if( wt1 != NULL ) ak_epoint_set_prepared_multiples( et1, wt1, ed );
+   else {
+     if(( data = ak_wcurve_get_table( wc, ed,
+                        ( 64*wc->size + ak_wcurve_window_bits )/ak_wcurve_window_bits )) == NULL ) {
+       ak_wpoint_set_odd_multiples( wt, &wc->point, wc );
+       ak_epoint_set_prepared_multiples( et1, wt, ed );
+     }
+      else {
+        for( j = 0; j < ak_wpoint_odd_multiples_count; j++, data += 3*wc->size ) {
+           ak_mpzn_set( et1[j].x, data, wc->size );
+           ak_mpzn_set( et1[j].y, data +wc->size, wc->size );
+           ak_mpzn_set( et1[j].t, data +2*wc->size, wc->size );
+        }
+        affine = ak_true;
+      }
+   }
+  ak_epoint_set_prepared_multiples( et2, wt2, ed );
+
+  ak_epoint_set_as_unit( &er, ed );
+  len1 = ak_wpoint_wnaf( naf1, k1, size );
+  len2 = ak_wpoint_wnaf( naf2, k2, size );
+  len = len1 > len2 ? len1 : len2;
+  for( i = ( long long int )len-1; i >= 0; i-- ) {
+     ak_epoint_double( &er, ed );
+     if(( i < ( long long int )len1 ) && naf1[i] ) {
+       ak_epoint tq = et1 +(( naf1[i] < 0 ? -naf1[i] : naf1[i] ) >> 1 );
+       if( naf1[i] < 0 ) { /* -(x:y:t:z) = (-x:y:-t:z) */
+         ak_mpzn_sub( tp.x, wc->p, tq->x, wc->size );
+         ak_mpzn_sub( tp.t, wc->p, tq->t, wc->size );
+         ak_epoint_add_prepared( &er, tp.x, tq->y, tp.t, affine ? NULL : tq->z, ed );
+       }
+        else ak_epoint_add_prepared( &er, tq->x, tq->y, tq->t, affine ? NULL : tq->z, ed );
+     }
+     if(( i < ( long long int )len2 ) && naf2[i] ) {
+       ak_epoint tq = et2 +(( naf2[i] < 0 ? -naf2[i] : naf2[i] ) >> 1 );
+       if( naf2[i] < 0 ) {
+         ak_mpzn_sub( tp.x, wc->p, tq->x, wc->size );
+         ak_mpzn_sub( tp.t, wc->p, tq->t, wc->size );
+         ak_epoint_add_prepared( &er, tp.x, tq->y, tp.t, tq->z, ed );
+       }
+        else ak_epoint_add_prepared( &er, tq->x, tq->y, tq->t, tq->z, ed );
+     }
+  }
+  ak_wpoint_set_epoint( wr, &er, ed );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму кратных точек \f$ R = [k_1]P_1 + [k_2]P_2\f$, используя заранее
+    вычисленные нечетные кратные точек \f$ P_1 \f$ и \f$ P_2 \f$
+    (см. функцию ak_wpoint_set_odd_multiples()). Если вместо кратных точки \f$ P_1 \f$ передан
+    указатель NULL, то в качестве \f$ P_1 \f$ используется образующая точка кривой.
+
+    Числа \f$ k_1, k_2 \f$ записываются в неприлегающей форме с окном ширины 5, после чего
+    вычисления выполняются одновременно для обоих слагаемых (метод Штрауса-Шамира): удвоения
+    точки являются общими, а количество сложений в среднем равно одному
+    на каждые шесть бит каждого из чисел. Если для кривой определена эквивалентная кривая
+    в искривленной форме Эдвардса, то сложения и удвоения выполняются на ней.
+
+    \b Внимание! Время работы функции зависит от значений \f$ k_1, k_2 \f$, поэтому
+    функция должна использоваться только с открытыми данными, например, при проверке подписи.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ R \f$ к аффинной форме.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param wt1 Нечетные кратные точки \f$ P_1 \f$.
+    @param k1 Степень кратности \f$ k_1 \f$.
+    @param wt2 Нечетные кратные точки \f$ P_2 \f$.
+    @param k2 Степень кратности \f$ k_2 \f$.
+    @param size Размер степеней в машинных словах; должен совпадать с размером
+    параметров кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow2_multiples( ak_wpoint wr, ak_wpoint wt1, ak_uint64 *k1,
+                                           ak_wpoint wt2, ak_uint64 *k2, size_t size, ak_wcurve ec )
+{
+  long long int i = 0;
+  struct wpoint tp;
+  size_t len1, len2, len;
+  signed char naf1[64*ak_mpzn512_size+1], naf2[64*ak_mpzn512_size+1];
+  struct wpoint wt[ak_wpoint_odd_multiples_count];
+  ak_ecurve ed = NULL;
+
+  ak_wpoint_set_as_unit( wr, ec );
+  if( size > ak_mpzn512_size ) return;
+  if(( ed = ak_wcurve_get_ecurve( ec )) != NULL ) {
+    ak_epoint_pow2_multiples( wr, wt1, k1, wt2, k2, size, ed );
+    return;
+  }
+  if( wt1 == NULL ) {
+    ak_wcurve_set_base_multiples( wt, ec );
+    wt1 = wt;
+  }
+
+  len1 = ak_wpoint_wnaf( naf1, k1, size );
+  len2 = ak_wpoint_wnaf( naf2, k2, size );
+  len = len1 > len2 ? len1 : len2;
+  for( i = ( long long int )len-1; i >= 0; i-- ) {
+     ak_wpoint_double( wr, ec );
+     if(( i < ( long long int )len1 ) && naf1[i] ) {
+       ak_wpoint_set_wpoint( &tp, wt1 +(( naf1[i] < 0 ? -naf1[i] : naf1[i] ) >> 1 ), ec );
+       if( naf1[i] < 0 ) ak_mpzn_sub( tp.y, ec->p, tp.y, ec->size );
+       ak_wpoint_add( wr, &tp, ec );
+     }
+     if(( i < ( long long int )len2 ) && naf2[i] ) {
+       ak_wpoint_set_wpoint( &tp, wt2 +(( naf2[i] < 0 ? -naf2[i] : naf2[i] ) >> 1 ), ec );
+       if( naf2[i] < 0 ) ak_mpzn_sub( tp.y, ec->p, tp.y, ec->size );
+       ak_wpoint_add( wr, &tp, ec );
+     }
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму кратных точек \f$ R = [k_1]P_1 + [k_2]P_2\f$ за один проход
+    по битам чисел \f$ k_1, k_2 \f$ (см. описание функции ak_wpoint_pow2_multiples()).
+    Если в качестве \f$ P_1 \f$ передан указатель NULL, то используется образующая точка кривой.
+
+    \b Внимание! Время работы функции зависит от значений \f$ k_1, k_2 \f$, поэтому
+    функция должна использоваться только с открытыми данными, например, при проверке подписи.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ R \f$ к аффинной форме.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param wp1 Точка \f$ P_1 \f$ (или NULL).
+    @param k1 Степень кратности \f$ k_1 \f$.
+    @param wp2 Точка \f$ P_2 \f$.
+    @param k2 Степень кратности \f$ k_2 \f$.
+    @param size Размер степеней в машинных словах; должен совпадать с размером
+    параметров кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow2( ak_wpoint wr, ak_wpoint wp1, ak_uint64 *k1,
+                                           ak_wpoint wp2, ak_uint64 *k2, size_t size, ak_wcurve ec )
+{
+  struct wpoint wt1[ak_wpoint_odd_multiples_count], wt2[ak_wpoint_odd_multiples_count];
+
+  if( wp1 != NULL ) ak_wpoint_set_odd_multiples( wt1, wp1, ec );
+  ak_wpoint_set_odd_multiples( wt2, wp2, ec );
+  ak_wpoint_pow2_multiples( wr, wp1 == NULL ? NULL : wt1, k1, wt2, k2, size, ec );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для заданной точки \f$ P = (x:y:z) \f$ функция проверяет
     что порядок точки действительно есть величина \f$ q \f$, заданная в параметрах
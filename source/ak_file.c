@@ -24,6 +24,12 @@
 #ifdef AK_HAVE_FNMATCH_H
  #include <fnmatch.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+#ifdef AK_HAVE_LIBURING_H
+ #include <liburing.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param filename Имя, для которого проводится проверка
@@ -530,6 +536,496 @@
  #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+                          /* Потоковое чтение файлов большого объема */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество одновременно выполняемых запросов на чтение при использовании io_uring. */
+ #define ak_file_stream_uring_depth                (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция считывает из файла не более size октетов, повторяя чтение до тех пор,
+    пока буффер не будет заполнен или не будет достигнут конец файла.
+    \return Количество считанных октетов. В случае ошибки возвращается -1.                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static ssize_t ak_file_read_full( ak_file file, ak_uint8 *buffer, const size_t size )
+{
+  size_t done = 0;
+
+  while( done < size ) {
+    ssize_t len = ak_file_read( file, buffer + done, size - done );
+    if( len < 0 ) {
+     #ifdef EINTR
+      if( errno == EINTR ) continue;
+     #endif
+      return -1;
+    }
+    if( len == 0 ) break;
+    done += ( size_t ) len;
+  }
+ return ( ssize_t ) done;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Последовательное чтение total октетов, начиная с текущей позиции файла.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_file_stream_read( ak_file file, ak_int64 total, const size_t block_size,
+                                                 ak_function_file_stream *function, ak_pointer ptr )
+{
+  bool_t last = ak_false;
+  int error = ak_error_ok;
+  ak_uint8 *buffer = NULL;
+
+  if(( buffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                      "memory allocation error for local buffer" );
+  do{
+     size_t need = ( size_t ) ak_min( ( ak_int64 ) block_size, total );
+     ssize_t len = ak_file_read_full( file, buffer, need );
+     if( len < 0 ) {
+       error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                                     "incorrect reading a file %s", file->name );
+       break;
+     }
+     total -= len;
+     last = (( total == 0 ) || (( size_t ) len < need ));
+     error = function( buffer, ( size_t ) len, last, ptr );
+  } while(( error == ak_error_ok ) && ( !last ));
+
+  ak_aligned_free( buffer );
+ return error;
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Буффер, заполняемый вспомогательным потоком при чтении с опережением. */
+ struct file_stream_buffer {
+  /*! \brief Указатель на считанные данные */
+   ak_uint8 *data;
+  /*! \brief Количество считанных октетов (-1 в случае ошибки чтения) */
+   ssize_t len;
+  /*! \brief Флаг того, что буффер содержит последний фрагмент */
+   bool_t last;
+  /*! \brief Флаг того, что буффер заполнен и ожидает обработки */
+   bool_t ready;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Контекст чтения с опережением. */
+ struct file_stream_reader {
+  /*! \brief Считываемый файл */
+   ak_file file;
+  /*! \brief Количество октетов, которые осталось считать */
+   ak_int64 total;
+  /*! \brief Размер каждого из буфферов */
+   size_t block_size;
+  /*! \brief Два буффера, заполняемые поочередно */
+   struct file_stream_buffer buffer[2];
+  /*! \brief Флаг досрочного завершения чтения */
+   bool_t stop;
+  /*! \brief Мьютекс, защищающий флаги буфферов */
+   pthread_mutex_t mutex;
+  /*! \brief Условная переменная для оповещения об изменении состояния буфферов */
+   pthread_cond_t cond;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока: поочередно заполняет буфферы данными из файла,
+    пока основной поток обрабатывает ранее считанные данные.                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_file_stream_reader_thread( void *ptr )
+{
+  size_t idx = 0;
+  bool_t last = ak_false;
+  struct file_stream_reader *rd = ( struct file_stream_reader * ) ptr;
+
+  do{
+     size_t need = 0;
+     ssize_t len = 0;
+     struct file_stream_buffer *buf = rd->buffer + idx;
+
+    /* ожидаем, пока основной поток освободит буффер */
+     pthread_mutex_lock( &rd->mutex );
+     while(( buf->ready ) && ( !rd->stop )) pthread_cond_wait( &rd->cond, &rd->mutex );
+     if( rd->stop ) {
+       pthread_mutex_unlock( &rd->mutex );
+       break;
+     }
+     pthread_mutex_unlock( &rd->mutex );
+
+    /* считываем очередной фрагмент */
+     need = ( size_t ) ak_min( ( ak_int64 ) rd->block_size, rd->total );
+     if(( len = ak_file_read_full( rd->file, buf->data, need )) > 0 ) rd->total -= len;
+     last = (( len < 0 ) || ( rd->total == 0 ) || (( size_t ) len < need ));
+
+     pthread_mutex_lock( &rd->mutex );
+     buf->len = len;
+     buf->last = last;
+     buf->ready = ak_true;
+     pthread_cond_broadcast( &rd->cond );
+     pthread_mutex_unlock( &rd->mutex );
+     idx ^= 1;
+  } while( !last );
+
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Чтение total октетов с опережением: пока основной поток обрабатывает один буффер,
+    вспомогательный поток заполняет второй. Если вспомогательный поток не может быть создан,
+    выполняется последовательное чтение.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_file_stream_read_ahead( ak_file file, ak_int64 total, const size_t block_size,
+                                                 ak_function_file_stream *function, ak_pointer ptr )
+{
+  size_t idx = 0;
+  pthread_t thread;
+  bool_t last = ak_false;
+  int error = ak_error_ok;
+  struct file_stream_reader rd;
+
+ /* для небольших фрагментов вспомогательный поток не нужен */
+  if( total <= ( ak_int64 ) block_size )
+    return ak_file_stream_read( file, total, block_size, function, ptr );
+
+  memset( &rd, 0, sizeof( struct file_stream_reader ));
+  rd.file = file;
+  rd.total = total;
+  rd.block_size = block_size;
+  if((( rd.buffer[0].data = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) ||
+     (( rd.buffer[1].data = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL )) {
+    if( rd.buffer[0].data != NULL ) ak_aligned_free( rd.buffer[0].data );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                     "memory allocation error for local buffers" );
+  }
+  pthread_mutex_init( &rd.mutex, NULL );
+  pthread_cond_init( &rd.cond, NULL );
+
+  if( pthread_create( &thread, NULL, ak_file_stream_reader_thread, &rd ) != 0 ) {
+    error = ak_file_stream_read( file, total, block_size, function, ptr );
+    goto labex;
+  }
+
+  do{
+     struct file_stream_buffer *buf = rd.buffer + idx;
+
+     pthread_mutex_lock( &rd.mutex );
+     while( !buf->ready ) pthread_cond_wait( &rd.cond, &rd.mutex );
+     pthread_mutex_unlock( &rd.mutex );
+
+     if( buf->len < 0 ) {
+       last = ak_true;
+       error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                                     "incorrect reading a file %s", file->name );
+     }
+      else {
+        last = buf->last;
+        error = function( buf->data, ( size_t ) buf->len, last, ptr );
+      }
+
+    /* возвращаем буффер вспомогательному потоку */
+     pthread_mutex_lock( &rd.mutex );
+     buf->ready = ak_false;
+     if( error != ak_error_ok ) rd.stop = ak_true;
+     pthread_cond_broadcast( &rd.cond );
+     pthread_mutex_unlock( &rd.mutex );
+     idx ^= 1;
+  } while(( error == ak_error_ok ) && ( !last ));
+
+  pthread_join( thread, NULL );
+
+  labex:
+   pthread_cond_destroy( &rd.cond );
+   pthread_mutex_destroy( &rd.mutex );
+   ak_aligned_free( rd.buffer[1].data );
+   ak_aligned_free( rd.buffer[0].data );
+ return error;
+}
+#endif
+
+#ifdef AK_HAVE_SYSMMAN_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработка total октетов, начиная со смещения offset, без копирования данных:
+    файл отображается в память с помощью функции ak_file_mmap(), после чего операционной системе
+    сообщается о последовательном характере доступа к данным. Если отображение невозможно,
+    выполняется последовательное чтение.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_file_stream_mmap( ak_file file, ak_int64 offset, ak_int64 total,
+                           const size_t block_size, ak_function_file_stream *function, ak_pointer ptr )
+{
+  ak_uint8 *addr = NULL;
+  bool_t last = ak_false;
+  int error = ak_error_ok;
+  ak_int64 page = 4096, base = 0;
+
+ #if defined( AK_HAVE_UNISTD_H ) && defined( _SC_PAGESIZE )
+  if(( page = ( ak_int64 ) sysconf( _SC_PAGESIZE )) <= 0 ) page = 4096;
+ #endif
+  base = offset - ( offset%page );
+
+ /* отображаемый фрагмент должен быть непустым и адресуемым */
+  if(( total == 0 ) || (( ak_uint64 )( total + offset - base ) > ( ak_uint64 )(( size_t )-1 ))
+     || (( addr = ak_file_mmap( file, NULL, ( size_t )( total + offset - base ),
+                                               PROT_READ, MAP_PRIVATE, ( size_t ) base )) == NULL )) {
+    if( ak_file_lseek( file, offset, SEEK_SET ) == -1 )
+      return ak_error_message( ak_error_lseek_file, __func__, "incorrect seeking to offset" );
+    return ak_file_stream_read( file, total, block_size, function, ptr );
+  }
+
+ #ifdef MADV_SEQUENTIAL
+  madvise( addr, ( size_t )( total + offset - base ), MADV_SEQUENTIAL );
+ #endif
+
+  addr += ( offset - base );
+  do{
+     size_t len = ( size_t ) ak_min( ( ak_int64 ) block_size, total );
+     total -= len;
+     last = ( total == 0 );
+     error = function( addr, len, last, ptr );
+     addr += len;
+  } while(( error == ak_error_ok ) && ( !last ));
+
+  ak_file_unmap( file );
+ return error;
+}
+#endif
+
+#ifdef AK_HAVE_LIBURING_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Запрос на чтение, выполняемый с использованием io_uring. */
+ struct file_stream_request {
+  /*! \brief Буффер для считываемых данных */
+   ak_uint8 *data;
+  /*! \brief Смещение от начала файла */
+   ak_int64 offset;
+  /*! \brief Количество запрошенных октетов */
+   size_t need;
+  /*! \brief Результат выполнения запроса */
+   ssize_t len;
+  /*! \brief Флаг того, что запрос отправлен ядру */
+   bool_t busy;
+  /*! \brief Флаг того, что запрос выполнен */
+   bool_t done;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция отправляет запрос на чтение очередного фрагмента файла. */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_file_stream_uring_submit( struct io_uring *ring, ak_file file,
+                                       struct file_stream_request *req, ak_int64 offset, size_t need )
+{
+  struct io_uring_sqe *sqe = io_uring_get_sqe( ring );
+
+  if( sqe == NULL ) return ak_false;
+  req->offset = offset;
+  req->need = need;
+  req->len = 0;
+  req->done = ak_false;
+  io_uring_prep_read( sqe, file->fd, req->data, ( unsigned int ) need, ( ak_uint64 ) offset );
+  io_uring_sqe_set_data( sqe, req );
+  if( io_uring_submit( ring ) < 0 ) return ak_false;
+  req->busy = ak_true;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция ожидает завершения хотя бы одного из отправленных запросов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_file_stream_uring_wait( struct io_uring *ring )
+{
+  struct io_uring_cqe *cqe = NULL;
+  struct file_stream_request *req = NULL;
+
+  if( io_uring_wait_cqe( ring, &cqe ) < 0 ) return ak_false;
+  req = ( struct file_stream_request * ) io_uring_cqe_get_data( cqe );
+  req->len = cqe->res;
+  req->busy = ak_false;
+  req->done = ak_true;
+  io_uring_cqe_seen( ring, cqe );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Чтение total октетов, начиная со смещения offset, с использованием интерфейса io_uring:
+    ядру одновременно передается несколько запросов на чтение последовательных фрагментов,
+    которые обрабатываются в порядке их следования в файле. Если интерфейс io_uring недоступен,
+    выполняется чтение с опережением или последовательное чтение.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_file_stream_uring( ak_file file, ak_int64 offset, ak_int64 total,
+                           const size_t block_size, ak_function_file_stream *function, ak_pointer ptr )
+{
+  size_t idx = 0;
+  struct io_uring ring;
+  bool_t last = ak_false;
+  int error = ak_error_ok;
+  ak_int64 next = offset, end = offset + total;
+  struct file_stream_request req[ak_file_stream_uring_depth];
+
+  memset( req, 0, sizeof( req ));
+  if(( total <= ( ak_int64 ) block_size ) ||
+                             ( io_uring_queue_init( ak_file_stream_uring_depth, &ring, 0 ) < 0 )) {
+    if( ak_file_lseek( file, offset, SEEK_SET ) == -1 )
+      return ak_error_message( ak_error_lseek_file, __func__, "incorrect seeking to offset" );
+   #ifdef AK_HAVE_PTHREAD_H
+    return ak_file_stream_read_ahead( file, total, block_size, function, ptr );
+   #else
+    return ak_file_stream_read( file, total, block_size, function, ptr );
+   #endif
+  }
+
+  for( idx = 0; idx < ak_file_stream_uring_depth; idx++ ) {
+     if(( req[idx].data = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
+       error = ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                     "memory allocation error for local buffers" );
+       goto labex;
+     }
+  }
+
+ /* отправляем первые запросы */
+  for( idx = 0; ( idx < ak_file_stream_uring_depth ) && ( next < end ); idx++ ) {
+     size_t need = ( size_t ) ak_min( ( ak_int64 ) block_size, end - next );
+     if( !ak_file_stream_uring_submit( &ring, file, req +idx, next, need )) break;
+     next += need;
+  }
+
+ /* обрабатываем ответы в порядке следования фрагментов */
+  idx = 0;
+  do{
+     struct file_stream_request *rq = req + idx;
+
+     while(( !rq->done ) && ( rq->busy )) {
+       if( !ak_file_stream_uring_wait( &ring )) break;
+     }
+     if( !rq->done ) {
+       error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                                     "incorrect reading a file %s", file->name );
+       break;
+     }
+     if( rq->len < 0 ) {
+       error = ak_error_message_fmt( ak_error_read_data, __func__, "incorrect reading a file %s (%s)",
+                                                               file->name, strerror( -( int )rq->len ));
+       break;
+     }
+
+    /* неполное чтение дочитываем синхронно; размер файла известен заранее,
+       поэтому досрочный конец файла также считается ошибкой чтения */
+     while(( size_t ) rq->len < rq->need ) {
+       ssize_t len = pread( file->fd, rq->data + rq->len,
+                                   rq->need - ( size_t ) rq->len, ( off_t )( rq->offset + rq->len ));
+      #ifdef EINTR
+       if(( len < 0 ) && ( errno == EINTR )) continue;
+      #endif
+       if( len <= 0 ) break;
+       rq->len += len;
+     }
+     if(( size_t ) rq->len < rq->need ) {
+       error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                                     "incorrect reading a file %s", file->name );
+       break;
+     }
+
+     last = ( rq->offset + rq->len == end );
+     rq->done = ak_false;
+     if(( error = function( rq->data, ( size_t ) rq->len, last, ptr )) != ak_error_ok ) break;
+
+    /* освободившийся буффер используем для следующего фрагмента */
+     if(( !last ) && ( next < end )) {
+       size_t need = ( size_t ) ak_min( ( ak_int64 ) block_size, end - next );
+       if( ak_file_stream_uring_submit( &ring, file, rq, next, need )) next += need;
+     }
+     idx = ( idx + 1 )%ak_file_stream_uring_depth;
+  } while( !last );
+
+ /* дожидаемся завершения всех отправленных запросов */
+  for( idx = 0; idx < ak_file_stream_uring_depth; idx++ )
+     while( req[idx].busy ) {
+       if( !ak_file_stream_uring_wait( &ring )) break;
+     }
+
+  labex:
+  /* буфферы освобождаются только после уничтожения очереди; буфферы запросов,
+     завершение которых не удалось дождаться, не освобождаются, поскольку ядро
+     может продолжать запись в них */
+   io_uring_queue_exit( &ring );
+   for( idx = 0; idx < ak_file_stream_uring_depth; idx++ )
+      if(( req[idx].data != NULL ) && ( !req[idx].busy )) ak_aligned_free( req[idx].data );
+ return error;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция считывает фрагмент файла, начинающийся со смещения offset и имеющий длину не более
+    size октетов, и последовательно передает считанные данные функции function.
+
+    Функция function вызывается для каждого считанного фрагмента; все фрагменты, кроме последнего,
+    имеют длину block_size октетов, последний фрагмент может иметь произвольную (в том числе,
+    нулевую) длину и передается с флагом last, равным \ref ak_true.
+    Таким образом, если значение block_size кратно длине блока алгоритма, обрабатывающего данные,
+    функция function может обрабатывать все фрагменты, кроме последнего, без дополнительной
+    буфферизации.
+
+    Способ считывания данных определяется параметром method. В случае, если выбранный способ
+    недоступен на используемой платформе (или при сборке библиотеки), применяется
+    последовательное чтение.
+
+    \note Специальное значение size = -1 может быть использовано для указания того,
+    что обрабатываются все данные до конца файла.
+
+    @param file Контекст файла, предварительно открытого на чтение.
+    @param offset Смещение от начала файла (в октетах).
+    @param size Размер обрабатываемого фрагмента (в октетах).
+    @param block_size Размер буффера для считывания данных (в октетах).
+    @param method Способ считывания данных.
+    @param function Функция, последовательно обрабатывающая считанные фрагменты.
+    @param ptr Указатель на произвольные данные, передаваемые функции function.
+
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки (в том числе, код, возвращенный функцией function).                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_read_stream( ak_file file, ak_int64 offset, ak_int64 size, size_t block_size,
+                        file_stream_t method, ak_function_file_stream *function, ak_pointer ptr )
+{
+  ak_int64 total = 0;
+
+  if(( file == NULL ) || ( function == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__, "using null pointer" );
+  if( offset < 0 ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                                  "using negative file offset" );
+  if( !block_size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                               "using buffer with zero length" );
+
+ /* вычисляем сколько октетов нам надо обработать */
+  if( offset >= file->size ) total = 0;
+   else total = ( size < 0 ) ? ( file->size - offset ) : ak_min( size, file->size - offset );
+
+ #if defined( AK_HAVE_FCNTL_H ) && defined( POSIX_FADV_SEQUENTIAL )
+  if( total > ( ak_int64 ) block_size )
+    posix_fadvise( file->fd, ( off_t ) offset, ( off_t ) total, POSIX_FADV_SEQUENTIAL );
+ #endif
+
+  if( method == file_stream_mmap ) {
+   #ifdef AK_HAVE_SYSMMAN_H
+    return ak_file_stream_mmap( file, offset, total, block_size, function, ptr );
+   #else
+    method = file_stream_read;
+   #endif
+  }
+  if( method == file_stream_uring ) {
+   #ifdef AK_HAVE_LIBURING_H
+    return ak_file_stream_uring( file, offset, total, block_size, function, ptr );
+   #else
+    method = file_stream_read_ahead;
+   #endif
+  }
+
+  if( ak_file_lseek( file, offset, SEEK_SET ) == -1 )
+    return ak_error_message( ak_error_lseek_file, __func__, "incorrect seeking to offset" );
+ #ifdef AK_HAVE_PTHREAD_H
+  if( method == file_stream_read_ahead )
+    return ak_file_stream_read_ahead( file, total, block_size, function, ptr );
+ #endif
+ return ak_file_stream_read( file, total, block_size, function, ptr );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция обрабатывает только префикс файла.
     В случае появления внутри строки символов вида .. их обработка не производится.
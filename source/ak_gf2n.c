@@ -5,7 +5,7 @@
 /*  Файл ak_gf2n.c                                                                                 */
 /*  - содержит реализацию функций умножения элементов конечных полей характеристики 2.             */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
@@ -279,6 +279,60 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений \f$ z = z + \sum_{i=0}^{count-1} a_ib_i\f$
+    элементов конечного поля \f$ \mathbb F_{2^{128}}\f$. Массивы `a` и `b` должны содержать
+    по `count` последовательно записанных элементов поля.
+
+    Для умножения используется функция ak_gf128_mul_uint64().                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  ak_uint64 t[2], *x = a, *y = b;
+
+  for( ; count > 0; count--, x += 2, y += 2 ) {
+     ak_gf128_mul_uint64( t, x, y );
+     ((ak_uint64 *)z)[0] ^= t[0];
+     ((ak_uint64 *)z)[1] ^= t[1];
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений \f$ z = z + \sum_{i=0}^{count-1} a_ib_i\f$
+    элементов конечного поля \f$ \mathbb F_{2^{256}}\f$. Массивы `a` и `b` должны содержать
+    по `count` последовательно записанных элементов поля.
+
+    Для умножения используется функция ak_gf256_mul_uint64().                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf256_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  int i = 0;
+  ak_uint64 t[4], *x = a, *y = b;
+
+  for( ; count > 0; count--, x += 4, y += 4 ) {
+     ak_gf256_mul_uint64( t, x, y );
+     for( i = 0; i < 4; i++ ) ((ak_uint64 *)z)[i] ^= t[i];
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений \f$ z = z + \sum_{i=0}^{count-1} a_ib_i\f$
+    элементов конечного поля \f$ \mathbb F_{2^{512}}\f$. Массивы `a` и `b` должны содержать
+    по `count` последовательно записанных элементов поля.
+
+    Для умножения используется функция ak_gf512_mul_uint64().                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf512_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  int i = 0;
+  ak_uint64 t[8], *x = a, *y = b;
+
+  for( ; count > 0; count--, x += 8, y += 8 ) {
+     ak_gf512_mul_uint64( t, x, y );
+     for( i = 0; i < 8; i++ ) ((ak_uint64 *)z)[i] ^= t[i];
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
 
@@ -288,7 +342,7 @@
     \f$ f(x) = x^{64} + x^4 + x^3 + x + 1 \in \mathbb F_2[x]\f$. Для умножения используется
     реализация с помощью команды PCLMULQDQ.                                                        */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_gf64_mul_pcmulqdq( ak_pointer z, ak_pointer x, ak_pointer y )
+ ak_target_pclmul void ak_gf64_mul_pcmulqdq( ak_pointer z, ak_pointer x, ak_pointer y )
 {
 #ifdef _MSC_VER
 	 __m128i gm, xm, ym, cm, cx;
@@ -328,7 +382,7 @@
     \f$ f(x) = x^{128} + x^7 + x^2 + x + 1 \in \mathbb F_2[x]\f$. Для умножения используется
     реализация с помощью команды PCLMULQDQ.                                                        */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_gf128_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
+ ak_target_pclmul void ak_gf128_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 {
 #ifdef _MSC_VER
 	 __m128i am, bm, cm, dm, em, fm;
@@ -374,13 +428,55 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений \f$ z = z + \sum_{i=0}^{count-1} a_ib_i\f$
+    элементов конечного поля \f$ \mathbb F_{2^{128}}\f$. Массивы `a` и `b` должны содержать
+    по `count` последовательно записанных элементов поля.
+
+    Поскольку приведение по модулю многочлена \f$ f(x) \f$ является линейной операцией,
+    функция накапливает сумму 256-ти битных произведений, вычисляемых с помощью команды PCLMULQDQ,
+    и выполняет приведение только один раз.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_target_pclmul void ak_gf128_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  ak_uint64 *x = a, *y = b, x3, D, c0, c1, d0, e0, e1;
+  __m128i am, bm, cm = _mm_setzero_si128(), dm = _mm_setzero_si128(), em = _mm_setzero_si128();
+
+ /* умножение без приведения */
+  for( ; count > 0; count--, x += 2, y += 2 ) {
+     am = _mm_loadu_si128(( const __m128i *) x );
+     bm = _mm_loadu_si128(( const __m128i *) y );
+     cm = _mm_xor_si128( cm, _mm_clmulepi64_si128( am, bm, 0x00 )); // c = a0*b0
+     dm = _mm_xor_si128( dm, _mm_clmulepi64_si128( am, bm, 0x11 )); // d = a1*b1
+     em = _mm_xor_si128( em, _mm_clmulepi64_si128( am, bm, 0x10 )); // e = a0*b1 + a1*b0
+     em = _mm_xor_si128( em, _mm_clmulepi64_si128( am, bm, 0x01 ));
+  }
+#ifdef _MSC_VER
+  c0 = cm.m128i_u64[0]; c1 = cm.m128i_u64[1];
+  d0 = dm.m128i_u64[0]; x3 = dm.m128i_u64[1];
+  e0 = em.m128i_u64[0]; e1 = em.m128i_u64[1];
+#else
+  c0 = cm[0]; c1 = cm[1];
+  d0 = dm[0]; x3 = dm[1];
+  e0 = em[0]; e1 = em[1];
+#endif
+
+ /* однократное приведение накопленной суммы */
+  D = d0 ^ e1 ^ (x3 >> 63) ^ (x3 >> 62) ^ (x3 >> 57);
+  c0 ^= D ^ (D << 1) ^ (D << 2) ^ (D << 7);
+  c1 ^= e0 ^ x3 ^ (x3 << 1) ^ (D >> 63) ^ (x3 << 2) ^ (D >> 62) ^ (x3 << 7) ^ (D >> 57);
+
+  ((ak_uint64 *)z)[0] ^= c0;
+  ((ak_uint64 *)z)[1] ^= c1;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция реализует операцию умножения двух элементов конечного поля \f$ \mathbb F_{2^{256}}\f$,
     порожденного неприводимым многочленом
     \f$ f(x) = x^{256} + x^10 + x^5 + x^2 + 1 \in \mathbb F_2[x]\f$. Для умножения используется
     реализация с помощью команды PCLMULQDQ.                                                        */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
+ ak_target_pclmul void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 {
 #ifdef _MSC_VER
      __m128i a1a0, a3a2, b1b0, b3b2;
@@ -497,7 +593,7 @@
     реализация с помощью команды PCLMULQDQ.
     \todo может быть имеет смысл разбить на 2 ifdef, а середину сделать общей?                     */
 /* ----------------------------------------------------------------------------------------------- */
-void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
+ ak_target_pclmul void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 {
 #ifdef _MSC_VER
      __m128i a1a0, a3a2, a5a4, a7a6, b1b0, b3b2, b5b4, b7b6;
@@ -785,8 +881,179 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сумма попарных произведений многочленов, состоящих из `n` 64-х битных слов,
+    вычисляемая без приведения.
+
+    Функция добавляет к массиву `r` из `2n` слов сумму \f$ \sum_{i=0}^{count-1} a_ib_i\f$
+    произведений многочленов над \f$ \mathbb F_2\f$. Каждая пара 128-ми битных фрагментов
+    многочленов обрабатывается четырьмя командами PCLMULQDQ, результаты которых накапливаются
+    в регистрах и переносятся в массив `r` только после обработки всех слагаемых.               */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_target_pclmul void ak_gf2n_mul_sum_nored_pcmulqdq( ak_uint64 *r,
+                                       ak_uint64 *x, ak_uint64 *y, const size_t n, size_t count )
+{
+  size_t i, j;
+  ak_uint64 t[2];
+  __m128i am, bm, acc[15];
+
+  for( i = 0; i < 2*n-1; i++ ) acc[i] = _mm_setzero_si128();
+  for( ; count > 0; count--, x += n, y += n ) {
+     for( i = 0; i < n; i += 2 ) {
+        am = _mm_loadu_si128(( const __m128i *)( x+i ));
+        for( j = 0; j < n; j += 2 ) {
+           bm = _mm_loadu_si128(( const __m128i *)( y+j ));
+           acc[i+j] = _mm_xor_si128( acc[i+j], _mm_clmulepi64_si128( am, bm, 0x00 ));
+           acc[i+j+1] = _mm_xor_si128( acc[i+j+1],
+                            _mm_xor_si128( _mm_clmulepi64_si128( am, bm, 0x01 ),
+                                                        _mm_clmulepi64_si128( am, bm, 0x10 )));
+           acc[i+j+2] = _mm_xor_si128( acc[i+j+2], _mm_clmulepi64_si128( am, bm, 0x11 ));
+        }
+     }
+  }
+  for( i = 0; i < 2*n-1; i++ ) {
+     _mm_storeu_si128(( __m128i *) t, acc[i] );
+     r[i] ^= t[0]; r[i+1] ^= t[1];
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений \f$ z = z + \sum_{i=0}^{count-1} a_ib_i\f$
+    элементов конечного поля \f$ \mathbb F_{2^{256}}\f$. Массивы `a` и `b` должны содержать
+    по `count` последовательно записанных элементов поля.
+
+    Поскольку приведение по модулю многочлена \f$ f(x) = x^{256} + x^{10} + x^5 + x^2 + 1\f$
+    является линейной операцией, функция накапливает сумму 512-ти битных произведений
+    и выполняет приведение только один раз.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_target_pclmul void ak_gf256_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  int k = 0;
+  ak_uint64 r[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  ak_gf2n_mul_sum_nored_pcmulqdq( r, a, b, 4, count );
+  for( k = 7; k > 3; k-- ) {
+     r[k-3] ^= (r[k] >> 54) ^ (r[k] >> 59) ^ (r[k] >> 62);
+     r[k-4] ^= (r[k] << 10) ^ (r[k] << 5) ^ (r[k] << 2) ^ r[k];
+  }
+  for( k = 0; k < 4; k++ ) ((ak_uint64 *)z)[k] ^= r[k];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений \f$ z = z + \sum_{i=0}^{count-1} a_ib_i\f$
+    элементов конечного поля \f$ \mathbb F_{2^{512}}\f$. Массивы `a` и `b` должны содержать
+    по `count` последовательно записанных элементов поля.
+
+    Приведение по модулю многочлена \f$ f(x) = x^{512} + x^8 + x^5 + x^2 + 1\f$
+    выполняется один раз для накопленной суммы 1024-х битных произведений.                         */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_target_pclmul void ak_gf512_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  int k = 0;
+  ak_uint64 r[16];
+
+  memset( r, 0, sizeof( r ));
+  ak_gf2n_mul_sum_nored_pcmulqdq( r, a, b, 8, count );
+  for( k = 15; k > 7; k-- ) {
+     r[k-7] ^= (r[k] >> 56) ^ (r[k] >> 59) ^ (r[k] >> 62);
+     r[k-8] ^= (r[k] << 8) ^ (r[k] << 5) ^ (r[k] << 2) ^ r[k];
+  }
+  for( k = 0; k < 8; k++ ) ((ak_uint64 *)z)[k] ^= r[k];
+}
+
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Тип функции умножения двух элементов конечного поля. */
+ typedef void ( ak_function_gf_mul )( ak_pointer , ak_pointer , ak_pointer );
+/*! \brief Тип функции вычисления суммы попарных произведений элементов конечного поля. */
+ typedef void ( ak_function_gf_mul_sum )( ak_pointer , ak_pointer , ak_pointer , size_t );
+
+/*! \brief Реализации умножения, выбранные функцией ak_gf2n_set_cpu_level(). */
+ static ak_function_gf_mul *ak_gf64_mul_function = ak_gf64_mul_uint64,
+                           *ak_gf128_mul_function = ak_gf128_mul_uint64,
+                           *ak_gf256_mul_function = ak_gf256_mul_uint64,
+                           *ak_gf512_mul_function = ak_gf512_mul_uint64;
+/*! \brief Реализация суммы попарных произведений, выбранная функцией ak_gf2n_set_cpu_level(). */
+ static ak_function_gf_mul_sum *ak_gf128_mul_sum_function = ak_gf128_mul_sum_uint64,
+                               *ak_gf256_mul_sum_function = ak_gf256_mul_sum_uint64,
+                               *ak_gf512_mul_sum_function = ak_gf512_mul_sum_uint64;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается при инициализации библиотеки, а также при изменении уровня реализации
+    вычислительных ядер. Реализации, использующие команду pclmulqdq, выбираются только в случае,
+    когда наличие команды подтверждено опросом процессора.
+
+    @param level Максимальный допустимый уровень реализации.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf2n_set_cpu_level( cpu_level_t level )
+{
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+  if(( level >= cpu_level_pclmul ) &&
+     ( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul )) {
+    ak_gf64_mul_function = ak_gf64_mul_pcmulqdq;
+    ak_gf128_mul_function = ak_gf128_mul_pcmulqdq;
+    ak_gf256_mul_function = ak_gf256_mul_pcmulqdq;
+    ak_gf512_mul_function = ak_gf512_mul_pcmulqdq;
+    ak_gf128_mul_sum_function = ak_gf128_mul_sum_pcmulqdq;
+    ak_gf256_mul_sum_function = ak_gf256_mul_sum_pcmulqdq;
+    ak_gf512_mul_sum_function = ak_gf512_mul_sum_pcmulqdq;
+    return;
+  }
+#else
+  (void)level;
+#endif
+  ak_gf64_mul_function = ak_gf64_mul_uint64;
+  ak_gf128_mul_function = ak_gf128_mul_uint64;
+  ak_gf256_mul_function = ak_gf256_mul_uint64;
+  ak_gf512_mul_function = ak_gf512_mul_uint64;
+  ak_gf128_mul_sum_function = ak_gf128_mul_sum_uint64;
+  ak_gf256_mul_sum_function = ak_gf256_mul_sum_uint64;
+  ak_gf512_mul_sum_function = ak_gf512_mul_sum_uint64;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf64_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf64_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf128_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf256_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf256_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf512_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf512_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul_sum( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  ak_gf128_mul_sum_function( z, a, b, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf256_mul_sum( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  ak_gf256_mul_sum_function( z, a, b, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf512_mul_sum( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  ak_gf512_mul_sum_function( z, a, b, count );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Тестирование операции умножения в поле \f$ \mathbb F_{2^{64}}\f$. */
  static bool_t ak_gf64_multiplication_test( void )
@@ -841,6 +1108,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
   }
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -893,7 +1161,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
       0xd2, 0x06, 0x35, 0x32, 0xda, 0x10, 0x4e, 0x7e, 0x2e, 0xd1, 0x5e, 0x9a, 0xa0, 0x29, 0x02, 0x04 };
  ak_uint8 result[16], result2[16];
 
- ak_uint128 a, b, m;
+ ak_uint128 a, b, m, va[8], vb[8];
 #ifdef AK_LITTLE_ENDIAN
   a.q[0] = 0x63746f725d53475dLL; a.q[1] = 0x7b5b546573745665LL;
   b.q[0] = 0x5b477565726f6e5dLL; b.q[1] = 0x4869285368617929LL;
@@ -930,39 +1198,72 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
  if( !ak_ptr_is_equal_with_log( result, m8, 16 )) goto lexit;
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
- if( ak_log_get_level() >= ak_log_maximum )
-   ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
+ if( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul ) {
+   if( ak_log_get_level() >= ak_log_maximum )
+     ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
- ak_gf128_mul_pcmulqdq( result2, &a, &b );
- /* сравнение с константой */
- if( !ak_ptr_is_equal_with_log( result2, m8, 16 )) {
-   ak_error_message( ak_error_ok, __func__,
-                                      "result with pcmulqdq differs from predefined const value" );
-   goto lexit;
+   ak_gf128_mul_pcmulqdq( result2, &a, &b );
+   /* сравнение с константой */
+   if( !ak_ptr_is_equal_with_log( result2, m8, 16 )) {
+     ak_error_message( ak_error_ok, __func__,
+                                        "result with pcmulqdq differs from predefined const value" );
+     goto lexit;
+   }
+   /* сравнение с другим способом вычисления */
+   if( !ak_ptr_is_equal_with_log( result2, result, 16 )) {
+     ak_error_message( ak_error_ok, __func__,
+                                 "result with pcmulqdq differs from standard method of evaluation" );
+     goto lexit;
+   }
+
+   /* сравнение для двух способов на нескольких значениях */
+   for( i = 1; i < 1000; i++ ) {
+     a.q[0] = b.q[1]; a.q[1] = b.q[0];
+     memcpy( b.b, result, 16 );
+
+     ak_gf128_mul_uint64( result, &a, &b );
+     ak_gf128_mul_pcmulqdq( result2, &a, &b );
+     if( !ak_ptr_is_equal_with_log( result, result2, 16 )) {
+       ak_error_message_fmt( ak_error_ok, __func__,
+              "result with pcmulqdq differs from standard method of evaluation on iteration %d", i );
+       goto lexit;
+     }
+   }
+   if( ak_log_get_level() >= ak_log_maximum )
+     ak_error_message( ak_error_ok, __func__, "one thousand iterations for random values is Ok");
+ }
+#endif
+
+ /* проверяем вычисление суммы произведений с отложенным приведением */
+ for( i = 0; i < 8; i++ ) {
+   va[i].q[0] = a.q[0] ^ (ak_uint64)i; va[i].q[1] = a.q[1] + (ak_uint64)i;
+   vb[i].q[0] = b.q[1] - (ak_uint64)i; vb[i].q[1] = b.q[0] ^ ((ak_uint64)i << 63);
+ }
+ memset( result, 0, 16 );
+ for( i = 0; i < 8; i++ ) {
+   ak_gf128_mul_uint64( m.b, &va[i], &vb[i] );
+   ((ak_uint64 *)result)[0] ^= m.q[0];
+   ((ak_uint64 *)result)[1] ^= m.q[1];
  }
- /* сравнение с другим способом вычисления */
- if( !ak_ptr_is_equal_with_log( result2, result, 16 )) {
-   ak_error_message( ak_error_ok, __func__,
-                               "result with pcmulqdq differs from standard method of evaluation" );
+ memset( result2, 0, 16 );
+ ak_gf128_mul_sum_uint64( result2, va, vb, 8 );
+ if( !ak_ptr_is_equal_with_log( result, result2, 16 )) {
+   ak_error_message( ak_error_ok, __func__, "wrong sum of products evaluation" );
    goto lexit;
  }
-
- /* сравнение для двух способов на нескольких значениях */
- for( i = 1; i < 1000; i++ ) {
-   a.q[0] = b.q[1]; a.q[1] = b.q[0];
-   memcpy( b.b, result, 16 );
-
-   ak_gf128_mul_uint64( result, &a, &b );
-   ak_gf128_mul_pcmulqdq( result2, &a, &b );
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul ) {
+   memset( result2, 0, 16 );
+   ak_gf128_mul_sum_pcmulqdq( result2, va, vb, 8 );
    if( !ak_ptr_is_equal_with_log( result, result2, 16 )) {
-     ak_error_message_fmt( ak_error_ok, __func__,
-            "result with pcmulqdq differs from standard method of evaluation on iteration %d", i );
+     ak_error_message( ak_error_ok, __func__,
+                                     "sum of products with pcmulqdq differs from standard method" );
      goto lexit;
    }
  }
- if( ak_log_get_level() >= ak_log_maximum )
-   ak_error_message( ak_error_ok, __func__, "one thousand iterations for random values is Ok");
 #endif
+ if( ak_log_get_level() >= ak_log_maximum )
+   ak_error_message( ak_error_ok, __func__, "sum of products with delayed reduction is Ok");
 
  return ak_true;
 
@@ -1004,6 +1305,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
   }
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -1088,6 +1390,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
   }
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -1145,7 +1448,8 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
    ak_error_message( ak_error_ok, __func__ , "testing the Galois fileds arithmetic started");
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
- if( audit >= ak_log_maximum )
+ if(( audit >= ak_log_maximum ) &&
+    ( ak_libakrypt_get_cpu_features() & ak_cpu_feature_pclmul ))
    ak_error_message( ak_error_ok, __func__ ,
                                       "using pcmulqdq for multiplication in finite Galois fields");
 #endif
@@ -5,6 +5,12 @@
 /*  - содержит реализацию алгоритмов итерационного сжатия                                          */
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Итерационные константы для алгоритма Стрибог (ГОСТ Р 34.11-2012). */
@@ -1197,6 +1203,59 @@
        for ( idx = 0; idx < 8; idx++ ) ctx->h[idx] ^= T[idx] ^ K[idx] ^ m[idx];
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование LPS, выполняемое одновременно для нескольких независимых векторов.
+    \details Обращения к таблицам для различных векторов чередуются, что позволяет процессору
+    совмещать их выполнение.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hash_context_streebog_lps_multi( ak_uint64 (*result)[8],
+                                                    ak_uint64 (*data)[8], const size_t count )
+{
+  size_t idx = 0, idx2 = 0, j = 0;
+
+  for( idx = 0; idx < 8; idx++ ) {
+    for( j = 0; j < count; j++ ) {
+       const unsigned char *a = ( const unsigned char *) data[j];
+       ak_uint64 sidx = idx, c = 0;
+       for( idx2 = 0; idx2 < 8; idx2++, sidx += 8 )
+          c ^= streebog_Areverse_expand_with_pi[idx2][a[sidx]];
+       result[j][idx] = c;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, выполняемое одновременно для `count` (не более \ref ak_hash_streebog_lanes)
+    независимых контекстов. Указатели n[j] могут принимать значение NULL.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hash_context_streebog_g_multi( ak_streebog *ctx, ak_uint64 **n,
+                                                         ak_uint64 **m, const size_t count )
+{
+  int idx = 0;
+  size_t j = 0, i = 0;
+  ak_uint64 K[ak_hash_streebog_lanes][8], T[ak_hash_streebog_lanes][8],
+                                                                  B[ak_hash_streebog_lanes][8];
+
+  for( j = 0; j < count; j++ ) {
+     if( n[j] != NULL ) ak_hash_context_streebog_x( B[j], ctx[j]->h, n[j] );
+      else for( i = 0; i < 8; i++ ) B[j][i] = ctx[j]->h[i];
+  }
+  ak_hash_context_streebog_lps_multi( K, B, count );
+  for( j = 0; j < count; j++ ) for( i = 0; i < 8; i++ ) T[j][i] = m[j][i];
+
+  for( idx = 0; idx < 12; idx++ ) {
+     for( j = 0; j < count; j++ ) ak_hash_context_streebog_x( B[j], T[j], K[j] );
+     ak_hash_context_streebog_lps_multi( T, B, count ); /* преобразуем тексты */
+
+     for( j = 0; j < count; j++ ) ak_hash_context_streebog_x( B[j], K[j], streebog_c[idx] );
+     ak_hash_context_streebog_lps_multi( K, B, count );  /* новые ключи */
+  }
+
+ /* изменяем значения переменных h */
+  for( j = 0; j < count; j++ )
+     for( i = 0; i < 8; i++ ) ctx[j]->h[i] ^= T[j][i] ^ K[j][i] ^ m[j][i];
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Преобразование Add (увеличение счетчика длины обработаного сообщения).                  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -1230,12 +1289,12 @@
    for( i = 0; i < 8; i++ )
    {
     #ifdef AK_LITTLE_ENDIAN
-      if( carry ) {
-                    ctx->sigma[i]++;
-                    if( ctx->sigma[i] ) carry = 0;
-      }
-      ctx->sigma[i] += xdata[i];
-      if( ctx->sigma[i] < xdata[i] ) carry = 1;
+     /* перенос вычисляется без ветвлений, что позволяет компилятору использовать команду adc */
+      ak_uint64 sum = ctx->sigma[i] + carry;
+      carry = ( sum < carry );
+      sum += xdata[i];
+      carry |= ( sum < xdata[i] );
+      ctx->sigma[i] = sum;
     #else
       ak_uint64 val_data = bswap_64( xdata[i] ),
                val_sigma = bswap_64( ctx->sigma[i] );
@@ -1670,6 +1729,370 @@
  return ak_mac_finalize( &hctx->mctx, in, size, out, out_size );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                       одновременное хеширование нескольких сообщений                            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Текущее состояние обработки одного сообщения в функции ak_hash_multi(). */
+ typedef struct streebog_lane {
+  /*! \brief Внутреннее состояние функции хеширования. */
+   struct streebog sx;
+  /*! \brief Дополненный последний блок сообщения. */
+   ak_uint64 m[8];
+  /*! \brief Указатель на следующий необработанный блок сообщения. */
+   ak_uint64 *dt;
+  /*! \brief Количество оставшихся полных блоков. */
+   size_t blocks;
+  /*! \brief Длина последнего (неполного) блока. */
+   size_t tail;
+  /*! \brief Порядковый номер сообщения. */
+   size_t idx;
+  /*! \brief Этап вычислений: 0 - полные блоки, 1 - последний блок,
+      2 и 3 - завершающие преобразования. */
+   int stage;
+} *ak_streebog_lane;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция хеширования нескольких сообщений алгоритмом Стрибог. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hash_streebog_multi( ak_streebog cx, const size_t count, ak_pointer *in,
+                                        const size_t *size, ak_uint8 *out, const size_t out_size )
+{
+  size_t j = 0, next = 0, active = 0;
+  struct streebog_lane lanes[ak_hash_streebog_lanes];
+  ak_streebog ctx[ak_hash_streebog_lanes];
+  ak_uint64 *n[ak_hash_streebog_lanes], *m[ak_hash_streebog_lanes];
+
+  while(( next < count ) || ( active > 0 )) {
+   /* заполняем освободившиеся места новыми сообщениями */
+    while(( active < ak_hash_streebog_lanes ) && ( next < count )) {
+       ak_streebog_lane ln = lanes + active;
+       ln->sx.hsize = cx->hsize;
+       ak_hash_context_streebog_clean( &ln->sx );
+       ln->dt = ( ak_uint64 *)in[next];
+       ln->blocks = size[next] >> 6;
+       ln->tail = size[next] - ( ln->blocks << 6 );
+       ln->idx = next;
+       ln->stage = ( ln->blocks > 0 ) ? 0 : 1;
+       memset( ln->m, 0, 64 );
+       if( ln->tail ) memcpy( ln->m, ( ak_uint8 *)in[next] + ( ln->blocks << 6 ), ln->tail );
+       (( ak_uint8 *)ln->m )[ln->tail] = 1; /* дополнение */
+       active++; next++;
+    }
+
+   /* определяем аргументы преобразования G для каждого сообщения */
+    for( j = 0; j < active; j++ ) {
+       ctx[j] = &lanes[j].sx;
+       switch( lanes[j].stage ) {
+         case 0: n[j] = lanes[j].sx.n; m[j] = lanes[j].dt; break;
+         case 1: n[j] = lanes[j].sx.n; m[j] = lanes[j].m; break;
+         case 2: n[j] = NULL; m[j] = lanes[j].sx.n; break;
+         default: n[j] = NULL; m[j] = lanes[j].sx.sigma; break;
+       }
+    }
+    ak_hash_context_streebog_g_multi( ctx, n, m, active );
+
+   /* обновляем счетчики и выводим результаты для завершенных сообщений */
+    for( j = active; j > 0; j-- ) {
+       ak_streebog_lane ln = lanes + j-1;
+       switch( ln->stage ) {
+         case 0:
+           ak_hash_context_streebog_add( &ln->sx, 512 );
+           ak_hash_context_streebog_sadd( &ln->sx, ln->dt );
+           ln->dt += 8;
+           if( --ln->blocks == 0 ) ln->stage = 1;
+           continue;
+         case 1:
+           ak_hash_context_streebog_add( &ln->sx, ln->tail << 3 );
+           ak_hash_context_streebog_sadd( &ln->sx, ln->m );
+           ln->stage = 2;
+           continue;
+         case 2:
+           ln->stage = 3;
+           continue;
+         default:
+           if( cx->hsize == 64 ) memcpy( out + ln->idx*out_size, ln->sx.h, ak_min( 64, out_size ));
+            else memcpy( out + ln->idx*out_size, ln->sx.h+4, ak_min( 32, out_size ));
+           if( j < active ) memcpy( ln, lanes + active-1, sizeof( struct streebog_lane ));
+           active--;
+       }
+    }
+  }
+  memset( lanes, 0, sizeof( lanes ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет хеш-коды для `count` независимых сообщений.
+    Результат совпадает с последовательным вызовом функции ak_hash_ptr() для каждого сообщения.
+
+    Для функций хеширования семейства Стрибог одновременно обрабатывается до
+    \ref ak_hash_streebog_lanes сообщений: преобразования G для различных сообщений выполняются
+    совместно, так что обращения к таблицам и сложения различных сообщений чередуются.
+    Место завершенного сообщения сразу занимает следующее, поэтому сообщения
+    могут иметь различную длину. Для остальных функций хеширования сообщения
+    обрабатываются последовательно.
+
+    Внутреннее состояние контекста `hctx` при хешировании алгоритмами Стрибог не изменяется.
+
+    @param hctx Контекст функции хеширования
+    @param count Количество сообщений.
+    @param in Массив из `count` указателей на сообщения.
+    @param size Массив из `count` длин сообщений (в октетах).
+    @param out Область памяти, куда последовательно помещаются `count` хеш-кодов,
+    каждый длины `out_size` октетов. Память должна быть заранее выделена.
+    @param out_size Размер области памяти (в октетах) для одного хеш-кода.
+
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_multi( ak_hash hctx, const size_t count, ak_pointer *in, const size_t *size,
+                                                           ak_pointer out, const size_t out_size )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+
+  if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                            "using null pointer to hash context" );
+  if( !count ) return ak_error_ok;
+  if(( in == NULL ) || ( size == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                  __func__, "using null pointer to input data" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to result buffer" );
+  if( !out_size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                            "using zero length of result buffer" );
+  for( i = 0; i < count; i++ )
+     if(( size[i] > 0 ) && ( in[i] == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                   __func__, "using null pointer to a message" );
+
+  if( hctx->mctx.update == ak_hash_context_streebog_update ) {
+    ak_hash_streebog_multi( &hctx->data.sctx, count, in, size, out, out_size );
+    return ak_error_ok;
+  }
+  for( i = 0; i < count; i++ )
+     if(( error = ak_hash_ptr( hctx, in[i], size[i],
+                                 ( ak_uint8 *)out + i*out_size, out_size )) != ak_error_ok )
+       return ak_error_message( error, __func__, "incorrect hashing of message" );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G для одного или нескольких контекстов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hash_context_streebog_pbkdf2_g( ak_streebog *ctx, ak_uint64 **n,
+                                                         ak_uint64 **m, const size_t count )
+{
+  if( count == 1 ) ak_hash_context_streebog_g( ctx[0], n[0], m[0] );
+   else ak_hash_context_streebog_g_multi( ctx, n, m, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выполняет итерации с номерами 2, ..., `iterations` алгоритма PBKDF2
+    (Р 50.1.111-2016, раздел 4) одновременно для `count` (не более \ref ak_hash_streebog_lanes)
+    паролей. Поскольку в каждой итерации алгоритм HMAC применяется к одному блоку длины 64 октета,
+    вместо общего интерфейса контекста hmac используется прямая последовательность из четырех
+    преобразований G для каждого из двух вызовов функции хеширования; преобразования G для
+    различных паролей выполняются совместно.
+
+    @param ipad Массив состояний функции Стрибог512 после обработки блока \f$ K \oplus ipad \f$.
+    @param opad Массив состояний функции Стрибог512 после обработки блока \f$ K \oplus opad \f$.
+    @param u Массив значений \f$ U_1 \f$; после завершения содержит последние значения \f$ U_c \f$.
+    @param t Массив накапливаемых сумм \f$ U_1 \oplus \ldots \oplus U_c \f$; к моменту вызова
+    должен содержать значения \f$ U_1 \f$.
+    @param count Количество одновременно обрабатываемых паролей.
+    @param iterations Общее количество итераций алгоритма PBKDF2.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hash_streebog512_pbkdf2_iterations( ak_streebog ipad, ak_streebog opad,
+               ak_uint64 (*u)[8], ak_uint64 (*t)[8], const size_t count, const size_t iterations )
+{
+  size_t it = 0, j = 0, i = 0, half = 0;
+  ak_uint64 pad[8];
+  struct streebog sx[ak_hash_streebog_lanes];
+  ak_streebog ctx[ak_hash_streebog_lanes];
+  ak_uint64 *n[ak_hash_streebog_lanes], *m[ak_hash_streebog_lanes];
+
+ /* дополнение пустого последнего блока */
+  memset( pad, 0, sizeof( pad ));
+  (( ak_uint8 *)pad )[0] = 1;
+
+  for( it = 1; it < iterations; it++ ) {
+     for( half = 0; half < 2; half++ ) {
+        for( j = 0; j < count; j++ ) {
+           memcpy( sx+j, half ? opad+j : ipad+j, sizeof( struct streebog ));
+           ctx[j] = sx+j; n[j] = sx[j].n; m[j] = u[j];
+        }
+       /* блок данных длины 64 октета */
+        ak_hash_context_streebog_pbkdf2_g( ctx, n, m, count );
+        for( j = 0; j < count; j++ ) {
+           ak_hash_context_streebog_add( sx+j, 512 );
+           ak_hash_context_streebog_sadd( sx+j, u[j] );
+           m[j] = pad;
+        }
+       /* пустой последний блок и финальные преобразования */
+        ak_hash_context_streebog_pbkdf2_g( ctx, n, m, count );
+        for( j = 0; j < count; j++ ) {
+           ak_hash_context_streebog_sadd( sx+j, pad );
+           n[j] = NULL; m[j] = sx[j].n;
+        }
+        ak_hash_context_streebog_pbkdf2_g( ctx, n, m, count );
+        for( j = 0; j < count; j++ ) m[j] = sx[j].sigma;
+        ak_hash_context_streebog_pbkdf2_g( ctx, n, m, count );
+        for( j = 0; j < count; j++ ) memcpy( u[j], sx[j].h, 64 );
+     }
+     for( j = 0; j < count; j++ )
+        for( i = 0; i < 8; i++ ) t[j][i] ^= u[j][i];
+  }
+  memset( sx, 0, sizeof( sx ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на хеширование части списка файлов (файлы с номерами first, first + step, ...). */
+ typedef struct hash_files {
+  /*! \brief Контекст функции хеширования. */
+   ak_hash hctx;
+  /*! \brief Список имен файлов. */
+   const char **filenames;
+  /*! \brief Общее количество файлов. */
+   size_t count;
+  /*! \brief Номер первого обрабатываемого файла. */
+   size_t first;
+  /*! \brief Шаг перебора файлов. */
+   size_t step;
+  /*! \brief Область памяти для результатов. */
+   ak_uint8 *out;
+  /*! \brief Размер одного результата. */
+   size_t out_size;
+  /*! \brief Код последней возникшей ошибки. */
+   int error;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Собственный контекст функции хеширования, используемый вспомогательным потоком. */
+   struct hash ctx;
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что задание выполняется вспомогательным потоком. */
+   bool_t threaded;
+#endif
+} *ak_hash_files;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно хеширует файлы, входящие в задание. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hash_files_update( ak_hash_files hf )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+
+  hf->error = ak_error_ok;
+  for( i = hf->first; i < hf->count; i += hf->step ) {
+     if(( error = ak_hash_file( hf->hctx, hf->filenames[i],
+                                      hf->out + i*hf->out_size, hf->out_size )) != ak_error_ok ) {
+       memset( hf->out + i*hf->out_size, 0, hf->out_size );
+       hf->error = error;
+     }
+  }
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hash_files_thread( void *ptr )
+{
+  ak_hash_files_update(( ak_hash_files )ptr );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет хеш-коды для каждого файла из заданного списка.
+    Результат совпадает с последовательным вызовом функции ak_hash_file() для каждого файла.
+
+    При наличии поддержки потоков файлы распределяются между несколькими потоками
+    (количество потоков определяется опцией `threads_count`), каждый из которых использует
+    собственный контекст функции хеширования.
+
+    @param hctx Контекст функции хеширования
+    @param filenames Массив из `count` имен файлов.
+    @param count Количество файлов.
+    @param out Область памяти, куда последовательно помещаются `count` хеш-кодов,
+    каждый длины `out_size` октетов. Память должна быть заранее выделена.
+    @param out_size Размер области памяти (в октетах) для одного хеш-кода.
+
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). Если хотя бы один файл
+    не удалось обработать, возвращается код ошибки, а соответствующий хеш-код заполняется нулями.  */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_file_list( ak_hash hctx, const char **filenames, const size_t count,
+                                                           ak_pointer out, const size_t out_size )
+{
+  size_t threads = 1;
+  struct hash_files main_task;
+#ifdef AK_HAVE_PTHREAD_H
+  size_t i = 0;
+  ak_hash_files tasks = NULL;
+#endif
+
+  if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                            "using null pointer to hash context" );
+  if( !count ) return ak_error_ok;
+  if( filenames == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                          "using null pointer to list of files" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to result buffer" );
+  if( !out_size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                            "using zero length of result buffer" );
+  main_task.hctx = hctx;
+  main_task.filenames = filenames;
+  main_task.count = count;
+  main_task.first = 0;
+  main_task.out = out;
+  main_task.out_size = out_size;
+
+ /* определяем количество потоков */
+  threads = ak_min( ak_libakrypt_get_threads_count(), count );
+  main_task.step = threads;
+#ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && (( tasks = malloc(( threads-1 )*sizeof( struct hash_files ))) != NULL )) {
+    for( i = 0; i < threads-1; i++ ) {
+       tasks[i] = main_task;
+       tasks[i].first = i+1;
+       tasks[i].threaded = ak_false;
+       if( ak_hash_create_oid( &tasks[i].ctx, hctx->oid ) == ak_error_ok ) {
+         tasks[i].hctx = &tasks[i].ctx;
+         if( pthread_create( &tasks[i].thread, NULL, ak_hash_files_thread, tasks+i ) == 0 )
+           tasks[i].threaded = ak_true;
+          else {
+            ak_error_message( ak_error_undefined_function, __func__,
+                                                                 "wrong creation of a thread" );
+            ak_hash_destroy( &tasks[i].ctx );
+            tasks[i].hctx = hctx;
+          }
+       }
+      /* обрабатываем задание самостоятельно */
+       if( !tasks[i].threaded ) ak_hash_files_update( tasks+i );
+    }
+    ak_hash_files_update( &main_task );
+    for( i = 0; i < threads-1; i++ ) {
+       if( tasks[i].threaded ) {
+         pthread_join( tasks[i].thread, NULL );
+         ak_hash_destroy( &tasks[i].ctx );
+       }
+       if( tasks[i].error != ak_error_ok ) main_task.error = tasks[i].error;
+    }
+    free( tasks );
+  }
+   else {
+     main_task.step = 1;
+     ak_hash_files_update( &main_task );
+   }
+#else
+  main_task.step = 1;
+  ak_hash_files_update( &main_task );
+#endif
+
+  if( main_task.error != ak_error_ok )
+    return ak_error_message( main_task.error, __func__, "incorrect hashing of some files" );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                          Функции тестирования алгоритмов работы                                 */
 /* ----------------------------------------------------------------------------------------------- */
@@ -1815,6 +2238,30 @@
   if( audit >= ak_log_maximum )
       ak_error_message_fmt( ak_error_ok, __func__ ,
                                                "the random walk test with %u steps is Ok", steps );
+
+ /* одновременное хеширование всех тестовых сообщений */
+  {
+    ak_uint8 mout[5*32];
+    ak_pointer min[5] = { streebog_M1_message, streebog_M2_message,
+     "The quick brown fox jumps over the lazy dog", "The quick brown fox jumps over the lazy dog.", "" };
+    size_t msize[5] = { 63, 72, 43, 44, 0 };
+
+    memset( mout, 0, sizeof( mout ));
+    ak_hash_multi( &ctx, 5, min, msize, mout, 32 );
+    if(( !ak_ptr_is_equal_with_log( mout, streebog256_testM1, 32 )) ||
+       ( !ak_ptr_is_equal_with_log( mout +32, streebog256_testM2, 32 )) ||
+       ( !ak_ptr_is_equal_with_log( mout +64, streebog256_testM3, 32 )) ||
+       ( !ak_ptr_is_equal_with_log( mout +96, streebog256_testM4, 32 )) ||
+       ( !ak_ptr_is_equal_with_log( mout +128, streebog256_testM5, 32 ))) {
+      ak_error_message( ak_error_not_equal_data, __func__ ,
+                                            "the simultaneous hashing of test messages is wrong" );
+      result = ak_false;
+      goto lab_exit;
+    }
+    if( audit >= ak_log_maximum )
+      ak_error_message( ak_error_ok, __func__ ,
+                                               "the simultaneous hashing of test messages is Ok" );
+  }
  /* уничтожаем контекст */
  lab_exit:
    ak_random_destroy( &rnd );
@@ -17,6 +17,55 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сохранение текущего состояния функции хеширования в маскированном виде.
+    \details Функция вызывается сразу после обработки блока \f$ K \oplus ipad \f$
+    (или \f$ K \oplus opad \f$); значение состояния складывается с новой случайной маской.
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.
+    \param offset Смещение (в словах) сохраняемого состояния: 0 для ipad, 24 для opad.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_internal_states_store( ak_hmac hctx, const size_t offset )
+{
+  size_t i = 0;
+  ak_uint64 *st = hctx->states + offset, *mk = hctx->masks + offset;
+
+  ak_random_ptr( &hctx->key.generator, mk, 24*sizeof( ak_uint64 ));
+  for( i = 0; i < 8; i++ ) {
+     st[i] = hctx->ctx.data.sctx.h[i] ^ mk[i];
+     st[i+8] = hctx->ctx.data.sctx.n[i] ^ mk[i+8];
+     st[i+16] = hctx->ctx.data.sctx.sigma[i] ^ mk[i+16];
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Восстановление сохраненного состояния функции хеширования.
+    \details Функция заменяет вызов ak_hash_clean() и обработку блока \f$ K \oplus ipad \f$
+    (или \f$ K \oplus opad \f$), т.е. экономит одно сжимающее отображение. После
+    восстановления сохраненное состояние перемаскируется.
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.
+    \param offset Смещение (в словах) восстанавливаемого состояния: 0 для ipad, 24 для opad.   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_internal_states_load( ak_hmac hctx, const size_t offset )
+{
+  size_t i = 0;
+  ak_uint64 x[24], *st = hctx->states + offset, *mk = hctx->masks + offset;
+
+ /* внутренний буффер функции хеширования должен быть пуст */
+  memset( hctx->ctx.mctx.data, 0, ak_mac_max_buffer_size );
+  hctx->ctx.mctx.length = 0;
+
+  ak_random_ptr( &hctx->key.generator, x, sizeof( x ));
+  for( i = 0; i < 8; i++ ) {
+     hctx->ctx.data.sctx.h[i] = st[i] ^ mk[i];
+     hctx->ctx.data.sctx.n[i] = st[i+8] ^ mk[i+8];
+     hctx->ctx.data.sctx.sigma[i] = st[i+16] ^ mk[i+16];
+  }
+  for( i = 0; i < 24; i++ ) { st[i] ^= x[i]; mk[i] ^= x[i]; }
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Очистка контекста алгоритма hmac.
@@ -43,6 +92,13 @@
   if( hctx->mctx.bsize > sizeof( buffer )) return ak_error_message( ak_error_wrong_length,
                                             __func__, "using hash function with huge block size" );
 
+ /* если состояние после обработки блока K^ipad уже вычислено, то просто восстанавливаем его */
+  if( hctx->states_flags&0x1 ) {
+    ak_hmac_internal_states_load( hctx, 0 );
+    hctx->key.resource.value.counter--; /* мы использовали ключ один раз */
+    return error;
+  }
+
  /* фомируем маскированное значение ключа */
   len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
   for( idx = 0; idx < len; idx++, jdx++ ) {
@@ -58,6 +114,10 @@
  /* обновляем состояние контекста хеширования */
   if(( error = ak_hash_update( &hctx->ctx, buffer, hctx->mctx.bsize )) != ak_error_ok )
     ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
+   else { /* запоминаем полученное состояние */
+     ak_hmac_internal_states_store( hctx, 0 );
+     hctx->states_flags |= 0x1;
+   }
 
  /* очищаем буффер */
   ak_ptr_wipe( buffer, sizeof( buffer ), &hctx->key.generator );
@@ -134,34 +194,39 @@
                                                             sizeof( temporary ))) != ak_error_ok )
     return ak_error_message( error, __func__ , "wrong updating of finalized data" );
 
- /* фомируем маскированное значение ключа */
-  len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
-  for( idx = 0; idx < len; idx++ , jdx++ ) {
-     keybuffer[idx] = hctx->key.key[idx] ^ 0x5C;
-     keybuffer[idx] ^= hctx->key.key[jdx];
-  }
-  for( ; idx < hctx->mctx.bsize; idx++ ) keybuffer[idx] = 0x5C;
-
-
  /* различие с nmac в последней функции хеширования */
   if( hctx->nmac_second_hash_oid ) {
     ak_hash_destroy( &hctx->ctx );
     hctx->nmac_second_hash_oid->func.first.create( &hctx->ctx );
   }
 
- /* возвращаем контекст хеширования в начальное состояние */
-  if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong cleaning of hash function context" );
-
- /* обновляем состояние контекста хеширования */
-  if(( error = ak_hash_update( &hctx->ctx, keybuffer, hctx->mctx.bsize )) != ak_error_ok )
-    return ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
-
- /* очищаем буффер */
-  ak_ptr_wipe( keybuffer, sizeof( keybuffer ), &hctx->key.generator );
+ /* если состояние после обработки блока K^opad уже вычислено, то восстанавливаем его */
+  if( hctx->states_flags&0x2 ) ak_hmac_internal_states_load( hctx, 24 );
+   else {
+    /* фомируем маскированное значение ключа */
+     len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
+     for( idx = 0; idx < len; idx++ , jdx++ ) {
+        keybuffer[idx] = hctx->key.key[idx] ^ 0x5C;
+        keybuffer[idx] ^= hctx->key.key[jdx];
+     }
+     for( ; idx < hctx->mctx.bsize; idx++ ) keybuffer[idx] = 0x5C;
+
+    /* возвращаем контекст хеширования в начальное состояние */
+     if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok )
+       return ak_error_message( error, __func__, "wrong cleaning of hash function context" );
+
+    /* обновляем состояние контекста хеширования */
+     if(( error = ak_hash_update( &hctx->ctx, keybuffer, hctx->mctx.bsize )) != ak_error_ok )
+       return ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
+
+    /* запоминаем полученное состояние и очищаем буффер */
+     ak_hmac_internal_states_store( hctx, 24 );
+     hctx->states_flags |= 0x2;
+     ak_ptr_wipe( keybuffer, sizeof( keybuffer ), &hctx->key.generator );
+     hctx->key.set_mask( &hctx->key );
+   }
 
  /* ресурс ключа */
-  hctx->key.set_mask( &hctx->key );
   hctx->key.resource.value.counter--; /* мы использовали ключ один раз */
 
  /* последний update/finalize и возврат результата */
@@ -200,6 +265,11 @@
   if( oid->mode != algorithm )
     return ak_error_message( ak_error_oid_mode, __func__ , "using oid with wrong mode" );
 
+ /* сохраненные состояния функции хеширования еще не вычислены */
+  memset( hctx->states, 0, sizeof( hctx->states ));
+  memset( hctx->masks, 0, sizeof( hctx->masks ));
+  hctx->states_flags = 0;
+
  /* получаем oid бесключевой функции хеширования */
   if(( hashoid = ak_oid_find_by_name( oid->name[0]+5 )) == NULL )
     return ak_error_message( ak_error_get_value(), __func__ ,
@@ -233,7 +303,6 @@
   hctx->key.oid = oid;
  /* устанавливаем указатель на второй алгоритм хеширования */
   hctx->nmac_second_hash_oid = NULL;
-
  return error;
 }
 
@@ -266,6 +335,25 @@
   return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается при смене ключа и при уничтожении контекста: сохраненные состояния,
+    вычисленные для предыдущего значения ключа, перестают использоваться и должны быть
+    уничтожены, даже если они не были вычислены полностью.
+
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hmac_wipe_internal_states( ak_hmac hctx )
+{
+  if( hctx->key.generator.random != NULL ) {
+    ak_ptr_wipe( hctx->states, sizeof( hctx->states ), &hctx->key.generator );
+    ak_ptr_wipe( hctx->masks, sizeof( hctx->masks ), &hctx->key.generator );
+  } else {
+      memset( hctx->states, 0, sizeof( hctx->states ));
+      memset( hctx->masks, 0, sizeof( hctx->masks ));
+    }
+  hctx->states_flags = 0;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param hctx Контекст алгоритма HMAC выработки имитовставки.
     \return В случае успешного завершения функций возвращает \ref ak_error_ok. В случае
@@ -278,6 +366,7 @@
                                                             "using null pointer to hmac context" );
   if(( error = ak_hash_destroy( &hctx->ctx )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect destroying of hash context" );
+  ak_hmac_wipe_internal_states( hctx );
   if(( error = ak_skey_destroy( &hctx->key )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect destroying of secret key context" );
   if(( error = ak_mac_destroy( &hctx->mctx )) != ak_error_ok )
@@ -303,6 +392,8 @@
   int error = ak_error_ok;
   if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                             "using null pointer to hmac context" );
+ /* при смене ключа сохраненные состояния функции хеширования становятся неверными */
+  ak_hmac_wipe_internal_states( hctx );
  /* вспоминаем, что если ключ длиннее, чем длина входного блока хэш-функции, то в качестве
                                                                       ключа используется его хэш */
   if( size > hctx->mctx.bsize ) {
@@ -350,6 +441,8 @@
   int error = ak_error_ok;
   if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                         "using null pointer to hmac context" );
+ /* при смене ключа сохраненные состояния функции хеширования становятся неверными */
+  ak_hmac_wipe_internal_states( hctx );
   if(( error = ak_skey_set_key_random( &hctx->key, generator )) != ak_error_ok )
     return ak_error_message( error, __func__ , "incorrect assigning a secret key value" );
 
@@ -385,6 +478,7 @@
   int error = ak_error_ok;
   if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                         "using null pointer to hmac context" );
+  ak_hmac_wipe_internal_states( hctx );
   if(( error = ak_skey_set_key_from_password( &hctx->key,
                                           pass, pass_size, salt, salt_size )) != ak_error_ok )
     return ak_error_message( error, __func__ , "incorrect assigning a secret key value" );
@@ -540,6 +634,97 @@
  return hctx->mctx.bsize;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление первой итерации алгоритма PBKDF2 и состояний функции хеширования
+    после обработки блоков \f$ K \oplus ipad \f$ и \f$ K \oplus opad \f$.
+    \details Значение \f$ U_1 \f$ вычисляется с помощью обычного контекста hmac-streebog512,
+    из которого затем извлекаются сохраненные (маскированные) состояния функции хеширования.
+
+    @param pass Пароль.
+    @param pass_size Размер пароля в байтах.
+    @param salt Инициализационный вектор.
+    @param salt_size Размер инициализационного вектора в байтах.
+    @param ipad Состояние функции хеширования после обработки блока \f$ K \oplus ipad \f$.
+    @param opad Состояние функции хеширования после обработки блока \f$ K \oplus opad \f$.
+    @param u Массив, куда помещается значение \f$ U_1 \f$.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_first( const ak_pointer pass, const size_t pass_size,
+                                      const ak_pointer salt, const size_t salt_size,
+                                              ak_streebog ipad, ak_streebog opad, ak_uint64 *u )
+{
+  size_t i = 0;
+  struct hmac hctx;
+  ak_uint8 counter[4] = { 0, 0, 0, 1 };
+  int error = ak_error_ok;
+
+ /* создаем контекст алгоритма hmac и определяем его ключ */
+  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
+  if(( error = ak_hmac_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
+    goto lab_exit;
+  }
+
+ /* вычисляем значение первой строки U1  */
+  if(( error = ak_hmac_clean( &hctx )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
+    goto lab_exit;
+  }
+  if(( error = ak_hmac_update( &hctx, salt, salt_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect updating of internal hmac context");
+    goto lab_exit;
+  }
+  if(( error = ak_hmac_finalize( &hctx, counter, 4, u, 64 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
+    goto lab_exit;
+  }
+  if( hctx.states_flags != 0x3 ) {
+    ak_error_message( error = ak_error_undefined_value, __func__,
+                                                  "using hmac context without internal states" );
+    goto lab_exit;
+  }
+
+ /* снимаем маски с сохраненных состояний */
+  for( i = 0; i < 8; i++ ) {
+     ipad->h[i] = hctx.states[i] ^ hctx.masks[i];
+     ipad->n[i] = hctx.states[i+8] ^ hctx.masks[i+8];
+     ipad->sigma[i] = hctx.states[i+16] ^ hctx.masks[i+16];
+     opad->h[i] = hctx.states[i+24] ^ hctx.masks[i+24];
+     opad->n[i] = hctx.states[i+32] ^ hctx.masks[i+32];
+     opad->sigma[i] = hctx.states[i+40] ^ hctx.masks[i+40];
+  }
+  ipad->hsize = opad->hsize = 64;
+
+  lab_exit: ak_hmac_destroy( &hctx );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция уничтожает промежуточные значения алгоритма PBKDF2 для `count` паролей:
+    значения `u` и `t`, а также немаскированные состояния `ipad` и `opad` функции хеширования.   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_wipe( ak_pointer u, ak_pointer t,
+                                      struct streebog *ipad, struct streebog *opad, size_t count )
+{
+  struct random generator;
+
+  if( ak_random_create_lcg( &generator ) != ak_error_ok ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect creation of random generator" );
+    memset( u, 0, count*64 );
+    memset( t, 0, count*64 );
+    memset( ipad, 0, count*sizeof( struct streebog ));
+    memset( opad, 0, count*sizeof( struct streebog ));
+    return;
+  }
+  ak_ptr_wipe( u, count*64, &generator );
+  ak_ptr_wipe( t, count*64, &generator );
+  ak_ptr_wipe( ipad, count*sizeof( struct streebog ), &generator );
+  ak_ptr_wipe( opad, count*sizeof( struct streebog ), &generator );
+  ak_random_destroy( &generator );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Пароль должен представлять собой ненулевую строку символов в utf8
     кодировке. Размер вырабатываемого ключевого вектора может колебаться от 32-х до 64-х байт.
@@ -558,6 +743,10 @@
     @param out Указатель на массив, куда будет помещен результат; под данный массив должна быть
     заранее выделена память не менее, чем dklen байт.
 
+    Первая итерация вычисляется с помощью контекста hmac-streebog512; остальные итерации
+    выполняются функцией ak_hash_streebog512_pbkdf2_iterations(), которая начинает каждое
+    вычисление hmac с заранее вычисленных состояний функции хеширования.
+
     @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
     возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
@@ -565,10 +754,9 @@
          const size_t pass_size, const ak_pointer salt, const size_t salt_size, const size_t cnt,
                                                                const size_t dklen, ak_pointer out )
 {
-  struct hmac hctx;
-  ak_uint8 result[64];
   int error = ak_error_ok;
-  size_t idx = 0, jdx = 0;
+  struct streebog ipad, opad;
+  ak_uint64 u[1][8], t[1][8];
 
  /* в начале, многочисленные проверки входных параметров */
   if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -581,42 +769,199 @@
                                        __func__ , "using a wrong length for resulting key vector" );
   if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                      "using null pointer to resulting key vector" );
- /* создаем контекст алгоритма hmac и определяем его ключ */
-  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
-  if(( error = ak_hmac_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
-    goto lab_exit;
-  }
+ /* вычисляем U1 */
+  if(( error = ak_hmac_pbkdf2_streebog512_first( pass, pass_size,
+                                           salt, salt_size, &ipad, &opad, u[0] )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect evaluation of the first iteration" );
 
- /* начальная инициализация промежуточного вектора */
-  memset( result, 0, 64 );
-  result[3] = 1;
+ /* теперь основной цикл по значению аргумента c */
+  memcpy( t[0], u[0], 64 );
+  ak_hash_streebog512_pbkdf2_iterations( &ipad, &opad, u, t, 1, cnt );
+  memcpy( out, (ak_uint8 *)t[0] +64-dklen, dklen );
 
- /* вычисляем значение первой строки U1  */
-  if(( error = ak_hmac_clean( &hctx )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
-    goto lab_exit;
-  }
-  if(( error = ak_hmac_update( &hctx, salt, salt_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect updating of internal hmac context");
-    goto lab_exit;
+  ak_hmac_pbkdf2_wipe( u, t, &ipad, &opad, 1 );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на выработку ключей из части списка паролей
+    (пароли с номерами first, first + step, ...). */
+ typedef struct hmac_pbkdf2_task {
+  /*! \brief Массив паролей. */
+   ak_pointer *pass;
+  /*! \brief Массив длин паролей. */
+   const size_t *pass_size;
+  /*! \brief Массив инициализационных векторов. */
+   ak_pointer *salt;
+  /*! \brief Массив длин инициализационных векторов. */
+   const size_t *salt_size;
+  /*! \brief Общее количество паролей. */
+   size_t count;
+  /*! \brief Количество итераций алгоритма PBKDF2. */
+   size_t cnt;
+  /*! \brief Длина вырабатываемых ключей. */
+   size_t dklen;
+  /*! \brief Номер первого обрабатываемого пароля. */
+   size_t first;
+  /*! \brief Шаг перебора паролей. */
+   size_t step;
+  /*! \brief Область памяти для результатов. */
+   ak_uint8 *out;
+  /*! \brief Код последней возникшей ошибки. */
+   int error;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что задание выполняется вспомогательным потоком. */
+   bool_t threaded;
+#endif
+} *ak_hmac_pbkdf2_task;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает ключи для паролей, входящих в задание.
+    \details Пароли обрабатываются группами по \ref ak_hash_streebog_lanes штук. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_task_update( ak_hmac_pbkdf2_task pt )
+{
+  int error = ak_error_ok;
+  size_t i = 0, j = 0, active = 0, idx[ak_hash_streebog_lanes];
+  struct streebog ipad[ak_hash_streebog_lanes], opad[ak_hash_streebog_lanes];
+  ak_uint64 u[ak_hash_streebog_lanes][8], t[ak_hash_streebog_lanes][8];
+
+  pt->error = ak_error_ok;
+  for( i = pt->first; i < pt->count; ) {
+    /* формируем группу паролей */
+     for( active = 0; ( active < ak_hash_streebog_lanes ) && ( i < pt->count ); i += pt->step ) {
+        if(( error = ak_hmac_pbkdf2_streebog512_first( pt->pass[i], pt->pass_size[i],
+                          pt->salt[i], pt->salt_size[i], ipad+active, opad+active, u[active] ))
+                                                                                 != ak_error_ok ) {
+          memset( pt->out + i*pt->dklen, 0, pt->dklen );
+          pt->error = error;
+          continue;
+        }
+        memcpy( t[active], u[active], 64 );
+        idx[active++] = i;
+     }
+    /* выполняем итерации одновременно для всех паролей группы */
+     if( !active ) continue;
+     ak_hash_streebog512_pbkdf2_iterations( ipad, opad, u, t, active, pt->cnt );
+     for( j = 0; j < active; j++ )
+        memcpy( pt->out + idx[j]*pt->dklen, (ak_uint8 *)t[j] +64-pt->dklen, pt->dklen );
   }
-  if(( error = ak_hmac_finalize( &hctx, result, 4, result, sizeof( result ))) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
-    goto lab_exit;
+
+  ak_hmac_pbkdf2_wipe( u, t, ipad, opad, ak_hash_streebog_lanes );
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hmac_pbkdf2_thread( void *ptr )
+{
+  ak_hmac_pbkdf2_task_update(( ak_hmac_pbkdf2_task )ptr );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключевые векторы для `count` пар (пароль, инициализационный вектор)
+    с одинаковым количеством итераций. Результат совпадает с последовательным вызовом функции
+    ak_hmac_pbkdf2_streebog512() для каждой пары. Функция предназначена для массовой обработки
+    ключевых контейнеров.
+
+    Пароли обрабатываются группами по \ref ak_hash_streebog_lanes штук, итерации для паролей
+    одной группы выполняются совместно. При наличии поддержки потоков пароли распределяются
+    между несколькими потоками (количество потоков определяется опцией `threads_count`).
+
+    @param count Количество паролей.
+    @param pass Массив из `count` паролей.
+    @param pass_size Массив из `count` длин паролей (в байтах), каждая длина отлична от нуля.
+    @param salt Массив из `count` инициализационных векторов.
+    @param salt_size Массив из `count` длин инициализационных векторов (в байтах).
+    @param cnt Количество итераций алгоритма.
+    @param dklen Длина каждого вырабатываемого ключевого вектора в байтах, величина должна
+    принимать значение от 32-х до 64-х.
+    @param out Область памяти, куда последовательно помещаются `count` ключевых векторов,
+    каждый длины `dklen` байт. Память должна быть заранее выделена.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. Если хотя бы для одного
+    пароля ключ не был выработан, возвращается код ошибки, а соответствующий ключевой вектор
+    заполняется нулями.                                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_pbkdf2_streebog512_multi( const size_t count, ak_pointer *pass,
+                   const size_t *pass_size, ak_pointer *salt, const size_t *salt_size,
+                                           const size_t cnt, const size_t dklen, ak_pointer out )
+{
+  size_t i = 0, threads = 1;
+  struct hmac_pbkdf2_task main_task;
+#ifdef AK_HAVE_PTHREAD_H
+  ak_hmac_pbkdf2_task tasks = NULL;
+#endif
+
+  if( !count ) return ak_error_ok;
+  if(( pass == NULL ) || ( pass_size == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                  __func__ , "using null pointer to passwords" );
+  if(( salt == NULL ) || ( salt_size == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                       __func__ , "using null pointer to salts" );
+  if(( dklen < 32 ) || ( dklen > 64 )) return ak_error_message( ak_error_wrong_length,
+                                       __func__ , "using a wrong length for resulting key vector" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                    "using null pointer to resulting key vectors" );
+  for( i = 0; i < count; i++ ) {
+     if(( pass[i] == NULL ) || ( salt[i] == NULL )) return ak_error_message(
+                           ak_error_null_pointer, __func__ , "using null pointer to password" );
+     if( !pass_size[i] ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                   "using a zero length password" );
   }
-  memcpy( out, result+64-dklen, dklen );
 
- /* теперь основной цикл по значению аргумента c */
-  for( idx = 1; idx < cnt; idx++ ) {
-     ak_hmac_ptr( &hctx, result, 64, result, sizeof( result ));
-     for( jdx = 0; jdx < dklen; jdx++ ) ((ak_uint8 *)out)[jdx] ^= result[64-dklen+jdx];
+  main_task.pass = pass;
+  main_task.pass_size = pass_size;
+  main_task.salt = salt;
+  main_task.salt_size = salt_size;
+  main_task.count = count;
+  main_task.cnt = cnt;
+  main_task.dklen = dklen;
+  main_task.first = 0;
+  main_task.out = out;
+
+ /* определяем количество потоков так, чтобы каждый поток обрабатывал полные группы паролей */
+  threads = ak_min( ak_libakrypt_get_threads_count(),
+                         ( count + ak_hash_streebog_lanes - 1 )/ak_hash_streebog_lanes );
+  if( !threads ) threads = 1;
+  main_task.step = threads;
+#ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) &&
+                  (( tasks = malloc(( threads-1 )*sizeof( struct hmac_pbkdf2_task ))) != NULL )) {
+    for( i = 0; i < threads-1; i++ ) {
+       tasks[i] = main_task;
+       tasks[i].first = i+1;
+       tasks[i].threaded = ak_false;
+       if( pthread_create( &tasks[i].thread, NULL, ak_hmac_pbkdf2_thread, tasks+i ) == 0 )
+         tasks[i].threaded = ak_true;
+        else {
+          ak_error_message( ak_error_undefined_function, __func__, "wrong creation of a thread" );
+          ak_hmac_pbkdf2_task_update( tasks+i );
+        }
+    }
+    ak_hmac_pbkdf2_task_update( &main_task );
+    for( i = 0; i < threads-1; i++ ) {
+       if( tasks[i].threaded ) pthread_join( tasks[i].thread, NULL );
+       if( tasks[i].error != ak_error_ok ) main_task.error = tasks[i].error;
+    }
+    free( tasks );
   }
-  memset( result, 0, 64 );
+   else {
+     main_task.step = 1;
+     ak_hmac_pbkdf2_task_update( &main_task );
+   }
+#else
+  main_task.step = 1;
+  ak_hmac_pbkdf2_task_update( &main_task );
+#endif
 
-  lab_exit: ak_hmac_destroy( &hctx );
- return error;
+  if( main_task.error != ak_error_ok )
+    return ak_error_message( main_task.error, __func__, "incorrect derivation of some keys" );
+ return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -978,7 +1323,9 @@
            salt_one[4]     = "salt",
            salt_two[5]     = { 's', 'a', 0, 'l', 't' };
 
-  ak_uint8 out[64];
+  ak_uint8 out[64], outs[128];
+  ak_pointer passes[2] = { password_one, password_two }, salts[2] = { salt_one, salt_two };
+  size_t pass_sizes[2] = { 8, 9 }, salt_sizes[2] = { 4, 5 };
   int error = ak_error_ok;
   int audit = ak_log_get_level();
 
@@ -1037,6 +1384,20 @@
   }
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                              "the 4th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* третий и четвертый тесты, выполняемые одновременно */
+  if(( error = ak_hmac_pbkdf2_streebog512_multi( 2, passes,
+                              pass_sizes, salts, salt_sizes, 4096, 64, outs )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect transformation of several passwords to keys");
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( outs, R3, 64 ) || !ak_ptr_is_equal_with_log( outs+64, R4, 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                          "wrong multiple test for pbkdf2 from R 50.1.111-2016" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                        "the multiple test for pbkdf2 from R 50.1.111-2016 is Ok" );
  return ak_true;
 }
 
@@ -17,6 +17,9 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*  Генерация производных ключей согласно обобщенному алгоритму из Р 50.1.113-2016                 */
@@ -345,128 +348,28 @@
  #define ak_tlstree_state_get_block( type ) (( type&0x3 ) << 5)
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \param type Тип алгоритма kdf, допустимыми значениями являются kdf256, kdf512 и kdfnmac
-    \param ctx Контекст алгоритма TLSTREE
-    \param master_key Указатель на область памяти
-    \param master_key_size Размер памяти в байтах
-    \param index Порядковый номер вырабатываемого ключа
-    \param tlstree Набор констант, являющийся параметром алгоритма
-
-    \return В случае возникновения ошибки функция возвращает ее код. В случае успеха
-    возвращается \ref ak_error_ok (ноль).                                                          */
-/* ----------------------------------------------------------------------------------------------- */
- int ak_tlstree_state_create( kdf_t type, ak_tlstree_state ctx, ak_uint8 *master_key,
-                                const size_t master_key_size, ak_uint64 index, tlstree_t tlstree )
-{
-    ak_uint64 seed;
-    size_t b32 = ak_tlstree_state_get_block( type ); /* размер хеш-кода: 32 или 64 */
-    int error = ak_error_ok;
-
-   /* проверки */
-    if(( type != kdf256 ) && ( type != kdf512 ) && ( type != kdfnmac ))
-      return ak_error_message( ak_error_wrong_key_type, __func__,
-           "using incorrect type of key defivation function (must ne: kdf256, kdf512 or kdfnmac" );
-    if( ctx == NULL )
-      return ak_error_message( ak_error_null_pointer, __func__,
-                                                           "using null-pointer to tlstree state" );
-   /* размещаем исходный ключ */
-    memset( ctx, 0, sizeof( struct tlstree_state ));
-    ctx->key_number = index;
-    ctx->state = tlstree;
-    ctx->type = type;
-    memcpy( ctx->key, master_key, ak_min( b32, master_key_size ));
-
-   /* первая итерация */
-  #ifdef AK_LITTLE_ENDIAN
-    seed = bswap_64( ctx->ind1 = ( index&tlstree_constant_values[tlstree].c1 ));
-  #else
-    seed = ctx->ind1 = ( index&tlstree_constant_values[tlstree].c1 );
-  #endif
-    if(( error = ak_skey_derive_kdf_hmac(
-                                        ctx->type,
-                                        ctx->key,
-                                        b32,
-                                        (ak_uint8 *) "level1",
-                                        6,
-                                        (ak_uint8 *) &seed,
-                                        8,
-                                        ctx->key +b32,
-                                        b32 )) != ak_error_ok ) {
-      ak_tlstree_state_destroy( ctx );
-      return ak_error_message( error, __func__, "incorrect creation of temporary K1 value" );
-    }
-
-   /* вторая итерация */
-  #ifdef AK_LITTLE_ENDIAN
-    seed = bswap_64( ctx->ind2 = ( index&tlstree_constant_values[tlstree].c2 ));
-  #else
-    seed = ctx->ind2 = ( index&tlstree_constant_values[tlstree].c2 );
-  #endif
-    if(( error = ak_skey_derive_kdf_hmac(
-                                        ctx->type,
-                                        ctx->key +b32,
-                                        b32,
-                                        (ak_uint8 *) "level2",
-                                        6,
-                                        (ak_uint8 *) &seed,
-                                        8,
-                                        ctx->key + (2*b32),
-                                        b32 )) != ak_error_ok ) {
-      ak_tlstree_state_destroy( ctx );
-      return ak_error_message( error, __func__, "incorrect creation of temporary K2 value" );
-    }
-
-   /* третья итерация */
-  #ifdef AK_LITTLE_ENDIAN
-    seed = bswap_64( ctx->ind3 = ( index&tlstree_constant_values[tlstree].c3 ));
-  #else
-    seed = ctx->ind3 = ( index&tlstree_constant_values[tlstree].c3 );
-  #endif
-    if(( error = ak_skey_derive_kdf_hmac(
-                                        ctx->type,
-                                        ctx->key + (2*b32),
-                                        b32,
-                                        (ak_uint8 *) "level3",
-                                        6,
-                                        (ak_uint8 *) &seed,
-                                        8,
-                                        ctx->key + (3*b32),
-                                        b32 )) != ak_error_ok ) {
-      ak_tlstree_state_destroy( ctx );
-      return ak_error_message( error, __func__, "incorrect creation of temporary K3 value" );
-    }
-
-  return error;
-}
-
-/* ----------------------------------------------------------------------------------------------- */
-/*! Функция увеличивает на единицу текущее значение номера ключа, после чего, при необходимости,
- *  пересчитывает значения промежуточных ключей.
- *
- *  \param ctx Контекст алгоритма TLSTREE.
- *  \return В случае возникновения ошибки, функция возвращает ее код. В случае успешного завершения
- *  возвращается ноль. */
+/*! \brief Пересчет промежуточных ключей для текущего значения номера ключа.
+    \details Пересчитываются только те уровни, значения индексов которых отличаются от
+    сохраненных в контексте; изменение ключа одного уровня влечет пересчет всех последующих.
+
+    \param ctx Контекст алгоритма TLSTREE.
+    \param force Истинное значение приводит к пересчету ключей всех трех уровней.
+    \return В случае возникновения ошибки, функция возвращает ее код. В случае успешного завершения
+    возвращается ноль.                                                                             */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_tlstree_state_next( ak_tlstree_state ctx )
+ static int ak_tlstree_state_update( ak_tlstree_state ctx, bool_t force )
 {
     ak_uint64 seed = 0;
     int error = ak_error_ok;
     size_t b32 = ak_tlstree_state_get_block( ctx->type ); /* размер хеш-кода: 32 или 64 */
 
-    if( ctx == NULL )
-      return ak_error_message( ak_error_null_pointer, __func__,
-                                                     "using null-pointer to the tlstree context");
-
-   /* следующий номер ключа */
-    ++ctx->key_number;
-
    /* первая итерация */
-    if(( seed = ( ctx->key_number&tlstree_constant_values[ctx->state].c1 )) != ctx->ind1 )
+    if( force || (( seed = ( ctx->key_number&tlstree_constant_values[ctx->state].c1 )) != ctx->ind1 ))
    {
      #ifdef AK_LITTLE_ENDIAN
-       seed = bswap_64( ctx->ind1 = seed );
+       seed = bswap_64( ctx->ind1 = ( ctx->key_number&tlstree_constant_values[ctx->state].c1 ));
      #else
-       ctx->ind1 = seed;
+       seed = ctx->ind1 = ( ctx->key_number&tlstree_constant_values[ctx->state].c1 );
      #endif
        if(( error = ak_skey_derive_kdf_hmac(
                                            ctx->type,
@@ -481,15 +384,16 @@
          ak_tlstree_state_destroy( ctx );
          return ak_error_message( error, __func__, "incorrect creation of temporary K1 value" );
        }
+       force = ak_true;
    }
 
    /* вторая итерация */
-    if(( seed = ( ctx->key_number&tlstree_constant_values[ctx->state].c2 )) != ctx->ind2 )
+    if( force || (( seed = ( ctx->key_number&tlstree_constant_values[ctx->state].c2 )) != ctx->ind2 ))
    {
      #ifdef AK_LITTLE_ENDIAN
-       seed = bswap_64( ctx->ind2 = seed );
+       seed = bswap_64( ctx->ind2 = ( ctx->key_number&tlstree_constant_values[ctx->state].c2 ));
      #else
-       ctx->ind2 = seed;
+       seed = ctx->ind2 = ( ctx->key_number&tlstree_constant_values[ctx->state].c2 );
      #endif
        if(( error = ak_skey_derive_kdf_hmac(
                                            ctx->type,
@@ -504,15 +408,16 @@
          ak_tlstree_state_destroy( ctx );
          return ak_error_message( error, __func__, "incorrect creation of temporary K2 value" );
        }
+       force = ak_true;
    }
 
    /* третья итерация */
-    if(( seed = ( ctx->key_number&tlstree_constant_values[ctx->state].c3 )) != ctx->ind3 )
+    if( force || (( seed = ( ctx->key_number&tlstree_constant_values[ctx->state].c3 )) != ctx->ind3 ))
    {
      #ifdef AK_LITTLE_ENDIAN
-       seed = bswap_64( ctx->ind3 = seed );
+       seed = bswap_64( ctx->ind3 = ( ctx->key_number&tlstree_constant_values[ctx->state].c3 ));
      #else
-       ctx->ind3 = seed;
+       seed = ctx->ind3 = ( ctx->key_number&tlstree_constant_values[ctx->state].c3 );
      #endif
        if(( error = ak_skey_derive_kdf_hmac(
                                            ctx->type,
@@ -532,6 +437,234 @@
   return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param type Тип алгоритма kdf, допустимыми значениями являются kdf256, kdf512 и kdfnmac
+    \param ctx Контекст алгоритма TLSTREE
+    \param master_key Указатель на область памяти
+    \param master_key_size Размер памяти в байтах
+    \param index Порядковый номер вырабатываемого ключа
+    \param tlstree Набор констант, являющийся параметром алгоритма
+
+    \return В случае возникновения ошибки функция возвращает ее код. В случае успеха
+    возвращается \ref ak_error_ok (ноль).                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlstree_state_create( kdf_t type, ak_tlstree_state ctx, ak_uint8 *master_key,
+                                const size_t master_key_size, ak_uint64 index, tlstree_t tlstree )
+{
+    int error = ak_error_ok;
+
+   /* проверки */
+    if(( type != kdf256 ) && ( type != kdf512 ) && ( type != kdfnmac ))
+      return ak_error_message( ak_error_wrong_key_type, __func__,
+           "using incorrect type of key defivation function (must ne: kdf256, kdf512 or kdfnmac" );
+    if( ctx == NULL )
+      return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null-pointer to tlstree state" );
+   /* размещаем исходный ключ */
+    memset( ctx, 0, sizeof( struct tlstree_state ));
+    ctx->key_number = index;
+    ctx->state = tlstree;
+    ctx->type = type;
+    memcpy( ctx->key, master_key, ak_min( ak_tlstree_state_get_block( type ), master_key_size ));
+
+   /* вычисляем ключи всех трех уровней */
+    if(( error = ak_tlstree_state_update( ctx, ak_true )) != ak_error_ok )
+      ak_error_message( error, __func__, "incorrect creation of derivative key" );
+
+  return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция увеличивает на единицу текущее значение номера ключа, после чего, при необходимости,
+ *  пересчитывает значения промежуточных ключей.
+ *
+ *  \param ctx Контекст алгоритма TLSTREE.
+ *  \return В случае возникновения ошибки, функция возвращает ее код. В случае успешного завершения
+ *  возвращается ноль. */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlstree_state_next( ak_tlstree_state ctx )
+{
+    if( ctx == NULL )
+      return ak_error_message( ak_error_null_pointer, __func__,
+                                                     "using null-pointer to the tlstree context");
+   /* следующий номер ключа */
+    ++ctx->key_number;
+
+  return ak_tlstree_state_update( ctx, ak_false );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция устанавливает произвольное значение номера ключа и пересчитывает только те
+ *  промежуточные ключи, которые отличаются от ключей, хранящихся в контексте. Например,
+ *  для набора констант tlstree_with_libakrypt_65536 переход к ключу, находящемуся в той же
+ *  группе из 256 ключей, требует одного вычисления функции KDF, а не трех.
+ *
+ *  \param ctx Контекст алгоритма TLSTREE.
+ *  \param key_number Новое значение номера ключа.
+ *  \return В случае возникновения ошибки, функция возвращает ее код. В случае успешного завершения
+ *  возвращается ноль. */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlstree_state_seek( ak_tlstree_state ctx, ak_uint64 key_number )
+{
+    if( ctx == NULL )
+      return ak_error_message( ak_error_null_pointer, __func__,
+                                                     "using null-pointer to the tlstree context");
+    ctx->key_number = key_number;
+
+  return ak_tlstree_state_update( ctx, ak_false );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Создание контекста алгоритма hmac, соответствующего типу алгоритма kdf. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_tlstree_hmac_create( kdf_t type, ak_hmac hctx )
+{
+    switch( type ) {
+      case kdf256: return ak_hmac_create_streebog256( hctx );
+      case kdf512: return ak_hmac_create_streebog512( hctx );
+      case kdfnmac: return ak_hmac_create_nmac( hctx );
+      default: break;
+    }
+  return ak_error_wrong_key_type;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление KDF( K, label, Str8( index )) с ключом K, уже присвоенным контексту hmac.
+    \details Повторные вызовы функции для одного ключа используют сохраненные
+    в контексте состояния функции хеширования после обработки блоков ipad и opad. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_tlstree_hmac_derive( ak_hmac hctx, const char *label, ak_uint64 index,
+                                                                    ak_uint8 *out, size_t size )
+{
+    ak_uint8 cv[2] = { 0x01, 0x00 };
+  #ifdef AK_LITTLE_ENDIAN
+    ak_uint64 seed = bswap_64( index );
+  #else
+    ak_uint64 seed = index;
+  #endif
+
+    ak_hmac_clean( hctx );
+    ak_hmac_update( hctx, cv, 1 );
+    ak_hmac_update( hctx, (ak_uint8 *) label, 6 );
+    ak_hmac_update( hctx, cv+1, 1 );
+    ak_hmac_update( hctx, &seed, 8 );
+  return ak_hmac_finalize( hctx, cv, 2, out, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает `count` последовательных производных ключей с номерами
+ *  `first`, `first+1`, ..., `first+count-1` и помещает их, один за другим, в область памяти `out`.
+ *
+ *  В отличие от последовательных вызовов функции ak_tlstree_state_next(), для ключей второго и
+ *  третьего уровня создаются контексты алгоритма hmac, которые используются до тех пор, пока
+ *  соответствующий ключ не изменится. Поэтому вычисление очередного производного ключа
+ *  не требует создания нового контекста и обработки блоков ipad и opad.
+ *
+ *  После выполнения функции контекст содержит ключ с номером `first+count-1`.
+ *
+ *  \param ctx Контекст алгоритма TLSTREE.
+ *  \param first Номер первого вырабатываемого ключа.
+ *  \param count Количество вырабатываемых ключей.
+ *  \param out Указатель на область памяти, в которую помещаются выработанные ключи.
+ *  \param size Размер области памяти (в октетах); должен быть не менее
+ *  `count` умноженного на длину производного ключа (32 или 64 октета).
+ *  \return В случае возникновения ошибки, функция возвращает ее код. В случае успешного завершения
+ *  возвращается ноль. */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlstree_state_get_keys( ak_tlstree_state ctx, ak_uint64 first, const size_t count,
+                                                                  ak_uint8 *out, const size_t size )
+{
+    size_t i = 0, b32 = 0;
+    struct hmac h2, h3;
+    ak_uint64 number = first, ind = 0;
+    int error = ak_error_ok;
+
+    if( ctx == NULL )
+      return ak_error_message( ak_error_null_pointer, __func__,
+                                                     "using null-pointer to the tlstree context");
+    if(( out == NULL ) || ( count == 0 ))
+      return ak_error_message( ak_error_null_pointer, __func__, "output buffer undefined" );
+    b32 = ak_tlstree_state_get_block( ctx->type );
+    if( size/b32 < count )
+      return ak_error_message( ak_error_wrong_length, __func__, "output buffer is too small" );
+    if( first + ( count - 1 ) < first )
+      return ak_error_message( ak_error_wrong_length, __func__, "key number overflow" );
+
+   /* переходим к первому ключу */
+    if(( error = ak_tlstree_state_seek( ctx, first )) != ak_error_ok )
+      return ak_error_message( error, __func__, "incorrect seek to the first key" );
+    memcpy( out, ctx->key + ( 3*b32 ), b32 );
+    if( count == 1 ) return ak_error_ok;
+
+   /* создаем контексты для ключей второго и третьего уровня */
+    if(( error = ak_tlstree_hmac_create( ctx->type, &h2 )) != ak_error_ok )
+      return ak_error_message( error, __func__, "incorrect creation of hmac context" );
+    if(( error = ak_tlstree_hmac_create( ctx->type, &h3 )) != ak_error_ok ) {
+      ak_hmac_destroy( &h2 );
+      return ak_error_message( error, __func__, "incorrect creation of hmac context" );
+    }
+    if((( error = ak_hmac_set_key( &h2, ctx->key +b32, b32 )) != ak_error_ok ) ||
+       (( error = ak_hmac_set_key( &h3, ctx->key +( 2*b32 ), b32 )) != ak_error_ok )) {
+      ak_error_message( error, __func__, "incorrect assigning a temporary key" );
+      goto labex;
+    }
+
+    for( i = 1; i < count; i++ ) {
+       bool_t changed = ak_false;
+       ctx->key_number = ++number;
+
+      /* ключ первого уровня меняется крайне редко: используем общую функцию */
+       if(( ind = ( number&tlstree_constant_values[ctx->state].c1 )) != ctx->ind1 ) {
+      #ifdef AK_LITTLE_ENDIAN
+         ak_uint64 seed = bswap_64( ctx->ind1 = ind );
+      #else
+         ak_uint64 seed = ctx->ind1 = ind;
+      #endif
+         if(( error = ak_skey_derive_kdf_hmac( ctx->type, ctx->key, b32, (ak_uint8 *) "level1", 6,
+                                (ak_uint8 *) &seed, 8, ctx->key +b32, b32 )) != ak_error_ok ) {
+           ak_error_message( error, __func__, "incorrect creation of temporary K1 value" );
+           goto labex;
+         }
+         if(( error = ak_hmac_set_key( &h2, ctx->key +b32, b32 )) != ak_error_ok ) {
+           ak_error_message( error, __func__, "incorrect assigning a temporary K1 value" );
+           goto labex;
+         }
+         changed = ak_true;
+       }
+       ind = number&tlstree_constant_values[ctx->state].c2;
+       if( changed || ( ind != ctx->ind2 )) {
+         ctx->ind2 = ind;
+         if(( error = ak_tlstree_hmac_derive( &h2, "level2",
+                                        ctx->ind2, ctx->key +( 2*b32 ), b32 )) != ak_error_ok ) {
+           ak_error_message( error, __func__, "incorrect creation of temporary K2 value" );
+           goto labex;
+         }
+         if(( error = ak_hmac_set_key( &h3, ctx->key +( 2*b32 ), b32 )) != ak_error_ok ) {
+           ak_error_message( error, __func__, "incorrect assigning a temporary K2 value" );
+           goto labex;
+         }
+         changed = ak_true;
+       }
+       ind = number&tlstree_constant_values[ctx->state].c3;
+       if( changed || ( ind != ctx->ind3 )) {
+         ctx->ind3 = ind;
+         if(( error = ak_tlstree_hmac_derive( &h3, "level3",
+                                        ctx->ind3, ctx->key +( 3*b32 ), b32 )) != ak_error_ok ) {
+           ak_error_message( error, __func__, "incorrect creation of temporary K3 value" );
+           goto labex;
+         }
+       }
+       memcpy( out +i*b32, ctx->key +( 3*b32 ), b32 );
+    }
+
+  labex:
+    ak_hmac_destroy( &h3 );
+    ak_hmac_destroy( &h2 );
+    if( error != ak_error_ok ) ak_tlstree_state_destroy( ctx );
+
+  return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param ctx Контекст алгоритма TLSTREE.
  *  \return Функция возвращает указатель на область памяти, внутри контекста алгоритма */
@@ -797,7 +930,8 @@
    };
 
   /* массив для хранения выработанных ключей */
-   ak_uint8 out[32];
+   ak_uint8 out[64], keys[40*64];
+   int i = 0;
 
   /* первый пример */
    if(( error = ak_skey_derive_tlstree( kdf256, inkey611, 32, 5,
@@ -934,6 +1068,51 @@
 
    if( ak_log_get_level() >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                  "4200 tests for comparison of different realizations of tlstree function is Ok" );
+
+  /* восьмой пример - произвольный доступ и выработка последовательности ключей;
+     диапазон номеров пересекает границы групп ключей второго и третьего уровней */
+   if(( error = ak_tlstree_state_create( kdf512, &ctx, inkey634, 32, 0,
+                                                 tlstree_with_libakrypt_4096 )) != ak_error_ok ) {
+     ak_error_message( error, __func__, "incorrect creation of tlstree context");
+     return ak_false;
+   }
+   if(( error = ak_tlstree_state_get_keys( &ctx, 4090, 40, keys, sizeof( keys ))) != ak_error_ok ) {
+     ak_error_message( error, __func__, "incorrect creation of tlstree key sequence");
+     return ak_false;
+   }
+   for( i = 0; i < 40; i++ ) {
+      if(( error = ak_skey_derive_tlstree( kdf512, inkey634, 32, 4090 +i,
+                                        tlstree_with_libakrypt_4096, out, 64 )) != ak_error_ok ) {
+        ak_error_message( error, __func__, "incorrect creation of tlstree derive key");
+        goto exlab2;
+      }
+      if( !ak_ptr_is_equal_with_log( out, keys +64*i, 64 )) {
+        ak_error_message_fmt( error = ak_error_not_equal_data, __func__,
+                                "wrong value of derivative key in sequence, index: %d", 4090 +i );
+        goto exlab2;
+      }
+   }
+  /* возвращаемся назад и переходим вперед */
+   for( i = 0; i < 3; i++ ) {
+      ak_uint64 number = ( i == 1 ) ? 4099 : 70000 +(ak_uint64)i*3;
+      if(( error = ak_tlstree_state_seek( &ctx, number )) != ak_error_ok ) {
+        ak_error_message( error, __func__, "incorrect seek of tlstree context");
+        goto exlab2;
+      }
+      ak_skey_derive_tlstree( kdf512, inkey634, 32, number, tlstree_with_libakrypt_4096, out, 64 );
+      if( !ak_ptr_is_equal_with_log( out, ak_tlstree_state_get_key( &ctx ), 64 )) {
+        ak_error_message_fmt( error = ak_error_not_equal_data, __func__,
+                                   "wrong value of derivative key after seek, index: %d", (int) number );
+        goto exlab2;
+      }
+   }
+
+   exlab2:
+     ak_tlstree_state_destroy( &ctx );
+     if( error != ak_error_ok ) return ak_false;
+
+   if( ak_log_get_level() >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                       "random access and key sequence of tlstree function is Ok" );
   return ak_true;
 }
 
@@ -1323,6 +1502,158 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на выработку ключевой информации для части массива контекстов
+    (контексты с номерами first, first + step, ...). */
+ typedef struct kdf_states {
+  /*! \brief Массив указателей на контексты выработки производных ключей. */
+   ak_kdf_state *states;
+  /*! \brief Общее количество контекстов. */
+   size_t count;
+  /*! \brief Номер первого обрабатываемого контекста. */
+   size_t first;
+  /*! \brief Шаг перебора контекстов. */
+   size_t step;
+  /*! \brief Область памяти для результатов. */
+   ak_uint8 *out;
+  /*! \brief Размер ключевой информации, вырабатываемой одним контекстом. */
+   size_t size;
+  /*! \brief Код последней возникшей ошибки. */
+   int error;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что задание выполняется вспомогательным потоком. */
+   bool_t threaded;
+#endif
+} *ak_kdf_states;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно вырабатывает ключевую информацию для контекстов,
+    входящих в задание. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kdf_states_update( ak_kdf_states ks )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+
+  ks->error = ak_error_ok;
+  for( i = ks->first; i < ks->count; i += ks->step ) {
+     if(( error = ak_kdf_state_next( ks->states[i],
+                                         ks->out +i*ks->size, ks->size )) != ak_error_ok ) {
+       memset( ks->out +i*ks->size, 0, ks->size );
+       ks->error = error;
+     }
+  }
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_kdf_states_thread( void *ptr )
+{
+  ak_kdf_states_update(( ak_kdf_states )ptr );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает очередной фрагмент ключевой информации длины `size` октетов
+    для каждого контекста из заданного массива. Результат совпадает с последовательным
+    вызовом функции ak_kdf_state_next() для каждого контекста.
+
+    Поскольку блоки `Ki` одного контекста связаны между собой (каждый следующий блок
+    зависит от предыдущего), их выработка не может быть распараллелена. Поэтому
+    параллельно обрабатываются независимые контексты: при наличии поддержки потоков
+    массив контекстов распределяется между несколькими потоками
+    (количество потоков определяется опцией `threads_count`).
+
+    \param states Массив из `count` указателей на контексты выработки производных ключей;
+    контексты не обязаны располагаться в памяти последовательно. Поскольку контекст содержит
+    секретный ключ, выравненный по границе 32 байт, память под каждый контекст должна
+    выделяться с тем же выравниванием (например, функцией `aligned_alloc()`).
+    \param count Количество контекстов.
+    \param out Область памяти, куда последовательно помещаются `count` фрагментов
+    ключевой информации, каждый длины `size` октетов. Память должна быть заранее выделена.
+    \param size Размер ключевой информации (в октетах), вырабатываемой каждым контекстом.
+
+    \return В случае успеха функция возвращает ноль (\ref ak_error_ok). Если хотя бы для одного
+    контекста ключевая информация не выработана, возвращается код ошибки, а соответствующий
+    фрагмент заполняется нулями.                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_kdf_state_next_multi( ak_kdf_state *states, const size_t count,
+                                                               ak_pointer out, const size_t size )
+{
+  size_t i = 0, threads = 1;
+  struct kdf_states main_task;
+#ifdef AK_HAVE_PTHREAD_H
+  ak_kdf_states tasks = NULL;
+#endif
+
+  if( states == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                         "using null pointer to array of states" );
+  if( !count ) return ak_error_ok;
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                              "using null pointer to key buffer" );
+  if( !size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                        "using null key buffer with zero length" );
+ /* проверяем, что все контексты будут обработаны, до начала вычислений */
+  for( i = 0; i < count; i++ ) {
+     if( states[i] == NULL ) return ak_error_message_fmt( ak_error_null_pointer, __func__,
+                                          "using null pointer to state %u", (unsigned int) i );
+     if(( states[i]->block_size == 0 ) ||
+        ( states[i]->number + ( size + states[i]->block_size - 1 )/states[i]->block_size
+                                                                           >= states[i]->max ))
+       return ak_error_message_fmt( ak_error_low_key_resource, __func__,
+                    "resource of key information is exhausted for state %u", (unsigned int) i );
+  }
+
+  main_task.states = states;
+  main_task.count = count;
+  main_task.first = 0;
+  main_task.out = out;
+  main_task.size = size;
+
+ /* определяем количество потоков */
+  threads = ak_min( ak_libakrypt_get_threads_count(), count );
+  main_task.step = threads;
+#ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && (( tasks = malloc(( threads-1 )*sizeof( struct kdf_states ))) != NULL )) {
+    for( i = 0; i < threads-1; i++ ) {
+       tasks[i] = main_task;
+       tasks[i].first = i+1;
+       tasks[i].threaded = ak_false;
+       if( pthread_create( &tasks[i].thread, NULL, ak_kdf_states_thread, tasks+i ) == 0 )
+         tasks[i].threaded = ak_true;
+        else {
+          ak_error_message( ak_error_undefined_function, __func__, "wrong creation of a thread" );
+         /* обрабатываем задание самостоятельно */
+          ak_kdf_states_update( tasks+i );
+        }
+    }
+    ak_kdf_states_update( &main_task );
+    for( i = 0; i < threads-1; i++ ) {
+       if( tasks[i].threaded ) pthread_join( tasks[i].thread, NULL );
+       if( tasks[i].error != ak_error_ok ) main_task.error = tasks[i].error;
+    }
+    free( tasks );
+  }
+   else {
+     main_task.step = 1;
+     ak_kdf_states_update( &main_task );
+   }
+#else
+  main_task.step = 1;
+  ak_kdf_states_update( &main_task );
+#endif
+
+  if( main_task.error != ak_error_ok )
+    return ak_error_message( main_task.error, __func__,
+                                        "incorrect generation of key information for some states" );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param state Контекст, содержащий текущее состояние алгоритма выработки производной 
     ключевой информации
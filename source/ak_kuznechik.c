@@ -670,6 +670,164 @@
   (( ak_uint64 *) out)[1] = x[1] ^ xkey[1];
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество блоков, одновременно обрабатываемых функциями
+    ak_kuznechik_encrypt_blocks() и ak_kuznechik_decrypt_blocks(). */
+ #define ak_kuznechik_interleaved_blocks   (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует преобразование LS для одного блока информации.
+    \details Параметр `oc` определяет порядок следования октетов блока (значение, отличное от нуля,
+    соответствует режиму совместимости с библиотекой openssl).                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_kuznechik_ls_transform( ak_uint64 *x, const int oc )
+{
+  int j = 0;
+  ak_uint8 c, *b = (ak_uint8 *)x;
+  ak_uint64 t = 0, s = 0;
+
+  for( j = 0; j < 16; j++ ) {
+     c = b[ oc ? 15-j : j ];
+     t ^= kuznechik_parameters.enc[j][c][0];
+     s ^= kuznechik_parameters.enc[j][c][1];
+  }
+  x[0] = t; x[1] = s;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает последовательно расположенные в памяти независимые блоки.
+    \details Раундовые преобразования для \ref ak_kuznechik_interleaved_blocks блоков выполняются
+    чередующимися, что позволяет процессору совмещать во времени выборки из таблиц для
+    различных блоков. Остаток обрабатывается поблочно.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_kuznechik_encrypt_blocks( ak_skey skey,
+                                                 ak_pointer in, ak_pointer out, size_t count,
+                                                               ak_function_bckey *single, const int oc )
+{
+  int i = 0, k = 0;
+  ak_uint64 *ekey = ( ak_uint64 *)skey->data;
+  ak_uint64 *mkey = ( ak_uint64 *)skey->data + 40;
+  ak_uint64 x[ak_kuznechik_interleaved_blocks][2],
+            *inp = ( ak_uint64 *)in, *outp = ( ak_uint64 *)out;
+
+  for( ; count >= ak_kuznechik_interleaved_blocks; count -= ak_kuznechik_interleaved_blocks ) {
+     for( k = 0; k < ak_kuznechik_interleaved_blocks; k++, inp += 2 ) {
+        x[k][0] = inp[0]; x[k][1] = inp[1];
+     }
+     for( i = 0; i < 18; i += 2 ) {
+        for( k = 0; k < ak_kuznechik_interleaved_blocks; k++ ) {
+           x[k][0] ^= ekey[i]; x[k][0] ^= mkey[i];
+           x[k][1] ^= ekey[i+1]; x[k][1] ^= mkey[i+1];
+           ak_kuznechik_ls_transform( x[k], oc );
+        }
+     }
+     for( k = 0; k < ak_kuznechik_interleaved_blocks; k++, outp += 2 ) {
+        x[k][0] ^= ekey[18]; x[k][1] ^= ekey[19];
+        outp[0] = x[k][0] ^ mkey[18];
+        outp[1] = x[k][1] ^ mkey[19];
+     }
+  }
+  for( ; count > 0; count--, inp += 2, outp += 2 ) single( skey, inp, outp );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует преобразование, обратное к линейному преобразованию L,
+    для одного блока информации (с учетом порядка следования октетов `oc`).                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_kuznechik_linv_transform( ak_uint64 *x, const int oc )
+{
+  int j = 0;
+  ak_uint8 c, *b = (ak_uint8 *)x;
+  ak_uint64 t = 0, s = 0;
+
+  for( j = 0; j < 16; j++ ) {
+     c = b[ oc ? 15-j : j ];
+     t ^= kuznechik_parameters.dec[j][c][0];
+     s ^= kuznechik_parameters.dec[j][c][1];
+  }
+  x[0] = t; x[1] = s;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция расшифровывает последовательно расположенные в памяти независимые блоки.
+    \details Аналогично функции ak_kuznechik_encrypt_blocks(), раундовые преобразования
+    для нескольких блоков выполняются чередующимися.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_kuznechik_decrypt_blocks( ak_skey skey,
+                                                 ak_pointer in, ak_pointer out, size_t count,
+                                                               ak_function_bckey *single, const int oc )
+{
+  int i = 0, j = 0, k = 0;
+  ak_uint64 *dkey = ( ak_uint64 *)skey->data + 20;
+  ak_uint64 *xkey = ( ak_uint64 *)skey->data + 60;
+  ak_uint64 x[ak_kuznechik_interleaved_blocks][2],
+            *inp = ( ak_uint64 *)in, *outp = ( ak_uint64 *)out;
+  ak_uint8 *b = NULL;
+
+  for( ; count >= ak_kuznechik_interleaved_blocks; count -= ak_kuznechik_interleaved_blocks ) {
+     for( k = 0; k < ak_kuznechik_interleaved_blocks; k++, inp += 2 ) {
+        x[k][0] = inp[0]; x[k][1] = inp[1];
+        b = (ak_uint8 *)x[k];
+        for( j = 0; j < 16; j++ ) b[j] = kuznechik_parameters.pi[b[j]];
+     }
+     for( i = 19; i > 1; i -= 2 ) {
+        for( k = 0; k < ak_kuznechik_interleaved_blocks; k++ ) {
+           ak_kuznechik_linv_transform( x[k], oc );
+           x[k][1] ^= dkey[i]; x[k][1] ^= xkey[i];
+           x[k][0] ^= dkey[i-1]; x[k][0] ^= xkey[i-1];
+        }
+     }
+     for( k = 0; k < ak_kuznechik_interleaved_blocks; k++, outp += 2 ) {
+        b = (ak_uint8 *)x[k];
+        for( j = 0; j < 16; j++ ) b[j] = kuznechik_parameters.pinv[b[j]];
+        x[k][0] ^= dkey[0]; x[k][1] ^= dkey[1];
+        outp[0] = x[k][0] ^ xkey[0];
+        outp[1] = x[k][1] ^ xkey[1];
+     }
+  }
+  for( ; count > 0; count--, inp += 2, outp += 2 ) single( skey, inp, outp );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция расшифровывает несколько независимых блоков информации
+    шифром Кузнечик (согласно ГОСТ Р 34.12-2015).                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_decrypt_blocks_with_mask( ak_skey skey,
+                                                  ak_pointer in, ak_pointer out, size_t count )
+{
+  ak_kuznechik_decrypt_blocks( skey, in, out, count, ak_kuznechik_decrypt_with_mask, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция расшифровывает несколько независимых блоков информации
+    шифром Кузнечик в режиме совместимости с библиотекой openssl.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_decrypt_blocks_with_mask_oc( ak_skey skey,
+                                                  ak_pointer in, ak_pointer out, size_t count )
+{
+  ak_kuznechik_decrypt_blocks( skey, in, out, count, ak_kuznechik_decrypt_with_mask_oc, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает несколько независимых блоков информации
+    шифром Кузнечик (согласно ГОСТ Р 34.12-2015).                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_encrypt_blocks_with_mask( ak_skey skey,
+                                                  ak_pointer in, ak_pointer out, size_t count )
+{
+  ak_kuznechik_encrypt_blocks( skey, in, out, count, ak_kuznechik_encrypt_with_mask, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает несколько независимых блоков информации
+    шифром Кузнечик в режиме совместимости с библиотекой openssl.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_encrypt_blocks_with_mask_oc( ak_skey skey,
+                                                  ak_pointer in, ak_pointer out, size_t count )
+{
+  ak_kuznechik_encrypt_blocks( skey, in, out, count, ak_kuznechik_encrypt_with_mask_oc, 1 );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! После инициализации устанавливаются обработчики (функции класса). Однако само значение
     ключу не присваивается - поле `bkey->key` остается неопределенным.
@@ -706,10 +864,14 @@
   if( oc ) {
     bkey->encrypt = ak_kuznechik_encrypt_with_mask_oc;
     bkey->decrypt = ak_kuznechik_decrypt_with_mask_oc;
+    bkey->encrypt_blocks = ak_kuznechik_encrypt_blocks_with_mask_oc;
+    bkey->decrypt_blocks = ak_kuznechik_decrypt_blocks_with_mask_oc;
   }
    else {
     bkey->encrypt = ak_kuznechik_encrypt_with_mask;
     bkey->decrypt = ak_kuznechik_decrypt_with_mask;
+    bkey->encrypt_blocks = ak_kuznechik_encrypt_blocks_with_mask;
+    bkey->decrypt_blocks = ak_kuznechik_decrypt_blocks_with_mask;
   }
  return error;
 }
@@ -1021,6 +1183,23 @@
     goto exit;
   }
 
+ /* многоблочная реализация должна давать тот же результат */
+  memset( myout, 0, sizeof( outecb ));
+  bkey.encrypt_blocks( &bkey.key, oc ? oc_in : in, myout, sizeof( in )/16 );
+  if( !ak_ptr_is_equal_with_log( myout, oc ? oc_outecb : outecb, sizeof( outecb ))) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                            "wrong encryption of several independent blocks" );
+    result = ak_false;
+    goto exit;
+  }
+  bkey.decrypt_blocks( &bkey.key, oc ? oc_outecb : outecb, myout, sizeof( outecb )/16 );
+  if( !ak_ptr_is_equal_with_log( myout, oc ? oc_in : in, sizeof( in ))) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                            "wrong decryption of several independent blocks" );
+    result = ak_false;
+    goto exit;
+  }
+
   if(( error = ak_bckey_decrypt_ecb( &bkey, oc ? oc_outecb : outecb,
                                                        myout, sizeof( outecb ))) != ak_error_ok ) {
     ak_error_message( error, __func__ , "wrong ecb mode decryption" );
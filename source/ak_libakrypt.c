@@ -16,6 +16,12 @@
 
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#ifdef AK_HAVE_CPUID_H
+ #include <cpuid.h>
+#endif
+#ifdef _MSC_VER
+ #include <intrin.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция проверяет корректность определения базовых типов данных
@@ -124,6 +130,173 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Набор расширений процессора, обнаруженных при инициализации библиотеки. */
+ static ak_uint32 ak_cpu_features = 0;
+/*! \brief Уровень реализации вычислительных ядер, используемый библиотекой. */
+ static cpu_level_t ak_cpu_level = cpu_level_generic;
+
+#if ( defined( AK_HAVE_CPUID_H ) && ( defined( __x86_64__ ) || defined( __i386__ ))) || \
+    ( defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 )))
+ #define AK_HAVE_CPUID
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выполнение команды cpuid; результат помещается в массив `regs` в порядке
+    eax, ebx, ecx, edx. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_libakrypt_cpuid( ak_uint32 leaf, ak_uint32 subleaf, ak_uint32 *regs )
+{
+#ifdef _MSC_VER
+  int r[4];
+  __cpuidex( r, (int) leaf, (int) subleaf );
+  regs[0] = (ak_uint32) r[0]; regs[1] = (ak_uint32) r[1];
+  regs[2] = (ak_uint32) r[2]; regs[3] = (ak_uint32) r[3];
+#else
+  unsigned int a = 0, b = 0, c = 0, d = 0;
+  __cpuid_count( leaf, subleaf, a, b, c, d );
+  regs[0] = a; regs[1] = b; regs[2] = c; regs[3] = d;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Чтение регистра XCR0, определяющего сохраняемые операционной системой состояния. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_libakrypt_xgetbv( void )
+{
+#ifdef _MSC_VER
+  return (ak_uint64) _xgetbv( 0 );
+#else
+  ak_uint32 a = 0, d = 0;
+  __asm__ volatile ( "xgetbv" : "=a" (a), "=d" (d) : "c" (0) );
+  return ((ak_uint64) d << 32 ) | a;
+#endif
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция опрашивает процессор с помощью команды cpuid. Наличие наборов команд avx и avx2
+    дополнительно подтверждается тем, что операционная система сохраняет регистры ymm
+    при переключении контекста.
+
+    @return Набор флагов \ref ak_cpu_feature_sse2, \ref ak_cpu_feature_pclmul и т.д.
+    На платформах, отличных от x86, возвращается ноль.                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint32 ak_libakrypt_detect_cpu_features( void )
+{
+  ak_uint32 features = 0;
+#ifdef AK_HAVE_CPUID
+  ak_uint32 max = 0, r[4] = { 0, 0, 0, 0 };
+
+  ak_libakrypt_cpuid( 0, 0, r );
+  if(( max = r[0] ) < 1 ) return features;
+
+  ak_libakrypt_cpuid( 1, 0, r );
+  if( r[3]&( 1u << 26 )) features |= ak_cpu_feature_sse2;
+  if( r[2]&( 1u << 9 )) features |= ak_cpu_feature_ssse3;
+  if( r[2]&( 1u << 19 )) features |= ak_cpu_feature_sse41;
+  if( r[2]&( 1u << 1 )) features |= ak_cpu_feature_pclmul;
+ /* бит 27 - osxsave, бит 28 - avx */
+  if(( r[2]&( 1u << 27 )) && ( r[2]&( 1u << 28 )))
+    if(( ak_libakrypt_xgetbv()&0x6 ) == 0x6 ) features |= ak_cpu_feature_avx;
+
+  if( max >= 7 ) {
+    ak_libakrypt_cpuid( 7, 0, r );
+    if(( features&ak_cpu_feature_avx ) && ( r[1]&( 1u << 5 ))) features |= ak_cpu_feature_avx2;
+    if( r[1]&( 1u << 8 )) features |= ak_cpu_feature_bmi2;
+    if( r[1]&( 1u << 19 )) features |= ak_cpu_feature_adx;
+  }
+#endif
+ return features;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выбор реализаций вычислительных ядер в соответствии с набором расширений процессора
+    и значением опции `cpu_dispatch_level`. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_libakrypt_dispatch_cpu_level( void )
+{
+  cpu_level_t level = cpu_level_generic;
+  ak_int64 option = ak_libakrypt_get_option_by_name( "cpu_dispatch_level" );
+
+  if( ak_cpu_features&ak_cpu_feature_pclmul ) {
+    level = cpu_level_pclmul;
+    if(( ak_cpu_features&ak_cpu_feature_avx2 ) && ( ak_cpu_features&ak_cpu_feature_bmi2 ) &&
+       ( ak_cpu_features&ak_cpu_feature_adx )) level = cpu_level_avx2;
+  }
+  if(( option >= cpu_level_generic ) && ( option < level )) level = (cpu_level_t) option;
+
+  ak_cpu_level = level;
+  ak_gf2n_set_cpu_level( level );
+  ak_mpzn_set_cpu_level( level );
+  ak_hash_crc64_set_cpu_level( level );
+ /* команды sse2 используются на любом уровне, кроме переносимой реализации,
+    заданной значением опции */
+  ak_ptr_fletcher32_set_sse2((( ak_cpu_features&ak_cpu_feature_sse2 ) &&
+                                 ( option != cpu_level_generic )) ? ak_true : ak_false );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вывод результатов опроса процессора и выбранного уровня реализации. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_libakrypt_log_cpu_level( void )
+{
+  const char *names[] = { "generic", "pclmul", "avx2" };
+
+  ak_error_message_fmt( ak_error_ok, __func__,
+    "cpu features: sse2 %s, ssse3 %s, sse4.1 %s, pclmul %s, avx %s, avx2 %s, bmi2 %s, adx %s",
+                                  ( ak_cpu_features&ak_cpu_feature_sse2 ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_ssse3 ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_sse41 ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_pclmul ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_avx ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_avx2 ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_bmi2 ) ? "yes" : "no",
+                                  ( ak_cpu_features&ak_cpu_feature_adx ) ? "yes" : "no" );
+  ak_error_message_fmt( ak_error_ok, __func__, "using %s implementation of computational kernels",
+                                                                           names[ak_cpu_level] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @return Набор флагов \ref ak_cpu_feature_sse2, \ref ak_cpu_feature_pclmul и т.д.,
+    определенных при инициализации библиотеки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint32 ak_libakrypt_get_cpu_features( void )
+{
+  return ak_cpu_features;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @return Уровень реализации, равный меньшему из значений: значения опции `cpu_dispatch_level`
+    и максимального уровня, поддерживаемого процессором.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ cpu_level_t ak_libakrypt_get_cpu_level( void )
+{
+  return ak_cpu_level;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция изменяет значение опции `cpu_dispatch_level` и заново выбирает реализации
+    вычислительных ядер. Уровень, не поддерживаемый процессором, понижается до максимально
+    доступного. Функция предназначена для тестирования и не должна вызываться
+    в момент, когда криптографические механизмы библиотеки используются другими потоками.
+
+    @param level Максимальный допустимый уровень реализации.
+    @return Функция возвращает \ref ak_error_ok (ноль) в случае успеха, в случае неудачи
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_set_cpu_level( cpu_level_t level )
+{
+  int error = ak_error_ok;
+
+  if(( level < cpu_level_generic ) || ( level > cpu_level_avx2 ))
+    return ak_error_message( ak_error_wrong_option, __func__, "using an incorrect level value" );
+  if(( error = ak_libakrypt_set_option( "cpu_dispatch_level", level )) != ak_error_ok )
+    return ak_error_message( error, __func__, "using an incorrect option name" );
+  ak_libakrypt_dispatch_cpu_level();
+  if( ak_log_get_level() > ak_log_standard ) ak_libakrypt_log_cpu_level();
+
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @return Возвращает ak_true в случае успешного тестирования. В случае возникновения ошибки
     функция возвращает ak_false. Код ошибки может быть получен с помощью
@@ -147,6 +320,12 @@
     return ak_false;
   }
 
+ /* тестируем реализации функции crc64 */
+  if( ak_libakrypt_test_crc64() != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect crc64 testing" );
+    return ak_false;
+  }
+
   if( audit >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__ , "testing hash functions ended successfully" );
 
@@ -385,12 +564,23 @@
      return ak_false;
    }
 
+ /* опрашиваем процессор и выбираем реализации вычислительных ядер */
+   ak_cpu_features = ak_libakrypt_detect_cpu_features();
+   ak_libakrypt_dispatch_cpu_level();
+   if( ak_log_get_level() > ak_log_standard ) ak_libakrypt_log_cpu_level();
+
  /* инициализируем константные таблицы для алгоритма Кузнечик */
    if(( error = ak_bckey_kuznechik_init_gost_tables()) != ak_error_ok ) {
     ak_error_message( error, __func__, "initialization of context manager is wrong" );
      return ak_false;
    }
 
+ /* инициализируем таблицы для ускоренной реализации crc64 */
+   if(( error = ak_hash_crc64_init_tables()) != ak_error_ok ) {
+     ak_error_message( error, __func__, "initialization of crc64 tables is wrong" );
+     return ak_false;
+   }
+
  /* в случае, когда компилируются сетевые функции, инициализируем работу с сокетами */
 #ifdef AK_HAVE_WINDOWS_H
   #ifdef LIBAKRYPT_NETWORK
@@ -442,6 +632,7 @@
   #endif
 #endif
 
+  ak_wcurve_destroy_tables();
   if( ak_log_get_level() != ak_log_none )
     ak_error_message( ak_error_ok, __func__ , "all crypto mechanisms successfully destroyed" );
 
@@ -185,6 +185,37 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Данные, передаваемые функции обработки фрагментов файла. */
+ struct mac_file_stream {
+  /*! \brief Контекст итерационного сжатия */
+   ak_mac mctx;
+  /*! \brief Область памяти для результата */
+   ak_pointer out;
+  /*! \brief Размер области памяти для результата */
+   size_t out_size;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает очередной фрагмент файла, считанный функцией ak_file_read_stream();
+    последний фрагмент завершает вычисление результата сжимающего отображения.                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_mac_file_stream_function( const ak_pointer data, const size_t size,
+                                                                       bool_t last, ak_pointer ptr )
+{
+  int error = ak_error_ok;
+  struct mac_file_stream *st = ( struct mac_file_stream * ) ptr;
+  size_t qcnt = size / st->mctx->bsize,
+         tail = size - qcnt*st->mctx->bsize;
+
+  if( !last ) return ak_mac_update( st->mctx, data, size );
+  if( qcnt && (( error = ak_mac_update( st->mctx, data,
+                                         qcnt*st->mctx->bsize )) != ak_error_ok ))
+    return ak_error_message( error, __func__, "incorrect updating of last fragment" );
+ return ak_mac_finalize( st->mctx, ( ak_uint8 * )data + qcnt*st->mctx->bsize, tail,
+                                                                          st->out, st->out_size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет результат сжимающего отображения для заданного файла и помещает
     его в область памяти, на которую указывает out.
@@ -201,11 +232,11 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_mac_file( ak_mac mctx, const char* filename, ak_pointer out, const size_t out_size )
 {
-  size_t len = 0;
   struct file file;
   int error = ak_error_ok;
+  file_stream_t method = file_stream_read;
   size_t block_size = 4096; /* оптимальная длина блока для Windows пока не ясна */
-  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+  struct mac_file_stream st;
 
  /* выполняем необходимые проверки */
   if( mctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -227,30 +258,16 @@
     return ak_mac_finalize( mctx, "", 0, out, out_size );
   }
 
- /* готовим область для хранения данных */
-  block_size = ak_max( ( size_t )file.blksize, mctx->bsize );
- /* здесь мы выделяем локальный буффер для считывания/обработки данных */
-  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
-    ak_file_close( &file );
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
-                                                      "memory allocation error for local buffer" );
-  }
- /* теперь обрабатываем файл с данными */
-  read_label: len = ( size_t ) ak_file_read( &file, localbuffer, block_size );
-  if( len == block_size ) {
-    ak_mac_update( mctx, localbuffer, block_size ); /* добавляем считанные данные */
-    goto read_label;
-  } else {
-           size_t qcnt = len / mctx->bsize,
-                  tail = len - qcnt*mctx->bsize;
-           if( qcnt ) ak_mac_update( mctx, localbuffer, qcnt*mctx->bsize );
-           error = ak_mac_finalize( mctx, localbuffer + qcnt*mctx->bsize, tail, out, out_size );
-         }
+ /* выбираем способ чтения и размер буффера (для больших файлов - из опций библиотеки),
+    после чего обрабатываем файл с данными */
+  method = ak_libakrypt_get_file_stream_method( &file, file.size, mctx->bsize, &block_size );
+  st.mctx = mctx; st.out = out; st.out_size = out_size;
+  error = ak_file_read_stream( &file, 0, -1, block_size, method, ak_mac_file_stream_function, &st );
+
  /* очищаем за собой данные, содержащиеся в контексте */
   ak_mac_clean( mctx );
  /* закрываем данные */
   ak_file_close( &file );
-  ak_aligned_free( localbuffer );
  return error;
 }
 
@@ -280,9 +297,10 @@
 {
     struct file file;
     int error = ak_error_ok;
+    file_stream_t method = file_stream_read;
     size_t block_size = 4096; /* оптимальная длина блока для Windows пока не ясна */
-    size_t len = 0, total_len = 0;
-    ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+    ak_int64 total_len = 0;
+    struct mac_file_stream st;
 
    /* в начале проверяем, нельзя ли свалить свою работу на чужие плечи? */
     if(( offset == 0 ) && ( data_size == -1 ))
@@ -308,43 +326,20 @@
       return ak_mac_finalize( mctx, "", 0, out, out_size );
     }
 
-   /* сдвигаем указатель на заданое число байт */
-    if(( ak_file_lseek( &file, offset, SEEK_SET )) == -1 ) {
-      ak_file_close( &file );
-      return ak_error_message( ak_error_lseek_file, __func__, "incorrect seeking to offset" );
-    }
-
-   /* готовим область для хранения данных */
-    block_size = ak_max( ( size_t )file.blksize, mctx->bsize );
-   /* здесь мы выделяем локальный буффер для считывания/обработки данных */
-    if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
-      ak_file_close( &file );
-      return ak_error_message( ak_error_out_of_memory, __func__ ,
-                                                       "memory allocation error for local buffer" );
-    }
-
    /* вычисляем сколько октетов нам надо обработать */
     total_len = ( data_size == -1 ) ?
                                 ( file.size - offset ) : ( ak_min( data_size, file.size - offset ));
 
-   /* теперь цикл последовательной обработки */
-    read_label: len = ( size_t ) ak_file_read( &file, localbuffer, ak_min( block_size, total_len ));
-    if( len == block_size ) {
-      ak_mac_update( mctx, localbuffer, block_size ); /* добавляем считанные данные */
-      total_len -= len;
-      goto read_label;
-    } else {
-             size_t qcnt = len / mctx->bsize,
-                    tail = len - qcnt*mctx->bsize;
-             if( qcnt ) ak_mac_update( mctx, localbuffer, qcnt*mctx->bsize );
-             error = ak_mac_finalize( mctx, localbuffer + qcnt*mctx->bsize, tail, out, out_size );
-         }
+   /* теперь последовательная обработка */
+    method = ak_libakrypt_get_file_stream_method( &file, total_len, mctx->bsize, &block_size );
+    st.mctx = mctx; st.out = out; st.out_size = out_size;
+    error = ak_file_read_stream( &file, offset, total_len, block_size,
+                                                        method, ak_mac_file_stream_function, &st );
 
    /* очищаем за собой данные, содержащиеся в контексте */
     ak_mac_clean( mctx );
    /* закрываем данные */
     ak_file_close( &file );
-    ak_aligned_free( localbuffer );
 
   return error;
 }
@@ -641,6 +641,140 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Один такт шифрующего преобразования, выполняемый одновременно для двух блоков.
+    Каждый блок использует собственную случайную траекторию (массивы ma и mb).                    */
+/* ----------------------------------------------------------------------------------------------- */
+ #define ak_magma_round2( i, k, x, y ) \
+   p = x##a; p -= mp[ma[i]][k]; p += kp[ma[i]][k] + ma[i]; \
+   q = x##b; q -= mp[mb[i]][k]; q += kp[mb[i]][k] + mb[i]; \
+   y##a ^= ak_magma_gostf_boxes( p, ma[i+1] ^ ma[i-1], ma[i] ); \
+   y##b ^= ak_magma_gostf_boxes( q, mb[i+1] ^ mb[i-1], mb[i] );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифрования последовательности независимых блоков информации
+    алгоритмом ГОСТ 34.12-2015 (Магма).
+
+    \details Блоки обрабатываются парами: такты двух независимых блоков чередуются, что позволяет
+    процессору совмещать выполнение обращений к таблицам замен. Результат совпадает
+    с последовательным вызовом одноблочной функции зашифрования.
+
+    @param skey Контекст секретного ключа.
+    @param in Последовательность блоков входной информации (открытый текст).
+    @param out Последовательность блоков выходной информации (шифртекст).
+    @param count Количество блоков.
+    @param oc Флаг режима совместимости с библиотекой openssl.                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_encrypt_blocks( ak_skey skey,
+                                  ak_pointer in, ak_pointer out, size_t count, const bool_t oc )
+{
+  ak_uint8 ma[34], mb[34];
+  ak_uint32 i, mv[2] = { 0, 0 }, *inp = in, *outp = out;
+  ak_uint32 (*kp)[8] = ((struct magma_encrypted_keys *)skey->data)->inkey;
+  ak_uint32 (*mp)[8] = ((struct magma_encrypted_keys *)skey->data)->inmask;
+  register ak_uint32 n3a, n4a, n3b, n4b, p = 0, q = 0;
+
+  for( ; count > 1; count -= 2, inp += 4, outp += 4 ) {
+    /* вырабатываем случайные траектории для обоих блоков */
+     skey->generator.random( &skey->generator, mv, sizeof( mv ));
+
+     if( oc ) {
+       ma[0] = ma[1] = ma[32] = ma[33] = 0;
+       mb[0] = mb[1] = mb[32] = mb[33] = 0;
+       for( i = 1; i < 31; i++ ) {
+          ma[i+1] = (ak_uint8)(( mv[0] >> i) & 0x01 );
+          mb[i+1] = (ak_uint8)(( mv[1] >> i) & 0x01 );
+       }
+     #ifdef AK_LITTLE_ENDIAN
+       n4a = bswap_32( inp[0] ); n3a = bswap_32( inp[1] );
+       n4b = bswap_32( inp[2] ); n3b = bswap_32( inp[3] );
+     #else
+       n4a = inp[0]; n3a = inp[1];
+       n4b = inp[2]; n3b = inp[3];
+     #endif
+     }
+      else {
+        ma[0] = ma[33] = 0;
+        mb[0] = mb[33] = 0;
+        for( i = 0; i < 32; i++ ) {
+           ma[i+1] = (ak_uint8)(( mv[0] >> i) & 0x01 );
+           mb[i+1] = (ak_uint8)(( mv[1] >> i) & 0x01 );
+        }
+      #ifdef AK_LITTLE_ENDIAN
+        n3a = inp[0]^( ma[1] * 0xffffffff ); n4a = inp[1];
+        n3b = inp[2]^( mb[1] * 0xffffffff ); n4b = inp[3];
+      #else
+        n3a = bswap_32( inp[0] )^( ma[1] * 0xffffffff ); n4a = bswap_32( inp[1] );
+        n3b = bswap_32( inp[2] )^( mb[1] * 0xffffffff ); n4b = bswap_32( inp[3] );
+      #endif
+      }
+
+     ak_magma_round2(  1, 7, n3, n4 ); ak_magma_round2(  2, 6, n4, n3 );
+     ak_magma_round2(  3, 5, n3, n4 ); ak_magma_round2(  4, 4, n4, n3 );
+     ak_magma_round2(  5, 3, n3, n4 ); ak_magma_round2(  6, 2, n4, n3 );
+     ak_magma_round2(  7, 1, n3, n4 ); ak_magma_round2(  8, 0, n4, n3 );
+
+     ak_magma_round2(  9, 7, n3, n4 ); ak_magma_round2( 10, 6, n4, n3 );
+     ak_magma_round2( 11, 5, n3, n4 ); ak_magma_round2( 12, 4, n4, n3 );
+     ak_magma_round2( 13, 3, n3, n4 ); ak_magma_round2( 14, 2, n4, n3 );
+     ak_magma_round2( 15, 1, n3, n4 ); ak_magma_round2( 16, 0, n4, n3 );
+
+     ak_magma_round2( 17, 7, n3, n4 ); ak_magma_round2( 18, 6, n4, n3 );
+     ak_magma_round2( 19, 5, n3, n4 ); ak_magma_round2( 20, 4, n4, n3 );
+     ak_magma_round2( 21, 3, n3, n4 ); ak_magma_round2( 22, 2, n4, n3 );
+     ak_magma_round2( 23, 1, n3, n4 ); ak_magma_round2( 24, 0, n4, n3 );
+
+     ak_magma_round2( 25, 0, n3, n4 ); ak_magma_round2( 26, 1, n4, n3 );
+     ak_magma_round2( 27, 2, n3, n4 ); ak_magma_round2( 28, 3, n4, n3 );
+     ak_magma_round2( 29, 4, n3, n4 ); ak_magma_round2( 30, 5, n4, n3 );
+     ak_magma_round2( 31, 6, n3, n4 ); ak_magma_round2( 32, 7, n4, n3 );
+
+     if( oc ) {
+     #ifdef AK_LITTLE_ENDIAN
+       outp[1] = bswap_32( n4a ); outp[0] = bswap_32( n3a );
+       outp[3] = bswap_32( n4b ); outp[2] = bswap_32( n3b );
+     #else
+       outp[1] = n4a; outp[0] = n3a;
+       outp[3] = n4b; outp[2] = n3b;
+     #endif
+     }
+      else {
+      #ifdef AK_LITTLE_ENDIAN
+        outp[0] = n4a^( ma[32] * 0xffffffff ); outp[1] = n3a;
+        outp[2] = n4b^( mb[32] * 0xffffffff ); outp[3] = n3b;
+      #else
+        outp[0] = bswap_32( n4a )^( ma[32] * 0xffffffff ); outp[1] = bswap_32( n3a );
+        outp[2] = bswap_32( n4b )^( mb[32] * 0xffffffff ); outp[3] = bswap_32( n3b );
+      #endif
+      }
+  }
+
+ /* последний блок (при нечетном количестве) */
+  if( count ) {
+    if( oc ) ak_magma_encrypt_with_random_walk_oc( skey, inp, outp );
+     else ak_magma_encrypt_with_random_walk( skey, inp, outp );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифрования последовательности блоков алгоритмом Магма. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_encrypt_blocks_with_random_walk( ak_skey skey,
+                                                     ak_pointer in, ak_pointer out, size_t count )
+{
+  ak_magma_encrypt_blocks( skey, in, out, count, ak_false );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифрования последовательности блоков алгоритмом Магма
+    в режиме совместимости с библиотекой openssl. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_encrypt_blocks_with_random_walk_oc( ak_skey skey,
+                                                     ak_pointer in, ak_pointer out, size_t count )
+{
+  ak_magma_encrypt_blocks( skey, in, out, count, ak_true );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция уничтожения развернутых ключей для маскированной магмы
 
@@ -948,10 +1082,12 @@
   if( oc ) {
     bkey->encrypt = ak_magma_encrypt_with_random_walk_oc;
     bkey->decrypt = ak_magma_decrypt_with_random_walk_oc;
+    bkey->encrypt_blocks = ak_magma_encrypt_blocks_with_random_walk_oc;
   }
    else {
     bkey->encrypt = ak_magma_encrypt_with_random_walk;
     bkey->decrypt = ak_magma_decrypt_with_random_walk;
+    bkey->encrypt_blocks = ak_magma_encrypt_blocks_with_random_walk;
   }
   return error;
 }
@@ -1170,6 +1306,25 @@
     goto exit;
   }
 
+ /* многоблочная реализация должна давать тот же результат (в том числе для нечетного числа блоков) */
+  memset( myout, 0, sizeof( magma_out_ecb ));
+  mkey.encrypt_blocks( &mkey.key, oc ? openssl_magma_in : magma_in, myout, sizeof( magma_in )/8 );
+  if( !ak_ptr_is_equal_with_log( myout, oc ? openssl_magma_out_ecb :
+                                                         magma_out_ecb, sizeof( magma_out_ecb ))) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                            "wrong encryption of several independent blocks" );
+    result = ak_false;
+    goto exit;
+  }
+  memset( myout, 0, sizeof( magma_out_ecb ));
+  mkey.encrypt_blocks( &mkey.key, oc ? openssl_magma_in : magma_in, myout, 3 );
+  if( !ak_ptr_is_equal_with_log( myout, oc ? openssl_magma_out_ecb : magma_out_ecb, 24 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                          "wrong encryption of odd number of independent blocks" );
+    result = ak_false;
+    goto exit;
+  }
+
   if(( error = ak_bckey_decrypt_ecb( &mkey, oc ? openssl_magma_out_ecb :
                                  magma_out_ecb, myout, sizeof( magma_out_ecb ))) != ak_error_ok ) {
     ak_error_message( error, __func__ , "wrong ecb mode decryption" );
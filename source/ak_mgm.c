@@ -129,6 +129,90 @@
 
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество блоков 128-битного шифра, обрабатываемых за один проход. */
+ #define ak_mgm_batch_blocks          (8)
+/*! \brief Минимальное количество блоков, начиная с которого используется обработка пачками. */
+ #define ak_mgm_batch_min_blocks      (4)
+
+#ifdef AK_LITTLE_ENDIAN
+ #define ak_mgm_ycount128_next(OUT)  (OUT) = ctx->ycount; \
+                                     ctx->ycount.q[0]++;
+ #define ak_mgm_zcount128_next(OUT)  (OUT) = ctx->zcount; \
+                                     ctx->zcount.q[1]++;
+#else
+ #define ak_mgm_ycount128_next(OUT)  (OUT) = ctx->ycount; \
+                                     ctx->ycount.q[0] = bswap_64( ctx->ycount.q[0] ); \
+                                     ctx->ycount.q[0]++; \
+                                     ctx->ycount.q[0] = bswap_64( ctx->ycount.q[0] );
+ #define ak_mgm_zcount128_next(OUT)  (OUT) = ctx->zcount; \
+                                     ctx->zcount.q[1] = bswap_64( ctx->zcount.q[1] ); \
+                                     ctx->zcount.q[1]++; \
+                                     ctx->zcount.q[1] = bswap_64( ctx->zcount.q[1] );
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает несколько независимых значений счетчика, используя,
+    при наличии, многоблочную реализацию алгоритма шифрования.                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mgm_encrypt_counters128( ak_bckey key,
+                                                  ak_uint128 *in, ak_uint128 *out, size_t count )
+{
+  if( key->encrypt_blocks != NULL ) key->encrypt_blocks( &key->key, in, out, count );
+   else for( ; count > 0; count--, in++, out++ ) key->encrypt( &key->key, in, out );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает пачку из `count` блоков (не более \ref ak_mgm_batch_blocks)
+    дополнительных данных 128-битного шифра.
+    \details Значения счетчика Z зашифровываются совместно, а сумма произведений
+    вычисляется с однократным приведением по модулю.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mgm_authentication_update128_blocks( ak_mgm_ctx ctx,
+                                      ak_bckey authenticationKey, ak_pointer data, size_t count )
+{
+  size_t i = 0;
+  ak_uint128 z[ak_mgm_batch_blocks], h[ak_mgm_batch_blocks];
+
+  for( i = 0; i < count; i++ ) { ak_mgm_zcount128_next( z[i] ); }
+  ak_mgm_encrypt_counters128( authenticationKey, z, h, count );
+  ak_gf128_mul_sum( &ctx->sum, h, data, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает (расшифровывает) пачку из `count` блоков
+    (не более \ref ak_mgm_batch_blocks) данных 128-битного шифра и, при наличии ключа
+    аутентификации, одновременно обновляет значение имитовставки.
+
+    \details Значения счетчиков Y и Z зашифровываются совместно; имитовставка всегда
+    вычисляется от шифртекста, поэтому при расшифровании она обновляется до того,
+    как входные данные могут быть перезаписаны.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mgm_crypt128_blocks( ak_mgm_ctx ctx, ak_bckey encryptionKey,
+               ak_bckey authenticationKey, ak_uint64 *inp, ak_uint64 *outp, size_t count,
+                                                                             const bool_t encrypt )
+{
+  size_t i = 0;
+  ak_uint128 y[ak_mgm_batch_blocks], e[ak_mgm_batch_blocks],
+             z[ak_mgm_batch_blocks], h[ak_mgm_batch_blocks];
+
+  for( i = 0; i < count; i++ ) { ak_mgm_ycount128_next( y[i] ); }
+  ak_mgm_encrypt_counters128( encryptionKey, y, e, count );
+
+  if( authenticationKey != NULL ) {
+    for( i = 0; i < count; i++ ) { ak_mgm_zcount128_next( z[i] ); }
+    ak_mgm_encrypt_counters128( authenticationKey, z, h, count );
+    if( !encrypt ) ak_gf128_mul_sum( &ctx->sum, h, inp, count );
+  }
+
+  for( i = 0; i < count; i++, inp += 2, outp += 2 ) {
+     outp[0] = inp[0] ^ e[i].q[0];
+     outp[1] = inp[1] ^ e[i].q[1];
+  }
+  if(( authenticationKey != NULL ) && encrypt )
+    ak_gf128_mul_sum( &ctx->sum, h, outp - 2*count, count );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция обрабатывает очередной блок дополнительных данных и
     обновляет внутреннее состояние переменных алгоритма MGM, участвующих в алгоритме
@@ -156,7 +240,7 @@
   ak_bckey authenticationKey = akey;
   ak_uint8 temp[16], *aptr = (ak_uint8 *)adata;
   ssize_t absize = ( ssize_t ) authenticationKey->bsize;
-  ssize_t resource = 0,
+  ssize_t resource = 0, count = 0,
           tail = ( ssize_t ) adata_size%absize,
           blocks = ( ssize_t ) adata_size/absize;
 
@@ -176,6 +260,10 @@
  if( absize == 16 ) { /* обработка 128-битным шифром */
 
    ctx->abitlen += ( blocks  << 7 );
+   for( ; blocks >= ak_mgm_batch_min_blocks; blocks -= count, aptr += 16*count ) {
+      count = ak_min( blocks, ak_mgm_batch_blocks );
+      ak_mgm_authentication_update128_blocks( ctx, authenticationKey, aptr, (size_t) count );
+   }
    for( ; blocks > 0; blocks--, aptr += 16 ) { astep128( aptr ); }
    if( tail ) {
     memset( temp, 0, 16 );
@@ -390,7 +478,7 @@
   size_t i = 0, absize = 0;
   ak_bckey encryptionKey = ekey;
   ak_bckey authenticationKey = akey;
-  size_t resource = 0, tail, blocks;
+  size_t resource = 0, tail, blocks, count = 0;
   ak_uint64 *inp = (ak_uint64 *)in, *outp = (ak_uint64 *)out;
 
  /* проверяем возможность обновления */
@@ -442,6 +530,10 @@
 
     if( absize&0x10 ) { /* режим работы для 128-битного шифра */
      /* основная часть */
+      for( ; blocks >= ak_mgm_batch_min_blocks; blocks -= count, inp += 2*count, outp += 2*count ) {
+         count = ak_min( blocks, ak_mgm_batch_blocks );
+         ak_mgm_crypt128_blocks( ctx, encryptionKey, NULL, inp, outp, count, ak_true );
+      }
       for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
          estep128;
       }
@@ -479,6 +571,10 @@
 
   if( absize&0x10 ) { /* режим работы для 128-битного шифра */
    /* основная часть */
+    for( ; blocks >= ak_mgm_batch_min_blocks; blocks -= count, inp += 2*count, outp += 2*count ) {
+      count = ak_min( blocks, ak_mgm_batch_blocks );
+      ak_mgm_crypt128_blocks( ctx, encryptionKey, authenticationKey, inp, outp, count, ak_true );
+    }
     for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
       estep128;
       astep128( outp );
@@ -549,7 +645,7 @@
   ak_uint128 e, h;
   size_t i = 0, absize = encryptionKey->bsize;
   ak_uint64 *inp = (ak_uint64 *)in, *outp = (ak_uint64 *)out;
-  size_t resource = 0,
+  size_t resource = 0, count = 0,
          tail = size%absize,
          blocks = size/absize;
 
@@ -584,6 +680,10 @@
                                     /* это полная копия кода, содержащегося в функции .. _encryption_ ... */
     if( absize&0x10 ) { /* режим работы для 128-битного шифра */
      /* основная часть */
+      for( ; blocks >= ak_mgm_batch_min_blocks; blocks -= count, inp += 2*count, outp += 2*count ) {
+         count = ak_min( blocks, ak_mgm_batch_blocks );
+         ak_mgm_crypt128_blocks( ctx, encryptionKey, NULL, inp, outp, count, ak_true );
+      }
       for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
          estep128;
       }
@@ -617,6 +717,10 @@
 
      if( absize&0x10 ) { /* режим работы для 128-битного шифра */
       /* основная часть */
+      for( ; blocks >= ak_mgm_batch_min_blocks; blocks -= count, inp += 2*count, outp += 2*count ) {
+         count = ak_min( blocks, ak_mgm_batch_blocks );
+         ak_mgm_crypt128_blocks( ctx, encryptionKey, authenticationKey, inp, outp, count, ak_false );
+      }
       for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
          astep128( inp );
          estep128;
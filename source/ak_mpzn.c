@@ -4,7 +4,7 @@
 /*  Файл ak_mpzn.c                                                                                 */
 /*  - содержит реализации функций для вычислений с большими целыми числами                         */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup math-doc Математические функции
@@ -645,18 +645,12 @@
 /* C. Koc, T.Acar, B. Kaliski Analyzing and Comparing Montgomery Multiplication Algorithms         */
 /*                                                             IEEE Micro, 16(3):26-33, June 1996. */
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция складывает два вычета x и y по модулю p, после чего приводит полученную сумму
-    по модулю p, то есть вычисляет значение сравнения \f$ z \equiv x + y \pmod{p}\f$.
-    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
-    слагаемые.
+/*! \brief Сложение вычетов по модулю p для модуля произвольного размера.
 
-    @param z Указатель на вычет, в который помещается результат
-    @param x Левый аргумент операции сложения
-    @param y Правый аргумент операции сложения
-    @param p Модуль, по которому производяится операция сложения
-    @param size Размер модуля в словах (значение константы ak_mpzn256_size или ak_mpzn512_size )   */
+    Функция используется функцией ak_mpzn_add_montgomery() в случае, когда для заданного
+    размера модуля отсутствует специализированная реализация.                                     */
 /* ----------------------------------------------------------------------------------------------- */
- inline void ak_mpzn_add_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+ static void ak_mpzn_add_montgomery_uint64( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
                                                                 ak_uint64 *p, const size_t size )
 {
   size_t i = 0;
@@ -720,23 +714,12 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
-    произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
-    \f$ y \equiv y_0r \pmod{p} \f$ функция вычисляет значение,
-    удовлетворяющее сравнению \f$ z \equiv x_0y_0r \pmod{p}\f$.
-    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
-    перемножаемые вычеты.
+/*! \brief Умножение вычетов в представлении Монтгомери для модуля произвольного размера.
 
-    @param z Указатель на вычет, в который помещается результат
-    @param x Левый аргумент опреации сложения
-    @param y Правый аргумент операции сложения
-    @param p Модуль, по которому производятся вычисления
-    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
-    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
-    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
-                                                                          \ref ak_mpzn512_size).   */
+    Функция используется функцией ak_mpzn_mul_montgomery() в случае, когда для заданного
+    размера модуля отсутствует специализированная реализация.                                     */
 /* ----------------------------------------------------------------------------------------------- */
- inline void ak_mpzn_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+ static void ak_mpzn_mul_montgomery_uint64( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
                                                ak_uint64 *p, ak_uint64 n0, const size_t size )
 {
   size_t i = 0, j = 0, ij = 0;
@@ -795,6 +778,410 @@
   if( cy != t[2*size] ) memcpy( z, t+size, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                  реализации операций Монтгомери для модулей фиксированного размера              */
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef __SIZEOF_INT128__
+ #define AK_HAVE_UINT128
+ __extension__ typedef unsigned __int128 ak_mpzn_dword;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение вычетов по модулю p для модуля, размер которого известен при компиляции.
+
+    Функция вызывается только с константным значением size, поэтому компилятор полностью
+    разворачивает циклы. Выбор результата выполняется без ветвлений.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_add_montgomery_fixed( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 t[ak_mpzn512_size], u[ak_mpzn512_size], cy = 0, bw = 0, mask;
+
+  for( i = 0; i < size; i++ ) {
+     ak_uint64 s = x[i] + cy;
+     cy = s < cy;
+     t[i] = s + y[i];
+     cy += t[i] < s;
+  }
+  for( i = 0; i < size; i++ ) {
+     ak_uint64 d = t[i] - bw;
+     bw = d > t[i];
+     u[i] = d - p[i];
+     bw += u[i] > d;
+  }
+ /* если сумма меньше модуля, то результатом является t, иначе t - p */
+  mask = 0 - ( ak_uint64 )( cy != bw );
+  for( i = 0; i < size; i++ ) z[i] = u[i]^( mask&( u[i]^t[i] ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычитание модуля из результата умножения Монтгомери, не превосходящего \f$ 2p \f$.
+
+    @param z Вычет, в который помещается результат
+    @param t Младшие size слов результата умножения
+    @param top Старшее слово результата умножения (ноль или единица)
+    @param p Модуль
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_montgomery_fixed_reduce( ak_uint64 *z, ak_uint64 *t,
+                                           const ak_uint64 top, ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 u[ak_mpzn512_size], bw = 0, mask;
+
+  for( i = 0; i < size; i++ ) {
+     ak_uint64 d = t[i] - bw;
+     bw = d > t[i];
+     u[i] = d - p[i];
+     bw += u[i] > d;
+  }
+  mask = 0 - ( ak_uint64 )( top != bw );
+  for( i = 0; i < size; i++ ) z[i] = u[i]^( mask&( u[i]^t[i] ));
+}
+
+#ifdef AK_HAVE_UINT128
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение вычетов в представлении Монтгомери для модуля, размер которого
+    известен при компиляции.
+
+    Используется вариант CIOS (Coarsely Integrated Operand Scanning) из статьи Коча, Акара и
+    Калиски: умножение на очередное слово x и редукция чередуются, поэтому промежуточный
+    результат занимает size+2 слова. Произведения слов вычисляются с помощью 128-ми битного
+    целого типа, что позволяет компилятору использовать команды умножения и сложения с переносом
+    без ассемблерных вставок.                                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_fixed( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_mpzn_dword w;
+  ak_uint64 t[ak_mpzn512_size+2], c, m, xi;
+
+  for( j = 0; j < size+2; j++ ) t[j] = 0;
+  for( i = 0; i < size; i++ ) {
+    /* t = t + x[i]*y */
+     xi = x[i]; c = 0;
+     for( j = 0; j < size; j++ ) {
+        w = ( ak_mpzn_dword )xi*y[j] + t[j] + c;
+        t[j] = ( ak_uint64 )w; c = ( ak_uint64 )( w >> 64 );
+     }
+     w = ( ak_mpzn_dword )t[size] + c;
+     t[size] = ( ak_uint64 )w; t[size+1] = ( ak_uint64 )( w >> 64 );
+
+    /* t = ( t + m*p )/2^64 */
+     m = t[0]*n0;
+     w = ( ak_mpzn_dword )m*p[0] + t[0];
+     c = ( ak_uint64 )( w >> 64 );
+     for( j = 1; j < size; j++ ) {
+        w = ( ak_mpzn_dword )m*p[j] + t[j] + c;
+        t[j-1] = ( ak_uint64 )w; c = ( ak_uint64 )( w >> 64 );
+     }
+     w = ( ak_mpzn_dword )t[size] + c;
+     t[size-1] = ( ak_uint64 )w;
+     t[size] = t[size+1] + ( ak_uint64 )( w >> 64 );
+  }
+  ak_mpzn_montgomery_fixed_reduce( z, t, t[size], p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul_montgomery_uint128( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                    ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_fixed( z, x, y, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul_montgomery_uint128( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                    ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_fixed( z, x, y, p, n0, ak_mpzn512_size );
+}
+#endif
+
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+/* ----------------------------------------------------------------------------------------------- */
+/* Реализация с использованием команд mulx (bmi2), adcx и adox (adx).                              */
+/* Строка умножения t[0..size] += m*y[0..size-1] вычисляется с двумя независимыми цепочками        */
+/* переносов: через флаг CF суммируются младшие слова произведений со словами t, через флаг OF -    */
+/* старшие слова произведений. Старшие слова соседних произведений хранятся в регистрах r9 и r11.   */
+/* ----------------------------------------------------------------------------------------------- */
+ #define ak_mulx_first( off ) \
+   "mulxq " off "(%[y]), %%r8, %%r9\n\t"  \
+   "adcxq " off "(%[t]), %%r8\n\t"        \
+   "movq %%r8, " off "(%[t])\n\t"
+
+ #define ak_mulx_even( off ) \
+   "mulxq " off "(%[y]), %%r8, %%r9\n\t"  \
+   "adcxq " off "(%[t]), %%r8\n\t"        \
+   "adoxq %%r11, %%r8\n\t"                \
+   "movq %%r8, " off "(%[t])\n\t"
+
+ #define ak_mulx_odd( off ) \
+   "mulxq " off "(%[y]), %%r10, %%r11\n\t" \
+   "adcxq " off "(%[t]), %%r10\n\t"        \
+   "adoxq %%r9, %%r10\n\t"                 \
+   "movq %%r10, " off "(%[t])\n\t"
+
+ /* последнее слово строки; сумма флагов CF и OF возвращается в качестве переноса */
+ #define ak_mulx_last( off ) \
+   "movq " off "(%[t]), %%r8\n\t"          \
+   "adcxq %%rax, %%r8\n\t"                 \
+   "adoxq %%r11, %%r8\n\t"                 \
+   "movq %%r8, " off "(%[t])\n\t"          \
+   "movl $0, %%r9d\n\t"                    \
+   "adcxq %%rax, %%r9\n\t"                 \
+   "adoxq %%rax, %%r9\n\t"                 \
+   "movq %%r9, %[c]\n\t"
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_mpzn512_mulx_row( ak_uint64 *t, ak_uint64 m, const ak_uint64 *y )
+{
+  ak_uint64 c;
+  __asm__ volatile (
+    "xorl %%eax, %%eax\n\t"
+    ak_mulx_first( "0" ) ak_mulx_odd( "8" ) ak_mulx_even( "16" ) ak_mulx_odd( "24" )
+    ak_mulx_even( "32" ) ak_mulx_odd( "40" ) ak_mulx_even( "48" ) ak_mulx_odd( "56" )
+    ak_mulx_last( "64" )
+    : [c] "=r" ( c )
+    : [t] "r" ( t ), [y] "r" ( y ), "d" ( m )
+    : "rax", "r8", "r9", "r10", "r11", "cc", "memory" );
+ return c;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение вычетов в представлении Монтгомери с использованием команд mulx, adcx и adox.
+
+    Используется вариант SOS (Separated Operand Scanning): сначала вычисляется полное
+    произведение \f$ xy \f$, затем выполняется редукция; каждая строка вычислений
+    реализуется ассемблерной вставкой.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ #define ak_mpzn_mul_montgomery_mulx( row, size )                                                  \
+ do {                                                                                              \
+   size_t i = 0, j = 0;                                                                            \
+   ak_uint64 t[2*size+1], c;                                                                       \
+                                                                                                   \
+   for( j = 0; j < 2*size+1; j++ ) t[j] = 0;                                                       \
+   for( i = 0; i < size; i++ ) row( t+i, x[i], y );                                                \
+   for( i = 0; i < size; i++ ) {                                                                   \
+      c = row( t+i, t[i]*n0, p );                                                                  \
+      for( j = i+size+1; c && ( j < 2*size+1 ); j++ ) { t[j] += c; c = t[j] < c; }                 \
+   }                                                                                               \
+   ak_mpzn_montgomery_fixed_reduce( z, t+size, t[2*size], p, size );                               \
+ } while( 0 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/* Для 256-ти битного модуля используется вариант CIOS, при котором промежуточный результат         */
+/* целиком размещается в регистрах r8 - r13; номера регистров сдвигаются на единицу после каждого   */
+/* шага редукции, поэтому деление на 2^64 не требует пересылок.                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ /* t[a0..a5] += x[i]*y */
+ #define ak_mulx4_mul( off, a0, a1, a2, a3, a4, a5 ) \
+   "movq " off "(%[x]), %%rdx\n\t"                                                      \
+   "xorl %%eax, %%eax\n\t"                                                              \
+   "mulxq 0(%[y]), %%r14, %%r15\n\t"  "adcxq %%r14, %%" a0 "\n\t" "adoxq %%r15, %%" a1 "\n\t" \
+   "mulxq 8(%[y]), %%r14, %%r15\n\t"  "adcxq %%r14, %%" a1 "\n\t" "adoxq %%r15, %%" a2 "\n\t" \
+   "mulxq 16(%[y]), %%r14, %%r15\n\t" "adcxq %%r14, %%" a2 "\n\t" "adoxq %%r15, %%" a3 "\n\t" \
+   "mulxq 24(%[y]), %%r14, %%r15\n\t" "adcxq %%r14, %%" a3 "\n\t" "adoxq %%r15, %%" a4 "\n\t" \
+   "movl $0, %%" a5 "d\n\t"                                                              \
+   "adcxq %%rax, %%" a4 "\n\t" "adoxq %%rax, %%" a5 "\n\t" "adcxq %%rax, %%" a5 "\n\t"
+
+ /* t[a0..a5] += m*p, m = t[a0]*n0, после чего слово a0 равно нулю */
+ #define ak_mulx4_red( a0, a1, a2, a3, a4, a5 ) \
+   "movq %%" a0 ", %%rdx\n\t"                                                           \
+   "imulq %[n0], %%rdx\n\t"                                                             \
+   "xorl %%eax, %%eax\n\t"                                                              \
+   "mulxq 0(%[p]), %%r14, %%r15\n\t"  "adcxq %%r14, %%" a0 "\n\t" "adoxq %%r15, %%" a1 "\n\t" \
+   "mulxq 8(%[p]), %%r14, %%r15\n\t"  "adcxq %%r14, %%" a1 "\n\t" "adoxq %%r15, %%" a2 "\n\t" \
+   "mulxq 16(%[p]), %%r14, %%r15\n\t" "adcxq %%r14, %%" a2 "\n\t" "adoxq %%r15, %%" a3 "\n\t" \
+   "mulxq 24(%[p]), %%r14, %%r15\n\t" "adcxq %%r14, %%" a3 "\n\t" "adoxq %%r15, %%" a4 "\n\t" \
+   "adcxq %%rax, %%" a4 "\n\t" "adoxq %%rax, %%" a5 "\n\t" "adcxq %%rax, %%" a5 "\n\t"
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul_montgomery_mulx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                    ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[ak_mpzn256_size+1];
+
+  __asm__ volatile (
+    "xorl %%r8d, %%r8d\n\t" "xorl %%r9d, %%r9d\n\t" "xorl %%r10d, %%r10d\n\t"
+    "xorl %%r11d, %%r11d\n\t" "xorl %%r12d, %%r12d\n\t"
+    ak_mulx4_mul( "0", "r8", "r9", "r10", "r11", "r12", "r13" )
+    ak_mulx4_red( "r8", "r9", "r10", "r11", "r12", "r13" )
+    ak_mulx4_mul( "8", "r9", "r10", "r11", "r12", "r13", "r8" )
+    ak_mulx4_red( "r9", "r10", "r11", "r12", "r13", "r8" )
+    ak_mulx4_mul( "16", "r10", "r11", "r12", "r13", "r8", "r9" )
+    ak_mulx4_red( "r10", "r11", "r12", "r13", "r8", "r9" )
+    ak_mulx4_mul( "24", "r11", "r12", "r13", "r8", "r9", "r10" )
+    ak_mulx4_red( "r11", "r12", "r13", "r8", "r9", "r10" )
+    "movq %%r12, 0(%[t])\n\t" "movq %%r13, 8(%[t])\n\t" "movq %%r8, 16(%[t])\n\t"
+    "movq %%r9, 24(%[t])\n\t" "movq %%r10, 32(%[t])\n\t"
+    :
+    : [t] "r" ( t ), [x] "r" ( x ), [y] "r" ( y ), [p] "r" ( p ), [n0] "m" ( n0 )
+    : "rax", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "cc", "memory" );
+  ak_mpzn_montgomery_fixed_reduce( z, t, t[ak_mpzn256_size], p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul_montgomery_mulx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                    ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_mulx( ak_mpzn512_mulx_row, ak_mpzn512_size );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_mul_montgomery_uint64( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                    ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_uint64( z, x, y, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_mul_montgomery_uint64( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                    ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_uint64( z, x, y, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_add_montgomery_fixed( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                                   ak_uint64 *p )
+{
+  ak_mpzn_add_montgomery_fixed( z, x, y, p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_add_montgomery_fixed( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                                   ak_uint64 *p )
+{
+  ak_mpzn_add_montgomery_fixed( z, x, y, p, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn256_add_montgomery_uint64( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                                   ak_uint64 *p )
+{
+  ak_mpzn_add_montgomery_uint64( z, x, y, p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn512_add_montgomery_uint64( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                                   ak_uint64 *p )
+{
+  ak_mpzn_add_montgomery_uint64( z, x, y, p, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Тип функции умножения вычетов в представлении Монтгомери для модуля фиксированного размера. */
+ typedef void ( ak_function_mpzn_mul_montgomery )( ak_uint64 * , ak_uint64 * , ak_uint64 * ,
+                                                                         ak_uint64 * , ak_uint64 );
+/*! \brief Тип функции сложения вычетов для модуля фиксированного размера. */
+ typedef void ( ak_function_mpzn_add_montgomery )( ak_uint64 * , ak_uint64 * , ak_uint64 * ,
+                                                                                     ak_uint64 * );
+
+/*! \brief Реализации умножения, выбранные функцией ak_mpzn_set_cpu_level(). */
+ static ak_function_mpzn_mul_montgomery
+                          *ak_mpzn256_mul_montgomery_function = ak_mpzn256_mul_montgomery_uint64,
+                          *ak_mpzn512_mul_montgomery_function = ak_mpzn512_mul_montgomery_uint64;
+/*! \brief Реализации сложения, выбранные функцией ak_mpzn_set_cpu_level(). */
+ static ak_function_mpzn_add_montgomery
+                          *ak_mpzn256_add_montgomery_function = ak_mpzn256_add_montgomery_uint64,
+                          *ak_mpzn512_add_montgomery_function = ak_mpzn512_add_montgomery_uint64;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается при инициализации библиотеки, а также при изменении уровня реализации
+    вычислительных ядер, и выбирает реализации операций Монтгомери для 256-ти и 512-ти битных
+    модулей, используемых при вычислениях с точками эллиптических кривых:
+     - при уровне \ref cpu_level_avx2 используются ассемблерные вставки с командами mulx, adcx и adox,
+     - в остальных случаях используется реализация с 128-ми битным целым типом (при его наличии).
+
+    Значение опции `use_fixed_size_montgomery`, равное нулю, оставляет реализации
+    для модулей произвольного размера; это позволяет сравнить скорость вычислений.
+
+    @param level Максимальный допустимый уровень реализации.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_set_cpu_level( cpu_level_t level )
+{
+  ak_mpzn256_mul_montgomery_function = ak_mpzn256_mul_montgomery_uint64;
+  ak_mpzn512_mul_montgomery_function = ak_mpzn512_mul_montgomery_uint64;
+  ak_mpzn256_add_montgomery_function = ak_mpzn256_add_montgomery_uint64;
+  ak_mpzn512_add_montgomery_function = ak_mpzn512_add_montgomery_uint64;
+  if( ak_libakrypt_get_option_by_name( "use_fixed_size_montgomery" ) != 1 ) return;
+
+  ak_mpzn256_add_montgomery_function = ak_mpzn256_add_montgomery_fixed;
+  ak_mpzn512_add_montgomery_function = ak_mpzn512_add_montgomery_fixed;
+#ifdef AK_HAVE_UINT128
+  ak_mpzn256_mul_montgomery_function = ak_mpzn256_mul_montgomery_uint128;
+  ak_mpzn512_mul_montgomery_function = ak_mpzn512_mul_montgomery_uint128;
+#endif
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+  if(( level >= cpu_level_avx2 ) &&
+     ( ak_libakrypt_get_cpu_features()&ak_cpu_feature_bmi2 ) &&
+     ( ak_libakrypt_get_cpu_features()&ak_cpu_feature_adx )) {
+    ak_mpzn256_mul_montgomery_function = ak_mpzn256_mul_montgomery_mulx;
+    ak_mpzn512_mul_montgomery_function = ak_mpzn512_mul_montgomery_mulx;
+  }
+#else
+  (void)level;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция складывает два вычета x и y по модулю p, после чего приводит полученную сумму
+    по модулю p, то есть вычисляет значение сравнения \f$ z \equiv x + y \pmod{p}\f$.
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
+    слагаемые.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент операции сложения
+    @param y Правый аргумент операции сложения
+    @param p Модуль, по которому производяится операция сложения
+    Для модулей размера \ref ak_mpzn256_size и \ref ak_mpzn512_size используются реализации,
+    выбранные функцией ak_mpzn_set_cpu_level().
+
+    @param size Размер модуля в словах (значение константы ak_mpzn256_size или ak_mpzn512_size )   */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_add_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: ak_mpzn256_add_montgomery_function( z, x, y, p ); break;
+    case ak_mpzn512_size: ak_mpzn512_add_montgomery_function( z, x, y, p ); break;
+    default: ak_mpzn_add_montgomery_uint64( z, x, y, p, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
+    произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
+    \f$ y \equiv y_0r \pmod{p} \f$ функция вычисляет значение,
+    удовлетворяющее сравнению \f$ z \equiv x_0y_0r \pmod{p}\f$.
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
+    перемножаемые вычеты.
+
+    Для модулей размера \ref ak_mpzn256_size и \ref ak_mpzn512_size используются реализации,
+    выбранные функцией ak_mpzn_set_cpu_level().
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации сложения
+    @param y Правый аргумент операции сложения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: ak_mpzn256_mul_montgomery_function( z, x, y, p, n0 ); break;
+    case ak_mpzn512_size: ak_mpzn512_mul_montgomery_function( z, x, y, p, n0 ); break;
+    default: ak_mpzn_mul_montgomery_uint64( z, x, y, p, n0, size );
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, где \f$ r \f$
     заданная степень двойки, вычисляется вычет \f$ z \f$,
@@ -841,6 +1228,442 @@
   memcpy( z, res, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                          вычисление обратных вычетов по простому модулю                         */
+/* ----------------------------------------------------------------------------------------------- */
+#ifndef AK_HAVE_UINT128
+/*! \brief Сдвиг вычета вправо на k бит (\f$ 0 < k < 64 \f$). */
+ static inline void ak_mpzn_rshift_bits( ak_uint64 *x, const size_t k, const size_t size )
+{
+  size_t i = 0;
+  for( i = 0; i < size-1; i++ ) x[i] = ( x[i] >> k )|( x[i+1] << ( 64-k ));
+  x[size-1] >>= k;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Деление вычета на \f$ 2^k \f$ по нечетному модулю p (\f$ 0 < k < 64 \f$).
+
+    К вычету прибавляется кратное модуля \f$ mp \f$, где \f$ m \equiv -xp^{-1} \pmod{2^k}\f$,
+    после чего сумма, делящаяся на \f$ 2^k \f$, сдвигается вправо. Значение \f$ n_0 \equiv -p^{-1}
+    \pmod{2^{64}}\f$ совпадает с константой, используемой в арифметике Монтгомери.                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_rshift_modulo( ak_uint64 *x, const size_t k,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 t[ak_mpzn512_size+1], m = ( x[0]*n0 )&(( (ak_uint64)1 << k ) -1 );
+
+  t[size] = ak_mpzn_mul_ui( t, p, size, m );
+  t[size] += ak_mpzn_add( t, t, x, size );
+  for( i = 0; i < size; i++ ) x[i] = ( t[i] >> k )|( t[i+1] << ( 64-k ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление обратного вычета бинарным расширенным алгоритмом Евклида.
+
+    Время работы алгоритма зависит от значения x, поэтому функция применяется только к открытым
+    данным. Вычет \f$ x \f$ должен удовлетворять неравенству \f$ 0 \leq x < p\f$,
+    для \f$ x = 0 \f$ возвращается ноль.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_inverse_binary( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t k = 0;
+  ak_mpznmax u, v, x1 = ak_mpznmax_one, x2 = ak_mpznmax_zero;
+
+  ak_mpzn_set( u, x, size );
+  ak_mpzn_set( v, p, size );
+  if( ak_mpzn_cmp_ui( u, size, 0 )) { ak_mpzn_set_ui( z, size, 0 ); return; }
+
+ /* инвариант: x1*x = u (mod p), x2*x = v (mod p) */
+  while( 1 ) {
+    while(( u[0]&1 ) == 0 ) {
+      for( k = 1; k < 63 && (( u[0] >> k )&1 ) == 0; k++ );
+      ak_mpzn_rshift_bits( u, k, size );
+      ak_mpzn_rshift_modulo( x1, k, p, n0, size );
+    }
+    if( ak_mpzn_cmp_ui( u, size, 1 )) { ak_mpzn_set( z, x1, size ); break; }
+    while(( v[0]&1 ) == 0 ) {
+      for( k = 1; k < 63 && (( v[0] >> k )&1 ) == 0; k++ );
+      ak_mpzn_rshift_bits( v, k, size );
+      ak_mpzn_rshift_modulo( x2, k, p, n0, size );
+    }
+    if( ak_mpzn_cmp_ui( v, size, 1 )) { ak_mpzn_set( z, x2, size ); break; }
+
+    if( ak_mpzn_cmp( u, v, size ) > 0 ) {
+      ak_mpzn_sub( u, u, v, size );
+      if( ak_mpzn_sub( x1, x1, x2, size )) ak_mpzn_add( x1, x1, p, size );
+    } else {
+        ak_mpzn_sub( v, v, u, size );
+        if( ak_mpzn_sub( x2, x2, x1, size )) ak_mpzn_add( x2, x2, p, size );
+        if( ak_mpzn_cmp_ui( v, size, 0 )) { /* x и p не взаимно просты */
+          ak_mpzn_set_ui( z, size, 0 );
+          break;
+        }
+      }
+  }
+}
+
+#else
+/* ----------------------------------------------------------------------------------------------- */
+ __extension__ typedef __int128 ak_mpzn_sdword;
+
+/*! \brief Максимальное количество 62-х битных слов для представления вычетов. */
+ #define ak_mpzn_s62_size  ( 9 )
+/*! \brief Маска младших 62-х бит. */
+ #define ak_mpzn_m62  ( (ak_uint64)-1 >> 2 )
+
+/*! \brief Матрица перехода, вычисляемая за 62 итерации алгоритма divsteps. */
+ typedef struct mpzn_trans {
+  ak_int64 u, v, q, r;
+ } *ak_mpzn_trans;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование вычета в представление по основанию \f$ 2^{62}\f$. */
+ static inline void ak_mpzn_to_s62( ak_int64 *r, const ak_uint64 *x,
+                                                              const size_t size, const size_t len )
+{
+  size_t i = 0, bit = 0, w = 0, s = 0;
+  for( i = 0; i < len; i++, bit += 62 ) {
+     w = bit >> 6; s = bit&0x3f;
+     r[i] = 0;
+     if( w < size ) r[i] = (ak_int64)( x[w] >> s );
+     if(( s > 2 ) && ( w+1 < size )) r[i] |= (ak_int64)( x[w+1] << ( 64-s ));
+     r[i] &= ak_mpzn_m62;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обратное преобразование неотрицательного вычета из представления по основанию \f$ 2^{62}\f$. */
+ static inline void ak_mpzn_from_s62( ak_uint64 *x, const ak_int64 *r,
+                                                              const size_t size, const size_t len )
+{
+  size_t i = 0, bit = 0, w = 0, s = 0;
+  memset( x, 0, size*sizeof( ak_uint64 ));
+  for( i = 0; i < len; i++, bit += 62 ) {
+     w = bit >> 6; s = bit&0x3f;
+     if( w < size ) x[w] |= (ak_uint64)r[i] << s;
+     if(( s > 2 ) && ( w+1 < size )) x[w+1] |= (ak_uint64)r[i] >> ( 64-s );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выполнение 62-х итераций алгоритма divsteps Бернштейна-Янга.
+
+    Функция использует только младшие биты значений f и g и вычисляет матрицу перехода t,
+    такую что \f$ 2^{62}(f', g') = t(f, g)\f$. Переменная eta равна \f$ -\delta \f$.
+    Вычисления выполняются без ветвлений и обращений к памяти, зависящих от данных.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_int64 ak_mpzn_divsteps_62( ak_int64 eta,
+                                                  ak_uint64 f, ak_uint64 g, ak_mpzn_trans t )
+{
+  int i = 0;
+  ak_uint64 u = 1, v = 0, q = 0, r = 1, c1, c2, x, y, z;
+
+  for( i = 0; i < 62; i++ ) {
+    /* c1 = -1, если eta < 0; c2 = -1, если g нечетно */
+     c1 = (ak_uint64)( eta >> 63 );
+     c2 = -( g&1 );
+    /* g <- g -/+ f, (q,r) <- (q,r) -/+ (u,v) */
+     x = ( f^c1 ) - c1;
+     y = ( u^c1 ) - c1;
+     z = ( v^c1 ) - c1;
+     g += x&c2;
+     q += y&c2;
+     r += z&c2;
+    /* при eta < 0 и нечетном g меняем местами значения и знак eta */
+     c1 &= c2;
+     eta = ( eta^(ak_int64)c1 ) - ((ak_int64)c1 + 1 );
+     f += g&c1;
+     u += q&c1;
+     v += r&c1;
+     g >>= 1;
+     u <<= 1;
+     v <<= 1;
+  }
+  t->u = (ak_int64)u; t->v = (ak_int64)v;
+  t->q = (ak_int64)q; t->r = (ak_int64)r;
+ return eta;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ (f, g) \leftarrow t(f, g)/2^{62} \f$. */
+ static inline void ak_mpzn_update_fg_62( ak_int64 *f, ak_int64 *g,
+                                                       ak_mpzn_trans t, const size_t len )
+{
+  size_t i = 0;
+  ak_mpzn_sdword cf, cg;
+
+  cf = (ak_mpzn_sdword)t->u*f[0] + (ak_mpzn_sdword)t->v*g[0];
+  cg = (ak_mpzn_sdword)t->q*f[0] + (ak_mpzn_sdword)t->r*g[0];
+  cf >>= 62; cg >>= 62;
+  for( i = 1; i < len; i++ ) {
+     cf += (ak_mpzn_sdword)t->u*f[i] + (ak_mpzn_sdword)t->v*g[i];
+     cg += (ak_mpzn_sdword)t->q*f[i] + (ak_mpzn_sdword)t->r*g[i];
+     f[i-1] = (ak_int64)cf&ak_mpzn_m62; cf >>= 62;
+     g[i-1] = (ak_int64)cg&ak_mpzn_m62; cg >>= 62;
+  }
+  f[len-1] = (ak_int64)cf;
+  g[len-1] = (ak_int64)cg;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ (d, e) \leftarrow t(d, e)/2^{62} \pmod{p}\f$.
+
+    Для деления на \f$ 2^{62}\f$ к результату прибавляются кратные модуля, обнуляющие младшие
+    62 бита. Если значения d и e лежат в интервале \f$ (-2p, p)\f$, то и результат лежит
+    в том же интервале.                                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_update_de_62( ak_int64 *d, ak_int64 *e, ak_mpzn_trans t,
+                                        const ak_int64 *p, const ak_uint64 pinv, const size_t len )
+{
+  size_t i = 0;
+  ak_int64 md, me, sd = d[len-1] >> 63, se = e[len-1] >> 63;
+  ak_mpzn_sdword cd, ce;
+
+ /* для отрицательных d и e заранее прибавляем модуль, чтобы результат не вышел за границы */
+  md = ( t->u&sd ) + ( t->v&se );
+  me = ( t->q&sd ) + ( t->r&se );
+  cd = (ak_mpzn_sdword)t->u*d[0] + (ak_mpzn_sdword)t->v*e[0];
+  ce = (ak_mpzn_sdword)t->q*d[0] + (ak_mpzn_sdword)t->r*e[0];
+  md -= (ak_int64)(( pinv*(ak_uint64)cd + (ak_uint64)md )&ak_mpzn_m62 );
+  me -= (ak_int64)(( pinv*(ak_uint64)ce + (ak_uint64)me )&ak_mpzn_m62 );
+  cd += (ak_mpzn_sdword)p[0]*md;
+  ce += (ak_mpzn_sdword)p[0]*me;
+  cd >>= 62; ce >>= 62;
+  for( i = 1; i < len; i++ ) {
+     cd += (ak_mpzn_sdword)t->u*d[i] + (ak_mpzn_sdword)t->v*e[i] + (ak_mpzn_sdword)p[i]*md;
+     ce += (ak_mpzn_sdword)t->q*d[i] + (ak_mpzn_sdword)t->r*e[i] + (ak_mpzn_sdword)p[i]*me;
+     d[i-1] = (ak_int64)cd&ak_mpzn_m62; cd >>= 62;
+     e[i-1] = (ak_int64)ce&ak_mpzn_m62; ce >>= 62;
+  }
+  d[len-1] = (ak_int64)cd;
+  e[len-1] = (ak_int64)ce;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Прибавление модуля к отрицательному вычету и приведение слов к диапазону \f$ [0, 2^{62})\f$. */
+ static inline void ak_mpzn_cond_add_s62( ak_int64 *d, const ak_int64 *p, const size_t len )
+{
+  size_t i = 0;
+  ak_int64 mask = d[len-1] >> 63;
+
+  for( i = 0; i < len; i++ ) d[i] += p[i]&mask;
+  for( i = 0; i < len-1; i++ ) {
+     d[i+1] += d[i] >> 62;
+     d[i] &= ak_mpzn_m62;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Приведение значения \f$ d \in (-2p, p)\f$, умноженного на знак sign, к интервалу
+    \f$ [0, p)\f$ и преобразование результата в обычное представление.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_normalize_s62( ak_uint64 *z, ak_int64 *d, const ak_int64 sign,
+                                           const ak_int64 *p, const size_t size, const size_t len )
+{
+  size_t i = 0;
+
+  ak_mpzn_cond_add_s62( d, p, len );
+  for( i = 0; i < len; i++ ) d[i] = ( d[i]^sign ) - sign;
+  for( i = 0; i < len-1; i++ ) {
+     d[i+1] += d[i] >> 62;
+     d[i] &= ak_mpzn_m62;
+  }
+  ak_mpzn_cond_add_s62( d, p, len );
+  ak_mpzn_from_s62( z, d, size, len );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление обратного вычета алгоритмом safegcd Бернштейна-Янга.
+
+    Количество итераций алгоритма divsteps зависит только от размера модуля и выбирается
+    в соответствии с оценкой \f$ m \geq (49d + 57)/17 \f$, где \f$ d \f$ битовая длина модуля
+    (см. D.J. Bernstein, B.-Y. Yang. Fast constant-time gcd computation and modular inversion, 2019).
+    Все вычисления выполняются за время, не зависящее от значения x.
+    Вычет \f$ x \f$ должен удовлетворять неравенству \f$ 0 \leq x < p\f$,
+    для \f$ x = 0 \f$ возвращается ноль.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_inverse_safegcd( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  struct mpzn_trans t;
+  ak_int64 eta = -1;
+  ak_int64 f[ak_mpzn_s62_size], g[ak_mpzn_s62_size], d[ak_mpzn_s62_size] = { 0 },
+                                           e[ak_mpzn_s62_size] = { 1 }, m[ak_mpzn_s62_size];
+  size_t i = 0, len = ( size << 6 )/62 +1,
+         count = ((( 49*( size << 6 ) +57 )/17 ) +1 +61 )/62;
+  ak_uint64 pinv = ( (ak_uint64)0 - n0 )&ak_mpzn_m62; /* p^{-1} mod 2^{62} */
+
+  ak_mpzn_to_s62( m, p, size, len );
+  ak_mpzn_to_s62( f, p, size, len );
+  ak_mpzn_to_s62( g, x, size, len );
+  for( i = 0; i < count; i++ ) {
+     eta = ak_mpzn_divsteps_62( eta, (ak_uint64)f[0], (ak_uint64)g[0], &t );
+     ak_mpzn_update_de_62( d, e, &t, m, pinv, len );
+     ak_mpzn_update_fg_62( f, g, &t, len );
+  }
+  ak_mpzn_normalize_s62( z, d, f[len-1] >> 63, m, size, len );
+
+  memset( d, 0, sizeof( d )); memset( e, 0, sizeof( e ));
+  memset( f, 0, sizeof( f )); memset( g, 0, sizeof( g ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выполнение 62-х итераций алгоритма divsteps за время, зависящее от данных.
+
+    В отличие от функции ak_mpzn_divsteps_62() серии нулевых младших бит значения g
+    пропускаются за одно действие, а за один шаг сложения обнуляется до шести младших бит g.     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_int64 ak_mpzn_divsteps_62_vartime( ak_int64 eta,
+                                                  ak_uint64 f, ak_uint64 g, ak_mpzn_trans t )
+{
+  ak_uint64 u = 1, v = 0, q = 0, r = 1, m, w, tmp;
+  int i = 62, limit, zeros;
+
+  while( 1 ) {
+    /* старший бит-ограничитель не позволяет пропустить больше i нулей */
+     zeros = __builtin_ctzll( g|( (ak_uint64)-1 << i ));
+     g >>= zeros;
+     u <<= zeros;
+     v <<= zeros;
+     eta -= zeros;
+     i -= zeros;
+     if( i == 0 ) break;
+    /* теперь g нечетно; при eta < 0 заменяем (f, g) на (g, -f) */
+     if( eta < 0 ) {
+       eta = -eta;
+       tmp = f; f = g; g = -tmp;
+       tmp = u; u = q; q = -tmp;
+       tmp = v; v = r; r = -tmp;
+      /* находим кратное f, обнуляющее до шести младших бит g */
+       limit = (( int )eta +1 ) > i ? i : (( int )eta +1 );
+       m = (( ak_uint64 )-1 >> ( 64 -limit ))&63U;
+       w = ( f*g*( f*f -2 ))&m;
+     } else {
+       /* находим кратное f, обнуляющее до четырех младших бит g */
+        limit = (( int )eta +1 ) > i ? i : (( int )eta +1 );
+        m = (( ak_uint64 )-1 >> ( 64 -limit ))&15U;
+        w = f +((( f +1 )&4 ) << 1 );
+        w = ( -w*g )&m;
+       }
+     g += f*w;
+     q += u*w;
+     r += v*w;
+  }
+  t->u = (ak_int64)u; t->v = (ak_int64)v;
+  t->q = (ak_int64)q; t->r = (ak_int64)r;
+ return eta;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление обратного вычета бинарным алгоритмом divsteps за время, зависящее от данных.
+
+    Итерации прекращаются, как только g обращается в ноль; при уменьшении значений f и g
+    уменьшается и количество обрабатываемых 62-х битных слов.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_inverse_divsteps_vartime( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  struct mpzn_trans t;
+  ak_int64 eta = -1, cond, fn, gn;
+  ak_int64 f[ak_mpzn_s62_size], g[ak_mpzn_s62_size], d[ak_mpzn_s62_size] = { 0 },
+                                           e[ak_mpzn_s62_size] = { 1 }, m[ak_mpzn_s62_size];
+  size_t j = 0, len = ( size << 6 )/62 +1, flen = len;
+  ak_uint64 pinv = ( (ak_uint64)0 - n0 )&ak_mpzn_m62;
+
+  if( ak_mpzn_cmp_ui( x, size, 0 )) { ak_mpzn_set_ui( z, size, 0 ); return; }
+  ak_mpzn_to_s62( m, p, size, len );
+  ak_mpzn_to_s62( f, p, size, len );
+  ak_mpzn_to_s62( g, x, size, len );
+  while( 1 ) {
+     eta = ak_mpzn_divsteps_62_vartime( eta, (ak_uint64)f[0], (ak_uint64)g[0], &t );
+     ak_mpzn_update_de_62( d, e, &t, m, pinv, len );
+     ak_mpzn_update_fg_62( f, g, &t, flen );
+     if( g[0] == 0 ) {
+       for( cond = 0, j = 1; j < flen; j++ ) cond |= g[j];
+       if( cond == 0 ) break;
+     }
+    /* если старшие слова f и g равны 0 или -1, то уменьшаем длину f и g */
+     fn = f[flen-1];
+     gn = g[flen-1];
+     cond = ( flen > 1 ) ? 0 : 1;
+     cond |= fn^( fn >> 63 );
+     cond |= gn^( gn >> 63 );
+     if( cond == 0 ) {
+       f[flen-2] = (ak_int64)( (ak_uint64)f[flen-2]|( (ak_uint64)fn << 62 ));
+       g[flen-2] = (ak_int64)( (ak_uint64)g[flen-2]|( (ak_uint64)gn << 62 ));
+       --flen;
+     }
+  }
+  ak_mpzn_normalize_s62( z, d, f[flen-1] >> 63, m, size, len );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, вычисляется
+    вычет \f$ z \equiv x^{-1}r \pmod{p}\f$, то есть обратный вычет в представлении Монтгомери.
+    Результат совпадает с результатом функции ak_mpzn_modpow_montgomery(), вызванной
+    для степени \f$ p-2 \f$, и вычисляется значительно быстрее.
+
+    Функция использует алгоритм safegcd Бернштейна-Янга, время работы которого не зависит
+    от значения \f$ x \f$; функция предназначена для обращения секретных значений.
+    При отсутствии поддержки 128-ми битных целых чисел используется возведение в степень \f$ p-2 \f$.
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет, удовлетворяющий неравенству \f$ 0 \leq x < p\f$;
+    для \f$ x = 0 \f$ результат равен нулю
+    @param p Простой модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в арифметике Монтгомери по модулю p
+    @param r2 Величина \f$ r^2 \pmod{p}\f$
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_montgomery( ak_uint64 *z, ak_uint64 *x,
+                                    ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+#ifdef AK_HAVE_UINT128
+ /* (xr)^{-1} = x^{-1}r^{-1}, два умножения на r^2 дают x^{-1}r */
+  ak_mpzn_inverse_safegcd( z, x, p, n0, size );
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );
+#else
+  ak_mpznmax u;
+
+  (void)r2;
+  ak_mpzn_set_ui( u, size, 2 );
+  ak_mpzn_sub( u, p, u, size );
+  ak_mpzn_modpow_montgomery( z, x, u, p, n0, size );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет обратный вычет в представлении Монтгомери, аналогично функции
+    ak_mpzn_inverse_montgomery(), с помощью бинарного расширенного алгоритма Евклида.
+    Время работы функции зависит от значения \f$ x \f$, поэтому функция должна применяться
+    только к открытым данным (например, при проверке электронной подписи).
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет, удовлетворяющий неравенству \f$ 0 \leq x < p\f$;
+    для \f$ x = 0 \f$ результат равен нулю
+    @param p Простой модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в арифметике Монтгомери по модулю p
+    @param r2 Величина \f$ r^2 \pmod{p}\f$
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_montgomery_vartime( ak_uint64 *z, ak_uint64 *x,
+                                    ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+#ifdef AK_HAVE_UINT128
+  ak_mpzn_inverse_divsteps_vartime( z, x, p, n0, size );
+#else
+  ak_mpzn_inverse_binary( z, x, p, n0, size );
+#endif
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /* преобразование "туда и обратно" */
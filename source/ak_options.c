@@ -4,12 +4,15 @@
 /*  Файл ak_options.с                                                                              */
 /*  - содержит реализацию функций для работы с опциями библиотеки                                  */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_ERRNO_H
  #include <errno.h>
 #endif
+#ifdef AK_HAVE_UNISTD_H
+ #include <unistd.h>
+#endif
 #ifdef AK_HAVE_SYSSTAT_H
  #include <sys/stat.h>
 #endif
@@ -45,6 +48,29 @@
      { "acpkm_message_count", 4096, 128, 65536 },
      { "acpkm_section_magma_block_count", 128, 128, 16777216 },
      { "acpkm_section_kuznechik_block_count", 512, 512, 16777216 },
+  /* количество ключей секций режима ACPKM, вырабатываемых заблаговременно (0 - без опережения) */
+     { "acpkm_lookahead_key_count", 0, 0, 16 },
+
+  /* максимальное количество потоков для параллельной обработки данных
+                                               (0 - определяется количеством доступных процессоров) */
+     { "threads_count", 0, 0, 256 },
+
+  /* файлы, объем которых не менее file_stream_threshold октетов, считываются
+     функциями вычисления хеш-кодов и имитовставок способом, заданным опцией file_stream_method:
+     0 - последовательное чтение, 1 - чтение с опережением во вспомогательном потоке,
+     2 - отображение в память, 3 - асинхронное чтение с использованием io_uring */
+     { "file_stream_method", 1, 0, 3 },
+     { "file_stream_threshold", 1048576, 0, 2147483648 },
+     { "file_stream_buffer_size", 1048576, 65536, 67108864 },
+
+  /* максимальный уровень реализации вычислительных ядер: 0 - переносимая реализация,
+     1 - команда pclmulqdq, 2 - расширения avx2, bmi2 и adx (при наличии у процессора) */
+     { "cpu_dispatch_level", 2, 0, 2 },
+  /* флаг использования специализированных реализаций операций Монтгомери
+                                                    для 256-ти и 512-ти битных модулей */
+     { "use_fixed_size_montgomery", 1, 0, 1 },
+  /* флаг использования искривленной формы Эдвардса для кривых, допускающих такое представление */
+     { "use_twisted_edwards", 1, 0, 1 },
 
   /* при значении равным единицы, формат шифрования данных соответствует варианту OpenSSL */
      { "openssl_compability", 0, 0, 1 },
@@ -101,6 +127,57 @@
  return result;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция определяет количество потоков, которые могут быть использованы функциями библиотеки
+    для параллельной обработки данных. Значение определяется опцией `threads_count`;
+    если опция равна нулю, то используется количество доступных процессоров.
+
+    \return Количество потоков (не менее единицы). Если библиотека собрана без поддержки
+    потоков, то функция всегда возвращает единицу.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_libakrypt_get_threads_count( void )
+{
+#ifdef AK_HAVE_PTHREAD_H
+  ak_int64 count = ak_libakrypt_get_option_by_name( "threads_count" );
+
+  if( count > 0 ) return ( size_t )count;
+ #if defined( AK_HAVE_UNISTD_H ) && defined( _SC_NPROCESSORS_ONLN )
+  if(( count = ( ak_int64 )sysconf( _SC_NPROCESSORS_ONLN )) > 0 )
+    return ( size_t )ak_min( count, 256 );
+ #endif
+#endif
+ return 1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для файлов (фрагментов файлов), объем которых меньше значения опции `file_stream_threshold`,
+    выбирается последовательное чтение блоками, длина которых определяется файловой системой.
+    Для данных большего объема способ чтения и размер буффера определяются опциями
+    `file_stream_method` и `file_stream_buffer_size`.
+
+    @param file Контекст файла, открытого на чтение.
+    @param size Объем обрабатываемых данных (в октетах).
+    @param granule Длина блока алгоритма, обрабатывающего данные; размер буффера
+    выбирается кратным данной величине.
+    @param block_size Указатель на переменную, в которую помещается размер буффера.
+    \return Способ считывания данных.                                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ file_stream_t ak_libakrypt_get_file_stream_method( ak_file file, const ak_int64 size,
+                                                          const size_t granule, size_t *block_size )
+{
+  file_stream_t method = file_stream_read;
+  size_t bsize = ak_max(( size_t )file->blksize, granule );
+
+  if( size >= ak_libakrypt_get_option_by_name( "file_stream_threshold" )) {
+    method = ( file_stream_t ) ak_libakrypt_get_option_by_name( "file_stream_method" );
+    bsize = ( size_t ) ak_libakrypt_get_option_by_name( "file_stream_buffer_size" );
+  }
+  if( granule > 1 ) bsize -= bsize%granule;
+  *block_size = ak_max( bsize, granule );
+
+ return method;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param index Индекс опции, должен быть от нуля до значения,
     возвращаемого функцией ak_libakrypt_options_count().
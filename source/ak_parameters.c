@@ -68,6 +68,25 @@
   id_tc26_gost_3410_2012_256_paramSetA_curve
 };
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры кривой paramSetA в искривленной форме Эдвардса
+    из рекомендаций Р 1323565.1.024-2019. */
+/*! \code
+      e = "1",
+      d = "0605F6B7C183FA81578BC39CFAD518132B9DF62897009AF7E522C32D6DC7BFFB",
+      s = "7E7E82520F9F015FAA1D0F18C14AB9FB35188275DA3FD94206B74F34A48E0ECD",
+      t = "0100FE73F595FF158E974B44D478D9588744FE5C192AC47EA63075DCE7A14AAA",
+     pu = "D",
+     pv = "60CA1E32AA475B348488C38FAB07649CE7EF8DBE87F22E81F92B2592DBA300E7"
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ const struct ecurve id_tc26_gost_3410_2012_256_paramSetA_edwards = {
+  ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+  { 0x40c8687d966dd5b1LL, 0x1fb647d3f0757f77LL, 0xffda75588b970634LL, 0x845fa0e16716c1bbLL }, /* d */
+  { 0x2fcde5e09a6488c5LL, 0xf8126e0b03e2a022LL, 0x000962a9dd1a3e72LL, 0xdee817c7a63a4f91LL }, /* s */
+  { 0x8acc116a43bcf88cLL, 0x05490bf8a813953eLL, 0xaaa468e41743d65eLL, 0x6b65457ae683caf4LL }  /* t */
+};
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Параметры 256-ти битной эллиптической кривой, определяемые RFC-4357, set A (вариант КриптоПро). */
 /*! \code
@@ -325,6 +344,25 @@
   id_tc26_gost_3410_2012_512_paramSetC_curve
  };
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры кривой paramSetC в искривленной форме Эдвардса
+    из рекомендаций Р 1323565.1.024-2019. */
+/*! \code
+      e = "1",
+      d = "9E4F5D8C017D8D9F13A5CF3CDF5BFE4DAB402D54198E31EBDE28A0621050439CA6B39E0A515C06B304E2CE43E79E369E91A0CFC2BC2A22B4CA302DBB33EE7550",
+      s = "186C289CFFA09C983B168C30C829006C952FF4AAF99C73850875D7E77BEBEF18D653187D6BA8FE533EC74C6F061872585B97CC0F50F57752CD73F4913304621E",
+      t = "9A628F975594ECEFD89BA28A2539FFB79C8AB238AEED0851FA5C1ABB02B80B44C6734501B83A011DD625CD0B5145091A6D9ACD4B1F5C5B1E21B2B249DDFD1271",
+     pu = "12",
+     pv = "469AF79D1FB1F5E16B99592B77A01E2A0FDFB0D01794368D9A56117F7B38669522DD4B650CF789EEBF068C5D139732F0905622C04B2BAAE7600303EE73001A3D"
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ const struct ecurve id_tc26_gost_3410_2012_512_paramSetC_edwards = {
+  ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetC,
+  { 0x6515a5166d05caf7, 0xae6dc7d439a723d5, 0xdc1c74edcea76671, 0x853a44eed58ae3e5, 0xc84c79f64266472e, 0xa1a4bfeccd0cf540, 0xab899e4c73783aa1, 0xde66ec2f500fc692 }, /* d */
+  { 0xa6ba96ba64be8cb4, 0x94648e0af196370a, 0x88f8e2c48c562663, 0x5eb16ec44a9d4706, 0xcdece1826f666e34, 0x9796d004ccbcc2af, 0x551d986ce321f157, 0x486644f42bfc0e5b }, /* s */
+  { 0xe62e462e6780f788, 0x9d124bf8b44685f8, 0xfa04be27a2713bbd, 0x163460d278ec7b50, 0x76b769a90b110bdd, 0xf0461ffcccd77e35, 0x71ec450cbde95f1a, 0x2511275d3802a118 }  /* t */
+ };
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                ak_parameters.c  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -19,6 +19,9 @@
 #ifdef AK_HAVE_STDLIB_H
  #include <stdlib.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Инициализация генератора псевдо-случайных чисел.
@@ -163,6 +166,11 @@
 
 /* ----------------------------------------------------------------------------------------------- */
   static ak_uint64 shift_value = 0; // Внутренняя статическая переменная (счетчик вызовов)
+#ifdef AK_HAVE_PTHREAD_H
+ /* счетчик изменяется под блокировкой, чтобы потоки, одновременно создающие генераторы,
+    получали различные начальные значения */
+  static pthread_mutex_t shift_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция использует для генерации случайного значения текущее время, номер процесса и
@@ -193,7 +201,14 @@
   clk = ( ak_uint64 ) clock();
 #endif
 
-  value = ( shift_value += 11 )*125643267795740073ULL + pval;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &shift_mutex );
+  value = ( shift_value += 11 );
+  pthread_mutex_unlock( &shift_mutex );
+#else
+  value = ( shift_value += 11 );
+#endif
+  value = value*125643267795740073ULL + pval;
   value = ( value * 506098983240188723ULL ) + 71331*uval + vtme;
  return value ^ clk;
 }
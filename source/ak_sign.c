@@ -9,6 +9,18 @@
 #ifdef AK_HAVE_TIME_H
  #include <time.h>
 #endif
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
+ #include <stdint.h>
+#ifdef AK_HAVE_UNISTD_H
+ #include <unistd.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Установление или изменение маски секретного ключа ассиметричного криптографического
@@ -37,7 +49,7 @@
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpznmax u, zeta;
+  ak_mpznmax zeta;
   ak_wcurve wc = NULL;
   int error = ak_error_ok;
   ak_uint64 *key = NULL, *mask = NULL;
@@ -80,10 +92,7 @@
      ak_mpzn_mul_montgomery( key, key, mask, wc->q, wc->nq, wc->size);
 
     /* вычисляем обратное значение для маски */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( mask, // m <- m^{q-2} (mod q)
-                                    mask, u, wc->q, wc->nq, wc->size );
+     ak_mpzn_inverse_montgomery( mask, mask, wc->q, wc->nq, wc->r2q, wc->size ); // m <- m^{-1} (mod q)
     /* меняем значение флага */
      skey->flags |= key_flag_set_mask;
 
@@ -100,9 +109,7 @@
     /* домножаем ключ на случайное число */
      ak_mpzn_mul_montgomery( key, key, zeta, wc->q, wc->nq, wc->size );
     /* вычисляем обратное значение zeta */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( zeta, zeta, u, wc->q, wc->nq, wc->size ); // z <- z^{q-2} (mod q)
+     ak_mpzn_inverse_montgomery( zeta, zeta, wc->q, wc->nq, wc->r2q, wc->size ); // z <- z^{-1} (mod q)
 
     /* домножаем маску на обратное значение zeta */
      ak_mpzn_mul_montgomery( mask, mask, zeta, wc->q, wc->nq, wc->size );
@@ -329,6 +336,7 @@
 /*! @param sctx Контекст секретного ключа электронной подписи (асимметричного алгоритма).
     @param wc Контекст параметров эллиптической кривой. Контекст однозначно связывает
     секретный ключ с эллиптической кривой, на которой происходят вычисления.
+    При смене кривой пул вычисленных заранее пар \f$ (k, r) \f$ уничтожается.
 
     @return Функция возвращает ноль (\ref ak_error_ok) в случае успешной инициализации контекста.
     В случае возникновения ошибки возвращается ее код.                                             */
@@ -343,7 +351,9 @@
     return ak_error_message_fmt( ak_error_curve_not_supported, __func__ ,
                               "%u bits elliptic curve is not applicable for algorithm %s",
                                                            wc->size << 6, sctx->key.oid->name[0] );
-    else sctx->key.data = wc;
+ /* пары (k, r) из пула вычислены для прежней кривой */
+  if( sctx->key.data != wc ) ak_signkey_destroy_pool( sctx );
+  sctx->key.data = wc;
  return ak_error_ok;
 }
 
@@ -351,6 +361,7 @@
 /*! @param sctx Контекст секретного ключа электронной подписи (асимметричного алгоритма).
     @param string Строка, определяющая набор параметров эллиптической кривой. Контекст однозначно
     связывает секретный ключ с эллиптической кривой, на которой происходят вычисления.
+    При смене кривой пул вычисленных заранее пар \f$ (k, r) \f$ уничтожается.
 
     @return Функция возвращает ноль (\ref ak_error_ok) в случае успешной инициализации контекста.
     В случае возникновения ошибки возвращается ее код.                                             */
@@ -368,7 +379,9 @@
     return ak_error_message_fmt( ak_error_curve_not_supported, __func__ ,
                               "%u bits elliptic curve is not applicable for algorithm %s",
                                                            wc->size << 6, sctx->key.oid->name[0] );
-   else sctx->key.data = wc;
+ /* пары (k, r) из пула вычислены для прежней кривой */
+  if( sctx->key.data != wc ) ak_signkey_destroy_pool( sctx );
+  sctx->key.data = wc;
  return ak_error_ok;
 }
 
@@ -407,6 +420,7 @@
   int error = ak_error_ok;
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                            "destroying a null pointer to digital signature secret key context" );
+  ak_signkey_destroy_pool( sctx );
   if(( error = ak_skey_destroy( &sctx->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "incorrect destroying of digital signature secret key" );
   if(( error = ak_hash_destroy( &sctx->ctx )) != ak_error_ok )
@@ -552,6 +566,476 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление второй половины подписи \f$ s \equiv rd + ke \pmod{q}\f$ и экспорт подписи.
+
+    @param sctx Контекст секретного ключа.
+    @param r Первая половина подписи \f$ r \f$ (в естественном представлении).
+    @param k Вычет \f$ k \f$ в представлении Монтгомери; если маска `kmask` определена,
+    то вычет \f$ km \pmod{q} \f$, где \f$ m \f$ маска.
+    @param kmask Обратный вычет к маске \f$ m^{-1} \pmod{q} \f$ в представлении Монтгомери
+    или NULL.
+    @param e Целое число, соотвествующее хеш-коду подписываемого сообщения.
+    @param out Массив, куда помещается результат.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_sign_values( ak_signkey sctx, ak_uint64 *r,
+                                     ak_uint64 *k, ak_uint64 *kmask, ak_uint64 *e, ak_pointer out )
+{
+  ak_mpzn512 s, u, v;
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+
+ /* приводим r к виду Монтгомери и помещаем во временную переменную u <- r */
+  ak_mpzn_mul_montgomery( u, r, wc->r2q, wc->q, wc->nq, wc->size );
+
+ /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску) */
+  ak_mpzn_mul_montgomery( s, u, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
+  ak_mpzn_mul_montgomery( s, s,
+              (ak_uint64 *)(sctx->key.key+sctx->key.key_size), wc->q, wc->nq, wc->size );
+
+ /* приводим e к виду Монтгомери и помещаем во временную переменную v <- e */
+  ak_mpzn_rem( v, e, wc->q, wc->size );
+  if( ak_mpzn_cmp_ui( v, wc->size, 0 )) ak_mpzn_set_ui( v, wc->size, 1 );
+  ak_mpzn_mul_montgomery( v, v, wc->r2q, wc->q, wc->nq, wc->size );
+
+ /* вычисляем k*e (mod q) и вычисляем s = r*d + k*e (mod q) (в форме Монтгомери) */
+  ak_mpzn_mul_montgomery( u, k, v, wc->q, wc->nq, wc->size ); /* u <- k*e */
+  if( kmask != NULL ) ak_mpzn_mul_montgomery( u, u, kmask, wc->q, wc->nq, wc->size );
+  ak_mpzn_add_montgomery( s, s, u, wc->q, wc->size );
+
+ /* приводим s к обычной форме */
+  ak_mpzn_mul_montgomery( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
+                                 wc->q, wc->nq, wc->size );
+ /* экспортируем результат */
+  ak_mpzn_to_little_endian( s, wc->size, out, sizeof(ak_uint64)*wc->size, ak_true );
+  ak_mpzn_to_little_endian( r, wc->size, (ak_uint64 *)out + wc->size,
+                                                             sizeof(ak_uint64)*wc->size, ak_true );
+ /* завершаемся */
+  sctx->key.set_mask( &sctx->key );
+  memset( s, 0, sizeof( ak_mpzn512 ));
+  memset( u, 0, sizeof( ak_mpzn512 ));
+  memset( v, 0, sizeof( ak_mpzn512 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                 пул вычисленных заранее пар (k, r) для выработки электронной подписи            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул вычисленных заранее пар \f$ (k, r) \f$, где \f$ r \equiv x([k]P) \pmod{q} \f$.
+
+    Каждый элемент пула содержит три вычета: значение \f$ km \pmod{q}\f$, обратный вычет к маске
+    \f$ m^{-1} \pmod{q} \f$ (оба вычета в представлении Монтгомери) и значение \f$ r \f$.
+    Так же, как и секретный ключ, вычет \f$ k \f$ никогда не хранится в памяти в открытом виде;
+    маска \f$ m \f$ вырабатывается независимо для каждого элемента.
+
+    Пул хранит номер создавшего его процесса: после вызова `fork()` дочерний процесс получает
+    копию пула, и повторное использование пар родительским и дочерним процессами привело бы
+    к раскрытию секретного ключа. Поэтому при обращении к пулу из другого процесса
+    все элементы пула уничтожаются.                                                                */
+ typedef struct signkey_pool {
+  /*! \brief Эллиптическая кривая, для которой вычислены пары. */
+   ak_wcurve wc;
+  /*! \brief Массив элементов пула. */
+   ak_uint64 *data;
+  /*! \brief Максимальное количество элементов пула. */
+   size_t capacity;
+  /*! \brief Текущее количество элементов пула. */
+   size_t count;
+  /*! \brief Номер процесса, которому принадлежат элементы пула. */
+   ak_uint64 pid;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Мьютекс, защищающий доступ к элементам пула. */
+   pthread_mutex_t mutex;
+  /*! \brief Условная переменная, используемая для пробуждения потока пополнения пула. */
+   pthread_cond_t cond;
+  /*! \brief Дескриптор потока пополнения пула. */
+   pthread_t thread;
+  /*! \brief Флаг того, что поток пополнения пула запущен. */
+   bool_t threaded;
+  /*! \brief Флаг завершения работы потока пополнения пула. */
+   bool_t stop;
+  /*! \brief Количество элементов, при котором поток начинает пополнять пул. */
+   size_t threshold;
+  /*! \brief Генератор, используемый потоком пополнения пула. */
+   ak_random generator;
+#endif
+} *ak_signkey_pool;
+
+/*! \brief Количество 64-х битных слов, занимаемых одним элементом пула. */
+ #define ak_signkey_pool_entry_size( pool )  ( 3*( pool )->wc->size )
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_signkey_pool_lock( ak_signkey_pool pool )
+{
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &pool->mutex );
+#else
+  (void) pool;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_signkey_pool_unlock( ak_signkey_pool pool )
+{
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &pool->mutex );
+#else
+  (void) pool;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает номер текущего процесса. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_signkey_pool_get_pid( void )
+{
+#ifndef _WIN32
+ return ( ak_uint64 ) getpid();
+#else
+ return ( ak_uint64 ) _getpid();
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка того, что пул используется процессом, создавшим его элементы.
+    \details Если пул был унаследован дочерним процессом после вызова `fork()`, то все элементы
+    пула уничтожаются; поток пополнения пула в дочерний процесс не копируется, поэтому
+    пул считается пулом без потока пополнения. Функция вызывается при заблокированном пуле.
+
+    @param pool Контекст пула.
+    @param generator Генератор, используемый для уничтожения элементов пула.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_pool_check_pid( ak_signkey_pool pool, ak_random generator )
+{
+  ak_uint64 pid = ak_signkey_pool_get_pid();
+
+  if( pool->pid == pid ) return;
+  ak_ptr_wipe( pool->data,
+        pool->capacity*ak_signkey_pool_entry_size( pool )*sizeof( ak_uint64 ), generator );
+  pool->count = 0;
+  pool->pid = pid;
+#ifdef AK_HAVE_PTHREAD_H
+  pool->threaded = ak_false;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет один элемент пула.
+    \details Вычисления выполняются без блокировки пула.
+
+    @param wc Эллиптическая кривая.
+    @param generator Генератор, используемый для выработки вычета \f$ k \f$ и маски.
+    @param entry Память для элемента пула (3 вычета).
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_pool_entry_new( ak_wcurve wc, ak_random generator, ak_uint64 *entry )
+{
+  ak_mpzn512 k, m;
+  struct wpoint wr;
+  int error = ak_error_ok;
+  ak_uint64 *km = entry, *minv = entry +wc->size, *r = entry +2*wc->size;
+
+  if(( error = ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "invalid generation of random value");
+  if(( error = ak_mpzn_set_random_modulo( m, wc->q, wc->size, generator )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "invalid generation of random mask");
+    goto labex;
+  }
+  if( ak_mpzn_cmp_ui( m, wc->size, 0 )) ak_mpzn_set_ui( m, wc->size, 1 );
+
+ /* вычисляем r */
+  ak_wpoint_pow_base( &wr, k, wc->size, wc );
+  ak_wpoint_reduce( &wr, wc );
+  ak_mpzn_rem( r, wr.x, wc->q, wc->size );
+
+ /* маскируем k: случайное число m сразу считаем записанным в представлении Монтгомери */
+  ak_mpzn_mul_montgomery( km, k, wc->r2q, wc->q, wc->nq, wc->size );
+  ak_mpzn_mul_montgomery( km, km, m, wc->q, wc->nq, wc->size );
+  ak_mpzn_inverse_montgomery( minv, m, wc->q, wc->nq, wc->r2q, wc->size );
+
+  labex:
+   memset( &wr, 0, sizeof( struct wpoint ));
+   ak_ptr_wipe( k, sizeof( k ), generator );
+   ak_ptr_wipe( m, sizeof( m ), generator );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Добавление элемента в пул; если пул заполнен, элемент уничтожается.
+    \return Функция возвращает \ref ak_true, если элемент добавлен в пул.                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_pool_push( ak_signkey_pool pool, ak_uint64 *entry, ak_random generator )
+{
+  bool_t result = ak_false;
+  size_t words = ak_signkey_pool_entry_size( pool );
+
+  ak_signkey_pool_lock( pool );
+  ak_signkey_pool_check_pid( pool, generator );
+  if( pool->count < pool->capacity ) {
+    memcpy( pool->data +pool->count*words, entry, words*sizeof( ak_uint64 ));
+    pool->count++;
+    result = ak_true;
+  }
+  ak_signkey_pool_unlock( pool );
+  ak_ptr_wipe( entry, words*sizeof( ak_uint64 ), generator );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Извлечение элемента из пула; извлеченный элемент удаляется из пула.
+    \return Функция возвращает \ref ak_true, если пул не пуст.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_pool_pop( ak_signkey_pool pool, ak_uint64 *entry, ak_random generator )
+{
+  bool_t result = ak_false;
+  size_t words = ak_signkey_pool_entry_size( pool );
+
+  ak_signkey_pool_lock( pool );
+  ak_signkey_pool_check_pid( pool, generator );
+  if( pool->count > 0 ) {
+    pool->count--;
+    memcpy( entry, pool->data +pool->count*words, words*sizeof( ak_uint64 ));
+    ak_ptr_wipe( pool->data +pool->count*words, words*sizeof( ak_uint64 ), generator );
+    result = ak_true;
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  if( pool->threaded && ( pool->count < pool->threshold )) pthread_cond_signal( &pool->cond );
+#endif
+  ak_signkey_pool_unlock( pool );
+ return result;
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, пополняющего пул.
+    \details Когда количество элементов пула становится меньше порогового значения,
+    поток вычисляет новые элементы до тех пор, пока пул не будет заполнен полностью.
+    После этого поток ожидает сигнала от функции, извлекающей элементы из пула.                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_signkey_pool_thread( void *ptr )
+{
+  bool_t filling = ak_false;
+  ak_signkey_pool pool = ptr;
+  ak_uint64 entry[3*ak_mpzn512_size];
+
+  pthread_mutex_lock( &pool->mutex );
+  while( !pool->stop ) {
+    if(( pool->count >= pool->capacity ) || ( !filling && ( pool->count >= pool->threshold ))) {
+      filling = ak_false;
+      pthread_cond_wait( &pool->cond, &pool->mutex );
+      continue;
+    }
+    filling = ak_true;
+    pthread_mutex_unlock( &pool->mutex );
+    if( ak_signkey_pool_entry_new( pool->wc, pool->generator, entry ) != ak_error_ok ) {
+      ak_error_message( ak_error_get_value(), __func__, "refill thread is stopped" );
+      return NULL;
+    }
+    ak_signkey_pool_push( pool, entry, pool->generator );
+    pthread_mutex_lock( &pool->mutex );
+  }
+  pthread_mutex_unlock( &pool->mutex );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает пул, содержащий вычисленные заранее пары \f$ (k, r) \f$, где
+    \f$ k \f$ случайный вычет по модулю \f$ q \f$ и \f$ r \equiv x([k]P) \pmod{q} \f$.
+    Если пул не пуст, функции ak_signkey_sign_hash(), ak_signkey_sign_ptr() и другие
+    вместо выработки случайного вычета и вычисления кратной точки извлекают из пула одну пару;
+    извлеченная пара удаляется из пула и больше не используется. В этом случае выработка
+    подписи требует лишь нескольких умножений по модулю \f$ q \f$.
+    Если пул пуст, подпись вырабатывается обычным образом.
+
+    Созданный пул не содержит элементов; пул заполняется функцией ak_signkey_fill_pool()
+    или потоком, запускаемым функцией ak_signkey_start_pool_refill().
+    Пул уничтожается при уничтожении контекста секретного ключа.
+
+    \b Внимание! Две подписи, выработанные с одним и тем же значением \f$ k \f$, позволяют
+    вычислить секретный ключ. Дочерний процесс, созданный вызовом `fork()`, получает копию пула,
+    поэтому при первом обращении к пулу из процесса, отличного от создавшего пул, все
+    содержащиеся в нем пары уничтожаются, а поток пополнения пула считается остановленным
+    (при необходимости, его следует запустить в дочернем процессе заново).
+    Вызов `fork()` во время работы потока пополнения пула не допускается.
+
+    @param sctx Контекст секретного ключа электронной подписи.
+    @param capacity Максимальное количество пар в пуле.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_create_pool( ak_signkey sctx, const size_t capacity )
+{
+  ak_wcurve wc = NULL;
+  ak_signkey_pool pool = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+  if(( wc = ( ak_wcurve ) sctx->key.data ) == NULL )
+    return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                 "using internal null pointer to elliptic curve" );
+  if( capacity == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                "using pool with zero capacity" );
+  if( sctx->pool != NULL ) ak_signkey_destroy_pool( sctx );
+
+  if(( pool = calloc( 1, sizeof( struct signkey_pool ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                      "incorrect memory allocation for pool" );
+  pool->wc = wc;
+  pool->capacity = capacity;
+  pool->pid = ak_signkey_pool_get_pid();
+  if(( pool->data = calloc( capacity, 3*wc->size*sizeof( ak_uint64 ))) == NULL ) {
+    free( pool );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                             "incorrect memory allocation for pool elements" );
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_init( &pool->mutex, NULL );
+  pthread_cond_init( &pool->cond, NULL );
+#endif
+  sctx->pool = pool;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция останавливает поток пополнения пула (если он был запущен), уничтожает
+    все содержащиеся в пуле пары и освобождает память.
+
+    @param sctx Контекст секретного ключа электронной подписи.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_destroy_pool( ak_signkey sctx )
+{
+  ak_signkey_pool pool = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+  if(( pool = sctx->pool ) == NULL ) return ak_error_ok;
+
+#ifdef AK_HAVE_PTHREAD_H
+ /* поток пополнения пула, запущенный родительским процессом, в дочернем процессе отсутствует */
+  ak_signkey_pool_lock( pool );
+  ak_signkey_pool_check_pid( pool, &sctx->key.generator );
+  ak_signkey_pool_unlock( pool );
+  if( pool->threaded ) {
+    pthread_mutex_lock( &pool->mutex );
+    pool->stop = ak_true;
+    pthread_cond_signal( &pool->cond );
+    pthread_mutex_unlock( &pool->mutex );
+    pthread_join( pool->thread, NULL );
+  }
+  pthread_cond_destroy( &pool->cond );
+  pthread_mutex_destroy( &pool->mutex );
+#endif
+  ak_ptr_wipe( pool->data, pool->capacity*ak_signkey_pool_entry_size( pool )*sizeof( ak_uint64 ),
+                                                                          &sctx->key.generator );
+  free( pool->data );
+  free( pool );
+  sctx->pool = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет пары \f$ (k, r) \f$ и добавляет их в пул до тех пор, пока не будет
+    добавлено заданное количество пар или пул не будет заполнен. Функция может вызываться
+    одновременно с выработкой подписей и с работой потока пополнения пула.
+
+    @param sctx Контекст секретного ключа электронной подписи.
+    @param generator Генератор случайных чисел, используемый для выработки вычетов \f$ k\f$.
+    @param count Количество добавляемых пар; если значение равно нулю,
+    то пул заполняется полностью.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_fill_pool( ak_signkey sctx, ak_random generator, const size_t count )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+  ak_signkey_pool pool = NULL;
+  ak_uint64 entry[3*ak_mpzn512_size];
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                "using null pointer to random number generator" );
+  if(( pool = sctx->pool ) == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                             "using secret key without pool" );
+  for( i = 0; ( count == 0 ) || ( i < count ); i++ ) {
+     if( ak_signkey_get_pool_count( sctx ) >= pool->capacity ) break;
+     if(( error = ak_signkey_pool_entry_new( pool->wc, generator, entry )) != ak_error_ok )
+       return ak_error_message( error, __func__ , "incorrect generation of pool element" );
+     if( !ak_signkey_pool_push( pool, entry, generator )) break;
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция запускает поток, который пополняет пул всякий раз, когда количество пар в пуле
+    становится меньше заданного порогового значения; при этом пул заполняется полностью.
+    Поток завершается при уничтожении пула или контекста секретного ключа.
+
+    \note Генератор случайных чисел используется потоком вплоть до его завершения, поэтому
+    он не должен использоваться другими потоками и должен существовать до уничтожения пула.
+
+    @param sctx Контекст секретного ключа электронной подписи.
+    @param generator Генератор случайных чисел, используемый для выработки вычетов \f$ k\f$.
+    @param threshold Пороговое значение количества пар; если значение равно нулю или превышает
+    размер пула, то используется размер пула.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_start_pool_refill( ak_signkey sctx, ak_random generator, const size_t threshold )
+{
+  ak_signkey_pool pool = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                "using null pointer to random number generator" );
+  if(( pool = sctx->pool ) == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                             "using secret key without pool" );
+#ifdef AK_HAVE_PTHREAD_H
+  ak_signkey_pool_lock( pool );
+  ak_signkey_pool_check_pid( pool, &sctx->key.generator );
+  ak_signkey_pool_unlock( pool );
+  if( pool->threaded ) return ak_error_message( ak_error_wrong_option, __func__ ,
+                                                       "refill thread is already started" );
+  pool->generator = generator;
+  pool->threshold = (( threshold == 0 ) || ( threshold > pool->capacity )) ?
+                                                                      pool->capacity : threshold;
+  pool->stop = ak_false;
+  if( pthread_create( &pool->thread, NULL, ak_signkey_pool_thread, pool ) != 0 )
+    return ak_error_message( ak_error_undefined_function, __func__,
+                                                                "wrong creation of a thread" );
+  pool->threaded = ak_true;
+ return ak_error_ok;
+#else
+  (void) threshold;
+ return ak_error_message( ak_error_undefined_function, __func__,
+                                          "library was compiled without support of threads" );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param sctx Контекст секретного ключа электронной подписи.
+    @return Функция возвращает количество пар, содержащихся в пуле, или ноль,
+    если пул не создан.                                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_signkey_get_pool_count( ak_signkey sctx )
+{
+  size_t count = 0;
+
+  if(( sctx == NULL ) || ( sctx->pool == NULL )) return 0;
+  ak_signkey_pool_lock( sctx->pool );
+  ak_signkey_pool_check_pid( sctx->pool, &sctx->key.generator );
+  count = sctx->pool->count;
+  ak_signkey_pool_unlock( sctx->pool );
+ return count;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вырабатывает электронную подпись для \f$ e \f$ - вычисленного хеш-кода подписываемого
     сообщения и заданного случайного числа \f$ k \f$. Для этого
@@ -588,48 +1072,23 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_signkey_sign_const_values( ak_signkey sctx, ak_uint64 *k, ak_uint64 *e, ak_pointer out )
 {
-  ak_mpzn512 r, s;
+  ak_mpzn512 r, km;
   struct wpoint wr;
   ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
 
  /* поскольку функция не экспортируется, мы оставляем все проверки функциям верхнего уровня */
  /* вычисляем r */
-  ak_wpoint_pow( &wr, &wc->point, k, wc->size, wc );
+  ak_wpoint_pow_base( &wr, k, wc->size, wc );
   ak_wpoint_reduce( &wr, wc );
   ak_mpzn_rem( r, wr.x, wc->q, wc->size );
 
- /* приводим r к виду Монтгомери и помещаем во временную переменную wr.x <- r */
-  ak_mpzn_mul_montgomery( wr.x, r, wc->r2q, wc->q, wc->nq, wc->size );
+ /* приводим k к виду Монтгомери и вычисляем s */
+  ak_mpzn_mul_montgomery( km, k, wc->r2q, wc->q, wc->nq, wc->size );
+  ak_signkey_sign_values( sctx, r, km, NULL, e, out );
 
- /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску) */
-  ak_mpzn_mul_montgomery( s, wr.x, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
-  ak_mpzn_mul_montgomery( s, s,
-              (ak_uint64 *)(sctx->key.key+sctx->key.key_size), wc->q, wc->nq, wc->size );
-
- /* приводим k к виду Монтгомери и помещаем во временную переменную wr.y <- k */
-  ak_mpzn_mul_montgomery( wr.y, k, wc->r2q, wc->q, wc->nq, wc->size );
-
- /* приводим e к виду Монтгомери и помещаем во временную переменную wr.z <- e */
-  ak_mpzn_rem( wr.z, e, wc->q, wc->size );
-  if( ak_mpzn_cmp_ui( wr.z, wc->size, 0 )) ak_mpzn_set_ui( wr.z, wc->size, 1 );
-  ak_mpzn_mul_montgomery( wr.z, wr.z, wc->r2q, wc->q, wc->nq, wc->size );
-
- /* вычисляем k*e (mod q) и вычисляем s = r*d + k*e (mod q) (в форме Монтгомери) */
-  ak_mpzn_mul_montgomery( wr.y, wr.y, wr.z, wc->q, wc->nq, wc->size ); /* wr.y <- k*e */
-  ak_mpzn_add_montgomery( s, s, wr.y, wc->q, wc->size );
-
- /* приводим s к обычной форме */
-  ak_mpzn_mul_montgomery( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
-                                 wc->q, wc->nq, wc->size );
- /* экспортируем результат */
-  ak_mpzn_to_little_endian( s, wc->size, out, sizeof(ak_uint64)*wc->size, ak_true );
-  ak_mpzn_to_little_endian( r, wc->size, (ak_uint64 *)out + wc->size,
-                                                             sizeof(ak_uint64)*wc->size, ak_true );
- /* завершаемся */
   memset( &wr, 0, sizeof( struct wpoint ));
-  sctx->key.set_mask( &sctx->key );
   memset( r, 0, sizeof( ak_mpzn512 ));
-  memset( s, 0, sizeof( ak_mpzn512 ));
+  memset( km, 0, sizeof( ak_mpzn512 ));
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -642,6 +1101,9 @@
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
     @param out_size Размер выделенной под выработанную ЭП памяти.
 
+    \note Если для ключа создан непустой пул пар \f$ (k, r) \f$ (см. ak_signkey_create_pool()),
+    то случайное число не вырабатывается, а используется одна из пар пула.
+
     @return Функция возвращает NULL, если указатель out не есть NULL, в противном случае
     возвращается указатель на буффер, содержащий вектор с электронной подписью. В случае
     возникновения ошибки возвращается NULL, при этом код ошибки может быть получен с помощью
@@ -656,6 +1118,7 @@
   size_t lb = 0;
   ak_mpzn512 k, h;
   int error = ak_error_ok;
+  ak_uint64 entry[3*ak_mpzn512_size];
 
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using null pointer to secret key context" );
@@ -669,18 +1132,27 @@
   if( out_size < 2*lb ) return ak_error_message( ak_error_wrong_length, __func__,
                                                        "using small buffer for digital sigature" );
 
- /* вырабатываем случайное число */
-  memset( k, 0, sizeof( ak_uint64 )*ak_mpzn512_size );
-  if(( error = ak_mpzn_set_random_modulo( k, (( ak_wcurve )sctx->key.data)->q,
-                                (( ak_wcurve )sctx->key.data)->size, generator )) != ak_error_ok )
-    return ak_error_message( error, __func__ , "invalid generation of random value");
-
  /* превращаем хеш от сообщения в последовательность 64х битных слов  */
   memcpy( h, hash, sctx->ctx.data.sctx.hsize );
 #ifndef AK_LITTLE_ENDIAN
   for( i = 0; i < (( ak_wcurve )sctx->key.data)->size; i++ ) h[i] = bswap_64( h[i] );
 #endif
 
+ /* если пул вычислен для текущей кривой и не пуст, то используем заранее вычисленную пару */
+  if(( sctx->pool != NULL ) && ( sctx->pool->wc == ( ak_wcurve )sctx->key.data ) &&
+                                  ak_signkey_pool_pop( sctx->pool, entry, &sctx->key.generator )) {
+    size_t size = (( ak_wcurve )sctx->key.data)->size;
+    ak_signkey_sign_values( sctx, entry +2*size, entry, entry +size, h, out );
+    ak_ptr_wipe( entry, sizeof( entry ), &sctx->key.generator );
+    return ak_error_ok;
+  }
+
+ /* вырабатываем случайное число */
+  memset( k, 0, sizeof( ak_uint64 )*ak_mpzn512_size );
+  if(( error = ak_mpzn_set_random_modulo( k, (( ak_wcurve )sctx->key.data)->q,
+                                (( ak_wcurve )sctx->key.data)->size, generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "invalid generation of random value");
+
  /* и только теперь вычисляем электронную подпись */
   ak_signkey_sign_const_values( sctx, k, h, out );
   ak_ptr_wipe( k, sizeof( ak_uint64 )*ak_mpzn512_size, &sctx->key.generator );
@@ -917,7 +1389,7 @@
  /* теперь определяем открытый ключ */
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)sctx->key.key, one,
                                                       pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_wpoint_pow( &pctx->qpoint, &pctx->wc->point, k, pctx->wc->size, pctx->wc );
+  ak_wpoint_pow_base( &pctx->qpoint, k, pctx->wc->size, pctx->wc );
 
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)( sctx->key.key + sctx->key.key_size ),
                                                   one, pctx->wc->q, pctx->wc->nq, pctx->wc->size);
@@ -957,40 +1429,29 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param pctx контекст открытого ключа.
-    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
-    @param hsize размер хеш-кода, в байтах.
+/*! \brief Проверка электронной подписи для вычисленного заранее значения хеш-функции.
+
+    Функция не проверяет входные параметры и использует вычисленные заранее нечетные кратные
+    точки открытого ключа (см. функцию ak_wpoint_set_odd_multiples()). Контекст ключа
+    и массив кратных точек только читаются, поэтому функция может одновременно
+    вызываться из нескольких потоков для одного и того же ключа.
+
+    @param pctx контекст открытого ключа.
+    @param qmultiples массив из \ref ak_wpoint_odd_multiples_count нечетных кратных
+    точки `pctx->qpoint`.
+    @param hash хеш-код сообщения, длина которого совпадает с длиной параметров кривой.
     @param sign электронная подпись, для которой выполняется проверка.
-    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
-    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
-    вызова функции ak_error_get_value().                                                           */
+    @param log флаг вывода в журнал несовпадающих значений.
+    @return Функция возвращает истину, если подпись верна.                                         */
 /* ----------------------------------------------------------------------------------------------- */
- bool_t ak_verifykey_verify_hash( ak_verifykey pctx,
-                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+ static bool_t ak_verifykey_verify_hash_values( ak_verifykey pctx, ak_wpoint qmultiples,
+                                          const ak_pointer hash, ak_pointer sign, bool_t log )
 {
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpzn512 v, z1, z2, u, r, s, h;
-  struct wpoint cpoint, tpoint;
-
-  if( pctx == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__,
-                                               "using a null pointer to secret key context" );
-    return ak_false;
-  }
-  if( hash == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to hash value" );
-    return ak_false;
-  }
-  if( hsize != sizeof( ak_uint64 )*(pctx->wc->size )) {
-    ak_error_message( ak_error_wrong_length, __func__, "using hash value with wrong length" );
-    return ak_false;
-  }
-  if( sign == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to sign value" );
-    return ak_false;
-  }
+  ak_mpzn512 v, z1, z2, r, s, h;
+  struct wpoint cpoint;
 
  /* импортируем подпись */
   ak_mpzn_set_little_endian( s, pctx->wc->size, sign, sizeof(ak_uint64)*pctx->wc->size, ak_true );
@@ -1007,10 +1468,9 @@
   if( ak_mpzn_cmp_ui( v, pctx->wc->size, 0 )) ak_mpzn_set_ui( v, pctx->wc->size, 1 );
   ak_mpzn_mul_montgomery( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
-  /* вычисляем v (в представлении Монтгомери) */
-  ak_mpzn_set_ui( u, pctx->wc->size, 2 );
-  ak_mpzn_sub( u, pctx->wc->q, u, pctx->wc->size );
-  ak_mpzn_modpow_montgomery( v, v, u, pctx->wc->q, pctx->wc->nq, pctx->wc->size ); // v <- v^{q-2} (mod q)
+  /* вычисляем v (в представлении Монтгомери), значение хеш-кода открыто */
+  ak_mpzn_inverse_montgomery_vartime( v, v, pctx->wc->q,
+                                     pctx->wc->nq, pctx->wc->r2q, pctx->wc->size ); // v <- v^{-1} (mod q)
 
   /* вычисляем z1 */
   ak_mpzn_mul_montgomery( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
@@ -1024,19 +1484,54 @@
   ak_mpzn_mul_montgomery( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
  /* сложение точек и проверка */
-  ak_wpoint_pow( &cpoint, &pctx->wc->point, z1, pctx->wc->size, pctx->wc );
-  ak_wpoint_pow( &tpoint, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
-  ak_wpoint_add( &cpoint, &tpoint, pctx->wc );
+  ak_wpoint_pow2_multiples( &cpoint, NULL, z1,
+                                           qmultiples, z2, pctx->wc->size, pctx->wc );
   ak_wpoint_reduce( &cpoint, pctx->wc );
   ak_mpzn_rem( cpoint.x, cpoint.x, pctx->wc->q, pctx->wc->size );
 
   if( ak_mpzn_cmp( cpoint.x, r, pctx->wc->size )) {
-    ak_ptr_is_equal_with_log( cpoint.x, r, pctx->wc->size*sizeof( ak_uint64 ));
+    if( log ) ak_ptr_is_equal_with_log( cpoint.x, r, pctx->wc->size*sizeof( ak_uint64 ));
     return ak_false;
   }
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param pctx контекст открытого ключа.
+    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
+    @param hsize размер хеш-кода, в байтах.
+    @param sign электронная подпись, для которой выполняется проверка.
+    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
+    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
+    вызова функции ak_error_get_value().                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_verifykey_verify_hash( ak_verifykey pctx,
+                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+{
+  struct wpoint qmultiples[ak_wpoint_odd_multiples_count];
+
+  if( pctx == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__,
+                                               "using a null pointer to secret key context" );
+    return ak_false;
+  }
+  if( hash == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to hash value" );
+    return ak_false;
+  }
+  if( hsize != sizeof( ak_uint64 )*(pctx->wc->size )) {
+    ak_error_message( ak_error_wrong_length, __func__, "using hash value with wrong length" );
+    return ak_false;
+  }
+  if( sign == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to sign value" );
+    return ak_false;
+  }
+
+  ak_wpoint_set_odd_multiples( qmultiples, &pctx->qpoint, pctx->wc );
+ return ak_verifykey_verify_hash_values( pctx, qmultiples, hash, sign, ak_true );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param pctx контекст открытого ключа.
     @param in область памяти для которой проверяется электронная подпись.
@@ -1161,6 +1656,250 @@
  return ak_verifykey_verify_hash( pctx, hash, pctx->ctx.data.sctx.hsize, sign );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                               пакетная проверка электронных подписей                            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Элемент упорядоченного списка проверяемых подписей. */
+ typedef struct verify_order {
+  /*! \brief Эллиптическая кривая, используемая открытым ключом. */
+   ak_wcurve wc;
+  /*! \brief Открытый ключ. */
+   ak_verifykey key;
+  /*! \brief Индекс элемента в исходном массиве. */
+   size_t index;
+  /*! \brief Номер набора нечетных кратных точки открытого ключа. */
+   size_t table;
+} *ak_verify_order;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сравнение элементов списка: элементы группируются по кривым и открытым ключам. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_verify_order_cmp( const void *a, const void *b )
+{
+  const struct verify_order *x = a, *y = b;
+
+  if( x->wc != y->wc ) return (( uintptr_t )x->wc < ( uintptr_t )y->wc ) ? -1 : 1;
+  if( x->key != y->key ) return (( uintptr_t )x->key < ( uintptr_t )y->key ) ? -1 : 1;
+  if( x->index != y->index ) return ( x->index < y->index ) ? -1 : 1;
+ return 0;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на проверку фрагмента пакета электронных подписей. */
+ typedef struct verify_batch {
+  /*! \brief Функция, выполняющая задание. */
+   void ( *function )( struct verify_batch * );
+  /*! \brief Массив проверяемых подписей. */
+   ak_verify_item items;
+  /*! \brief Упорядоченный список проверяемых подписей. */
+   ak_verify_order order;
+  /*! \brief Количество элементов списка (или наборов кратных точек). */
+   size_t count;
+  /*! \brief Номер первого обрабатываемого элемента списка. */
+   size_t first;
+  /*! \brief Шаг перебора элементов списка. */
+   size_t step;
+  /*! \brief Массив результатов проверки. */
+   bool_t *results;
+  /*! \brief Нечетные кратные точек открытых ключей, вычисленные для пакета. */
+   ak_wpoint multiples;
+  /*! \brief Номера первых элементов списка, использующих каждый из наборов кратных точек. */
+   size_t *heads;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что задание выполняется вспомогательным потоком. */
+   bool_t threaded;
+#endif
+} *ak_verify_batch;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет наборы нечетных кратных точек открытых ключей, входящие в задание. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verify_batch_precompute( ak_verify_batch vb )
+{
+  size_t i = 0;
+
+  for( i = vb->first; i < vb->count; i += vb->step ) {
+     ak_verifykey key = vb->order[vb->heads[i]].key;
+     ak_wpoint_set_odd_multiples( vb->multiples +i*ak_wpoint_odd_multiples_count,
+                                                                         &key->qpoint, key->wc );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно проверяет подписи, входящие в задание. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verify_batch_update( ak_verify_batch vb )
+{
+  size_t i = 0;
+
+  for( i = vb->first; i < vb->count; i += vb->step ) {
+     ak_verify_item item = vb->items +vb->order[i].index;
+     vb->results[vb->order[i].index] = ak_verifykey_verify_hash_values( item->key,
+               vb->multiples +vb->order[i].table*ak_wpoint_odd_multiples_count,
+                                                             item->hash, item->sign, ak_false );
+  }
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_verify_batch_thread( void *ptr )
+{
+  ak_verify_batch vb = ( ak_verify_batch )ptr;
+
+  vb->function( vb );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция распределяет задание между несколькими потоками и дожидается их завершения.
+    \details Количество потоков определяется опцией `threads_count` и не превышает количества
+    обрабатываемых элементов.                                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verify_batch_run( ak_verify_batch main_task )
+{
+  size_t threads = ak_max( 1, ak_min( ak_libakrypt_get_threads_count(), main_task->count ));
+#ifdef AK_HAVE_PTHREAD_H
+  size_t i = 0;
+  ak_verify_batch tasks = NULL;
+#endif
+
+  main_task->first = 0;
+  main_task->step = threads;
+#ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && (( tasks = malloc(( threads-1 )*sizeof( struct verify_batch ))) != NULL )) {
+    for( i = 0; i < threads-1; i++ ) {
+       tasks[i] = *main_task;
+       tasks[i].first = i+1;
+       tasks[i].threaded = ak_false;
+       if( pthread_create( &tasks[i].thread, NULL, ak_verify_batch_thread, tasks+i ) == 0 )
+         tasks[i].threaded = ak_true;
+        else {
+          ak_error_message( ak_error_undefined_function, __func__, "wrong creation of a thread" );
+         /* обрабатываем задание самостоятельно */
+          tasks[i].function( tasks+i );
+        }
+    }
+    main_task->function( main_task );
+    for( i = 0; i < threads-1; i++ )
+       if( tasks[i].threaded ) pthread_join( tasks[i].thread, NULL );
+    free( tasks );
+    return;
+  }
+#endif
+  main_task->step = 1;
+  main_task->function( main_task );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет электронные подписи для массива элементов, каждый из которых содержит
+    открытый ключ, вычисленное заранее значение хеш-функции и электронную подпись.
+    Результат проверки каждой подписи совпадает с результатом функции ak_verifykey_verify_hash().
+
+    Перед началом вычислений элементы массива упорядочиваются по эллиптическим кривым
+    и открытым ключам. Для каждого ключа один раз вычисляются нечетные кратные точки
+    открытого ключа; если несколько контекстов содержат одну и ту же точку, то используется
+    один набор кратных точек. Кратные точки хранятся в памяти, выделяемой на время
+    выполнения функции, контексты ключей не изменяются.
+
+    При наличии поддержки потоков вычисления выполняются в два этапа, каждый из которых
+    распределяется между несколькими потоками (количество потоков определяется
+    опцией `threads_count`): сначала вычисляются наборы кратных точек для различных ключей,
+    затем проверяются подписи упорядоченного массива.
+
+    \note Контексты открытых ключей, указанные в элементах массива, не должны изменяться
+    другими потоками во время выполнения функции.
+
+    \param items Массив из `count` проверяемых подписей.
+    \param count Количество элементов массива.
+    \param results Массив из `count` элементов, в который помещаются результаты проверки:
+    \ref ak_true, если подпись верна, и \ref ak_false, если подпись неверна или элемент
+    массива содержит некорректные данные (нулевые указатели, хеш-код неверной длины).
+
+    \return В случае успеха функция возвращает ноль (\ref ak_error_ok), даже если часть
+    подписей неверна. Код ошибки возвращается, если массивы не определены или
+    не удалось выделить память.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_verify_hash_batch( ak_verify_item items, const size_t count, bool_t *results )
+{
+  size_t i = 0, valid = 0, tables = 0, *heads = NULL;
+  ak_wpoint multiples = NULL;
+  ak_verify_order order = NULL;
+  ak_verifykey prev = NULL;
+  struct verify_batch main_task;
+
+  if( items == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                    "using null pointer to array of signatures" );
+  if( results == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to array of results" );
+  if( !count ) return ak_error_ok;
+  if(( order = malloc( count*sizeof( struct verify_order ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                 "incorrect memory allocation for sorted list" );
+
+ /* отбрасываем некорректные элементы и упорядочиваем остальные по кривым и ключам */
+  for( i = 0; i < count; i++ ) {
+     ak_verify_item item = items +i;
+     results[i] = ak_false;
+     if(( item->key == NULL ) || ( item->key->wc == NULL ) ||
+        ( item->hash == NULL ) || ( item->sign == NULL ) ||
+        ( item->hsize != sizeof( ak_uint64 )*item->key->wc->size )) continue;
+     order[valid].wc = item->key->wc;
+     order[valid].key = item->key;
+     order[valid].index = i;
+     valid++;
+  }
+  qsort( order, valid, sizeof( struct verify_order ), ak_verify_order_cmp );
+
+ /* определяем различные открытые ключи; каждому из них соответствует свой набор кратных точек */
+  for( i = 0; i < valid; i++ ) {
+     ak_verifykey key = order[i].key;
+     if(( prev == NULL ) || (( key != prev ) && (( prev->wc != key->wc ) ||
+        ak_mpzn_cmp( prev->qpoint.x, key->qpoint.x, key->wc->size ) ||
+        ak_mpzn_cmp( prev->qpoint.y, key->qpoint.y, key->wc->size ) ||
+        ak_mpzn_cmp( prev->qpoint.z, key->qpoint.z, key->wc->size )))) tables++;
+     order[i].table = tables -1;
+     prev = key;
+  }
+  if( tables > 0 ) {
+    if((( multiples =
+          malloc( tables*ak_wpoint_odd_multiples_count*sizeof( struct wpoint ))) == NULL ) ||
+       (( heads = malloc( tables*sizeof( size_t ))) == NULL )) {
+      if( multiples != NULL ) free( multiples );
+      free( order );
+      return ak_error_message( ak_error_out_of_memory, __func__,
+                                           "incorrect memory allocation for multiples of keys" );
+    }
+    for( i = 0; i < valid; i++ )
+       if(( i == 0 ) || ( order[i].table != order[i-1].table )) heads[order[i].table] = i;
+  }
+
+  memset( &main_task, 0, sizeof( struct verify_batch ));
+  main_task.items = items;
+  main_task.order = order;
+  main_task.results = results;
+  main_task.multiples = multiples;
+  main_task.heads = heads;
+
+ /* вычисляем кратные точки для всех ключей, затем проверяем подписи */
+  main_task.function = ak_verify_batch_precompute;
+  main_task.count = tables;
+  ak_verify_batch_run( &main_task );
+
+  main_task.function = ak_verify_batch_update;
+  main_task.count = valid;
+  ak_verify_batch_run( &main_task );
+
+  if( heads != NULL ) free( heads );
+  if( multiples != NULL ) free( multiples );
+  free( order );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! В отличие от номеров секретных ключей, номера открытых ключей не являются случайными.
     Согласно рекомендациям RFC 5280 номер открытого ключа вырабатывается из
@@ -18,6 +18,9 @@
 #ifdef AK_HAVE_PTHREAD_H
  #include <pthread.h>
 #endif
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+ #include <emmintrin.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*!  Переменная, содержащая в себе код последней ошибки                                            */
@@ -915,12 +918,125 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Приведение накопленного значения второй суммы по модулю многочлена
+    \f$ x^{16} + x^{15} + x^{11} + x^9 + x^8 + x^7 + x^5 + x^4 + x^2 + x + 1\f$.
+
+    Функция понижает степень многочлена, содержащего не более 24-х коэффициентов:
+    каждый из старших коэффициентов заменяется вычетом \f$ x^{16+i} \pmod{f(x)} \f$.
+    Все замены выполняются независимо друг от друга и без условных переходов,
+    зависящих от значений ключа.                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint32 ak_fletcher32_xor_reduce( ak_uint32 t )
+{
+  static const ak_uint32 r[8] = {
+                           0x8BB7, 0x9CD9, 0xB205, 0xEFBD, 0x54CD, 0xA99A, 0xD883, 0x3AB1 };
+ return ( t ^( r[0]&( 0u - (( t >> 16 )&0x1 ))) ^( r[1]&( 0u - (( t >> 17 )&0x1 )))
+            ^( r[2]&( 0u - (( t >> 18 )&0x1 ))) ^( r[3]&( 0u - (( t >> 19 )&0x1 )))
+            ^( r[4]&( 0u - (( t >> 20 )&0x1 ))) ^( r[5]&( 0u - (( t >> 21 )&0x1 )))
+            ^( r[6]&( 0u - (( t >> 22 )&0x1 ))) ^( r[7]&( 0u - (( t >> 23 )&0x1 ))))&0xffff;
+}
+
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+/*! \brief Атрибут функций, использующих набор команд sse2 без соответствующих флагов компилятора.
+    \details Такие функции вызываются только после проверки наличия команд с помощью cpuid. */
+ #ifdef AK_HAVE_TARGET_XOR_SI128
+  #define ak_target_sse2 __attribute__(( target( "sse2" )))
+ #else
+  #define ak_target_sse2
+ #endif
+
+/*! \brief Флаг использования реализаций контрольных сумм, использующих команды sse2;
+    значение изменяется функцией ak_ptr_fletcher32_set_sse2(). Если компилятор сам использует
+    команды sse2, то флаг устанавливается по-умолчанию. */
+ #ifdef AK_HAVE_TARGET_XOR_SI128
+  static bool_t fletcher32_sse2_enabled = ak_false;
+ #else
+  static bool_t fletcher32_sse2_enabled = ak_true;
+ #endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработка блоков из 16 октетов в функции ak_ptr_fletcher32_xor():
+    слово с номером i блока умножается на x^{8-i}, а вторая сумма - на x^8.
+    \return Количество обработанных октетов.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_target_sse2 size_t ak_ptr_fletcher32_xor_sse2( const ak_uint8 *ptr, const size_t cnt,
+                                                                   ak_uint32 *sA, ak_uint32 *sB )
+{
+  size_t idx = 0;
+  __m128i w, v, mul = _mm_setr_epi16( 256, 128, 64, 32, 16, 8, 4, 2 );
+
+  while( idx + 16 <= cnt ) {
+    w = _mm_loadu_si128(( const __m128i *)( ptr +idx ));
+    w = _mm_xor_si128( w, _mm_slli_si128( w, 2 ));
+    w = _mm_xor_si128( w, _mm_slli_si128( w, 4 ));
+    w = _mm_xor_si128( w, _mm_slli_si128( w, 8 ));
+    w = _mm_xor_si128( w, _mm_set1_epi16(( short int ) *sA ));
+    v = _mm_unpacklo_epi16( _mm_mullo_epi16( w, mul ), _mm_mulhi_epu16( w, mul ));
+    v = _mm_xor_si128( v, _mm_unpackhi_epi16( _mm_mullo_epi16( w, mul ),
+                                                                  _mm_mulhi_epu16( w, mul )));
+    v = _mm_xor_si128( v, _mm_srli_si128( v, 8 ));
+    v = _mm_xor_si128( v, _mm_srli_si128( v, 4 ));
+    *sB = ak_fletcher32_xor_reduce(( ak_uint32 )_mm_cvtsi128_si32( v )^( *sB << 8 ));
+    *sA = ( ak_uint32 )_mm_extract_epi16( w, 7 );
+    idx += 16;
+  }
+ return idx;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработка блоков из четырех 32-х битных слов в функции ak_ptr_fletcher32():
+    после обработки m блоков вторая сумма равна 4*(сумма v1) - (v0[1] + 2*v0[2] + 3*v0[3]).
+    \return Количество обработанных 32-х битных слов.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_target_sse2 size_t ak_ptr_fletcher32_sse2( const ak_uint32 *ptr, const size_t len,
+                                                                   ak_uint32 *c0, ak_uint32 *c1 )
+{
+  size_t i = 0;
+  ak_uint32 s0[4], s1[4];
+  __m128i v0 = _mm_setzero_si128(), v1 = _mm_setzero_si128();
+
+  for( i = 0; i + 4 <= len; i += 4 ) {
+     v0 = _mm_add_epi32( v0, _mm_loadu_si128(( const __m128i *)( ptr +i )));
+     v1 = _mm_add_epi32( v1, v0 );
+  }
+  _mm_storeu_si128(( __m128i *) s0, v0 );
+  _mm_storeu_si128(( __m128i *) s1, v1 );
+  *c0 = s0[0] + s0[1] + s0[2] + s0[3];
+  *c1 = (( s1[0] + s1[1] + s1[2] + s1[3] ) << 2 ) - ( s0[1] + ( s0[2] << 1 ) + 3*s0[3] );
+ return i;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается при инициализации библиотеки libakrypt, а также при изменении уровня
+    реализации вычислительных ядер (см. функцию ak_libakrypt_set_cpu_level()).
+    Если библиотека собрана без поддержки команд sse2, то вызов функции ни на что не влияет.
+
+    @param enable Значение \ref ak_true разрешает использование команд sse2,
+    значение \ref ak_false - запрещает.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_ptr_fletcher32_set_sse2( bool_t enable )
+{
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+  fletcher32_sse2_enabled = enable;
+#else
+  (void)enable;
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \details Используется модифицированный алгоритм,
     заменяющий обычное модульное сложение на операцию порязрядного сложения по модулю 2.
     Такая замена не только не изменяет статистические свойства алгоритма, но и позволяет
     вычислять контрольную сумму от ключевой информации в не зависимотси от значения используемой маски.
 
+    Вторая сумма представляет собой линейное отображение над полем из двух элементов,
+    поэтому данные обрабатываются блоками из восьми 16-ти битных слов: сначала
+    вычисляется не приведенная сумма блока, затем выполняется одно приведение по модулю.
+    При наличии инструкций SSE2 префиксные суммы блока и их сдвиги вычисляются
+    одновременно для всех восьми слов.
+
     \param data Указатель на область пямяти, для которой вычисляется контрольная сумма.
     \param size Размер области (в октетах).
     \param out Область памяти куда помещается результат.
@@ -930,8 +1046,8 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_ptr_fletcher32_xor( ak_const_pointer data, const size_t size, ak_uint32 *out )
 {
-  ak_uint32 sB = 0;
-  size_t idx = 0, cnt = size ^( size&0x1 );
+  ak_uint32 sA = 0, sB = 0, t = 0;
+  size_t idx = 0, cnt = size ^( size&0x1 ), j = 0;
   const ak_uint8 *ptr = data;
 
   if( data == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
@@ -940,20 +1056,27 @@
                                                                         "using zero length data" );
   if( out == NULL )  return ak_error_message( ak_error_null_pointer, __func__,
                                                            "using null pointer to output buffer" );
- /* основной цикл по четному числу байт  */
-  *out = 0;
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+ /* основной цикл по блокам из 16 октетов */
+  if( fletcher32_sse2_enabled ) idx = ak_ptr_fletcher32_xor_sse2( ptr, cnt, &sA, &sB );
+#endif
+
+ /* цикл по блокам из восьми слов (четное число байт) */
   while( idx < cnt ) {
-    *out ^= ( ptr[idx] | (ak_uint32)(ptr[idx+1] << 8));
-    sB = (( sB ^= *out )&0x8000) ? (sB << 1)^0x8BB7 : (sB << 1);
-    idx+= 2;
+    t = sB;
+    for( j = 0; ( j < 8 ) && ( idx < cnt ); j++, idx += 2 ) {
+       sA ^= ( ptr[idx] | (ak_uint32)(ptr[idx+1] << 8));
+       t = ( t^sA ) << 1;
+    }
+    sB = ak_fletcher32_xor_reduce( t );
   }
 
  /* дополняем последний (нечетный) байт */
   if( idx != size ) {
-    *out ^= ptr[idx];
-    sB = (( sB ^= *out )&0x8000) ? (sB << 1)^0x8BB7 : (sB << 1);
+    sA ^= ptr[idx];
+    sB = ak_fletcher32_xor_reduce(( sB^sA ) << 1 );
   }
-  *out ^= ( sB << 16 );
+  *out = sA ^( sB << 16 );
  return ak_error_ok;
 }
 
@@ -961,6 +1084,10 @@
 /*! Функция реализует алгоритм Флетчера с измененным модулем простого числа
     подробное описание см. [здесь]( https://en.wikipedia.org/wiki/Fletcher%27s_checksum#Fletcher-32).
 
+    При наличии инструкций SSE2 данные обрабатываются блоками из четырех 32-х битных слов:
+    для каждой позиции слова в блоке накапливаются собственные суммы, которые
+    после обработки всех блоков объединяются с весами, соответствующими позициям слов.
+
     \param data Указатель на область пямяти, для которой вычисляется контрольная сумма.
     \param size Размер области (в октетах).
     \param out Область памяти куда помещается результат.
@@ -972,7 +1099,7 @@
 {
  ak_uint32 c0 = 0, c1 = 0;
  const ak_uint32 *ptr = ( const ak_uint32 *) data;
- size_t i, len = size >> 2, tail = size - ( len << 2 );
+ size_t i = 0, len = size >> 2, tail = size - ( len << 2 );
 
   if( data == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                               "using null pointer to input data" );
@@ -980,8 +1107,13 @@
                                                                         "using zero length data" );
   if( out == NULL )  return ak_error_message( ak_error_null_pointer, __func__,
                                                            "using null pointer to output buffer" );
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+ /* для коротких ключей (32 октета) объединение сумм обходится дороже последовательного цикла */
+  if( fletcher32_sse2_enabled && ( len >= 16 )) i = ak_ptr_fletcher32_sse2( ptr, len, &c0, &c1 );
+#endif
+
  /* основной цикл обработки 32-х битных слов */
-  for( i = 0; i < len; i++ ) {
+  for( ; i < len; i++ ) {
     c0 += ptr[i];
     c1 += c0;
   }
@@ -11,58 +11,41 @@
 #ifdef AK_HAVE_STDALIGN_H
  #include <stdalign.h>
 #endif
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция реализует алгоритм двухключевого шифрования, описываемый в стандарте IEEE P 1619.
-
-    \note Для блочных шифров с длиной блока 128 бит реализация полностью соответствует
-    указанному стандарту. Для шифров с длиной блока 64 реализация использует преобразования,
-    в частности вычисления к конечном поле \f$ \mathbb F_{2^{128}}\f$,
-    определенные для 128 битных шифров.
-
-    @param encryptionKey Ключ, используемый для шифрования информации
-    @param authenticationKey Ключ, используемый для преобразования синхропосылки и выработки
-    псевдослучайной последовательности
-    @param in Указатель на область памяти, где хранятся входные (открытые) данные
-    @param out Указатель на область памяти, куда будут помещены зашифровываемые данные
-    @param size Размер входных данных (в октетах)
-    @param iv Указатель на область памяти, где находится синхропосылка (произвольные данные).
-    @param iv_size Размер синхропосылки в октетах, должен быть отличен от нуля.
-    Если размер синхропосылки превышает 16 октетов (128 бит), то оставшиеся значения не используются.
+/*! \brief Количество блоков 128-битного шифра, передаваемых за один вызов
+    многоблочной функции зашифрования/расшифрования. */
+ #define ak_xts_batch_blocks                   (8)
+/*! \brief Минимальное количество секторов, обрабатываемых одним потоком. */
+ #define ak_xts_sectors_per_thread            (16)
 
-    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В случае возникновения
-    ошибки возвращается ее код.                                                                    */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_bckey_encrypt_xts( ak_bckey encryptionKey,  ak_bckey authenticationKey,
-                        ak_pointer in, ak_pointer out, size_t size, ak_pointer iv, size_t iv_size )
+/*! \brief Умножение значения tweak на примитивный элемент поля \f$ \mathbb F_{2^{128}}\f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_xts_tweak_next( ak_uint64 *tweak )
 {
-  int error = ak_error_ok;
-  ak_int64 jcnt = 0, blocks = 0;
-  ak_uint64 *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
-#ifdef AK_HAVE_STDALIGN_H
- #ifndef AK_HAVE_WINDOWS_H
-  alignas(16)
- #endif
-#endif
-  ak_uint64 tweak[2], t[2], *tptr = t;
+  ak_uint64 t0 = tweak[0] >> 63, t1 = tweak[1] >> 63;
 
- /* проверяем целостность ключа */
-  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                               "incorrect integrity code of encryption key value" );
-  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                           "incorrect integrity code of authentication key value" );
-
- /* проверяем ресурс ключа аутентификации */
-  if( authenticationKey->key.resource.value.counter < (ssize_t)( authenticationKey->bsize >> 3 ))
-    return ak_error_message( ak_error_low_key_resource,
-                                              __func__ , "low resource of authentication cipher key" );
-   else authenticationKey->key.resource.value.counter -= ( authenticationKey->bsize >> 3 );
+  tweak[0] <<= 1;
+  tweak[1] <<= 1;
+  tweak[1] ^= t0;
+  if( t1 ) tweak[0] ^= 0x87;
+}
 
- /* вырабатываем начальное состояние вектора */
-  memset( tweak, 0, sizeof( tweak ));
-  memcpy( tweak, iv, ak_min( iv_size, sizeof( tweak )));
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает начальное значение tweak по заданной синхропосылке. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_xts_tweak_create( ak_bckey authenticationKey,
+                                          ak_uint64 *tweak, ak_pointer iv, const size_t iv_size )
+{
+  memset( tweak, 0, 16 );
+  memcpy( tweak, iv, ak_min( iv_size, 16 ));
 
   if( authenticationKey->bsize == 8 ) {
     authenticationKey->encrypt( &authenticationKey->key, tweak, tweak );
@@ -70,72 +53,78 @@
     authenticationKey->encrypt( &authenticationKey->key, tweak+1, tweak+1 );
   } else
       authenticationKey->encrypt( &authenticationKey->key, tweak, tweak );
+}
 
- /* вычисляем количество блоков */
-  blocks = ( ak_int64 )( size/encryptionKey->bsize );
-  if( size != blocks*encryptionKey->bsize )
-    return ak_error_message( ak_error_wrong_block_cipher_length,
-                            __func__ , "the length of input data is not divided by block length" );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает (расшифровывает) заданное количество блоков,
+    изменяя текущее значение tweak.
 
- /* изменяем ресурс ключа */
-  if( encryptionKey->key.resource.value.counter < blocks )
-    return ak_error_message( ak_error_low_key_resource,
-                                              __func__ , "low resource of encryption cipher key" );
-   else encryptionKey->key.resource.value.counter -= blocks;
+    \details Для 128-битного шифра, обладающего многоблочной реализацией, значения tweak для
+    \ref ak_xts_batch_blocks последовательных блоков вычисляются заранее, а сами блоки передаются
+    в функцию шифрования одним вызовом, что позволяет чередовать их обработку.
+    Проверки ключей и изменение их ресурса должны быть выполнены заранее.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_xts_update( ak_bckey encryptionKey, ak_uint64 *tweak,
+                   ak_uint64 *inptr, ak_uint64 *outptr, ak_int64 blocks, const bool_t encrypt )
+{
+  ak_int64 jcnt = 0, k = 0;
+#ifdef AK_HAVE_STDALIGN_H
+ #ifndef AK_HAVE_WINDOWS_H
+  alignas(16)
+ #endif
+#endif
+  ak_uint64 t[2*ak_xts_batch_blocks], tw[2*ak_xts_batch_blocks], *tptr = t;
+  ak_function_bckey *single = encrypt ? encryptionKey->encrypt : encryptionKey->decrypt;
+  ak_function_bckey_blocks *multi =
+                          encrypt ? encryptionKey->encrypt_blocks : encryptionKey->decrypt_blocks;
 
  /* запускаем основной цикл обработки блоков информации */
    switch( encryptionKey->bsize ) {
      case  8: /* шифр с длиной блока 64 бита */
        while( blocks > 0 ) {
           *tptr = *inptr^*(tweak+jcnt); inptr++;
-          encryptionKey->encrypt( &encryptionKey->key, tptr, tptr );
+          single( &encryptionKey->key, tptr, tptr );
           *outptr = *tptr ^ *(tweak+jcnt); outptr++;
           --blocks;
           tptr++;
 
           if( !(jcnt = 1 - jcnt)) { /* изменяем значение tweak */
             tptr = t;
-            t[0] = tweak[0] >> 63; t[1] = tweak[1] >> 63;
-            tweak[0] <<= 1; tweak[1] <<= 1;
-            tweak[1] ^= t[0];
-            if( t[1] ) tweak[0] ^= 0x87;
+            ak_xts_tweak_next( tweak );
           }
        }
        break;
 
      case 16: /* шифр с длиной блока 128 бит */
+       if( multi != NULL ) {
+         for( ; blocks >= ak_xts_batch_blocks; blocks -= ak_xts_batch_blocks ) {
+           /* накладываем последовательные значения tweak */
+            for( k = 0; k < 2*ak_xts_batch_blocks; k += 2, inptr += 2 ) {
+               tw[k] = tweak[0]; tw[k+1] = tweak[1];
+               t[k] = inptr[0]^tweak[0]; t[k+1] = inptr[1]^tweak[1];
+               ak_xts_tweak_next( tweak );
+            }
+            multi( &encryptionKey->key, t, t, ak_xts_batch_blocks );
+            for( k = 0; k < 2*ak_xts_batch_blocks; k += 2, outptr += 2 ) {
+               outptr[0] = t[k]^tw[k]; outptr[1] = t[k+1]^tw[k+1];
+            }
+         }
+       }
        while( blocks > 0 ) {
          /* шифруем */
           t[0] = *inptr^*tweak; inptr++;
           t[1] = *inptr^*(tweak+1); inptr++;
 
-          encryptionKey->encrypt( &encryptionKey->key, t, t );
+          single( &encryptionKey->key, t, t );
           *outptr = t[0]^*tweak; outptr++;
           *outptr = t[1]^*(tweak+1); outptr++;
           --blocks;
 
          /* изменяем значение tweak */
-          t[0] = tweak[0] >> 63;
-          t[1] = tweak[1] >> 63;
-          tweak[0] <<= 1;
-          tweak[1] <<= 1;
-          tweak[1] ^= t[0];
-          if( t[1] ) tweak[0] ^= 0x87;
+          ak_xts_tweak_next( tweak );
        }
        break;
    }
-
- /* очищаем */
-  if(( error = ak_ptr_wipe( tweak, sizeof( tweak ), &encryptionKey->key.generator )) != ak_error_ok )
-   ak_error_message( error, __func__ , "wrong wiping of tweak value" );
-
- /* перемаскируем ключ */
-  if(( error = encryptionKey->key.set_mask( &encryptionKey->key )) != ak_error_ok )
-    ak_error_message( error, __func__ , "wrong remasking of encryption key" );
-  if(( error = authenticationKey->key.set_mask( &authenticationKey->key )) != ak_error_ok )
-    ak_error_message( error, __func__ , "wrong remasking of authentication key" );
-
-  return error;
 }
 
 /* нижеследующий фрагмент выглядит более современно,
@@ -153,6 +142,118 @@
          *outptr = _mm_extract_epi64( data, 0 ); outptr++;
          *outptr = _mm_extract_epi64( data, 1 ); outptr++;
          --blocks;                                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет ключи и изменяет их ресурс перед обработкой данных.
+
+    @param sectors Количество независимо обрабатываемых фрагментов данных (секторов),
+    для каждого из которых вырабатывается собственное значение tweak
+    @param blocks Общее количество обрабатываемых блоков                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_xts_check_keys( ak_bckey encryptionKey, ak_bckey authenticationKey,
+                                                        const ak_int64 sectors, const ak_int64 blocks )
+{
+ /* проверяем целостность ключа */
+  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                               "incorrect integrity code of encryption key value" );
+  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                           "incorrect integrity code of authentication key value" );
+
+ /* проверяем ресурс ключа аутентификации */
+  if( authenticationKey->key.resource.value.counter <
+                                           sectors*(ssize_t)( authenticationKey->bsize >> 3 ))
+    return ak_error_message( ak_error_low_key_resource,
+                                              __func__ , "low resource of authentication cipher key" );
+   else authenticationKey->key.resource.value.counter -=
+                                               sectors*(ssize_t)( authenticationKey->bsize >> 3 );
+
+ /* изменяем ресурс ключа */
+  if( encryptionKey->key.resource.value.counter < blocks )
+    return ak_error_message( ak_error_low_key_resource,
+                                              __func__ , "low resource of encryption cipher key" );
+   else encryptionKey->key.resource.value.counter -= blocks;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция перемаскирует ключи после завершения обработки данных. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_xts_remask_keys( ak_bckey encryptionKey, ak_bckey authenticationKey )
+{
+  int error = ak_error_ok;
+
+  if(( error = encryptionKey->key.set_mask( &encryptionKey->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong remasking of encryption key" );
+  if(( error = authenticationKey->key.set_mask( &authenticationKey->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong remasking of authentication key" );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Общая часть функций зашифрования и расшифрования в режиме XTS. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_xts( ak_bckey encryptionKey,  ak_bckey authenticationKey, ak_pointer in,
+                 ak_pointer out, size_t size, ak_pointer iv, size_t iv_size, const bool_t encrypt )
+{
+  int error = ak_error_ok;
+  ak_int64 blocks = 0;
+#ifdef AK_HAVE_STDALIGN_H
+ #ifndef AK_HAVE_WINDOWS_H
+  alignas(16)
+ #endif
+#endif
+  ak_uint64 tweak[2];
+
+ /* вычисляем количество блоков */
+  blocks = ( ak_int64 )( size/encryptionKey->bsize );
+  if( size != blocks*encryptionKey->bsize )
+    return ak_error_message( ak_error_wrong_block_cipher_length,
+                            __func__ , "the length of input data is not divided by block length" );
+ /* проверяем ключи и изменяем их ресурс */
+  if(( error = ak_xts_check_keys( encryptionKey, authenticationKey, 1, blocks )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect using of secret keys" );
+
+ /* вырабатываем начальное состояние вектора и обрабатываем данные */
+  ak_xts_tweak_create( authenticationKey, tweak, iv, iv_size );
+  ak_xts_update( encryptionKey, tweak, in, out, blocks, encrypt );
+
+ /* очищаем */
+  if(( error = ak_ptr_wipe( tweak, sizeof( tweak ), &encryptionKey->key.generator )) != ak_error_ok )
+   ak_error_message( error, __func__ , "wrong wiping of tweak value" );
+
+ return ak_xts_remask_keys( encryptionKey, authenticationKey );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует алгоритм двухключевого шифрования, описываемый в стандарте IEEE P 1619.
+
+    \note Для блочных шифров с длиной блока 128 бит реализация полностью соответствует
+    указанному стандарту. Для шифров с длиной блока 64 реализация использует преобразования,
+    в частности вычисления к конечном поле \f$ \mathbb F_{2^{128}}\f$,
+    определенные для 128 битных шифров.
+
+    @param encryptionKey Ключ, используемый для шифрования информации
+    @param authenticationKey Ключ, используемый для преобразования синхропосылки и выработки
+    псевдослучайной последовательности
+    @param in Указатель на область памяти, где хранятся входные (открытые) данные
+    @param out Указатель на область памяти, куда будут помещены зашифровываемые данные
+    @param size Размер входных данных (в октетах)
+    @param iv Указатель на область памяти, где находится синхропосылка (произвольные данные).
+    @param iv_size Размер синхропосылки в октетах, должен быть отличен от нуля.
+    Если размер синхропосылки превышает 16 октетов (128 бит), то оставшиеся значения не используются.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В случае возникновения
+    ошибки возвращается ее код.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_encrypt_xts( ak_bckey encryptionKey,  ak_bckey authenticationKey,
+                        ak_pointer in, ak_pointer out, size_t size, ak_pointer iv, size_t iv_size )
+{
+  return ak_bckey_xts( encryptionKey, authenticationKey, in, out, size, iv, iv_size, ak_true );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция реализует обратное преобразование к алгоритму, реализуемому с помощью
     функции ak_bckey_encrypt_xts().
@@ -173,106 +274,235 @@
  int ak_bckey_decrypt_xts( ak_bckey encryptionKey,  ak_bckey authenticationKey,
                         ak_pointer in, ak_pointer out, size_t size, ak_pointer iv, size_t iv_size )
 {
-  int error = ak_error_ok;
-  ak_int64 jcnt = 0, blocks = 0;
-  ak_uint64 *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
-#ifdef AK_HAVE_STDALIGN_H
- #ifndef AK_HAVE_WINDOWS_H
-  alignas(16)
- #endif
-#endif
-  ak_uint64 tweak[2], t[2], *tptr = t;
+  return ak_bckey_xts( encryptionKey, authenticationKey, in, out, size, iv, iv_size, ak_false );
+}
 
- /* проверяем целостность ключа */
-  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                               "incorrect integrity code of encryption key value" );
-  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                           "incorrect integrity code of authentication key value" );
+/* ----------------------------------------------------------------------------------------------- */
+/*                   шифрование последовательности независимых секторов                            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Фрагмент данных, состоящий из последовательно расположенных секторов. */
+ typedef struct xts_sectors {
+  /*! \brief Ключ шифрования данных. */
+   ak_bckey encryptionKey;
+  /*! \brief Ключ выработки значений tweak. */
+   ak_bckey authenticationKey;
+  /*! \brief Указатель на входные данные. */
+   ak_uint8 *in;
+  /*! \brief Указатель на выходные данные. */
+   ak_uint8 *out;
+  /*! \brief Количество обрабатываемых секторов. */
+   size_t count;
+  /*! \brief Размер одного сектора (в октетах). */
+   size_t sector_size;
+  /*! \brief Номер первого сектора. */
+   ak_uint64 sector;
+  /*! \brief Флаг зашифрования (ak_true) или расшифрования (ak_false) данных. */
+   bool_t encrypt;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Копия ключа шифрования, используемая вспомогательным потоком. */
+   struct bckey ekey;
+  /*! \brief Копия ключа выработки значений tweak, используемая вспомогательным потоком. */
+   struct bckey akey;
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что фрагмент обрабатывается вспомогательным потоком. */
+   bool_t threaded;
+#endif
+} *ak_xts_sectors;
 
- /* проверяем ресурс ключа аутентификации */
-  if( authenticationKey->key.resource.value.counter < (ssize_t)( authenticationKey->bsize >> 3 ))
-    return ak_error_message( ak_error_low_key_resource,
-                                              __func__ , "low resource of authentication cipher key" );
-   else authenticationKey->key.resource.value.counter -= ( authenticationKey->bsize >> 3 );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает последовательность секторов. Для каждого сектора синхропосылкой
+    служит его номер, записанный в виде 128-битного числа в порядке little endian
+    (номер блока данных согласно IEEE P 1619).                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_xts_sectors_update( ak_xts_sectors st )
+{
+  size_t i = 0, j = 0;
+  ak_uint8 iv[16];
+  ak_uint64 tweak[2], sector = st->sector;
+  ak_uint8 *inptr = st->in, *outptr = st->out;
+  ak_int64 blocks = ( ak_int64 )( st->sector_size/st->encryptionKey->bsize );
+
+  memset( iv, 0, sizeof( iv ));
+  for( i = 0; i < st->count; i++, sector++, inptr += st->sector_size, outptr += st->sector_size ) {
+     for( j = 0; j < 8; j++ ) iv[j] = ( ak_uint8 )( sector >> ( j << 3 ));
+
+     ak_xts_tweak_create( st->authenticationKey, tweak, iv, sizeof( iv ));
+     ak_xts_update( st->encryptionKey, tweak,
+                                 (ak_uint64 *)inptr, (ak_uint64 *)outptr, blocks, st->encrypt );
+  }
+  ak_ptr_wipe( tweak, sizeof( tweak ), &st->encryptionKey->key.generator );
+}
 
- /* вырабатываем начальное состояние вектора */
-  memset( tweak, 0, sizeof( tweak ));
-  memcpy( tweak, iv, ak_min( iv_size, sizeof( tweak )));
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_xts_sectors_thread( void *ptr )
+{
+  ak_xts_sectors_update(( ak_xts_sectors )ptr );
+ return NULL;
+}
 
-  if( authenticationKey->bsize == 8 ) {
-    authenticationKey->encrypt( &authenticationKey->key, tweak, tweak );
-    tweak[1] ^= tweak[0];
-    authenticationKey->encrypt( &authenticationKey->key, tweak+1, tweak+1 );
-  } else
-      authenticationKey->encrypt( &authenticationKey->key, tweak, tweak );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает копии ключей и запускает вспомогательный поток.
+    \details Поскольку реализации блочных шифров могут изменять внутреннее состояние контекста
+    ключа в ходе шифрования, каждый поток использует собственные копии ключей.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_xts_sectors_start_thread( ak_xts_sectors st )
+{
+  st->threaded = ak_false;
+  if( ak_bckey_create_and_set_bckey( &st->ekey, st->encryptionKey ) != ak_error_ok )
+    return ak_false;
+  if( ak_bckey_create_and_set_bckey( &st->akey, st->authenticationKey ) != ak_error_ok ) {
+    ak_bckey_destroy( &st->ekey );
+    return ak_false;
+  }
+  st->encryptionKey = &st->ekey;
+  st->authenticationKey = &st->akey;
+  if( pthread_create( &st->thread, NULL, ak_xts_sectors_thread, st ) != 0 ) {
+    ak_error_message( ak_error_undefined_function, __func__, "wrong creation of a thread" );
+    ak_xts_sectors_update( st );
+    ak_bckey_destroy( &st->akey );
+    ak_bckey_destroy( &st->ekey );
+    return ak_true;
+  }
+  st->threaded = ak_true;
+ return ak_true;
+}
+#endif
 
- /* вычисляем количество блоков */
-  blocks = ( ak_int64 )( size/encryptionKey->bsize );
-  if( size != blocks*encryptionKey->bsize )
-    return ak_error_message( ak_error_wrong_block_cipher_length,
-                            __func__ , "the length of input data is not divided by block length" );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Общая часть функций зашифрования и расшифрования последовательности секторов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_xts_sectors( ak_bckey encryptionKey, ak_bckey authenticationKey,
+                              ak_pointer in, ak_pointer out, size_t size, ak_uint64 sector,
+                                                       size_t sector_size, const bool_t encrypt )
+{
+  int error = ak_error_ok;
+  size_t count = 0, threads = 1;
+  struct xts_sectors main_task;
+#ifdef AK_HAVE_PTHREAD_H
+  size_t i = 0, part = 0;
+  ak_xts_sectors tasks = NULL;
+#endif
 
- /* изменяем ресурс ключа */
-  if( encryptionKey->key.resource.value.counter < blocks )
-    return ak_error_message( ak_error_low_key_resource,
-                                              __func__ , "low resource of encryption cipher key" );
-   else encryptionKey->key.resource.value.counter -= blocks;
+  if( encryptionKey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                          "using null pointer to encryption key" );
+  if( authenticationKey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                      "using null pointer to authentication key" );
+  if(( in == NULL ) || ( out == NULL )) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                  "using null pointer to data" );
+  if(( sector_size == 0 ) || ( sector_size%encryptionKey->bsize ))
+    return ak_error_message( ak_error_wrong_block_cipher_length, __func__ ,
+                                      "the length of sector is not divided by block length" );
+  if( size%sector_size )
+    return ak_error_message( ak_error_wrong_block_cipher_length, __func__ ,
+                                      "the length of input data is not divided by sector length" );
+  if(( count = size/sector_size ) == 0 ) return ak_error_ok;
+
+ /* проверяем ключи и изменяем их ресурс */
+  if(( error = ak_xts_check_keys( encryptionKey, authenticationKey, ( ak_int64 )count,
+                                  ( ak_int64 )( size/encryptionKey->bsize ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect using of secret keys" );
+
+  main_task.encryptionKey = encryptionKey;
+  main_task.authenticationKey = authenticationKey;
+  main_task.in = in;
+  main_task.out = out;
+  main_task.count = count;
+  main_task.sector_size = sector_size;
+  main_task.sector = sector;
+  main_task.encrypt = encrypt;
+
+ /* определяем количество потоков */
+  threads = ak_min( ak_libakrypt_get_threads_count(), count/ak_xts_sectors_per_thread );
+#ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && (( tasks = malloc(( threads-1 )*sizeof( struct xts_sectors ))) != NULL )) {
+    part = count/threads;
+    main_task.count = count - ( threads-1 )*part;
+   /* вспомогательные потоки обрабатывают последние фрагменты данных */
+    for( i = 0; i < threads-1; i++ ) {
+       tasks[i] = main_task;
+       tasks[i].count = part;
+       tasks[i].sector = sector + main_task.count + i*part;
+       tasks[i].in = ( ak_uint8 *)in + ( main_task.count + i*part )*sector_size;
+       tasks[i].out = ( ak_uint8 *)out + ( main_task.count + i*part )*sector_size;
+       if( !ak_xts_sectors_start_thread( tasks+i )) { /* обрабатываем фрагмент самостоятельно */
+         tasks[i].encryptionKey = encryptionKey;
+         tasks[i].authenticationKey = authenticationKey;
+         ak_xts_sectors_update( tasks+i );
+       }
+    }
+    ak_xts_sectors_update( &main_task );
+    for( i = 0; i < threads-1; i++ ) {
+       if( !tasks[i].threaded ) continue;
+       pthread_join( tasks[i].thread, NULL );
+       ak_bckey_destroy( &tasks[i].akey );
+       ak_bckey_destroy( &tasks[i].ekey );
+    }
+    free( tasks );
+  }
+   else ak_xts_sectors_update( &main_task );
+#else
+  (void)threads;
+  ak_xts_sectors_update( &main_task );
+#endif
 
- /* запускаем основной цикл обработки блоков информации */
-   switch( encryptionKey->bsize ) {
-     case  8: /* шифр с длиной блока 64 бита */
-       while( blocks > 0 ) {
-          *tptr = *inptr^*(tweak+jcnt); inptr++;
-          encryptionKey->decrypt( &encryptionKey->key, tptr, tptr );
-          *outptr = *tptr ^ *(tweak+jcnt); outptr++;
-          --blocks;
-          tptr++;
+ return ak_xts_remask_keys( encryptionKey, authenticationKey );
+}
 
-          if( !(jcnt = 1 - jcnt)) { /* изменяем значение tweak */
-            tptr = t;
-            t[0] = tweak[0] >> 63; t[1] = tweak[1] >> 63;
-            tweak[0] <<= 1; tweak[1] <<= 1;
-            tweak[1] ^= t[0];
-            if( t[1] ) tweak[0] ^= 0x87;
-          }
-       }
-       break;
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция зашифровывает последовательность независимых секторов фиксированного размера
+    (например, образ диска) в режиме XTS. Сектор с порядковым номером `i` (начиная с нуля)
+    зашифровывается на синхропосылке, равной номеру `sector + i`, записанному в виде
+    128-битного числа в порядке little endian.
 
-     case 16: /* шифр с длиной блока 128 бит */
-       while( blocks > 0 ) {
-         /* шифруем */
-          t[0] = *inptr^*tweak; inptr++;
-          t[1] = *inptr^*(tweak+1); inptr++;
+    Результат совпадает с последовательным вызовом функции ak_bckey_encrypt_xts() для каждого
+    сектора с указанной синхропосылкой. При наличии поддержки потоков большие объемы данных
+    разбиваются на фрагменты, обрабатываемые параллельно (количество потоков определяется
+    опцией `threads_count`).
 
-          encryptionKey->decrypt( &encryptionKey->key, t, t );
-          *outptr = t[0]^*tweak; outptr++;
-          *outptr = t[1]^*(tweak+1); outptr++;
-          --blocks;
+    @param encryptionKey Ключ, используемый для шифрования информации
+    @param authenticationKey Ключ, используемый для выработки значений tweak
+    @param in Указатель на область памяти, где хранятся входные (открытые) данные
+    @param out Указатель на область памяти, куда будут помещены зашифрованные данные
+    (может совпадать с in)
+    @param size Размер входных данных (в октетах), должен быть кратен размеру сектора
+    @param sector Номер первого сектора
+    @param sector_size Размер сектора (в октетах), должен быть кратен длине блока
 
-         /* изменяем значение tweak */
-          t[0] = tweak[0] >> 63;
-          t[1] = tweak[1] >> 63;
-          tweak[0] <<= 1;
-          tweak[1] <<= 1;
-          tweak[1] ^= t[0];
-          if( t[1] ) tweak[0] ^= 0x87;
-       }
-       break;
-   }
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В случае возникновения
+    ошибки возвращается ее код.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_encrypt_xts_sectors( ak_bckey encryptionKey, ak_bckey authenticationKey,
+                ak_pointer in, ak_pointer out, size_t size, ak_uint64 sector, size_t sector_size )
+{
+  return ak_bckey_xts_sectors( encryptionKey, authenticationKey,
+                                                   in, out, size, sector, sector_size, ak_true );
+}
 
- /* очищаем */
-  if(( error = ak_ptr_wipe( tweak, sizeof( tweak ), &encryptionKey->key.generator )) != ak_error_ok )
-   ak_error_message( error, __func__ , "wrong wiping of tweak value" );
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует обратное преобразование к алгоритму, реализуемому с помощью
+    функции ak_bckey_encrypt_xts_sectors().
 
- /* перемаскируем ключ */
-  if(( error = encryptionKey->key.set_mask( &encryptionKey->key )) != ak_error_ok )
-    ak_error_message( error, __func__ , "wrong remasking of encryption key" );
-  if(( error = authenticationKey->key.set_mask( &authenticationKey->key )) != ak_error_ok )
-    ak_error_message( error, __func__ , "wrong remasking of authentication key" );
+    @param encryptionKey Ключ, используемый для шифрования информации
+    @param authenticationKey Ключ, используемый для выработки значений tweak
+    @param in Указатель на область памяти, где хранятся входные (зашифрованные) данные
+    @param out Указатель на область памяти, куда будут помещены расшифрованные данные
+    (может совпадать с in)
+    @param size Размер входных данных (в октетах), должен быть кратен размеру сектора
+    @param sector Номер первого сектора
+    @param sector_size Размер сектора (в октетах), должен быть кратен длине блока
 
-  return error;
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В случае возникновения
+    ошибки возвращается ее код.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_decrypt_xts_sectors( ak_bckey encryptionKey, ak_bckey authenticationKey,
+                ak_pointer in, ak_pointer out, size_t size, ak_uint64 sector, size_t sector_size )
+{
+  return ak_bckey_xts_sectors( encryptionKey, authenticationKey,
+                                                  in, out, size, sector, sector_size, ak_false );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
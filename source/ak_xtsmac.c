@@ -15,6 +15,12 @@
 #ifdef AK_HAVE_STDALIGN_H
  #include <stdalign.h>
 #endif
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Структура, содержащая текущее состояние внутренних переменных режима
@@ -152,6 +158,184 @@
      ak_xtsmac_next_gamma64; \
    } while(0);
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                     обработка последовательностей пар блоков                                    */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Минимальное количество пар блоков, обрабатываемых одним потоком. */
+ #define ak_xtsmac_blocks_per_thread       (4096)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно обрабатывает заданное количество пар блоков.
+
+    \details Если указатель `out` равен `NULL`, то входные данные только добавляются к значению
+    имитовставки (ассоциированные данные). В противном случае данные зашифровываются
+    (флаг `encrypt` равен `ak_true`) или расшифровываются с одновременным обновлением
+    значения имитовставки.                                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_xtsmac_update_blocks64( ak_xtsmac_ctx ctx, ak_bckey key, const ak_uint8 *in,
+                                            ak_uint8 *out, size_t blocks, const bool_t encrypt )
+{
+#ifdef AK_HAVE_STDALIGN_H
+ #ifndef AK_HAVE_WINDOWS_H
+  alignas(32)
+ #endif
+#endif
+  ak_uint64 t[2], temp[2];
+  ak_uint8 *tb = (ak_uint8 *)&t, *outptr = out;
+  const ak_uint8 *inptr = in;
+  ak_bckey authenticationKey = key, encryptionKey = key;
+
+  if( out == NULL ) {
+    while( blocks-- > 0 ) ak_xtsmac_authenticate_step64( inptr );
+  }
+   else {
+     if( encrypt ) while( blocks-- > 0 ) ak_xtsmac_encrypt_step64( inptr, outptr )
+      else while( blocks-- > 0 ) ak_xtsmac_decrypt_step64( inptr, outptr )
+   }
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение маскирующей гаммы, отстоящее от текущего
+    на `count` пар блоков, т.е. \f$ \gamma_{n+count} = \gamma_n \cdot x^{count} \f$.
+
+    \details Степень \f$ x^{count} \f$ вычисляется возведением в квадрат с умножением,
+    поэтому начальное значение гаммы для любого фрагмента данных вычисляется
+    за \f$ O(\log count) \f$ умножений в поле \f$ \mathbb F_{2^{128}}\f$.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_xtsmac_gamma_jump( ak_uint64 *gamma, size_t count )
+{
+#ifdef AK_LITTLE_ENDIAN
+  ak_uint64 t[2], x[2] = { 2, 0 }, z[2] = { 1, 0 };
+
+  while( count ) {
+    if( count&0x1 ) {
+      ak_gf128_mul( t, z, x );
+      z[0] = t[0]; z[1] = t[1];
+    }
+    if(( count >>= 1 ) == 0 ) break;
+    ak_gf128_mul( t, x, x );
+    x[0] = t[0]; x[1] = t[1];
+  }
+  ak_gf128_mul( t, gamma, z );
+  gamma[0] = t[0]; gamma[1] = t[1];
+#else
+  ak_uint64 n0, n1;
+
+ /* функции умножения ожидают представление little endian, поэтому используем удвоение */
+  while( count-- > 0 ) {
+    n0 = gamma[0] >> 63; n1 = gamma[1] >> 63;
+    gamma[0] <<= 1; gamma[1] <<= 1; gamma[1] ^= n0;
+    if( n1 ) gamma[0] ^= 0x87;
+  }
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Фрагмент последовательности пар блоков, обрабатываемый отдельным потоком. */
+ typedef struct xtsmac_blocks {
+  /*! \brief Собственная копия контекста (гамма фрагмента и частичная сумма). */
+   struct xtsmac_ctx ctx;
+  /*! \brief Используемый ключ. */
+   ak_bckey key;
+  /*! \brief Указатель на входные данные. */
+   const ak_uint8 *in;
+  /*! \brief Указатель на выходные данные (NULL для ассоциированных данных). */
+   ak_uint8 *out;
+  /*! \brief Количество пар блоков. */
+   size_t blocks;
+  /*! \brief Флаг зашифрования (ak_true) или расшифрования (ak_false) данных. */
+   bool_t encrypt;
+  /*! \brief Копия ключа, используемая вспомогательным потоком. */
+   struct bckey kcopy;
+  /*! \brief Дескриптор вспомогательного потока. */
+   pthread_t thread;
+  /*! \brief Флаг того, что фрагмент обрабатывается вспомогательным потоком. */
+   bool_t threaded;
+} *ak_xtsmac_blocks;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вспомогательного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_xtsmac_blocks_thread( void *ptr )
+{
+  ak_xtsmac_blocks bt = ptr;
+  ak_xtsmac_update_blocks64( &bt->ctx, bt->key, bt->in, bt->out, bt->blocks, bt->encrypt );
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает последовательность пар блоков, при необходимости
+    распределяя ее между несколькими потоками.
+
+    \details Значение имитовставки является суммой вкладов отдельных пар блоков,
+    каждый из которых зависит только от данных и значения гаммы для данной пары.
+    Поэтому последовательность разбивается на фрагменты, для каждого фрагмента
+    вычисляется начальное значение гаммы (см. ak_xtsmac_gamma_jump()), фрагменты
+    обрабатываются независимо, а полученные частичные суммы складываются.
+    Результат вычислений совпадает с последовательной обработкой данных.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_xtsmac_update_blocks( ak_xtsmac_ctx ctx, ak_bckey key, const ak_uint8 *in,
+                                            ak_uint8 *out, size_t blocks, const bool_t encrypt )
+{
+#ifdef AK_HAVE_PTHREAD_H
+  size_t i = 0, part = 0, first = 0,
+         threads = ak_min( ak_libakrypt_get_threads_count(), blocks/ak_xtsmac_blocks_per_thread );
+  ak_xtsmac_blocks tasks = NULL;
+
+  if(( threads > 1 ) && (( tasks = malloc(( threads-1 )*sizeof( struct xtsmac_blocks ))) != NULL )) {
+    part = blocks/threads;
+    first = blocks - ( threads-1 )*part;
+   /* вспомогательные потоки обрабатывают последние фрагменты данных */
+    for( i = 0; i < threads-1; i++ ) {
+       memcpy( &tasks[i].ctx, ctx, sizeof( struct xtsmac_ctx ));
+       memset( tasks[i].ctx.sum, 0, sizeof( tasks[i].ctx.sum ));
+       ak_xtsmac_gamma_jump( tasks[i].ctx.gamma.u64, first + i*part );
+       tasks[i].in = in + (( first + i*part ) << 4 );
+       tasks[i].out = ( out == NULL ) ? NULL : out + (( first + i*part ) << 4 );
+       tasks[i].blocks = part;
+       tasks[i].encrypt = encrypt;
+       tasks[i].threaded = ak_false;
+       tasks[i].key = key;
+      /* реализация шифра изменяет контекст ключа, поэтому каждый поток использует копию */
+       if( ak_bckey_create_and_set_bckey( &tasks[i].kcopy, key ) == ak_error_ok ) {
+         tasks[i].key = &tasks[i].kcopy;
+         if( pthread_create( &tasks[i].thread, NULL, ak_xtsmac_blocks_thread, tasks+i ) == 0 )
+           tasks[i].threaded = ak_true;
+          else {
+            ak_error_message( ak_error_undefined_function, __func__,
+                                                                 "wrong creation of a thread" );
+            ak_bckey_destroy( &tasks[i].kcopy );
+            tasks[i].key = key;
+          }
+       }
+      /* обрабатываем фрагмент самостоятельно */
+       if( !tasks[i].threaded ) ak_xtsmac_update_blocks64( &tasks[i].ctx,
+                             key, tasks[i].in, tasks[i].out, tasks[i].blocks, tasks[i].encrypt );
+    }
+    ak_xtsmac_update_blocks64( ctx, key, in, out, first, encrypt );
+
+   /* объединяем частичные суммы */
+    for( i = 0; i < threads-1; i++ ) {
+       if( tasks[i].threaded ) {
+         pthread_join( tasks[i].thread, NULL );
+         ak_bckey_destroy( &tasks[i].kcopy );
+       }
+       ctx->sum[0] ^= tasks[i].ctx.sum[0];
+       ctx->sum[1] ^= tasks[i].ctx.sum[1];
+    }
+    ctx->gamma.u64[0] = tasks[threads-2].ctx.gamma.u64[0];
+    ctx->gamma.u64[1] = tasks[threads-2].ctx.gamma.u64[1];
+
+    ak_ptr_wipe( tasks, ( threads-1 )*sizeof( struct xtsmac_blocks ), &key->key.generator );
+    free( tasks );
+    return;
+  }
+#endif
+  ak_xtsmac_update_blocks64( ctx, key, in, out, blocks, encrypt );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                             реализация пошаговой стратегии вычислений                           */
 /* ----------------------------------------------------------------------------------------------- */
@@ -281,10 +465,9 @@
 
   }
    else { /* обработка 64-битным шифром */
-      while( blocks-- > 0 ) {
-        ak_xtsmac_authenticate_step64( inptr );
-        ctx->abitlen += 128;
-      }
+      ak_xtsmac_update_blocks( ctx, authenticationKey, inptr, NULL, ( size_t )blocks, ak_true );
+      inptr += ( blocks << 4 );
+      ctx->abitlen += ( blocks << 7 );
       if( tail ) {
         memcpy( tptr, inptr, tail ); /* копируем входные данные (здесь меньше одного 16-ти байтного блока) */
         memset( tptr +tail, 0, 16 -tail ); /* зануляем остаток */
@@ -441,12 +624,10 @@
  /* теперь blocks отлично от нуля и можно выполнить общий цикл обработки данных */
   switch( encryptionKey->bsize ) {
     case  8:
-      while( blocks-- > 0 ) {
-         //printf("in:  %s\n", ak_ptr_to_hexstr( inptr, 16, ak_false ));
-         ak_xtsmac_encrypt_step64( inptr, outptr );
-         ctx->pbitlen += 128;
-         //printf("out: %s\n\n", ak_ptr_to_hexstr( outptr -16, 16, ak_false ));
-      }
+      ak_xtsmac_update_blocks( ctx, encryptionKey, inptr, outptr, ( size_t )blocks, ak_true );
+      inptr += ( blocks << 4 );
+      outptr += ( blocks << 4 );
+      ctx->pbitlen += ( blocks << 7 );
       if( tail ) {
        /* копируем ту часть шифртекста, что не будет изменена */
          outptr -= 16;
@@ -553,10 +734,11 @@
  /* теперь blocks отлично от нуля и можно выполнить общий цикл обработки данных */
   switch( encryptionKey->bsize ) {
     case  8:
-      while( blocks-- > 1 ) {
-         ak_xtsmac_decrypt_step64( inptr, outptr );
-         ctx->pbitlen += 128;
-      }
+      ak_xtsmac_update_blocks( ctx, encryptionKey,
+                                        inptr, outptr, ( size_t )( blocks-1 ), ak_false );
+      inptr += (( blocks-1 ) << 4 );
+      outptr += (( blocks-1 ) << 4 );
+      ctx->pbitlen += (( blocks-1 ) << 7 );
       if( tail ) {
         ak_uint8 *loptr = NULL;
         ak_uint64 tgamma[2] = { ctx->gamma.u64[0], ctx->gamma.u64[1] };
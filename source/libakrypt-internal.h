@@ -10,6 +10,30 @@
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup options-doc Инициализация и настройка параметров библиотеки
+ @{ */
+/*! \brief Количество потоков, используемых для параллельной обработки данных. */
+ size_t ak_libakrypt_get_threads_count( void );
+/*! \brief Выбор способа считывания данных при потоковой обработке файла. */
+ file_stream_t ak_libakrypt_get_file_stream_method( ak_file , const ak_int64 ,
+                                                                        const size_t , size_t * );
+/*! \brief Выбор реализаций операций умножения в конечных полях характеристики два
+    в соответствии с возможностями процессора. */
+ void ak_gf2n_set_cpu_level( cpu_level_t );
+/*! \brief Выбор реализаций операций Монтгомери для 256-ти и 512-ти битных модулей
+    в соответствии с возможностями процессора. */
+ void ak_mpzn_set_cpu_level( cpu_level_t );
+
+/*! \brief Атрибут функций, использующих команду pclmulqdq без соответствующих флагов компилятора.
+    \details Такие функции вызываются только после проверки наличия команды с помощью cpuid. */
+#ifdef AK_HAVE_TARGET_CLMULEPI64
+ #define ak_target_pclmul __attribute__(( target( "pclmul,sse2" )))
+#else
+ #define ak_target_pclmul
+#endif
+/** @} */
+
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup skey-doc Cекретные ключи криптографических механизмов
  @{ */
@@ -51,6 +75,17 @@
  @{ */
  extern const ak_uint64 streebog_Areverse_expand_with_pi[8][256];
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество сообщений, сжимаемых одновременно функцией ak_hash_multi(). */
+ #define ak_hash_streebog_lanes                (4)
+/*! \brief Вычисление таблиц, используемых для ускоренной реализации алгоритма crc64. */
+ int ak_hash_crc64_init_tables( void );
+/*! \brief Выбор реализации алгоритма crc64 в соответствии с возможностями процессора. */
+ void ak_hash_crc64_set_cpu_level( cpu_level_t );
+/*! \brief Выполнение итераций алгоритма PBKDF2 одновременно для нескольких паролей. */
+ void ak_hash_streebog512_pbkdf2_iterations( ak_streebog , ak_streebog ,
+                                    ak_uint64 (*)[8], ak_uint64 (*)[8], const size_t , const size_t );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция инициализации контекста начальными значениями. */
  int ak_mac_create( ak_mac , const size_t , ak_pointer ,
@@ -69,8 +104,19 @@
  int ak_mac_file( ak_mac , const char* , ak_pointer , const size_t );
 /*! \brief Применение сжимающего отображения к фрагменту заданного файла. */
  int ak_mac_file_offset( ak_mac , const char* , ak_int64 , ak_int64 , ak_pointer , const size_t );
+/*! \brief Уничтожение сохраненных состояний функции хеширования в контексте алгоритма HMAC. */
+ void ak_hmac_wipe_internal_states( ak_hmac );
 /** @} */
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удаление таблиц кратных образующих точек эллиптических кривых. */
+ void ak_wcurve_destroy_tables( void );
+/*! \brief Вычисление нечетных кратных точки эллиптической кривой. */
+ void ak_wpoint_set_odd_multiples( ak_wpoint , ak_wpoint , ak_wcurve );
+/*! \brief Вычисление суммы кратных точек с использованием заранее вычисленных кратных. */
+ void ak_wpoint_pow2_multiples( ak_wpoint , ak_wpoint , ak_uint64 * ,
+                                                  ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup aead-doc Аутентифицированное шифрование данных
  @{ */
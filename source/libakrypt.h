@@ -162,6 +162,41 @@ extern "C" {
 /*! \brief Функция выводит текущие значения всех опций библиотеки. */
  dll_export void ak_libakrypt_log_options( void );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Уровень реализации вычислительных ядер, выбираемый во время работы библиотеки. */
+ typedef enum {
+  /*! \brief Переносимая реализация без использования специальных команд процессора. */
+   cpu_level_generic = 0,
+  /*! \brief Реализация с использованием команды умножения многочленов pclmulqdq. */
+   cpu_level_pclmul = 1,
+  /*! \brief Реализация с использованием расширений avx2, bmi2 и adx. */
+   cpu_level_avx2 = 2
+} cpu_level_t;
+
+/*! \brief Процессор поддерживает набор команд sse2. */
+ #define ak_cpu_feature_sse2                  (0x0001)
+/*! \brief Процессор поддерживает набор команд ssse3. */
+ #define ak_cpu_feature_ssse3                 (0x0002)
+/*! \brief Процессор поддерживает набор команд sse4.1. */
+ #define ak_cpu_feature_sse41                 (0x0004)
+/*! \brief Процессор поддерживает команду pclmulqdq. */
+ #define ak_cpu_feature_pclmul                (0x0008)
+/*! \brief Процессор и операционная система поддерживают набор команд avx. */
+ #define ak_cpu_feature_avx                   (0x0010)
+/*! \brief Процессор и операционная система поддерживают набор команд avx2. */
+ #define ak_cpu_feature_avx2                  (0x0020)
+/*! \brief Процессор поддерживает набор команд bmi2 (команда mulx). */
+ #define ak_cpu_feature_bmi2                  (0x0040)
+/*! \brief Процессор поддерживает команды adcx и adox. */
+ #define ak_cpu_feature_adx                   (0x0080)
+
+/*! \brief Функция возвращает набор расширений процессора, обнаруженных при инициализации библиотеки. */
+ dll_export ak_uint32 ak_libakrypt_get_cpu_features( void );
+/*! \brief Функция возвращает уровень реализации вычислительных ядер, используемый библиотекой. */
+ dll_export cpu_level_t ak_libakrypt_get_cpu_level( void );
+/*! \brief Функция устанавливает максимальный уровень реализации вычислительных ядер. */
+ dll_export int ak_libakrypt_set_cpu_level( cpu_level_t );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция устанавливает режим совместимости криптографических преобразований с библиотекой openssl. */
  dll_export int ak_libakrypt_set_openssl_compability( bool_t );
@@ -184,6 +219,8 @@ extern "C" {
  dll_export bool_t ak_libakrypt_test_streebog256( void );
 /*! \brief Проверка корректной работы функции хеширования Стрибог-512 */
  dll_export bool_t ak_libakrypt_test_streebog512( void );
+/*! \brief Проверка корректной работы различных реализаций алгоритма crc64 */
+ dll_export bool_t ak_libakrypt_test_crc64( void );
 /*! \brief Функция проверяет корректность реализации алгоритмов хэширования. */
  dll_export bool_t ak_libakrypt_test_hash_functions( void );
 /*! \brief Функция проверяет корректность реализации алгоритмов выработки имитовставки. */
@@ -708,6 +745,8 @@ extern "C" {
  typedef int ( ak_function_bckey_create ) ( ak_bckey );
 /*! \brief Функция зашифрования/расширования одного блока информации. */
  typedef void ( ak_function_bckey )( ak_skey, ak_pointer, ak_pointer );
+/*! \brief Функция зашифрования/расширования нескольких независимых блоков информации. */
+ typedef void ( ak_function_bckey_blocks )( ak_skey, ak_pointer, ak_pointer, size_t );
 /*! \brief Функция, предназначенная для зашифрования/расшифрования области памяти заданного размера */
  typedef int ( ak_function_bckey_encrypt )( ak_bckey, ak_pointer, ak_pointer, size_t,
                                                                                 ak_pointer, size_t );
@@ -728,6 +767,14 @@ extern "C" {
    ak_function_bckey *encrypt;
   /*! \brief Функция расширования одного блока информации. */
    ak_function_bckey *decrypt;
+  /*! \brief Функция зашифрования нескольких независимых блоков информации.
+      \details Если указатель не определен, то блоки зашифровываются последовательно
+      с помощью функции `encrypt`. */
+   ak_function_bckey_blocks *encrypt_blocks;
+  /*! \brief Функция расшифрования нескольких независимых блоков информации.
+      \details Если указатель не определен, то блоки расшифровываются последовательно
+      с помощью функции `decrypt`. */
+   ak_function_bckey_blocks *decrypt_blocks;
   /*! \brief Функция развертки ключа. */
    ak_function_skey *schedule_keys;
   /*! \brief Функция уничтожения развернутых ключей. */
@@ -825,6 +872,12 @@ extern "C" {
 /*! \brief Расшифрование данных в режиме `XTS`. */
  dll_export int ak_bckey_decrypt_xts( ak_bckey ,  ak_bckey , ak_pointer , ak_pointer , size_t ,
                                                                              ak_pointer , size_t );
+/*! \brief Зашифрование последовательности независимых секторов в режиме `XTS`. */
+ dll_export int ak_bckey_encrypt_xts_sectors( ak_bckey ,  ak_bckey , ak_pointer , ak_pointer ,
+                                                                   size_t , ak_uint64 , size_t );
+/*! \brief Расшифрование последовательности независимых секторов в режиме `XTS`. */
+ dll_export int ak_bckey_decrypt_xts_sectors( ak_bckey ,  ak_bckey , ak_pointer , ak_pointer ,
+                                                                   size_t , ak_uint64 , size_t );
 /** @}*/
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -832,6 +885,9 @@ extern "C" {
  @{ */
 /*! \brief Вычисление имитовставки согласно ГОСТ Р 34.13-2015. */
  dll_export int ak_bckey_cmac( ak_bckey , ak_pointer , const size_t , ak_pointer , const size_t );
+/*! \brief Вычисление имитовставок для нескольких независимых сообщений. */
+ dll_export int ak_bckey_cmac_multi( ak_bckey , const size_t , ak_pointer * , const size_t * ,
+                                                                       ak_pointer , const size_t );
 /*! \brief Очистка внутреннего состояния секретного ключа. */
  dll_export int ak_bckey_cmac_clean( ak_bckey );
 /*! \brief Обновление внутреннего состояния секретного ключа при вычислении имитовставки
@@ -932,6 +988,8 @@ extern "C" {
  dll_export int ak_hash_create_streebog512( ak_hash );
 /*! \brief Инициализация контекста некриптографической функции хеширования crc64. */
  dll_export int ak_hash_create_crc64( ak_hash );
+/*! \brief Вычисление значения crc64 для объединения двух фрагментов данных. */
+ dll_export ak_uint64 ak_hash_crc64_combine( ak_uint64 , ak_uint64 , ak_uint64 );
 /*! \brief Инициализация контекста функции бесключевого хеширования по заданному OID алгоритма. */
  dll_export int ak_hash_create_oid( ak_hash, ak_oid );
 /*! \brief Уничтожение контекста функции хеширования. */
@@ -956,6 +1014,12 @@ extern "C" {
 /*! \brief Хеширование фрагмента заданного файла. */
  dll_export int ak_hash_file_offset( ak_hash , const char * ,
                                                   ak_int64 , ak_int64 , ak_pointer , const size_t );
+/*! \brief Хеширование нескольких независимых областей памяти. */
+ dll_export int ak_hash_multi( ak_hash , const size_t , ak_pointer * , const size_t * ,
+                                                                       ak_pointer , const size_t );
+/*! \brief Хеширование каждого файла из заданного списка. */
+ dll_export int ak_hash_file_list( ak_hash , const char ** , const size_t ,
+                                                                       ak_pointer , const size_t );
 /** @}*/
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -986,6 +1050,13 @@ extern "C" {
   /*! \brief Идентификатор второго алгоритма хеширования,
       применяется только в алгоритмах семейства NMAC (см. Р 1323565.1.022-2018) */
    ak_oid nmac_second_hash_oid;
+  /*! \brief Маскированные состояния функции хеширования после обработки блоков
+      \f$ K \oplus ipad \f$ (первые 24 слова) и \f$ K \oplus opad \f$ (последние 24 слова) */
+   ak_uint64 states[48];
+  /*! \brief Маски, наложенные на сохраненные состояния */
+   ak_uint64 masks[48];
+  /*! \brief Флаги вычисленных состояний: 1 - для блока ipad, 2 - для блока opad */
+   ak_uint32 states_flags;
 } *ak_hmac;
 
 /*! \brief Создание секретного ключа алгоритма выработки имитовставки HMAC на основе функции Стрибог256. */
@@ -1114,6 +1185,11 @@ extern "C" {
  dll_export ak_uint8 *ak_tlstree_state_get_key( ak_tlstree_state );
 /*! \brief Функция вырабатывает новое значение производного ключа (для следующего номера ключа) */
  dll_export int ak_tlstree_state_next( ak_tlstree_state );
+/*! \brief Функция вырабатывает значение производного ключа для произвольного номера ключа */
+ dll_export int ak_tlstree_state_seek( ak_tlstree_state , ak_uint64 );
+/*! \brief Функция вырабатывает последовательность производных ключей с заданными номерами */
+ dll_export int ak_tlstree_state_get_keys( ak_tlstree_state , ak_uint64 , const size_t ,
+                                                                      ak_uint8 *, const size_t );
 /*! \brief Функция уничтожает контекст алгоритма TLSTREE */
  dll_export int ak_tlstree_state_destroy( ak_tlstree_state );
 
@@ -1166,6 +1242,9 @@ extern "C" {
  dll_export size_t ak_kdf_state_get_block_size( ak_kdf_state );
 /*! \brief Функция вырабатывает следующий фрагмент ключевой информации */
  dll_export int ak_kdf_state_next( ak_kdf_state , ak_pointer , const size_t );
+/*! \brief Функция вырабатывает следующий фрагмент ключевой информации для массива контекстов */
+ dll_export int ak_kdf_state_next_multi( ak_kdf_state * , const size_t ,
+                                                                      ak_pointer , const size_t );
 /*! \brief Удаление контекста выработки производных ключей */
  dll_export int ak_kdf_state_destroy( ak_kdf_state );
 
@@ -1198,6 +1277,9 @@ extern "C" {
 /*! \brief Развертка ключевого вектора из пароля (согласно Р 50.1.111-2016, раздел 4) */
  dll_export int ak_hmac_pbkdf2_streebog512( const ak_pointer , const size_t ,
                    const ak_pointer , const size_t, const size_t , const size_t , ak_pointer );
+/*! \brief Развертка ключевых векторов из нескольких паролей одновременно. */
+ dll_export int ak_hmac_pbkdf2_streebog512_multi( const size_t , ak_pointer * , const size_t * ,
+                        ak_pointer * , const size_t * , const size_t , const size_t , ak_pointer );
 /** @}*/
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1454,6 +1536,12 @@ extern "C" {
 /*! \brief Модульное возведение в степень в представлении Монтгомери. */
  dll_export void ak_mpzn_modpow_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Вычисление обратного вычета в представлении Монтгомери за постоянное время. */
+ dll_export void ak_mpzn_inverse_montgomery( ak_uint64 *, ak_uint64 *,
+                                              ak_uint64 *, ak_uint64, ak_uint64 *, const size_t );
+/*! \brief Вычисление обратного вычета в представлении Монтгомери для открытых данных. */
+ dll_export void ak_mpzn_inverse_montgomery_vartime( ak_uint64 *, ak_uint64 *,
+                                              ak_uint64 *, ak_uint64, ak_uint64 *, const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /*! \brief Преобразование ak_mpznxxx в mpz_t. */
@@ -1490,6 +1578,8 @@ extern "C" {
 };
 /*! \brief Контекст точки эллиптической кривой в короткой форме Вейерштрасса */
  typedef struct wpoint *ak_wpoint;
+/*! \brief Количество нечетных кратных точки, используемых при вычислении суммы кратных точек */
+ #define ak_wpoint_odd_multiples_count  (8)
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Инициализация и присвоение контексту значения образующей точки эллиптической кривой. */
@@ -1512,6 +1602,11 @@ extern "C" {
  dll_export void ak_wpoint_reduce( ak_wpoint , ak_wcurve );
 /*! \brief Вычисление кратной точки эллиптической кривой. */
  dll_export void ak_wpoint_pow( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной точки для образующей точки эллиптической кривой. */
+ dll_export void ak_wpoint_pow_base( ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление суммы двух кратных точек эллиптической кривой (с открытыми степенями). */
+ dll_export void ak_wpoint_pow2( ak_wpoint , ak_wpoint , ak_uint64 * ,
+                                                  ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Перечисление числовых идентификаторов поддерживаемых эллиптических кривых */
@@ -1618,6 +1713,79 @@ extern "C" {
 /*! \brief Функция возвращает указатель на параметры кривой по ее числовому идентификатору */
  dll_export const struct wcurve *ak_wcurve_get_parameters( wcurve_id_t );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Класс, реализующий точку эллиптической кривой в искривленной форме Эдвардса.
+
+    Точка \f$ P \f$ кривой \f$ u^2 + v^2 \equiv 1 + du^2v^2 \pmod{p} \f$ представляется
+    в расширенных проективных координатах \f$ P=(x:y:t:z) \f$, где \f$ u = x/z \f$, \f$ v = y/z \f$
+    и \f$ tz = xy \f$. Для координат точки используется представление Монтгомери.               */
+/* ----------------------------------------------------------------------------------------------- */
+ struct epoint
+{
+/*! \brief x-координата точки эллиптической кривой */
+ ak_uint64 x[ak_mpzn512_size];
+/*! \brief y-координата точки эллиптической кривой */
+ ak_uint64 y[ak_mpzn512_size];
+/*! \brief t-координата точки эллиптической кривой */
+ ak_uint64 t[ak_mpzn512_size];
+/*! \brief z-координата точки эллиптической кривой */
+ ak_uint64 z[ak_mpzn512_size];
+};
+/*! \brief Контекст точки эллиптической кривой в искривленной форме Эдвардса */
+ typedef struct epoint *ak_epoint;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Класс, реализующий эллиптическую кривую в искривленной форме Эдвардса,
+    эквивалентную кривой в короткой форме Вейерштрасса.
+
+    Кривая задается сравнением \f$ eu^2 + v^2 \equiv 1 + du^2v^2 \pmod{p} \f$, где для всех
+    кривых из рекомендаций Р 1323565.1.024-2019 значение \f$ e \f$ равно единице.
+    Поскольку \f$ d \f$ является квадратичным невычетом, формулы сложения точек полны, то есть
+    применимы к любым двум точкам кривой, в том числе совпадающим.
+
+    Точки кривой в форме Вейерштрасса \f$ y^2 \equiv x^3 + ax + b \pmod{p} \f$ отображаются
+    в точки кривой Эдвардса равенствами \f$ u = (x-t)/y \f$, \f$ v = (x - t - s)/(x - t + s) \f$,
+    где \f$ s = (e-d)/4 \f$ и \f$ t = (e+d)/6 \f$; обратное отображение задается равенствами
+    \f$ x = s(1+v)/(1-v) + t \f$, \f$ y = s(1+v)/((1-v)u) \f$.                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ struct ecurve
+{
+ /*! \brief Эквивалентная кривая в короткой форме Вейерштрасса. */
+  ak_wcurve wc;
+ /*! \brief Коэффициент \f$ d \f$ кривой (в представлении Монтгомери). */
+  ak_uint64 d[ak_mpzn512_size];
+ /*! \brief Величина \f$ s \f$ (в представлении Монтгомери). */
+  ak_uint64 s[ak_mpzn512_size];
+ /*! \brief Величина \f$ t \f$ (в представлении Монтгомери). */
+  ak_uint64 t[ak_mpzn512_size];
+};
+/*! \brief Контекст эллиптической кривой в искривленной форме Эдвардса */
+ typedef struct ecurve *ak_ecurve;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает кривую Эдвардса, эквивалентную заданной кривой (или NULL). */
+ dll_export ak_ecurve ak_wcurve_get_ecurve( ak_wcurve );
+/*! \brief Присвоение точке кривой Эдвардса значения нейтрального элемента группы точек. */
+ dll_export void ak_epoint_set_as_unit( ak_epoint , ak_ecurve );
+/*! \brief Отображение точки кривой в форме Вейерштрасса в точку кривой Эдвардса. */
+ dll_export void ak_epoint_set_wpoint( ak_epoint , ak_wpoint , ak_ecurve );
+/*! \brief Отображение точки кривой Эдвардса в точку кривой в форме Вейерштрасса. */
+ dll_export void ak_wpoint_set_epoint( ak_wpoint , ak_epoint , ak_ecurve );
+/*! \brief Проверка принадлежности точки кривой Эдвардса. */
+ dll_export bool_t ak_epoint_is_ok( ak_epoint , ak_ecurve );
+/*! \brief Удвоение точки эллиптической кривой в искривленной форме Эдвардса. */
+ dll_export void ak_epoint_double( ak_epoint , ak_ecurve );
+/*! \brief Прибавление к одной точке эллиптической кривой в форме Эдвардса значения другой точки. */
+ dll_export void ak_epoint_add( ak_epoint , ak_epoint , ak_ecurve );
+/*! \brief Вычисление кратной точки эллиптической кривой в искривленной форме Эдвардса. */
+ dll_export void ak_epoint_pow( ak_epoint , ak_epoint , ak_uint64 *, size_t , ak_ecurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                       параметры эллиптических кривых в форме Эдвардса                           */
+/* ----------------------------------------------------------------------------------------------- */
+ extern const struct ecurve id_tc26_gost_3410_2012_256_paramSetA_edwards;
+ extern const struct ecurve id_tc26_gost_3410_2012_512_paramSetC_edwards;
+
 /** @}*/
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1644,6 +1812,12 @@ extern "C" {
  dll_export void ak_gf256_mul_uint64( ak_pointer z, ak_pointer x, ak_pointer y );
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$. */
  dll_export void ak_gf512_mul_uint64( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{128}}\f$. */
+ dll_export void ak_gf128_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{256}}\f$. */
+ dll_export void ak_gf256_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{512}}\f$. */
+ dll_export void ak_gf512_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{64}}\f$. */
@@ -1654,19 +1828,40 @@ extern "C" {
  dll_export void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b );
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$. */
  dll_export void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b );
-
- #define ak_gf64_mul ak_gf64_mul_pcmulqdq
- #define ak_gf128_mul ak_gf128_mul_pcmulqdq
- #define ak_gf256_mul ak_gf256_mul_pcmulqdq
- #define ak_gf512_mul ak_gf512_mul_pcmulqdq
-#else
-
- #define ak_gf64_mul ak_gf64_mul_uint64
- #define ak_gf128_mul ak_gf128_mul_uint64
- #define ak_gf256_mul ak_gf256_mul_uint64
- #define ak_gf512_mul ak_gf512_mul_uint64
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{128}}\f$
+    с отложенным приведением. */
+ dll_export void ak_gf128_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{256}}\f$
+    с отложенным приведением. */
+ dll_export void ak_gf256_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{512}}\f$
+    с отложенным приведением. */
+ dll_export void ak_gf512_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{64}}\f$ с использованием реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf64_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{128}}\f$ с использованием реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf128_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{256}}\f$ с использованием реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf256_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$ с использованием реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf512_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{128}}\f$ с использованием
+    реализации, выбранной при инициализации библиотеки. */
+ dll_export void ak_gf128_mul_sum( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{256}}\f$ с использованием
+    реализации, выбранной при инициализации библиотеки. */
+ dll_export void ak_gf256_mul_sum( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сумма попарных произведений элементов поля \f$ \mathbb F_{2^{512}}\f$ с использованием
+    реализации, выбранной при инициализации библиотеки. */
+ dll_export void ak_gf512_mul_sum( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+
 /* Размеры конечных полей (в октетах) */
 /*! \brief Размер поля \f$ \mathbb F_{2^{64}}\f$ в байтах. */
  #define ak_galois64_size               (8)
@@ -2047,6 +2242,8 @@ extern "C" {
   struct hash ctx;
  /*! \brief номер открытого ключа, выработанного из данного секретного ключа. */
   ak_uint8 verifykey_number[32];
+ /*! \brief пул вычисленных заранее пар \f$ (k, r) \f$ (или NULL, если пул не создан) */
+  struct signkey_pool *pool;
 } *ak_signkey;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -2085,6 +2282,16 @@ extern "C" {
  dll_export int ak_signkey_set_key( ak_signkey , const ak_pointer , const size_t );
 /*! \brief Присвоение секретному ключу электронной подписи случайного значения. */
  dll_export int ak_signkey_set_key_random( ak_signkey , ak_random );
+/*! \brief Создание пула вычисленных заранее пар \f$ (k, r) \f$ для выработки электронной подписи. */
+ dll_export int ak_signkey_create_pool( ak_signkey , const size_t );
+/*! \brief Уничтожение пула вычисленных заранее пар \f$ (k, r) \f$. */
+ dll_export int ak_signkey_destroy_pool( ak_signkey );
+/*! \brief Вычисление заданного количества пар \f$ (k, r) \f$ и добавление их в пул. */
+ dll_export int ak_signkey_fill_pool( ak_signkey , ak_random , const size_t );
+/*! \brief Запуск потока, пополняющего пул пар \f$ (k, r) \f$ в фоновом режиме. */
+ dll_export int ak_signkey_start_pool_refill( ak_signkey , ak_random , const size_t );
+/*! \brief Количество пар \f$ (k, r) \f$, содержащихся в пуле. */
+ dll_export size_t ak_signkey_get_pool_count( ak_signkey );
 /** @}*/
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -2182,6 +2389,22 @@ extern "C" {
  dll_export bool_t ak_verifykey_verify_file_offset( ak_verifykey , const char * ,
                                                                 ak_int64 , ak_int64 , ak_pointer );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Элемент пакета проверяемых электронных подписей. */
+ typedef struct verify_item {
+  /*! \brief Открытый ключ, с помощью которого проверяется подпись. */
+   ak_verifykey key;
+  /*! \brief Хеш-код подписанного сообщения. */
+   ak_pointer hash;
+  /*! \brief Размер хеш-кода (в октетах). */
+   size_t hsize;
+  /*! \brief Проверяемая электронная подпись. */
+   ak_pointer sign;
+} *ak_verify_item;
+
+/*! \brief Проверка массива электронных подписей для вычисленных заранее значений хеш-функции. */
+ dll_export int ak_verifykey_verify_hash_batch( ak_verify_item , const size_t , bool_t * );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Параметры запроса на сертификат открытого ключа */
  typedef struct request_opts {
@@ -2485,9 +2708,15 @@ extern "C" {
 /*! \brief Функция создает ключ абонента для схемы Блома. */
  dll_export int ak_blomkey_create_abonent_key( ak_blomkey , ak_blomkey ,
                                                                        ak_pointer , const size_t );
+/*! \brief Функция создает ключи нескольких абонентов для схемы Блома. */
+ dll_export int ak_blomkey_create_abonent_keys( ak_blomkey , ak_blomkey ,
+                                                  ak_pointer * , const size_t * , const size_t );
 /*! \brief Функция создает ключ парной связи (в виде последовательности октетов) */
  dll_export int ak_blomkey_create_pairwise_key_as_ptr( ak_blomkey ,
                                                  ak_pointer , const size_t , ak_pointer , size_t );
+/*! \brief Функция создает ключи парной связи с несколькими абонентами */
+ dll_export int ak_blomkey_create_pairwise_keys_as_ptr( ak_blomkey , ak_pointer * ,
+                                        const size_t * , const size_t , ak_pointer , size_t );
 /*! \brief Функция создает ключ парной связи и помещает его в контекст секретного ключа */
  dll_export ak_pointer ak_blomkey_new_pairwise_key( ak_blomkey , ak_pointer ,
                                                                            const size_t , ak_oid );
@@ -2500,6 +2729,10 @@ extern "C" {
 /*! \brief Экспорт ключа схемы Блома в заданный файл */
  dll_export int ak_blomkey_export_to_file_with_password( ak_blomkey ,
                                              const char * , const size_t , char * , const size_t );
+/*! \brief Выработка ключей нескольких абонентов и их экспорт в файлы */
+ dll_export int ak_blomkey_export_abonent_keys_to_files_with_password( ak_blomkey ,
+                                    ak_pointer * , const size_t * , const size_t , const char * ,
+                                                            const size_t , char * , const size_t );
 /*! \brief Импорт ключа схемы Блома из заданного файла */
  dll_export int ak_blomkey_import_from_file_with_password( ak_blomkey ,
                                                             const char * , const size_t , char * );